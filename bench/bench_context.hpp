@@ -0,0 +1,31 @@
+/**
+ * Contexte des microbenchmarks (taskman_bench).
+ * Responsabilité unique : fournir à tous les benchmarks la même base générée
+ * (demo:generate --scale) et quelques valeurs tirées de cette base (IDs, phase, rôle).
+ */
+
+#ifndef TASKMAN_BENCH_CONTEXT_HPP
+#define TASKMAN_BENCH_CONTEXT_HPP
+
+#include <string>
+#include <vector>
+
+namespace taskman {
+
+struct BenchContext {
+    std::string db_path;
+    int tasks = 0;                       // nombre de tâches de la base
+    std::vector<std::string> task_ids;   // échantillon d'IDs (répartis sur toute la base)
+    std::string phase_id;                // phase du milieu du projet (tâches de tous statuts)
+    std::string role = "developer";
+};
+
+/** Contexte préparé par main() avant l'exécution des benchmarks. */
+const BenchContext& bench_context();
+
+/** ID de l'échantillon n (modulo sa taille) : les appels successifs ne lisent pas la même ligne. */
+const std::string& bench_task_id(size_t n);
+
+} // namespace taskman
+
+#endif /* TASKMAN_BENCH_CONTEXT_HPP */
@@ -0,0 +1,104 @@
+/**
+ * Microbenchmarks — accès base : QueryExecutor, filtres de TaskRepository, génération d'UUID.
+ */
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include "bench_context.hpp"
+#include "core/task/task_repository.hpp"
+#include "core/task/task_service.hpp"
+#include "infrastructure/db/db.hpp"
+#include "infrastructure/db/transaction.hpp"
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace taskman;
+
+namespace {
+
+/** Compte les lignes reçues, sans les conserver (coût de la requête seule). */
+struct CountingSink : RowSink {
+    size_t rows = 0;
+    void columns(const RowCursor&) override {}
+    void row(const RowCursor&) override { ++rows; }
+};
+
+void open_bench_db(Database& db) {
+    REQUIRE(db.open(bench_context().db_path.c_str()));
+}
+
+} // namespace
+
+TEST_CASE("QueryExecutor — query et run", "[bench][db]") {
+    Database db;
+    open_bench_db(db);
+    QueryExecutor& executor = db.get_executor();
+    size_t n = 0;
+
+    BENCHMARK("query: task by id") {
+        return executor.query("SELECT id, title, status FROM tasks WHERE id = ?", {bench_task_id(n++)});
+    };
+    BENCHMARK("query: count tasks") {
+        return executor.query("SELECT COUNT(*) AS n FROM tasks");
+    };
+    BENCHMARK("query_into: 1000 tasks") {
+        CountingSink sink;
+        executor.query_into("SELECT id, title, status FROM tasks LIMIT 1000", {}, sink);
+        return sink.rows;
+    };
+
+    // Écritures annulées à la fin (savepoint) : la base reste identique d'une exécution à l'autre
+    Transaction tx(executor);
+    REQUIRE(tx.active());
+    BENCHMARK("run: update by id") {
+        return executor.run("UPDATE tasks SET sort_order = sort_order WHERE id = ?", {bench_task_id(n++)});
+    };
+}
+
+TEST_CASE("TaskRepository — combinaisons de filtres", "[bench][db]") {
+    Database db;
+    open_bench_db(db);
+    TaskRepository repo(db.get_executor());
+    const BenchContext& ctx = bench_context();
+    using Filter = std::optional<std::string>;
+    const std::vector<Filter> phases = {std::nullopt, ctx.phase_id};
+    const std::vector<Filter> statuses = {std::nullopt, std::string("to_do"), std::string("done")};
+    const std::vector<Filter> roles = {std::nullopt, ctx.role};
+    const std::vector<Filter> blocked = {std::nullopt, std::string("blocked"), std::string("unblocked")};
+
+    for (const auto& phase : phases) {
+        for (const auto& status : statuses) {
+            for (const auto& role : roles) {
+                for (const auto& blocked_filter : blocked) {
+                    std::string name = std::string("phase=") + (phase ? *phase : "*") + " status="
+                                     + status.value_or("*") + " role=" + role.value_or("*")
+                                     + " blocked=" + blocked_filter.value_or("*");
+                    BENCHMARK(std::string("list_page(50) ") + name) {
+                        std::optional<TaskListKey> next;
+                        return repo.list_page(phase, status, role, blocked_filter, std::nullopt, std::nullopt, 50,
+                                              {}, next);
+                    };
+                    BENCHMARK(std::string("count ") + name) {
+                        return repo.count(phase, std::nullopt, status, role, blocked_filter, std::nullopt);
+                    };
+                }
+            }
+        }
+    }
+
+    BENCHMARK("list_into: all tasks") {
+        CountingSink sink;
+        repo.list_into(std::nullopt, std::nullopt, std::nullopt, std::nullopt, std::nullopt, {}, sink);
+        return sink.rows;
+    };
+    BENCHMARK("get_by_id") {
+        return repo.get_by_id(ctx.task_ids[0]);
+    };
+}
+
+TEST_CASE("UUID v4", "[bench]") {
+    BENCHMARK("TaskService::generate_uuid_v4") {
+        return TaskService::generate_uuid_v4();
+    };
+}
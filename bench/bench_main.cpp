@@ -0,0 +1,100 @@
+/**
+ * Point d'entrée de taskman_bench : options de la base (--db, --tasks, --seed) ajoutées à la
+ * ligne de commande Catch2, génération de la base puis exécution des BENCHMARK.
+ *
+ * Sans --db, une base de --tasks tâches est générée dans le répertoire temporaire à chaque
+ * exécution ; avec --db, le fichier est réutilisé s'il existe, généré sinon.
+ */
+
+#include "bench_context.hpp"
+#include "core/task/task_repository.hpp"
+#include "infrastructure/db/db.hpp"
+#include "util/demo_scale.hpp"
+#include <catch2/catch_session.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <string>
+
+namespace taskman {
+
+namespace {
+
+BenchContext context;
+
+/** Génère la base (demo:generate --scale) si besoin et remplit context. */
+bool prepare_context(std::string db_path, int tasks, uint64_t seed) {
+    namespace fs = std::filesystem;
+    bool generate = true;
+    if (db_path.empty()) {
+        db_path = (fs::temp_directory_path()
+                   / ("taskman_bench_" + std::to_string(tasks) + "_" + std::to_string(seed) + ".db")).string();
+        fs::remove(db_path);
+    } else {
+        generate = !fs::exists(db_path);
+    }
+
+    Database db;
+    if (!db.open(db_path.c_str()) || !db.init_schema()) return false;
+    if (generate) {
+        DemoScale scale;
+        scale.tasks = tasks;
+        scale.seed = seed;
+        std::cerr << "taskman_bench: generating " << db_path << "\n";
+        if (!generate_scale_demo(db, scale, std::cerr)) return false;
+    }
+
+    context.db_path = db_path;
+    auto rows = db.query("SELECT COUNT(*) AS n FROM tasks");
+    context.tasks = rows.empty() ? 0 : std::stoi(rows[0]["n"].value_or("0"));
+    for (auto& row : db.query("SELECT id FROM tasks ORDER BY id LIMIT 1000")) {
+        context.task_ids.push_back(row["id"].value_or(""));
+    }
+    if (context.task_ids.empty()) {
+        std::cerr << "taskman: " << db_path << " has no tasks\n";
+        return false;
+    }
+    TaskRepository repo(db.get_executor());
+    std::optional<TaskListKey> next;
+    auto in_progress = repo.list_page(std::nullopt, std::string("in_progress"), std::nullopt, std::nullopt,
+                                      std::nullopt, std::nullopt, 1, {}, next);
+    auto first = in_progress.empty() ? repo.get_by_id(context.task_ids[0]) : in_progress[0];
+    context.phase_id = first["phase_id"].value_or("");
+    std::cerr << "taskman_bench: " << db_path << ", " << context.tasks << " tasks\n";
+    return true;
+}
+
+} // namespace
+
+const BenchContext& bench_context() {
+    return context;
+}
+
+const std::string& bench_task_id(size_t n) {
+    return context.task_ids[n % context.task_ids.size()];
+}
+
+} // namespace taskman
+
+int main(int argc, char* argv[]) {
+    Catch::Session session;
+    std::string db_path;
+    int tasks = 10000;
+    uint64_t seed = 1;
+    using Catch::Clara::Opt;
+    session.cli(session.cli()
+                | Opt(db_path, "path")["--db"]("database to benchmark (generated if missing)")
+                | Opt(tasks, "n")["--tasks"]("tasks of the generated database (default 10000)")
+                | Opt(seed, "n")["--seed"]("seed of the generated database (default 1)"));
+    int rc = session.applyCommandLine(argc, argv);
+    if (rc != 0) return rc;
+    const auto& config = session.configData();
+    if (config.showHelp || config.listTests || config.listTags || config.listReporters) return session.run();
+    if (tasks < 1) {
+        std::cerr << "taskman: --tasks must be at least 1\n";
+        return 1;
+    }
+    if (!taskman::prepare_context(db_path, tasks, seed)) return 1;
+    return session.run();
+}
@@ -0,0 +1,81 @@
+/**
+ * Microbenchmarks — MCP : execute_tool (handlers typés) et aller-retour JSON-RPC tools/call
+ * par le dispatcher (parse, ordonnanceur, exécution, réponse sérialisée).
+ */
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include "bench_context.hpp"
+#include "mcp/mcp_dispatcher.hpp"
+#include "mcp/mcp_protocol_handler.hpp"
+#include "mcp/mcp_tool_executor.hpp"
+#include <nlohmann/json.hpp>
+#include <string>
+
+using namespace taskman;
+
+TEST_CASE("MCP — execute_tool", "[bench][mcp]") {
+    const BenchContext& ctx = bench_context();
+    McpDispatcher dispatcher(ctx.db_path);
+    auto executor = dispatcher.make_executor();
+    std::string output;
+    bool is_error = false;
+    size_t n = 0;
+
+    auto call = [&](const std::string& tool, const nlohmann::json& arguments) {
+        output.clear();
+        executor->execute_tool(tool, arguments, output, is_error);
+        return output.size();
+    };
+    REQUIRE(call("taskman_task_get", {{"id", bench_task_id(0)}}) > 0);
+    REQUIRE_FALSE(is_error);
+
+    BENCHMARK("taskman_task_get") {
+        return call("taskman_task_get", {{"id", bench_task_id(n++)}});
+    };
+    BENCHMARK("taskman_task_list limit=50") {
+        return call("taskman_task_list", {{"limit", 50}});
+    };
+    BENCHMARK("taskman_task_list phase status=to_do blocked-filter=unblocked limit=50") {
+        return call("taskman_task_list", {{"phase", ctx.phase_id}, {"status", "to_do"},
+                                          {"blocked-filter", "unblocked"}, {"limit", 50}});
+    };
+    BENCHMARK("taskman_context role limit=10") {
+        return call("taskman_context", {{"role", ctx.role}, {"limit", 10}});
+    };
+}
+
+TEST_CASE("MCP — aller-retour JSON-RPC", "[bench][mcp]") {
+    McpDispatcher dispatcher(bench_context().db_path);
+    McpProtocolHandler handler;
+    dispatcher.register_methods(handler);
+    size_t n = 0;
+
+    // Ligne reçue → réponse sérialisée, comme run_mcp_server pour un client qui attend chaque réponse
+    auto round_trip = [&](const std::string& line) {
+        nlohmann::json parsed;
+        std::string response;
+        if (handler.parse_line(line, parsed, response)) {
+            dispatcher.submit(handler, std::move(parsed), [&response](std::string reply) { response = std::move(reply); });
+            dispatcher.wait_idle();
+        }
+        return response;
+    };
+    auto tools_call = [&](const std::string& tool, const nlohmann::json& arguments) {
+        nlohmann::json message = {{"jsonrpc", "2.0"}, {"id", static_cast<int>(++n)}, {"method", "tools/call"},
+                                  {"params", {{"name", tool}, {"arguments", arguments}}}};
+        return message.dump();
+    };
+    REQUIRE(round_trip(tools_call("taskman_task_get", {{"id", bench_task_id(0)}})).find("\"isError\":false")
+            != std::string::npos);
+
+    BENCHMARK("tools/call taskman_task_get") {
+        return round_trip(tools_call("taskman_task_get", {{"id", bench_task_id(n)}})).size();
+    };
+    BENCHMARK("tools/call taskman_task_list limit=50") {
+        return round_trip(tools_call("taskman_task_list", {{"limit", 50}})).size();
+    };
+    BENCHMARK("tools/list") {
+        return round_trip(R"({"jsonrpc":"2.0","id":1,"method":"tools/list"})").size();
+    };
+}
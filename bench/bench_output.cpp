@@ -0,0 +1,63 @@
+/**
+ * Microbenchmarks — sortie : task_to_json et formatage des listes (JSON, texte, page).
+ */
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include "bench_context.hpp"
+#include "core/task/task_formatter.hpp"
+#include "core/task/task_repository.hpp"
+#include "infrastructure/db/db.hpp"
+#include "util/formats.hpp"
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <sstream>
+#include <string>
+
+using namespace taskman;
+
+TEST_CASE("Formatage des tâches", "[bench][output]") {
+    Database db;
+    REQUIRE(db.open(bench_context().db_path.c_str()));
+    TaskRepository repo(db.get_executor());
+    std::optional<TaskListKey> next;
+    const auto rows = repo.list_page(std::nullopt, std::nullopt, std::nullopt, std::nullopt, std::nullopt,
+                                     std::nullopt, 1000, {}, next);
+    REQUIRE_FALSE(rows.empty());
+    const std::vector<std::string> fields = {"id", "title", "status", "role"};
+
+    BENCHMARK("task_to_json: 1 task") {
+        nlohmann::json j;
+        task_to_json(j, rows[0]);
+        return j;
+    };
+    BENCHMARK("task_to_json: " + std::to_string(rows.size()) + " tasks") {
+        nlohmann::json arr = nlohmann::json::array();
+        for (const auto& row : rows) {
+            nlohmann::json j;
+            task_to_json(j, row);
+            arr.push_back(std::move(j));
+        }
+        return arr;
+    };
+    BENCHMARK("format_json_list: " + std::to_string(rows.size()) + " tasks") {
+        std::ostringstream out;
+        TaskFormatter::format_json_list(rows, out);
+        return out.str().size();
+    };
+    BENCHMARK("format_json_list --fields id,title,status,role") {
+        std::ostringstream out;
+        TaskFormatter::format_json_list(rows, out, fields);
+        return out.str().size();
+    };
+    BENCHMARK("format_text_list: " + std::to_string(rows.size()) + " tasks") {
+        std::ostringstream out;
+        TaskFormatter::format_text_list(rows, out);
+        return out.str().size();
+    };
+    BENCHMARK("format_json_page: " + std::to_string(rows.size()) + " tasks") {
+        std::ostringstream out;
+        TaskFormatter::format_json_page(rows, std::string("cursor"), out);
+        return out.str().size();
+    };
+}
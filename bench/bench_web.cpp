@@ -0,0 +1,91 @@
+/**
+ * Microbenchmarks — web : handlers des contrôleurs REST, servis par un httplib::Server local
+ * (127.0.0.1, port libre) et appelés par un httplib::Client à connexion persistante.
+ * Inclure httplib.h en premier (avant Windows.h sur Windows).
+ */
+#include <httplib.h>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include "bench_context.hpp"
+#include "core/milestone/milestone_repository.hpp"
+#include "core/note/note_repository.hpp"
+#include "core/phase/phase_repository.hpp"
+#include "core/task/task_repository.hpp"
+#include "core/task/task_service.hpp"
+#include "infrastructure/db/db.hpp"
+#include "web/web_controllers.hpp"
+#include <string>
+#include <thread>
+
+using namespace taskman;
+
+TEST_CASE("Web — handlers des contrôleurs", "[bench][web]") {
+    const BenchContext& ctx = bench_context();
+    Database db;
+    REQUIRE(db.open(ctx.db_path.c_str()));
+    QueryExecutor& executor = db.get_executor();
+    TaskRepository task_repo(executor);
+    TaskService task_service(task_repo);
+    PhaseRepository phase_repo(executor);
+    MilestoneRepository milestone_repo(executor);
+    NoteRepository note_repo(executor);
+    TaskController task_controller(task_repo, task_service, note_repo);
+    PhaseController phase_controller(phase_repo);
+    MilestoneController milestone_controller(milestone_repo);
+
+    httplib::Server svr;
+    task_controller.register_routes(svr);
+    phase_controller.register_routes(svr);
+    milestone_controller.register_routes(svr);
+    int port = svr.bind_to_any_port("127.0.0.1");
+    REQUIRE(port > 0);
+    std::thread server([&svr] { svr.listen_after_bind(); });
+    svr.wait_until_ready();
+
+    httplib::Client client("127.0.0.1", port);
+    client.set_keep_alive(true);
+    size_t n = 0;
+    auto get = [&client](const std::string& path) {
+        auto res = client.Get(path);
+        return res && res->status == 200 ? res->body.size() : 0;
+    };
+    const std::string phase = "phase=" + ctx.phase_id;
+    CHECK(get("/task/" + bench_task_id(0)) > 0);
+
+    BENCHMARK("GET /task/:id") {
+        return get("/task/" + bench_task_id(n++));
+    };
+    BENCHMARK("GET /task/:id/deps") {
+        return get("/task/" + bench_task_id(n++) + "/deps");
+    };
+    BENCHMARK("GET /task/:id/notes") {
+        return get("/task/" + bench_task_id(n++) + "/notes");
+    };
+    BENCHMARK("GET /tasks?limit=50") {
+        return get("/tasks?limit=50");
+    };
+    BENCHMARK("GET /tasks?limit=50&page=20") {
+        return get("/tasks?limit=50&page=20");
+    };
+    BENCHMARK("GET /tasks?phase&status=to_do&blocked_filter=unblocked") {
+        return get("/tasks?" + phase + "&status=to_do&blocked_filter=unblocked");
+    };
+    BENCHMARK("GET /tasks?role&blocked_filter=blocked") {
+        return get("/tasks?role=" + ctx.role + "&blocked_filter=blocked");
+    };
+    BENCHMARK("GET /tasks/count") {
+        return get("/tasks/count");
+    };
+    BENCHMARK("GET /tasks/count?phase&blocked_filter=blocked") {
+        return get("/tasks/count?" + phase + "&blocked_filter=blocked");
+    };
+    BENCHMARK("GET /phases") {
+        return get("/phases");
+    };
+    BENCHMARK("GET /milestones") {
+        return get("/milestones");
+    };
+
+    svr.stop();
+    server.join();
+}
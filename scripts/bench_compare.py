@@ -0,0 +1,70 @@
+#!/usr/bin/env python3
+"""
+Compare two taskman_bench runs written by the Catch2 XML reporter.
+Prints the mean of each benchmark in both runs and the relative change, and
+flags the benchmarks slower than --threshold percent. Benchmarks present in
+only one run are listed separately.
+Example:
+    ./build/taskman_bench --tasks 100000 --reporter xml::out=base.xml
+    ./build/taskman_bench --tasks 100000 --reporter xml::out=new.xml
+    python3 scripts/bench_compare.py base.xml new.xml --threshold 10
+Exit code: 1 if a benchmark regressed beyond the threshold (for CI), 0 otherwise.
+"""
+import argparse
+import sys
+import xml.etree.ElementTree as ET
+
+
+def load(path):
+    """Mean (ns) per "test case / benchmark" name, in report order."""
+    means = {}
+    for case in ET.parse(path).getroot().iter("TestCase"):
+        for result in case.iter("BenchmarkResults"):
+            mean = result.find("mean")
+            if mean is not None:
+                means[case.get("name") + " / " + result.get("name")] = float(mean.get("value"))
+    return means
+
+
+def fmt_ns(ns):
+    """Duration with a readable unit."""
+    for unit, scale in (("s", 1e9), ("ms", 1e6), ("us", 1e3)):
+        if ns >= scale:
+            return "%.2f %s" % (ns / scale, unit)
+    return "%.0f ns" % ns
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Compare two taskman_bench XML reports")
+    ap.add_argument("base", help="Reference report (e.g. previous release)")
+    ap.add_argument("new", help="Report to check")
+    ap.add_argument("--threshold", type=float, default=10.0,
+                    help="Regression threshold in percent of the mean (default 10)")
+    args = ap.parse_args()
+
+    base, new = load(args.base), load(args.new)
+    regressions = 0
+    width = max((len(name) for name in new), default=0)
+    for name, mean in new.items():
+        if name not in base:
+            continue
+        change = (mean - base[name]) / base[name] * 100.0 if base[name] > 0 else 0.0
+        flag = ""
+        if change > args.threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+        print("%-*s  %10s  %10s  %+7.1f%%%s" % (width, name, fmt_ns(base[name]), fmt_ns(mean), change, flag))
+
+    for label, names in (("only in " + args.base, [n for n in base if n not in new]),
+                         ("only in " + args.new, [n for n in new if n not in base])):
+        if names:
+            print("\n%s:" % label)
+            for name in names:
+                print("  " + name)
+
+    print("\n%d benchmark(s) slower than %.1f%%" % (regressions, args.threshold))
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+"""
+Measure per-call latency of the MCP server (taskman mcp) over stdio.
+Starts one server process, sends tools/call requests one at a time and waits
+for each response, so the numbers reflect the server-side cost of a call.
+Example:
+    python3 scripts/bench_mcp.py --exe build/taskman --db /tmp/bench.db --calls 300
+With --session, replays a recorded session (one JSON-RPC message per line, e.g.
+scripts/mcp_session.jsonl) written to the server in one go, and reports throughput:
+    python3 scripts/bench_mcp.py --exe build/taskman --db /tmp/bench.db --session scripts/mcp_session.jsonl
+The database is (re)generated with demo:generate unless --keep-db is given.
+"""
+import argparse
+import json
+import os
+import subprocess
+import sys
+import threading
+import time
+
+TOOLS = ["taskman_task_list", "taskman_phase_list", "taskman_milestone_list"]
+
+
+def percentile(values, p):
+    """Nearest-rank percentile of a sorted list."""
+    if not values:
+        return 0.0
+    k = max(0, min(len(values) - 1, int(round(p / 100.0 * len(values) + 0.5)) - 1))
+    return values[k]
+
+
+def replay_session(exe, env, path, repeat):
+    """Pipe every message of the session to one server, read all responses, time the whole run."""
+    with open(path, encoding="utf-8") as f:
+        messages = [line.strip() for line in f if line.strip()]
+    expected = sum(1 for m in messages if "id" in json.loads(m)) * repeat
+    payload = ("\n".join(messages) + "\n") * repeat
+
+    proc = subprocess.Popen([exe, "mcp"], env=env, stdin=subprocess.PIPE, stdout=subprocess.PIPE, text=True)
+
+    def feed():
+        proc.stdin.write(payload)
+        proc.stdin.close()
+
+    start = time.perf_counter()
+    writer = threading.Thread(target=feed)
+    writer.start()
+    responses = 0
+    errors = 0
+    for line in proc.stdout:
+        responses += 1
+        resp = json.loads(line)
+        if "error" in resp or resp.get("result", {}).get("isError"):
+            errors += 1
+    elapsed = time.perf_counter() - start
+    writer.join()
+    proc.wait()
+    result = {
+        "session": os.path.basename(path),
+        "messages": len(messages) * repeat,
+        "responses": responses,
+        "expected_responses": expected,
+        "errors": errors,
+        "total_ms": round(elapsed * 1000.0, 3),
+        "messages_per_s": round(len(messages) * repeat / elapsed, 1),
+    }
+    print(json.dumps(result))
+    return 0 if responses == expected else 1
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Benchmark taskman MCP per-call latency")
+    ap.add_argument("--exe", required=True, help="Path to taskman executable")
+    ap.add_argument("--db", required=True, help="Database path (TASKMAN_DB_NAME)")
+    ap.add_argument("--calls", type=int, default=300, help="Number of tools/call requests")
+    ap.add_argument("--tool", action="append", help="Tool name to call (repeatable; default: list tools)")
+    ap.add_argument("--keep-db", action="store_true", help="Do not regenerate the demo database")
+    ap.add_argument("--session", help="Replay a recorded session (JSONL) and report throughput")
+    ap.add_argument("--repeat", type=int, default=1, help="Number of times the session is replayed")
+    args = ap.parse_args()
+
+    env = dict(os.environ, TASKMAN_DB_NAME=args.db)
+    if not args.keep_db:
+        subprocess.run([args.exe, "demo:generate"], env=env, check=True, stdout=subprocess.DEVNULL)
+
+    if args.session:
+        return replay_session(args.exe, env, args.session, args.repeat)
+
+    tools = args.tool or TOOLS
+    proc = subprocess.Popen([args.exe, "mcp"], env=env, stdin=subprocess.PIPE, stdout=subprocess.PIPE,
+                            text=True, bufsize=1)
+    latencies = []
+    errors = 0
+    for i in range(args.calls):
+        req = {"jsonrpc": "2.0", "id": i, "method": "tools/call",
+               "params": {"name": tools[i % len(tools)], "arguments": {}}}
+        start = time.perf_counter()
+        proc.stdin.write(json.dumps(req) + "\n")
+        proc.stdin.flush()
+        line = proc.stdout.readline()
+        latencies.append((time.perf_counter() - start) * 1000.0)
+        if not line:
+            print("bench_mcp: server closed stdout", file=sys.stderr)
+            return 1
+        resp = json.loads(line)
+        if "error" in resp or resp.get("result", {}).get("isError"):
+            errors += 1
+    proc.stdin.close()
+    proc.wait()
+
+    latencies.sort()
+    result = {
+        "calls": len(latencies),
+        "errors": errors,
+        "mean_ms": round(sum(latencies) / len(latencies), 3),
+        "p50_ms": round(percentile(latencies, 50), 3),
+        "p95_ms": round(percentile(latencies, 95), 3),
+        "p99_ms": round(percentile(latencies, 99), 3),
+    }
+    print(json.dumps(result))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+"""
+Measure the startup latency of one-shot CLI invocations (exec to exit).
+Runs each command --runs times against the same database and reports the
+median and p95 wall time, next to the cost of spawning a trivial process
+(baseline), so the numbers show what taskman itself adds.
+Example:
+    python3 scripts/bench_startup.py --exe build/taskman --db /tmp/startup.db --runs 200
+    python3 scripts/bench_startup.py --exe build/taskman --db /tmp/startup.db --command "task:list --limit 5"
+Default commands: --version, task:get <id>, task:get with an invalid option,
+task:list --limit 5. "{id}" in a --command is replaced by a task id of the database.
+The database is (re)generated with demo:generate unless --keep-db is given.
+"""
+import argparse
+import json
+import os
+import shlex
+import subprocess
+import sys
+import time
+
+COMMANDS = ["--version", "task:get {id}", "task:get {id} --no-such-option", "task:list --limit 5"]
+
+
+def percentile(values, p):
+    """Nearest-rank percentile of a sorted list."""
+    if not values:
+        return 0.0
+    k = max(0, min(len(values) - 1, int(round(p / 100.0 * len(values) + 0.5)) - 1))
+    return values[k]
+
+
+def time_runs(argv, env, runs, warmup):
+    """Wall time in ms of each run of argv (output discarded), after warmup runs."""
+    for _ in range(warmup):
+        subprocess.run(argv, env=env, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    times = []
+    for _ in range(runs):
+        start = time.perf_counter()
+        subprocess.run(argv, env=env, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+        times.append((time.perf_counter() - start) * 1000.0)
+    times.sort()
+    return times
+
+
+def summary(name, times):
+    return {
+        "command": name,
+        "runs": len(times),
+        "median_ms": round(percentile(times, 50), 3),
+        "p95_ms": round(percentile(times, 95), 3),
+        "min_ms": round(times[0], 3),
+    }
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Benchmark taskman CLI startup latency")
+    ap.add_argument("--exe", required=True, help="Path to taskman executable")
+    ap.add_argument("--db", required=True, help="Database path (TASKMAN_DB_NAME)")
+    ap.add_argument("--runs", type=int, default=100, help="Timed runs per command")
+    ap.add_argument("--warmup", type=int, default=5, help="Untimed runs per command (page cache)")
+    ap.add_argument("--command", action="append", help="Command line to time (repeatable; default: see above)")
+    ap.add_argument("--keep-db", action="store_true", help="Do not regenerate the demo database")
+    args = ap.parse_args()
+
+    env = dict(os.environ, TASKMAN_DB_NAME=args.db)
+    if not args.keep_db:
+        subprocess.run([args.exe, "demo:generate"], env=env, check=True, stdout=subprocess.DEVNULL)
+    listed = subprocess.run([args.exe, "task:list", "--limit", "1"], env=env, check=True,
+                            stdout=subprocess.PIPE, text=True)
+    tasks = json.loads(listed.stdout).get("tasks", [])
+    if not tasks:
+        print("bench_startup: no task in " + args.db, file=sys.stderr)
+        return 1
+    task_id = tasks[0]["id"]
+
+    baseline = [sys.executable, "-c", "pass"] if os.name == "nt" else ["true"]
+    results = [summary("(baseline) " + " ".join(baseline), time_runs(baseline, env, args.runs, args.warmup))]
+    for command in args.command or COMMANDS:
+        command = command.replace("{id}", task_id)
+        argv = [args.exe] + shlex.split(command)
+        results.append(summary(command, time_runs(argv, env, args.runs, args.warmup)))
+    for r in results:
+        print(json.dumps(r))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
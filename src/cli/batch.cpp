@@ -0,0 +1,223 @@
+/**
+ * Implémentation de la commande batch.
+ */
+
+#include "batch.hpp"
+#include "command.hpp"
+#include "infrastructure/db/db.hpp"
+#include "infrastructure/db/transaction.hpp"
+#include "util/output_capture.hpp"
+#include <nlohmann/json.hpp>
+#include <cxxopts.hpp>
+#include <cstring>
+#include <iostream>
+#include <optional>
+
+namespace taskman {
+
+namespace {
+
+/** Commandes refusées dans un batch : elles lisent stdin ou ne rendent pas la main. */
+bool is_excluded(const std::string& name) {
+    return name == "batch" || name == "mcp" || name == "web";
+}
+
+/** Sans les blancs finaux. */
+std::string trim_right(const std::string& s) {
+    size_t end = s.find_last_not_of(" \t\r\n");
+    return end == std::string::npos ? std::string() : s.substr(0, end + 1);
+}
+
+/** Ligne de résultat : la sortie JSON est insérée telle quelle (compactée si sur plusieurs lignes). */
+std::string result_line(size_t line, const std::string& command, int exit_code,
+                        const std::string& out, const std::string& err) {
+    std::string s = "{\"line\":" + std::to_string(line) + ",\"command\":" + nlohmann::json(command).dump()
+                  + ",\"exit_code\":" + std::to_string(exit_code);
+    std::string body = trim_right(out);
+    if (!body.empty()) {
+        s += ",\"result\":";
+        if (!nlohmann::json::accept(body)) {
+            s += nlohmann::json(body).dump();
+        } else if (body.find('\n') != std::string::npos) {
+            s += nlohmann::json::parse(body).dump();
+        } else {
+            s += body;
+        }
+    }
+    std::string error = trim_right(err);
+    if (!error.empty()) {
+        s += ",\"error\":" + nlohmann::json(error).dump();
+    }
+    s += "}";
+    return s;
+}
+
+} // namespace
+
+bool parse_batch_line(const std::string& line, std::vector<std::string>& args, std::string& error) {
+    args.clear();
+    size_t start = line.find_first_not_of(" \t\r");
+    if (start == std::string::npos || line[start] == '#') return true;
+
+    if (line[start] == '[') {
+        nlohmann::json array = nlohmann::json::parse(line, nullptr, false);
+        if (!array.is_array()) {
+            error = "invalid JSON array";
+            return false;
+        }
+        for (const auto& item : array) {
+            if (!item.is_string()) {
+                error = "JSON array must contain only strings";
+                return false;
+            }
+            args.push_back(item.get<std::string>());
+        }
+    } else {
+        std::string current;
+        bool in_token = false;
+        char quote = 0;
+        for (size_t i = start; i < line.size(); ++i) {
+            char c = line[i];
+            if (quote == '\'') {
+                if (c == '\'') quote = 0;
+                else current += c;
+            } else if (quote == '"') {
+                if (c == '"') {
+                    quote = 0;
+                } else if (c == '\\' && i + 1 < line.size() && (line[i + 1] == '"' || line[i + 1] == '\\')) {
+                    current += line[++i];
+                } else {
+                    current += c;
+                }
+            } else if (c == ' ' || c == '\t' || c == '\r') {
+                if (in_token) {
+                    args.push_back(current);
+                    current.clear();
+                    in_token = false;
+                }
+            } else {
+                in_token = true;
+                if (c == '\'' || c == '"') {
+                    quote = c;
+                } else if (c == '\\' && i + 1 < line.size()) {
+                    current += line[++i];
+                } else {
+                    current += c;
+                }
+            }
+        }
+        if (quote) {
+            error = "unterminated quote";
+            return false;
+        }
+        if (in_token) args.push_back(current);
+    }
+    if (!args.empty() && args[0] == "taskman") args.erase(args.begin());
+    if (args.empty()) {
+        error = "missing command";
+        return false;
+    }
+    return true;
+}
+
+int cmd_batch(int argc, char* argv[], Database& db) {
+    cxxopts::Options opts("taskman batch", "Run commands read from stdin (one per line) in one process");
+    opts.add_options()
+        ("transaction", "Run all commands in one transaction: all or nothing, stop at the first failure")
+        ("stop-on-error", "Stop at the first failure (previous commands stay applied)")
+        ("help", "Show help");
+
+    for (int i = 0; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0) {
+            std::cout << opts.help() << '\n';
+            std::cout << "\nEach line is a command without the leading \"taskman\" (shell-style quoting),\n"
+                      << "or a JSON array of arguments. Empty lines and lines starting with # are skipped.\n"
+                      << "One JSON line per command: {\"line\",\"command\",\"exit_code\",\"result\",\"error\"}.\n"
+                      << "\nExample:\n"
+                      << "  printf '%s\\n' 'task:edit 1 --status done' '[\"task:note:add\",\"1\",\"--content\",\"Shipped\"]' \\\n"
+                      << "    | taskman batch --transaction\n";
+            return 0;
+        }
+    }
+
+    cxxopts::ParseResult result;
+    try {
+        result = opts.parse(argc, argv);
+    } catch (const cxxopts::exceptions::exception& e) {
+        std::cerr << "taskman: " << e.what() << "\n";
+        return 1;
+    }
+    const bool transaction = result.count("transaction") > 0;
+    const bool stop_on_error = transaction || result.count("stop-on-error") > 0;
+
+    CommandRegistry registry;
+    register_all_commands(registry);
+
+    std::optional<Transaction> tx;
+    if (transaction) {
+        tx.emplace(db.get_executor());
+        if (!tx->active()) return 1;
+    }
+
+    int status = 0;
+    size_t line_no = 0;
+    std::string line;
+    std::vector<std::string> args;
+    while (std::getline(std::cin, line)) {
+        ++line_no;
+        std::string error;
+        if (!parse_batch_line(line, args, error)) {
+            std::cout << result_line(line_no, "", 1, "", "taskman: " + error) << "\n";
+            status = 1;
+            if (stop_on_error) break;
+            continue;
+        }
+        if (args.empty()) continue;
+
+        const std::string& name = args[0];
+        if (!registry.has_command(name) || is_excluded(name) || (transaction && name == "demo:generate")) {
+            std::string reason = registry.has_command(name) ? "not allowed in batch: " : "unknown command: ";
+            std::cout << result_line(line_no, name, 1, "", "taskman: " + reason + name) << "\n";
+            status = 1;
+            if (stop_on_error) break;
+            continue;
+        }
+
+        std::vector<char*> argv_ptrs;
+        for (auto& a : args) argv_ptrs.push_back(a.data());
+        argv_ptrs.push_back(nullptr);
+        Database* db_ptr = registry.command_requires_database(name) ? &db : nullptr;
+
+        int exit_code = 0;
+        std::string out, err;
+        {
+            OutputCapture capture;
+            try {
+                exit_code = registry.execute(name, static_cast<int>(args.size()), argv_ptrs.data(), db_ptr);
+            } catch (const std::exception& e) {
+                std::cerr << "taskman: " << e.what() << "\n";
+                exit_code = 1;
+            }
+            out = capture.out();
+            err = capture.err();
+        }
+        std::cout << result_line(line_no, name, exit_code, out, err) << "\n";
+        if (exit_code != 0) {
+            status = 1;
+            if (stop_on_error) break;
+        }
+    }
+
+    if (tx) {
+        if (status != 0) {
+            tx->rollback();
+            std::cerr << "taskman: batch stopped at line " << line_no << ", changes rolled back\n";
+        } else if (!tx->commit()) {
+            return 1;
+        }
+    }
+    std::cout.flush();
+    return status;
+}
+
+} // namespace taskman
@@ -0,0 +1,38 @@
+/**
+ * Commande batch — plusieurs commandes CLI dans un seul processus.
+ * Responsabilité unique : lire les commandes sur stdin, les exécuter via CommandRegistry sur
+ * la même connexion (éventuellement dans une seule transaction) et écrire un résultat par ligne.
+ */
+
+#ifndef TASKMAN_BATCH_HPP
+#define TASKMAN_BATCH_HPP
+
+#include <string>
+#include <vector>
+
+namespace taskman {
+
+class Database;
+
+/**
+ * Découpe une ligne de batch en arguments (args[0] = nom de la commande).
+ * Ligne commençant par '[' : tableau JSON de chaînes. Sinon découpage façon shell : blancs
+ * séparateurs, '…' littéral, "…" avec \" et \\, \ hors guillemets. Un "taskman" initial est
+ * ignoré (lignes copiées d'un script). Ligne vide ou commentaire (#) : args vide, retour true.
+ * En échec : message dans error, retour false.
+ */
+bool parse_batch_line(const std::string& line, std::vector<std::string>& args, std::string& error);
+
+/** batch [--transaction] [--stop-on-error]
+ *  Lit une commande par ligne sur stdin et l'exécute sur db ; pour chacune écrit sur stdout
+ *  {"line":N,"command":"…","exit_code":C,"result":<sortie>} (+ "error" : texte de stderr).
+ *  result est la sortie JSON telle quelle, ou une chaîne (sortie texte) ; absent si vide.
+ *  --transaction : tout ou rien, arrêt au premier échec (écritures annulées).
+ *  --stop-on-error : arrêt au premier échec (écritures précédentes conservées).
+ *  Retourne 0 si toutes les commandes ont réussi, 1 sinon.
+ */
+int cmd_batch(int argc, char* argv[], Database& db);
+
+} // namespace taskman
+
+#endif /* TASKMAN_BATCH_HPP */
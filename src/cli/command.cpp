@@ -3,6 +3,7 @@
  */
 
 #include "command.hpp"
+#include "conditional_read.hpp"
 #include <stdexcept>
 
 namespace taskman {
@@ -14,7 +15,24 @@ void CommandRegistry::register_command(std::unique_ptr<Command> cmd) {
         throw std::invalid_argument("Cannot register null command");
     }
     std::string name = cmd->name();
-    commands_[name] = std::move(cmd);
+    commands_.erase(name);
+    Entry& entry = commands_[name];
+    entry.command = std::move(cmd);
+}
+
+void CommandRegistry::register_command(const std::string& name, CommandFactory factory) {
+    if (!factory) {
+        throw std::invalid_argument("Cannot register null command factory");
+    }
+    commands_.erase(name);
+    commands_[name].factory = factory;
+}
+
+Command& CommandRegistry::command_of(const Entry& entry) {
+    if (entry.factory) {
+        std::call_once(entry.built, [&entry] { entry.command = entry.factory(); });
+    }
+    return *entry.command;
 }
 
 int CommandRegistry::execute(const std::string& name, int argc, char* argv[], Database* db) const {
@@ -22,13 +40,17 @@ int CommandRegistry::execute(const std::string& name, int argc, char* argv[], Da
     if (it == commands_.end()) {
         return -1; // Commande non trouvée
     }
-    return it->second->execute(argc, argv, db);
+    Command& cmd = command_of(it->second);
+    if (db && cmd.read_only()) {
+        return execute_read(cmd, argc, argv, *db);
+    }
+    return cmd.execute(argc, argv, db);
 }
 
 std::map<std::string, std::string> CommandRegistry::list_commands() const {
     std::map<std::string, std::string> result;
-    for (const auto& [name, cmd] : commands_) {
-        result[name] = cmd->summary();
+    for (const auto& [name, entry] : commands_) {
+        result[name] = command_of(entry).summary();
     }
     return result;
 }
@@ -42,7 +64,7 @@ bool CommandRegistry::command_requires_database(const std::string& name) const {
     if (it == commands_.end()) {
         return false; // Commande inexistante, par défaut pas de DB nécessaire
     }
-    return it->second->requires_database();
+    return command_of(it->second).requires_database();
 }
 
 } // namespace taskman
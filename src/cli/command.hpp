@@ -7,6 +7,7 @@
 #define TASKMAN_COMMAND_HPP
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <map>
 
@@ -46,12 +47,29 @@ public:
      * Si false, db peut être nullptr dans execute().
      */
     virtual bool requires_database() const { return true; }
+
+    /**
+     * Indique si la commande ne fait que lire la base.
+     * Si true, elle accepte --if-none-match <jeton> (voir conditional_read.hpp).
+     */
+    virtual bool read_only() const { return false; }
 };
 
+/** Fabrique d'une commande (voir CommandRegistry::register_command(name, factory)). */
+using CommandFactory = std::unique_ptr<Command> (*)();
+
+/** Fabrique par défaut : construit une commande de type T. */
+template <typename T>
+std::unique_ptr<Command> make_command() {
+    return std::make_unique<T>();
+}
+
 /**
  * Registre de commandes.
  * Permet d'enregistrer et d'exécuter des commandes par nom.
  * Respecte le principe Open/Closed : nouvelles commandes s'enregistrent sans modifier le code existant.
+ * Construction paresseuse : une commande enregistrée par fabrique n'est construite qu'au premier
+ * usage (un appel CLI n'en construit qu'une ; list_commands() les construit toutes).
  */
 class CommandRegistry {
 public:
@@ -64,8 +82,16 @@ public:
      */
     void register_command(std::unique_ptr<Command> cmd);
 
+    /**
+     * Enregistre une commande construite au premier usage.
+     * @param name Nom de la commande (doit être celui que retourne Command::name())
+     * @param factory Fabrique de la commande (ex. make_command<TaskGetCommand>)
+     */
+    void register_command(const std::string& name, CommandFactory factory);
+
     /**
      * Exécute une commande par son nom.
+     * Pour une commande read_only(), --if-none-match est retiré de argv et traité ici.
      * @param name Nom de la commande
      * @param argc Nombre d'arguments
      * @param argv Tableau d'arguments
@@ -91,7 +117,18 @@ public:
     bool command_requires_database(const std::string& name) const;
 
 private:
-    std::map<std::string, std::unique_ptr<Command>> commands_;
+    /** Commande enregistrée : construite une seule fois, même depuis plusieurs threads (MCP).
+     *  factory nul : commande déjà construite (register_command(unique_ptr)). */
+    struct Entry {
+        CommandFactory factory = nullptr;
+        mutable std::once_flag built;
+        mutable std::unique_ptr<Command> command;
+    };
+
+    /** Commande de l'entrée, construite au premier appel. */
+    static Command& command_of(const Entry& entry);
+
+    std::map<std::string, Entry> commands_;
 };
 
 /**
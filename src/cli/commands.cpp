@@ -4,11 +4,13 @@
  */
 
 #include "command.hpp"
+#include "batch.hpp"
 #include "infrastructure/db/db.hpp"
 #include "core/task/task.hpp"
 #include "core/phase/phase.hpp"
 #include "core/milestone/milestone.hpp"
 #include "core/note/note.hpp"
+#include "core/context/context.hpp"
 #include "util/demo.hpp"
 #include "util/agents.hpp"
 #include "util/executable_path.hpp"
@@ -16,6 +18,7 @@
 #include "mcp/mcp_config.hpp"
 #include "web/web.hpp"
 #include "mcp/mcp.hpp"
+#include "mcp/mcp_bench.hpp"
 #include <iostream>
 #include <cstring>
 #include <string>
@@ -35,12 +38,24 @@ public:
     int execute(int argc, char* argv[], Database* db) override {
         if (!db) return 1;
         if (argc >= 2 && (std::strcmp(argv[1], "--help") == 0 || std::strcmp(argv[1], "-h") == 0)) {
-            std::cout << "taskman init\n\n"
+            std::cout << "taskman init [--compact-enums]\n\n"
                          "Create and initialize the database tables (phases, milestones, tasks, task_deps).\n"
-                         "Run once when starting a new project.\n\n";
+                         "Run once when starting a new project.\n\n"
+                         "  --compact-enums  Store status, role and creator as integer codes (one-way migration;\n"
+                         "                   command output is unchanged). Run VACUUM afterwards to reclaim space.\n\n";
             return 0;
         }
+        bool compact = false;
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--compact-enums") == 0) {
+                compact = true;
+            } else {
+                std::cerr << "taskman: unknown option: " << argv[i] << "\n";
+                return 1;
+            }
+        }
         if (!db->init_schema()) return 1;
+        if (compact && !db->compact_enums()) return 1;
         return 0;
     }
 };
@@ -71,6 +86,7 @@ class PhaseListCommand : public Command {
 public:
     std::string name() const override { return "phase:list"; }
     std::string summary() const override { return "List phases"; }
+    bool read_only() const override { return true; }
     
     int execute(int argc, char* argv[], Database* db) override {
         if (!db) return 1;
@@ -104,6 +120,7 @@ class MilestoneListCommand : public Command {
 public:
     std::string name() const override { return "milestone:list"; }
     std::string summary() const override { return "List milestones (option --phase)"; }
+    bool read_only() const override { return true; }
     
     int execute(int argc, char* argv[], Database* db) override {
         if (!db) return 1;
@@ -137,6 +154,7 @@ class TaskGetCommand : public Command {
 public:
     std::string name() const override { return "task:get"; }
     std::string summary() const override { return "Get a task"; }
+    bool read_only() const override { return true; }
     
     int execute(int argc, char* argv[], Database* db) override {
         if (!db) return 1;
@@ -148,6 +166,7 @@ class TaskListCommand : public Command {
 public:
     std::string name() const override { return "task:list"; }
     std::string summary() const override { return "List tasks (option --phase, --status, --role)"; }
+    bool read_only() const override { return true; }
     
     int execute(int argc, char* argv[], Database* db) override {
         if (!db) return 1;
@@ -155,6 +174,17 @@ public:
     }
 };
 
+class TaskWaitCommand : public Command {
+public:
+    std::string name() const override { return "task:wait"; }
+    std::string summary() const override { return "Wait until a task is ready (option --role, --timeout)"; }
+    
+    int execute(int argc, char* argv[], Database* db) override {
+        if (!db) return 1;
+        return cmd_task_wait(argc, argv, *db);
+    }
+};
+
 class TaskDepAddCommand : public Command {
 public:
     std::string name() const override { return "task:dep:add"; }
@@ -177,6 +207,39 @@ public:
     }
 };
 
+class TaskDepBatchCommand : public Command {
+public:
+    std::string name() const override { return "task:dep:batch"; }
+    std::string summary() const override { return "Add/remove several dependencies at once"; }
+    
+    int execute(int argc, char* argv[], Database* db) override {
+        if (!db) return 1;
+        return cmd_task_dep_batch(argc, argv, *db);
+    }
+};
+
+class TaskBulkAddCommand : public Command {
+public:
+    std::string name() const override { return "task:bulk-add"; }
+    std::string summary() const override { return "Create several tasks and their dependencies at once"; }
+    
+    int execute(int argc, char* argv[], Database* db) override {
+        if (!db) return 1;
+        return cmd_task_bulk_add(argc, argv, *db);
+    }
+};
+
+class TaskBulkEditCommand : public Command {
+public:
+    std::string name() const override { return "task:bulk-edit"; }
+    std::string summary() const override { return "Edit several tasks at once"; }
+    
+    int execute(int argc, char* argv[], Database* db) override {
+        if (!db) return 1;
+        return cmd_task_bulk_edit(argc, argv, *db);
+    }
+};
+
 class TaskNoteAddCommand : public Command {
 public:
     std::string name() const override { return "task:note:add"; }
@@ -192,6 +255,7 @@ class TaskNoteListCommand : public Command {
 public:
     std::string name() const override { return "task:note:list"; }
     std::string summary() const override { return "List notes for a task"; }
+    bool read_only() const override { return true; }
     
     int execute(int argc, char* argv[], Database* db) override {
         if (!db) return 1;
@@ -203,6 +267,7 @@ class TaskNoteListByIdsCommand : public Command {
 public:
     std::string name() const override { return "task:note:list-by-ids"; }
     std::string summary() const override { return "List notes by comma-separated IDs"; }
+    bool read_only() const override { return true; }
     
     int execute(int argc, char* argv[], Database* db) override {
         if (!db) return 1;
@@ -210,6 +275,29 @@ public:
     }
 };
 
+class ContextCommand : public Command {
+public:
+    std::string name() const override { return "context"; }
+    std::string summary() const override { return "Project context for an agent (phases, ready/in-progress/blocked tasks)"; }
+    bool read_only() const override { return true; }
+    
+    int execute(int argc, char* argv[], Database* db) override {
+        if (!db) return 1;
+        return cmd_context(argc, argv, *db);
+    }
+};
+
+class BatchCommand : public Command {
+public:
+    std::string name() const override { return "batch"; }
+    std::string summary() const override { return "Run commands from stdin in one process (--transaction)"; }
+    
+    int execute(int argc, char* argv[], Database* db) override {
+        if (!db) return 1;
+        return cmd_batch(argc, argv, *db);
+    }
+};
+
 class DemoGenerateCommand : public Command {
 public:
     std::string name() const override { return "demo:generate"; }
@@ -355,34 +443,54 @@ public:
     }
 };
 
+class BenchMcpCommand : public Command {
+public:
+    std::string name() const override { return "bench:mcp"; }
+    std::string summary() const override { return "Replay a recorded MCP session in-process (--replay, --db)"; }
+    bool requires_database() const override { return false; }
+    
+    int execute(int argc, char* argv[], Database* db) override {
+        (void)db; // --db : base propre au rejeu
+        return cmd_bench_mcp(argc, argv);
+    }
+};
+
 // ============================================================================
 // Fonction utilitaire pour initialiser le registre avec toutes les commandes
 // ============================================================================
 
 void register_all_commands(CommandRegistry& registry) {
-    registry.register_command(std::make_unique<InitCommand>());
-    registry.register_command(std::make_unique<PhaseAddCommand>());
-    registry.register_command(std::make_unique<PhaseEditCommand>());
-    registry.register_command(std::make_unique<PhaseListCommand>());
-    registry.register_command(std::make_unique<MilestoneAddCommand>());
-    registry.register_command(std::make_unique<MilestoneEditCommand>());
-    registry.register_command(std::make_unique<MilestoneListCommand>());
-    registry.register_command(std::make_unique<TaskAddCommand>());
-    registry.register_command(std::make_unique<TaskEditCommand>());
-    registry.register_command(std::make_unique<TaskGetCommand>());
-    registry.register_command(std::make_unique<TaskListCommand>());
-    registry.register_command(std::make_unique<TaskDepAddCommand>());
-    registry.register_command(std::make_unique<TaskDepRemoveCommand>());
-    registry.register_command(std::make_unique<TaskNoteAddCommand>());
-    registry.register_command(std::make_unique<TaskNoteListCommand>());
-    registry.register_command(std::make_unique<TaskNoteListByIdsCommand>());
-    registry.register_command(std::make_unique<DemoGenerateCommand>());
-    registry.register_command(std::make_unique<ProjectInitCommand>());
-    registry.register_command(std::make_unique<AgentsGenerateCommand>());
-    registry.register_command(std::make_unique<RulesGenerateCommand>());
-    registry.register_command(std::make_unique<McpConfigCommand>());
-    registry.register_command(std::make_unique<McpCommand>());
-    registry.register_command(std::make_unique<WebCommand>());
+    // Par fabrique : seule la commande invoquée est construite
+    registry.register_command("init", make_command<InitCommand>);
+    registry.register_command("phase:add", make_command<PhaseAddCommand>);
+    registry.register_command("phase:edit", make_command<PhaseEditCommand>);
+    registry.register_command("phase:list", make_command<PhaseListCommand>);
+    registry.register_command("milestone:add", make_command<MilestoneAddCommand>);
+    registry.register_command("milestone:edit", make_command<MilestoneEditCommand>);
+    registry.register_command("milestone:list", make_command<MilestoneListCommand>);
+    registry.register_command("task:add", make_command<TaskAddCommand>);
+    registry.register_command("task:edit", make_command<TaskEditCommand>);
+    registry.register_command("task:get", make_command<TaskGetCommand>);
+    registry.register_command("task:list", make_command<TaskListCommand>);
+    registry.register_command("task:wait", make_command<TaskWaitCommand>);
+    registry.register_command("task:dep:add", make_command<TaskDepAddCommand>);
+    registry.register_command("task:dep:remove", make_command<TaskDepRemoveCommand>);
+    registry.register_command("task:dep:batch", make_command<TaskDepBatchCommand>);
+    registry.register_command("task:bulk-add", make_command<TaskBulkAddCommand>);
+    registry.register_command("task:bulk-edit", make_command<TaskBulkEditCommand>);
+    registry.register_command("task:note:add", make_command<TaskNoteAddCommand>);
+    registry.register_command("task:note:list", make_command<TaskNoteListCommand>);
+    registry.register_command("task:note:list-by-ids", make_command<TaskNoteListByIdsCommand>);
+    registry.register_command("context", make_command<ContextCommand>);
+    registry.register_command("batch", make_command<BatchCommand>);
+    registry.register_command("demo:generate", make_command<DemoGenerateCommand>);
+    registry.register_command("project:init", make_command<ProjectInitCommand>);
+    registry.register_command("agents:generate", make_command<AgentsGenerateCommand>);
+    registry.register_command("rules:generate", make_command<RulesGenerateCommand>);
+    registry.register_command("mcp:config", make_command<McpConfigCommand>);
+    registry.register_command("mcp", make_command<McpCommand>);
+    registry.register_command("bench:mcp", make_command<BenchMcpCommand>);
+    registry.register_command("web", make_command<WebCommand>);
 }
 
 } // namespace taskman
@@ -0,0 +1,103 @@
+/**
+ * Implémentation des lectures conditionnelles.
+ */
+
+#include "conditional_read.hpp"
+#include "command.hpp"
+#include "infrastructure/db/data_version.hpp"
+#include "infrastructure/db/db.hpp"
+#include "util/output_capture.hpp"
+#include <nlohmann/json.hpp>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <vector>
+
+namespace taskman {
+
+namespace {
+
+/** Sortie non JSON demandée (--format text|ndjson ou --format=text|ndjson) : à envelopper comme chaîne. */
+bool is_string_format(const std::vector<char*>& args) {
+    auto is_string = [](const char* format) {
+        return std::strcmp(format, "text") == 0 || std::strcmp(format, "ndjson") == 0;
+    };
+    for (size_t i = 1; i < args.size() && args[i]; ++i) {
+        if (std::strncmp(args[i], "--format=", 9) == 0 && is_string(args[i] + 9)) return true;
+        if (std::strcmp(args[i], "--format") == 0 && i + 1 < args.size() && args[i + 1]
+            && is_string(args[i + 1])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+std::string unchanged_response(const std::string& version) {
+    return "{\"unchanged\":true,\"version\":" + nlohmann::json(version).dump() + "}";
+}
+
+std::string changed_response(const std::string& version, const std::string& body, bool body_is_json) {
+    std::string out = "{\"unchanged\":false,\"version\":" + nlohmann::json(version).dump() + ",\"result\":";
+    if (body_is_json) {
+        size_t end = body.find_last_not_of(" \t\r\n");
+        out.append(body, 0, end == std::string::npos ? 0 : end + 1);
+    } else {
+        out += nlohmann::json(body).dump();
+    }
+    out += "}";
+    return out;
+}
+
+int execute_read(Command& command, int argc, char* argv[], Database& db) {
+    // argv[0] = nom de la commande ; --if-none-match <jeton> ou --if-none-match=<jeton>
+    const std::string option = std::string("--") + IF_NONE_MATCH_KEY;
+    std::optional<std::string> expected;
+    std::vector<char*> args;
+    for (int i = 0; i < argc; ++i) {
+        if (i > 0 && option == argv[i]) {
+            if (i + 1 >= argc) {
+                std::cerr << "taskman: " << option << " requires a value\n";
+                return 1;
+            }
+            expected = argv[++i];
+            continue;
+        }
+        if (i > 0 && std::strncmp(argv[i], (option + "=").c_str(), option.size() + 1) == 0) {
+            expected = argv[i] + option.size() + 1;
+            continue;
+        }
+        args.push_back(argv[i]);
+    }
+    if (!expected) {
+        return command.execute(argc, argv, &db);
+    }
+
+    DataVersion data_version(db.get_executor());
+    std::optional<std::string> token = data_version.token();
+    if (!token) {
+        std::cerr << DATA_VERSION_MISSING_MESSAGE;
+        return 1;
+    }
+    if (*token == *expected) {
+        std::cout << unchanged_response(*token) << "\n";
+        return 0;
+    }
+    std::string body;
+    int result = 0;
+    args.push_back(nullptr);
+    {
+        OutputCapture capture(OutputCapture::Streams::Out);  // erreurs de la commande sur stderr
+        result = command.execute(static_cast<int>(args.size() - 1), args.data(), &db);
+        body = capture.out();
+    }
+    if (result != 0) {
+        std::cout << body;
+        return result;
+    }
+    std::cout << changed_response(*token, body, !is_string_format(args)) << "\n";
+    return 0;
+}
+
+} // namespace taskman
@@ -0,0 +1,43 @@
+/**
+ * Lectures conditionnelles — option --if-none-match des commandes et outils en lecture seule.
+ * Responsabilité unique : comparer le jeton fourni à DataVersion et envelopper la réponse :
+ *   inchangé : {"unchanged":true,"version":"<jeton>"}
+ *   modifié  : {"unchanged":false,"version":"<jeton>","result":<sortie habituelle>}
+ * Partagé par CommandRegistry (CLI) et McpToolExecutor (MCP).
+ */
+
+#ifndef TASKMAN_CONDITIONAL_READ_HPP
+#define TASKMAN_CONDITIONAL_READ_HPP
+
+#include <string>
+
+namespace taskman {
+
+class Command;
+class Database;
+
+/** Nom de l'option (CLI : --if-none-match, MCP : clé d'arguments). */
+constexpr const char* IF_NONE_MATCH_KEY = "if-none-match";
+
+/** Message d'erreur quand la base n'a pas de compteur data_version. */
+constexpr const char* DATA_VERSION_MISSING_MESSAGE =
+    "taskman: --if-none-match needs the change counter of the database: run taskman init\n";
+
+/** Réponse « inchangé » (sans retour à la ligne final). */
+std::string unchanged_response(const std::string& version);
+
+/** Réponse « modifié » : body est inséré tel quel si body_is_json (blancs finaux retirés),
+ * sinon comme chaîne JSON (sortie --format text ou ndjson). Sans retour à la ligne final. */
+std::string changed_response(const std::string& version, const std::string& body, bool body_is_json);
+
+/**
+ * Exécute une commande read_only. Sans --if-none-match dans argv : exécution directe.
+ * Sinon l'option est retirée de argv, le jeton courant est lu avant les données ; s'il est égal
+ * au jeton fourni, seule la réponse « inchangé » est écrite, sinon la sortie de la commande
+ * est capturée puis enveloppée. Retourne le code de sortie de la commande (1 si jeton illisible).
+ */
+int execute_read(Command& command, int argc, char* argv[], Database& db);
+
+} // namespace taskman
+
+#endif /* TASKMAN_CONDITIONAL_READ_HPP */
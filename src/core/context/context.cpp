@@ -0,0 +1,25 @@
+/**
+ * Implémentation de la commande context.
+ *
+ * Même découpage que les autres modules :
+ * - ContextService : lecture (dépôts tâches, phases, jalons, notes) dans une transaction
+ * - ContextFormatter : formatage sortie
+ * - ContextCommandParser : parsing CLI
+ */
+
+#include "context.hpp"
+#include "context_command_parser.hpp"
+#include "context_formatter.hpp"
+#include "context_service.hpp"
+#include "infrastructure/db/db.hpp"
+
+namespace taskman {
+
+int cmd_context(int argc, char* argv[], Database& db) {
+    ContextService service(db.get_executor());
+    ContextFormatter formatter;
+    ContextCommandParser parser(service, formatter);
+    return parser.parse(argc, argv);
+}
+
+} // namespace taskman
@@ -0,0 +1,18 @@
+/**
+ * Commande context : contexte de démarrage d'un agent en un seul appel.
+ */
+
+#ifndef TASKMAN_CONTEXT_HPP
+#define TASKMAN_CONTEXT_HPP
+
+namespace taskman {
+
+class Database;
+
+/** context [--role <role>] [--limit <n>] [--format json|text] → phases/jalons avec avancement,
+ * tâches prêtes, en cours (dernière note) et bloquées du rôle, lus dans un seul snapshot. */
+int cmd_context(int argc, char* argv[], Database& db);
+
+} // namespace taskman
+
+#endif /* TASKMAN_CONTEXT_HPP */
@@ -0,0 +1,68 @@
+/**
+ * Implémentation de ContextCommandParser.
+ */
+
+#include "context_command_parser.hpp"
+#include <cxxopts.hpp>
+#include <cstring>
+#include <iostream>
+
+namespace taskman {
+
+bool ContextCommandParser::parse_int(const std::string& s, int& out) {
+    try {
+        size_t pos = 0;
+        out = std::stoi(s, &pos);
+        return pos == s.size();
+    } catch (...) {
+        return false;
+    }
+}
+
+int ContextCommandParser::parse(int argc, char* argv[]) {
+    cxxopts::Options opts("taskman context", "Project context for an agent: phases, ready, in-progress and blocked tasks");
+    opts.add_options()
+        ("role", "Role whose tasks are listed (default: all roles)", cxxopts::value<std::string>())
+        ("limit", "Maximum tasks per section (1-100)", cxxopts::value<std::string>())
+        ("format", "Output: json or text", cxxopts::value<std::string>()->default_value("json"));
+
+    for (int i = 0; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0) {
+            std::cout << opts.help() << '\n';
+            return 0;
+        }
+    }
+    cxxopts::ParseResult result;
+    try {
+        result = opts.parse(argc, argv);
+    } catch (const cxxopts::exceptions::exception& e) {
+        std::cerr << "taskman: " << e.what() << "\n";
+        return 1;
+    }
+
+    std::string format = result["format"].as<std::string>();
+    if (!ContextFormatter::is_valid_format(format)) {
+        std::cerr << "taskman: --format must be json or text\n";
+        return 1;
+    }
+    int limit = ContextService::DEFAULT_LIMIT;
+    if (result.count("limit") && !parse_int(result["limit"].as<std::string>(), limit)) {
+        std::cerr << "taskman: --limit must be an integer\n";
+        return 1;
+    }
+    std::optional<std::string> role;
+    if (result.count("role")) role = result["role"].as<std::string>();
+
+    ProjectContext context;
+    if (!service_.load(role, limit, context)) {
+        return 1;
+    }
+    if (format == "text") {
+        formatter_.format_text(context, std::cout);
+    } else {
+        formatter_.format_json(context, std::cout);
+    }
+    return 0;
+}
+
+} // namespace taskman
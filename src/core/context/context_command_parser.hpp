@@ -0,0 +1,41 @@
+/**
+ * ContextCommandParser — parsing des arguments CLI de la commande context.
+ * Responsabilité unique : parser les arguments CLI et appeler ContextService.
+ * Utilise ContextFormatter pour le formatage.
+ * Respecte le principe SRP (Single Responsibility Principle).
+ */
+
+#ifndef TASKMAN_CONTEXT_COMMAND_PARSER_HPP
+#define TASKMAN_CONTEXT_COMMAND_PARSER_HPP
+
+#include "context_formatter.hpp"
+#include "context_service.hpp"
+#include <string>
+
+namespace taskman {
+
+class ContextCommandParser {
+public:
+    /** Constructeur prenant des références à ContextService et ContextFormatter. */
+    ContextCommandParser(ContextService& service, ContextFormatter& formatter)
+        : service_(service), formatter_(formatter) {}
+
+    ContextCommandParser(const ContextCommandParser&) = delete;
+    ContextCommandParser& operator=(const ContextCommandParser&) = delete;
+
+    /** Parse et exécute la commande context.
+     * Retourne 0 en cas de succès, 1 en cas d'erreur. */
+    int parse(int argc, char* argv[]);
+
+private:
+    ContextService& service_;
+    ContextFormatter& formatter_;
+
+    /** Parse un entier depuis une chaîne.
+     * Retourne true si le parsing réussit, false sinon. */
+    static bool parse_int(const std::string& s, int& out);
+};
+
+} // namespace taskman
+
+#endif /* TASKMAN_CONTEXT_COMMAND_PARSER_HPP */
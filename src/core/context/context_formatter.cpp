@@ -0,0 +1,204 @@
+/**
+ * Implémentation de ContextFormatter.
+ */
+
+#include "context_formatter.hpp"
+#include "util/formats.hpp"
+#include <map>
+#include <utility>
+
+namespace taskman {
+
+namespace {
+    using json = nlohmann::json;
+
+    std::string value(const ProjectContext::Row& row, const char* key) {
+        auto it = row.find(key);
+        return (it != row.end() && it->second) ? *it->second : std::string();
+    }
+
+    /** Valeur entière ou null (sort_order, reached). */
+    json int_or_null(const ProjectContext::Row& row, const char* key) {
+        auto it = row.find(key);
+        if (it == row.end() || !it->second) return nullptr;
+        try {
+            return std::stoi(*it->second);
+        } catch (...) {
+            return *it->second;
+        }
+    }
+
+    json empty_progress() {
+        return json{{"total", 0}, {"to_do", 0}, {"in_progress", 0}, {"done", 0}};
+    }
+
+    /** Ajoute count tâches de statut status (NULL compté en to_do). */
+    void add_progress(json& progress, const std::string& status, int count) {
+        progress["total"] = progress["total"].get<int>() + count;
+        const char* key = (status == "in_progress" || status == "done") ? status.c_str() : "to_do";
+        progress[key] = progress[key].get<int>() + count;
+    }
+
+    json section(int total, json items) {
+        return json{{"total", total}, {"items", std::move(items)}};
+    }
+
+    json task_items(const std::vector<ProjectContext::Row>& tasks) {
+        json items = json::array();
+        for (const auto& task : tasks) {
+            std::vector<std::string> fields;
+            for (const auto& [key, v] : task) fields.push_back(key);
+            json obj;
+            task_to_json(obj, task, fields);
+            items.push_back(std::move(obj));
+        }
+        return items;
+    }
+}
+
+json ContextFormatter::to_json(const ProjectContext& context) {
+    json result;
+    result["role"] = context.role ? json(*context.role) : json();
+
+    // Avancement par phase et par jalon
+    std::map<std::string, json> phase_progress;
+    std::map<std::pair<std::string, std::string>, json> milestone_progress;
+    for (const auto& row : context.progress) {
+        int count = 0;
+        try {
+            count = std::stoi(value(row, "count"));
+        } catch (...) {
+            continue;
+        }
+        std::string phase_id = value(row, "phase_id");
+        std::string status = value(row, "status");
+        auto& p = phase_progress.emplace(phase_id, empty_progress()).first->second;
+        add_progress(p, status, count);
+        auto it = row.find("milestone_id");
+        if (it != row.end() && it->second) {
+            auto& m = milestone_progress.emplace(std::make_pair(phase_id, *it->second), empty_progress()).first->second;
+            add_progress(m, status, count);
+        }
+    }
+
+    json phases = json::array();
+    for (const auto& row : context.phases) {
+        std::string phase_id = value(row, "id");
+        json phase;
+        phase["id"] = phase_id;
+        phase["name"] = value(row, "name");
+        phase["status"] = value(row, "status");
+        phase["sort_order"] = int_or_null(row, "sort_order");
+        auto p = phase_progress.find(phase_id);
+        phase["progress"] = p != phase_progress.end() ? p->second : empty_progress();
+        json milestones = json::array();
+        for (const auto& m : context.milestones) {
+            if (value(m, "phase_id") != phase_id) continue;
+            json milestone;
+            milestone["id"] = value(m, "id");
+            milestone["name"] = value(m, "name");
+            milestone["criterion"] = value(m, "criterion");
+            milestone["reached"] = int_or_null(m, "reached");
+            auto mp = milestone_progress.find({phase_id, value(m, "id")});
+            milestone["progress"] = mp != milestone_progress.end() ? mp->second : empty_progress();
+            milestones.push_back(std::move(milestone));
+        }
+        phase["milestones"] = std::move(milestones);
+        auto total = context.milestones_total.find(phase_id);
+        phase["milestones_total"] = total != context.milestones_total.end() ? total->second : 0;
+        phases.push_back(std::move(phase));
+    }
+    result["phases"] = section(context.phases_total, std::move(phases));
+
+    result["ready"] = section(context.ready_total, task_items(context.ready));
+
+    json in_progress = task_items(context.in_progress);
+    for (auto& task : in_progress) {
+        auto it = context.latest_notes.find(task.value("id", ""));
+        if (it == context.latest_notes.end()) {
+            task["latest_note"] = nullptr;
+            continue;
+        }
+        json note;
+        note_to_json(note, it->second);
+        note.erase("task_id");
+        task["latest_note"] = std::move(note);
+    }
+    result["in_progress"] = section(context.in_progress_total, std::move(in_progress));
+
+    json blocked = task_items(context.blocked);
+    for (auto& task : blocked) {
+        std::string id = task.value("id", "");
+        json blocked_by = json::array();
+        int total = 0;
+        for (const auto& dep : context.blockers) {
+            if (value(dep, "task_id") != id) continue;
+            if (++total > ContextService::BLOCKERS_PER_TASK) continue;
+            json d;
+            task_to_json(d, dep, {"id", "title", "status", "role"});
+            blocked_by.push_back(std::move(d));
+        }
+        task["blocked_by"] = std::move(blocked_by);
+        task["blocked_by_total"] = total;
+    }
+    result["blocked"] = section(context.blocked_total, std::move(blocked));
+    return result;
+}
+
+void ContextFormatter::format_json(const ProjectContext& context, std::ostream& out) {
+    out << to_json(context).dump() << "\n";
+}
+
+void ContextFormatter::format_text(const ProjectContext& context, std::ostream& out) {
+    json ctx = to_json(context);
+    auto count_of = [](const json& s) {
+        size_t shown = s["items"].size();
+        int total = s["total"].get<int>();
+        return static_cast<int>(shown) < total ? std::to_string(shown) + " of " + std::to_string(total)
+                                               : std::to_string(total);
+    };
+    auto done_ratio = [](const json& progress) {
+        return std::to_string(progress["done"].get<int>()) + "/" + std::to_string(progress["total"].get<int>()) + " done";
+    };
+    auto task_line = [](const json& task) {
+        std::string line = "  - " + task.value("id", "") + " " + task.value("title", "");
+        if (task.contains("role") && task["role"].is_string()) line += " (" + task["role"].get<std::string>() + ")";
+        return line;
+    };
+
+    out << "role: " << (context.role ? *context.role : "all") << "\n";
+    out << "phases (" << count_of(ctx["phases"]) << "):\n";
+    for (const auto& phase : ctx["phases"]["items"]) {
+        out << "  " << phase["id"].get<std::string>() << " " << phase["name"].get<std::string>()
+            << " [" << phase["status"].get<std::string>() << "] " << done_ratio(phase["progress"]) << "\n";
+        for (const auto& m : phase["milestones"]) {
+            out << "    - " << m["id"].get<std::string>() << " " << m["name"].get<std::string>()
+                << (m["reached"] == 1 ? " [reached] " : " ") << done_ratio(m["progress"]) << "\n";
+        }
+    }
+    out << "ready (" << count_of(ctx["ready"]) << "):\n";
+    for (const auto& task : ctx["ready"]["items"]) out << task_line(task) << "\n";
+    out << "in_progress (" << count_of(ctx["in_progress"]) << "):\n";
+    for (const auto& task : ctx["in_progress"]["items"]) {
+        out << task_line(task) << "\n";
+        if (task["latest_note"].is_object()) {
+            const auto& note = task["latest_note"];
+            out << "    latest note" << (note["kind"].is_string() ? " (" + note["kind"].get<std::string>() + ")" : "")
+                << ": " << note.value("content", "") << "\n";
+        }
+    }
+    out << "blocked (" << count_of(ctx["blocked"]) << "):\n";
+    for (const auto& task : ctx["blocked"]["items"]) {
+        out << task_line(task) << "\n";
+        for (const auto& dep : task["blocked_by"]) {
+            out << "    blocked by " << dep.value("id", "") << " " << dep.value("title", "")
+                << " [" << (dep["status"].is_string() ? dep["status"].get<std::string>() : "to_do") << "]\n";
+        }
+    }
+}
+
+bool ContextFormatter::is_valid_format(const std::string& format) {
+    return format == "json" || format == "text";
+}
+
+} // namespace taskman
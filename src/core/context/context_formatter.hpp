@@ -0,0 +1,41 @@
+/**
+ * ContextFormatter — formatage de sortie du contexte projet (commande context).
+ * Responsabilité unique : construire l'arbre phases → jalons avec compteurs d'avancement
+ * et les sections de tâches, en JSON ou en texte lisible.
+ * Respecte le principe SRP (Single Responsibility Principle).
+ */
+
+#ifndef TASKMAN_CONTEXT_FORMATTER_HPP
+#define TASKMAN_CONTEXT_FORMATTER_HPP
+
+#include "context_service.hpp"
+#include <nlohmann/json.hpp>
+#include <ostream>
+#include <string>
+
+namespace taskman {
+
+class ContextFormatter {
+public:
+    /** Construit le contexte JSON :
+     * {"role", "phases": {"total", "items": [{id, name, status, sort_order, progress, milestones, milestones_total}]},
+     *  "ready" / "in_progress" / "blocked": {"total", "items": [...]}}.
+     * progress = {"total", "to_do", "in_progress", "done"} ; les tâches en cours portent latest_note
+     * (ou null), les tâches bloquées blocked_by (au plus BLOCKERS_PER_TASK) et blocked_by_total. */
+    static nlohmann::json to_json(const ProjectContext& context);
+
+    /** Formate le contexte en JSON (voir to_json).
+     * Écrit le résultat dans le stream fourni. */
+    static void format_json(const ProjectContext& context, std::ostream& out);
+
+    /** Formate le contexte en texte lisible (une section par bloc).
+     * Écrit le résultat dans le stream fourni. */
+    static void format_text(const ProjectContext& context, std::ostream& out);
+
+    /** Valide un format de sortie : json ou text. */
+    static bool is_valid_format(const std::string& format);
+};
+
+} // namespace taskman
+
+#endif /* TASKMAN_CONTEXT_FORMATTER_HPP */
@@ -0,0 +1,74 @@
+/**
+ * Implémentation de ContextService.
+ */
+
+#include "context_service.hpp"
+#include "core/task/task_service.hpp"
+#include "infrastructure/db/transaction.hpp"
+#include "util/diagnostics.hpp"
+#include "util/roles.hpp"
+
+namespace taskman {
+
+ContextService::ContextService(QueryExecutor& executor)
+    : executor_(executor), tasks_(executor), phases_(executor), milestones_(executor), notes_(executor) {}
+
+bool ContextService::load(const std::optional<std::string>& role, int limit, ProjectContext& out) {
+    if (role.has_value() && !is_valid_role(*role)) {
+        diag() << get_roles_error_message();
+        return false;
+    }
+    if (limit < 1 || limit > MAX_LIMIT) {
+        diag() << "taskman: --limit must be between 1 and " << MAX_LIMIT << "\n";
+        return false;
+    }
+    out = ProjectContext{};
+    out.role = role;
+
+    // Toutes les lectures voient le même état de la base
+    Transaction snapshot(executor_);
+    if (!snapshot.active()) return false;
+
+    out.phases = phases_.list(PHASE_LIMIT, 0);
+    out.phases_total = phases_.count();
+    std::vector<std::string> ids;
+    for (const auto& phase : out.phases) ids.push_back(phase.at("id").value_or(""));
+    out.milestones = milestones_.list_by_phases(ids, MILESTONE_LIMIT);
+    for (const auto& milestone : out.milestones) {
+        out.milestones_total[milestone.at("phase_id").value_or("")] =
+            std::stoi(milestone.at("phase_total").value_or("0"));
+    }
+    out.progress = tasks_.count_by_milestone_and_status();
+
+    TaskProjection summary;
+    summary.fields = TaskService::summary_fields();
+    summary.description_max = TaskService::SUMMARY_DESCRIPTION_MAX;
+    std::optional<TaskListKey> next;
+
+    const std::optional<std::string> to_do = std::string("to_do");
+    const std::optional<std::string> unblocked = std::string("unblocked");
+    out.ready = tasks_.list_page(std::nullopt, to_do, role, unblocked, std::nullopt, std::nullopt, limit, summary, next);
+    out.ready_total = tasks_.count(std::nullopt, std::nullopt, to_do, role, unblocked);
+
+    const std::optional<std::string> in_progress = std::string("in_progress");
+    out.in_progress = tasks_.list_page(std::nullopt, in_progress, role, std::nullopt, std::nullopt, std::nullopt,
+                                       limit, summary, next);
+    out.in_progress_total = tasks_.count(std::nullopt, std::nullopt, in_progress, role);
+    ids.clear();
+    for (const auto& task : out.in_progress) ids.push_back(task.at("id").value_or(""));
+    out.latest_notes = notes_.latest_by_task_ids(ids, NOTE_CONTENT_MAX);
+
+    TaskProjection brief;
+    brief.fields = {"id", "phase_id", "milestone_id", "title", "status", "role"};
+    const std::optional<std::string> blocked = std::string("blocked");
+    const std::optional<std::string> not_done = std::string("not_done");
+    out.blocked = tasks_.list_page(std::nullopt, std::nullopt, role, blocked, not_done, std::nullopt, limit, brief, next);
+    out.blocked_total = tasks_.count(std::nullopt, std::nullopt, std::nullopt, role, blocked, not_done);
+    ids.clear();
+    for (const auto& task : out.blocked) ids.push_back(task.at("id").value_or(""));
+    out.blockers = tasks_.find_open_dependencies(ids);
+
+    return snapshot.commit();
+}
+
+} // namespace taskman
@@ -0,0 +1,84 @@
+/**
+ * ContextService — contexte de démarrage d'un agent (commande context, outil taskman_context).
+ * Responsabilité unique : rassembler, en une seule lecture cohérente de la base, l'arbre
+ * phases/jalons avec l'avancement, les tâches prêtes et en cours d'un rôle et leurs blocages.
+ * Compose TaskRepository, PhaseRepository, MilestoneRepository et NoteRepository ; chaque
+ * section est plafonnée (le total est conservé pour signaler la troncature).
+ */
+
+#ifndef TASKMAN_CONTEXT_SERVICE_HPP
+#define TASKMAN_CONTEXT_SERVICE_HPP
+
+#include "core/milestone/milestone_repository.hpp"
+#include "core/note/note_repository.hpp"
+#include "core/phase/phase_repository.hpp"
+#include "core/task/task_repository.hpp"
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace taskman {
+
+/** Données brutes du contexte ; la mise en forme (arbre, compteurs) revient à ContextFormatter. */
+struct ProjectContext {
+    using Row = std::map<std::string, std::optional<std::string>>;
+
+    std::optional<std::string> role;
+    /** Phases (au plus PHASE_LIMIT, ordre de phase:list) et nombre total. */
+    std::vector<Row> phases;
+    int phases_total = 0;
+    /** Jalons des phases listées (au plus MILESTONE_LIMIT par phase, ordre de milestone:list) et
+     * nombre total de jalons par phase_id. */
+    std::vector<Row> milestones;
+    std::map<std::string, int> milestones_total;
+    /** Lignes phase_id, milestone_id, status, count (TaskRepository::count_by_milestone_and_status). */
+    std::vector<Row> progress;
+    /** Tâches to_do non bloquées du rôle (projection summary) et nombre total. */
+    std::vector<Row> ready;
+    int ready_total = 0;
+    /** Tâches in_progress du rôle (projection summary), nombre total et dernière note par task_id. */
+    std::vector<Row> in_progress;
+    int in_progress_total = 0;
+    std::map<std::string, Row> latest_notes;
+    /** Tâches non terminées et bloquées du rôle, nombre total, et leurs dépendances non terminées
+     * (lignes task_id, id, title, status, role). */
+    std::vector<Row> blocked;
+    int blocked_total = 0;
+    std::vector<Row> blockers;
+};
+
+class ContextService {
+public:
+    /** Tâches par section (--limit) : valeur par défaut et maximum. */
+    static constexpr int DEFAULT_LIMIT = 10;
+    static constexpr int MAX_LIMIT = 100;
+    /** Plafonds fixes : phases, jalons par phase, dépendances listées par tâche bloquée. */
+    static constexpr int PHASE_LIMIT = 50;
+    static constexpr int MILESTONE_LIMIT = 20;
+    static constexpr int BLOCKERS_PER_TASK = 5;
+    /** Longueur maximale du contenu de la dernière note (caractères). */
+    static constexpr int NOTE_CONTENT_MAX = 280;
+
+    /** Constructeur prenant une référence à QueryExecutor (partagé par les dépôts et la transaction). */
+    explicit ContextService(QueryExecutor& executor);
+
+    ContextService(const ContextService&) = delete;
+    ContextService& operator=(const ContextService&) = delete;
+
+    /** Lit le contexte dans une transaction de lecture (un seul snapshot de la base).
+     * role : filtre des sections de tâches (nullopt = tous les rôles). limit : tâches par section.
+     * Retourne false si role ou limit est invalide ou en cas d'erreur (message sur stderr). */
+    bool load(const std::optional<std::string>& role, int limit, ProjectContext& out);
+
+private:
+    QueryExecutor& executor_;
+    TaskRepository tasks_;
+    PhaseRepository phases_;
+    MilestoneRepository milestones_;
+    NoteRepository notes_;
+};
+
+} // namespace taskman
+
+#endif /* TASKMAN_CONTEXT_SERVICE_HPP */
@@ -3,6 +3,8 @@
  */
 
 #include "milestone_command_parser.hpp"
+#include "util/ndjson_writer.hpp"
+#include "util/table_writer.hpp"
 #include <cxxopts.hpp>
 #include <cstring>
 #include <iostream>
@@ -156,7 +158,7 @@ int MilestoneCommandParser::parse_list(int argc, char* argv[]) {
     cxxopts::Options opts("taskman milestone:list", "List milestones");
     opts.add_options()
         ("phase", "Filter by phase ID", cxxopts::value<std::string>())
-        ("format", "Output: json or text", cxxopts::value<std::string>()->default_value("json"));
+        ("format", "Output: json, text, table or ndjson", cxxopts::value<std::string>()->default_value("json"));
 
     for (int i = 0; i < argc; ++i) {
         if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0) {
@@ -173,14 +175,27 @@ int MilestoneCommandParser::parse_list(int argc, char* argv[]) {
     }
 
     std::string format = result["format"].as<std::string>();
-    if (!MilestoneFormatter::is_valid_format(format)) {
-        std::cerr << "taskman: --format must be json or text\n";
+    if (!MilestoneFormatter::is_valid_list_format(format)) {
+        std::cerr << "taskman: --format must be json, text, table or ndjson\n";
         return 1;
     }
 
     std::optional<std::string> phase_id;
     if (result.count("phase")) phase_id = result["phase"].as<std::string>();
 
+    if (format == "table") {
+        TableWriter table(std::cout);
+        if (!service_.list_milestones_into(phase_id, table)) return 1;
+        table.finish();
+        return 0;
+    }
+    if (format == "ndjson") {
+        NdjsonWriter ndjson(std::cout);
+        bool ok = service_.list_milestones_into(phase_id, ndjson);
+        ndjson.finish();
+        return ok ? 0 : 1;
+    }
+
     auto milestones = service_.list_milestones(phase_id);
 
     if (format == "json") {
@@ -8,9 +8,9 @@
 namespace taskman {
 
 void MilestoneFormatter::format_json(const std::map<std::string, std::optional<std::string>>& milestone, std::ostream& out) {
-    nlohmann::json obj;
-    milestone_to_json(obj, milestone);
-    out << obj.dump() << "\n";
+    std::string json;
+    append_json<MILESTONE_FIELDS>(json, milestone);
+    out << json << "\n";
 }
 
 void MilestoneFormatter::format_text(const std::map<std::string, std::optional<std::string>>& milestone, std::ostream& out) {
@@ -33,13 +33,9 @@ void MilestoneFormatter::format_text(const std::map<std::string, std::optional<s
 }
 
 void MilestoneFormatter::format_json_list(const std::vector<std::map<std::string, std::optional<std::string>>>& milestones, std::ostream& out) {
-    nlohmann::json arr = nlohmann::json::array();
-    for (const auto& milestone : milestones) {
-        nlohmann::json obj;
-        milestone_to_json(obj, milestone);
-        arr.push_back(obj);
-    }
-    out << arr.dump() << "\n";
+    std::string json;
+    append_json_array<MILESTONE_FIELDS>(json, milestones);
+    out << json << "\n";
 }
 
 void MilestoneFormatter::format_text_list(const std::vector<std::map<std::string, std::optional<std::string>>>& milestones, std::ostream& out) {
@@ -53,4 +49,8 @@ bool MilestoneFormatter::is_valid_format(const std::string& format) {
     return format == "json" || format == "text";
 }
 
+bool MilestoneFormatter::is_valid_list_format(const std::string& format) {
+    return is_valid_format(format) || format == "table" || format == "ndjson";
+}
+
 } // namespace taskman
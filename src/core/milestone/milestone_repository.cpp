@@ -3,13 +3,19 @@
  */
 
 #include "milestone_repository.hpp"
+#include "util/entity_fields.hpp"
 
 namespace taskman {
 
+namespace {
+    const std::string SELECT_SQL = std::string("SELECT ") + select_list<MILESTONE_FIELDS>() + " FROM milestones";
+    const std::string GET_SQL = SELECT_SQL + " WHERE id = ?";
+    const std::string LIST_SQL = SELECT_SQL + " ORDER BY phase_id, id LIMIT ? OFFSET ?";
+    const std::string LIST_BY_PHASE_SQL = SELECT_SQL + " WHERE phase_id = ? ORDER BY phase_id, id";
+}
+
 std::map<std::string, std::optional<std::string>> MilestoneRepository::get_by_id(const std::string& id) {
-    auto rows = executor_.query(
-        "SELECT id, phase_id, name, criterion, reached, created_at, updated_at FROM milestones WHERE id = ?",
-        {id});
+    auto rows = executor_.query(GET_SQL.c_str(), {id});
     if (rows.empty()) {
         return {};
     }
@@ -32,15 +38,39 @@ bool MilestoneRepository::add(const std::string& id,
 }
 
 std::vector<std::map<std::string, std::optional<std::string>>> MilestoneRepository::list(int limit, int offset) {
-    return executor_.query(
-        "SELECT id, phase_id, name, criterion, reached, created_at, updated_at FROM milestones ORDER BY phase_id, id LIMIT ? OFFSET ?",
-        {std::to_string(limit), std::to_string(offset)});
+    return executor_.query(LIST_SQL.c_str(), {std::to_string(limit), std::to_string(offset)});
 }
 
 std::vector<std::map<std::string, std::optional<std::string>>> MilestoneRepository::list_by_phase(const std::string& phase_id) {
-    return executor_.query(
-        "SELECT id, phase_id, name, criterion, reached, created_at, updated_at FROM milestones WHERE phase_id = ? ORDER BY phase_id, id",
-        {phase_id});
+    return executor_.query(LIST_BY_PHASE_SQL.c_str(), {phase_id});
+}
+
+std::vector<std::map<std::string, std::optional<std::string>>> MilestoneRepository::list_by_phases(
+    const std::vector<std::string>& phase_ids, int per_phase_limit) {
+    if (phase_ids.empty()) {
+        return {};
+    }
+    std::string placeholders;
+    for (size_t i = 0; i < phase_ids.size(); ++i) {
+        if (i > 0) placeholders += ',';
+        placeholders += '?';
+    }
+    // Fenêtre par phase : rang pour le plafond, effectif pour signaler la troncature
+    std::string sql = std::string("SELECT ") + select_list<MILESTONE_FIELDS>() + ", phase_total FROM ("
+                      "SELECT *, ROW_NUMBER() OVER (PARTITION BY phase_id ORDER BY id) AS rn, "
+                      "COUNT(*) OVER (PARTITION BY phase_id) AS phase_total "
+                      "FROM milestones WHERE phase_id IN (" + placeholders + ")) WHERE rn <= " + std::to_string(per_phase_limit) +
+                      " ORDER BY phase_id, id";
+    std::vector<std::optional<std::string>> params(phase_ids.begin(), phase_ids.end());
+    return executor_.query(sql.c_str(), params);
+}
+
+bool MilestoneRepository::list_into(int limit, int offset, RowSink& sink) {
+    return executor_.query_into(LIST_SQL.c_str(), {std::to_string(limit), std::to_string(offset)}, sink);
+}
+
+bool MilestoneRepository::list_by_phase_into(const std::string& phase_id, RowSink& sink) {
+    return executor_.query_into(LIST_BY_PHASE_SQL.c_str(), {phase_id}, sink);
 }
 
 bool MilestoneRepository::update(const std::string& id,
@@ -43,6 +43,17 @@ public:
      * Retourne un vecteur de maps représentant les milestones. */
     std::vector<std::map<std::string, std::optional<std::string>>> list_by_phase(const std::string& phase_id);
 
+    /** Au plus per_phase_limit milestones de chacune des phases phase_ids (ordre de list()), chaque ligne
+     * portant en plus phase_total : nombre de milestones de sa phase. Vide si phase_ids est vide. */
+    std::vector<std::map<std::string, std::optional<std::string>>> list_by_phases(
+        const std::vector<std::string>& phase_ids, int per_phase_limit);
+
+    /** Comme list(), en flux vers sink. Retourne false en cas d'erreur SQL. */
+    bool list_into(int limit, int offset, RowSink& sink);
+
+    /** Comme list_by_phase(), en flux vers sink. Retourne false en cas d'erreur SQL. */
+    bool list_by_phase_into(const std::string& phase_id, RowSink& sink);
+
     /** Met à jour un milestone existant.
      * Retourne true en cas de succès, false en cas d'erreur. */
     bool update(const std::string& id,
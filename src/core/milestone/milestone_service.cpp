@@ -27,6 +27,13 @@ std::vector<std::map<std::string, std::optional<std::string>>> MilestoneService:
     return repository_.list(10000, 0);
 }
 
+bool MilestoneService::list_milestones_into(const std::optional<std::string>& phase_id, RowSink& sink) {
+    if (phase_id.has_value()) {
+        return repository_.list_by_phase_into(*phase_id, sink);
+    }
+    return repository_.list_into(10000, 0, sink);
+}
+
 bool MilestoneService::update_milestone(const std::string& id,
                                         const std::optional<std::string>& name,
                                         const std::optional<std::string>& criterion,
@@ -41,6 +41,9 @@ public:
     std::vector<std::map<std::string, std::optional<std::string>>> list_milestones(
         const std::optional<std::string>& phase_id = std::nullopt);
 
+    /** Liste les milestones en flux vers sink (--format table, ndjson). Retourne false en cas d'erreur. */
+    bool list_milestones_into(const std::optional<std::string>& phase_id, RowSink& sink);
+
     /** Met à jour un milestone existant.
      * Retourne true en cas de succès, false en cas d'erreur. */
     bool update_milestone(const std::string& id,
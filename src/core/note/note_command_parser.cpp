@@ -3,6 +3,7 @@
  */
 
 #include "note_command_parser.hpp"
+#include "util/ndjson_writer.hpp"
 #include "util/roles.hpp"
 #include <cxxopts.hpp>
 #include <cstring>
@@ -91,7 +92,7 @@ int NoteCommandParser::parse_list(int argc, char* argv[]) {
     cxxopts::Options opts("taskman task:note:list", "List notes for a task");
     opts.add_options()
         ("task-id", "Task ID", cxxopts::value<std::string>())
-        ("format", "Output: json or text", cxxopts::value<std::string>()->default_value("json"));
+        ("format", "Output: json, text or ndjson", cxxopts::value<std::string>()->default_value("json"));
     opts.parse_positional({"task-id"});
 
     for (int i = 0; i < argc; ++i) {
@@ -120,11 +121,18 @@ int NoteCommandParser::parse_list(int argc, char* argv[]) {
     }
 
     std::string format = result["format"].as<std::string>();
-    if (!NoteFormatter::is_valid_format(format)) {
-        std::cerr << "taskman: --format must be json or text\n";
+    if (!NoteFormatter::is_valid_list_format(format)) {
+        std::cerr << "taskman: --format must be json, text or ndjson\n";
         return 1;
     }
 
+    if (format == "ndjson") {
+        NdjsonWriter ndjson(std::cout, {"kind", "role"});
+        bool ok = service_.list_notes_into(task_id, ndjson);
+        ndjson.finish();
+        return ok ? 0 : 1;
+    }
+
     auto notes = service_.list_notes(task_id);
 
     if (format == "text") {
@@ -139,7 +147,7 @@ int NoteCommandParser::parse_list_by_ids(int argc, char* argv[]) {
     cxxopts::Options opts("taskman task:note:list-by-ids", "List notes by a comma-separated list of note IDs");
     opts.add_options()
         ("ids", "Comma-separated note IDs", cxxopts::value<std::string>())
-        ("format", "Output: json or text", cxxopts::value<std::string>()->default_value("json"));
+        ("format", "Output: json, text or ndjson", cxxopts::value<std::string>()->default_value("json"));
     for (int i = 0; i < argc; ++i) {
         if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0) {
             std::cout << opts.help() << '\n';
@@ -172,10 +180,16 @@ int NoteCommandParser::parse_list_by_ids(int argc, char* argv[]) {
         }
     }
     std::string format = result["format"].as<std::string>();
-    if (!NoteFormatter::is_valid_format(format)) {
-        std::cerr << "taskman: --format must be json or text\n";
+    if (!NoteFormatter::is_valid_list_format(format)) {
+        std::cerr << "taskman: --format must be json, text or ndjson\n";
         return 1;
     }
+    if (format == "ndjson") {
+        NdjsonWriter ndjson(std::cout, {"kind", "role"});
+        bool ok = service_.list_notes_by_ids_into(ids, ndjson);
+        ndjson.finish();
+        return ok ? 0 : 1;
+    }
     auto notes = service_.list_notes_by_ids(ids);
     if (format == "text") {
         formatter_.format_text_list(notes, std::cout);
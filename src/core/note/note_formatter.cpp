@@ -3,41 +3,16 @@
  */
 
 #include "note_formatter.hpp"
+#include "util/formats.hpp"
 #include <nlohmann/json.hpp>
 #include <iostream>
 
 namespace taskman {
 
 void NoteFormatter::format_json(const std::map<std::string, std::optional<std::string>>& note, std::ostream& out) {
-    auto get = [&note](const char* k) {
-        return note.count(k) ? note.at(k) : std::optional<std::string>();
-    };
-    nlohmann::json obj;
-    if (auto v = get("id"); v.has_value())
-        obj["id"] = *v;
-    else
-        obj["id"] = nullptr;
-    if (auto v = get("task_id"); v.has_value())
-        obj["task_id"] = *v;
-    else
-        obj["task_id"] = nullptr;
-    if (auto v = get("content"); v.has_value())
-        obj["content"] = *v;
-    else
-        obj["content"] = nullptr;
-    if (auto v = get("kind"); v.has_value() && !v->empty())
-        obj["kind"] = *v;
-    else
-        obj["kind"] = nullptr;
-    if (auto v = get("role"); v.has_value() && !v->empty())
-        obj["role"] = *v;
-    else
-        obj["role"] = nullptr;
-    if (auto v = get("created_at"); v.has_value())
-        obj["created_at"] = *v;
-    else
-        obj["created_at"] = nullptr;
-    out << obj.dump() << "\n";
+    std::string json;
+    append_json<NOTE_FIELDS>(json, note);
+    out << json << "\n";
 }
 
 void NoteFormatter::format_text(const std::map<std::string, std::optional<std::string>>& note, std::ostream& out) {
@@ -59,39 +34,9 @@ void NoteFormatter::format_text(const std::map<std::string, std::optional<std::s
 }
 
 void NoteFormatter::format_json_list(const std::vector<std::map<std::string, std::optional<std::string>>>& notes, std::ostream& out) {
-    nlohmann::json arr = nlohmann::json::array();
-    for (const auto& note : notes) {
-        auto get = [&note](const char* k) {
-            return note.count(k) ? note.at(k) : std::optional<std::string>();
-        };
-        nlohmann::json obj;
-        if (auto v = get("id"); v.has_value())
-            obj["id"] = *v;
-        else
-            obj["id"] = nullptr;
-        if (auto v = get("task_id"); v.has_value())
-            obj["task_id"] = *v;
-        else
-            obj["task_id"] = nullptr;
-        if (auto v = get("content"); v.has_value())
-            obj["content"] = *v;
-        else
-            obj["content"] = nullptr;
-        if (auto v = get("kind"); v.has_value() && !v->empty())
-            obj["kind"] = *v;
-        else
-            obj["kind"] = nullptr;
-        if (auto v = get("role"); v.has_value() && !v->empty())
-            obj["role"] = *v;
-        else
-            obj["role"] = nullptr;
-        if (auto v = get("created_at"); v.has_value())
-            obj["created_at"] = *v;
-        else
-            obj["created_at"] = nullptr;
-        arr.push_back(obj);
-    }
-    out << arr.dump() << "\n";
+    std::string json;
+    append_json_array<NOTE_FIELDS>(json, notes);
+    out << json << "\n";
 }
 
 void NoteFormatter::format_text_list(const std::vector<std::map<std::string, std::optional<std::string>>>& notes, std::ostream& out) {
@@ -105,4 +50,8 @@ bool NoteFormatter::is_valid_format(const std::string& format) {
     return format == "json" || format == "text";
 }
 
+bool NoteFormatter::is_valid_list_format(const std::string& format) {
+    return is_valid_format(format) || format == "ndjson";
+}
+
 } // namespace taskman
@@ -3,6 +3,7 @@
  */
 
 #include "note_repository.hpp"
+#include "infrastructure/db/enum_columns.hpp"
 
 namespace taskman {
 
@@ -12,16 +13,47 @@ bool NoteRepository::add(const std::string& id,
                          const std::optional<std::string>& kind,
                          const std::optional<std::string>& role) {
     const char* sql = "INSERT INTO task_notes (id, task_id, content, kind, role) VALUES (?, ?, ?, ?, ?)";
-    std::vector<std::optional<std::string>> params = {id, task_id, content, kind, role};
+    std::vector<std::optional<std::string>> params = {id, task_id, content, kind,
+                                                      EnumColumns(executor_).bind("role", role)};
     if (!executor_.run(sql, params)) return false;
     // Update task.updated_at when a note is added
     return executor_.run("UPDATE tasks SET updated_at = datetime('now') WHERE id = ?", {task_id});
 }
 
+bool NoteRepository::add_many(const std::vector<NoteRecord>& notes) {
+    std::vector<std::vector<std::optional<std::string>>> rows;
+    rows.reserve(notes.size());
+    EnumColumns enums(executor_);
+    for (const auto& n : notes) rows.push_back({n.id, n.task_id, n.content, n.kind, enums.bind("role", n.role)});
+    return executor_.run_many("INSERT INTO task_notes (id, task_id, content, kind, role) VALUES (?, ?, ?, ?, ?)", rows);
+}
+
+namespace {
+
+/** "SELECT <colonnes> FROM task_notes" (role décodé en stockage compact). */
+std::string select_sql(QueryExecutor& executor) {
+    return "SELECT " + EnumColumns(executor).select_list<NOTE_FIELDS>() + " FROM task_notes";
+}
+
+/** SELECT des notes d'une tâche. */
+std::string list_by_task_id_sql(QueryExecutor& executor) {
+    return select_sql(executor) + " WHERE task_id = ? ORDER BY created_at";
+}
+
+/** SELECT des notes dont l'ID est dans ids (une ? par ID). */
+std::string list_by_ids_sql(QueryExecutor& executor, size_t count) {
+    std::string placeholders;
+    for (size_t i = 0; i < count; ++i) {
+        if (i > 0) placeholders += ',';
+        placeholders += '?';
+    }
+    return select_sql(executor) + " WHERE id IN (" + placeholders + ") ORDER BY created_at";
+}
+
+} // namespace
+
 std::map<std::string, std::optional<std::string>> NoteRepository::get_by_id(const std::string& id) {
-    auto rows = executor_.query(
-        "SELECT id, task_id, content, kind, role, created_at FROM task_notes WHERE id = ?",
-        {id});
+    auto rows = executor_.query((select_sql(executor_) + " WHERE id = ?").c_str(), {id});
     if (rows.empty()) {
         return {};
     }
@@ -29,24 +61,56 @@ std::map<std::string, std::optional<std::string>> NoteRepository::get_by_id(cons
 }
 
 std::vector<std::map<std::string, std::optional<std::string>>> NoteRepository::list_by_task_id(const std::string& task_id) {
-    return executor_.query(
-        "SELECT id, task_id, content, kind, role, created_at FROM task_notes WHERE task_id = ? ORDER BY created_at",
-        {task_id});
+    return executor_.query(list_by_task_id_sql(executor_).c_str(), {task_id});
 }
 
 std::vector<std::map<std::string, std::optional<std::string>>> NoteRepository::list_by_ids(const std::vector<std::string>& ids) {
     if (ids.empty()) {
         return {};
     }
+    std::vector<std::optional<std::string>> params(ids.begin(), ids.end());
+    return executor_.query(list_by_ids_sql(executor_, ids.size()).c_str(), params);
+}
+
+bool NoteRepository::list_by_task_id_into(const std::string& task_id, RowSink& sink) {
+    return executor_.query_into(list_by_task_id_sql(executor_).c_str(), {task_id}, sink);
+}
+
+bool NoteRepository::list_by_ids_into(const std::vector<std::string>& ids, RowSink& sink) {
+    if (ids.empty()) {
+        return true;
+    }
+    std::vector<std::optional<std::string>> params(ids.begin(), ids.end());
+    return executor_.query_into(list_by_ids_sql(executor_, ids.size()).c_str(), params, sink);
+}
+
+std::map<std::string, std::map<std::string, std::optional<std::string>>> NoteRepository::latest_by_task_ids(
+    const std::vector<std::string>& task_ids, int content_max) {
+    std::map<std::string, std::map<std::string, std::optional<std::string>>> latest;
+    if (task_ids.empty()) {
+        return latest;
+    }
     std::string placeholders;
-    for (size_t i = 0; i < ids.size(); ++i) {
+    for (size_t i = 0; i < task_ids.size(); ++i) {
         if (i > 0) placeholders += ',';
         placeholders += '?';
     }
-    std::vector<std::optional<std::string>> params(ids.begin(), ids.end());
-    std::string sql = "SELECT id, task_id, content, kind, role, created_at FROM task_notes WHERE id IN (" +
-                      placeholders + ") ORDER BY created_at";
-    return executor_.query(sql.c_str(), params);
+    std::string content = "content";
+    if (content_max > 0) {
+        std::string n = std::to_string(content_max);
+        content = "CASE WHEN length(content) > " + n + " THEN substr(content, 1, " + n + ") || '…' ELSE content END";
+    }
+    // Index idx_task_notes_task_id : une recherche par tâche, puis fenêtre sur ses notes
+    std::string sql = "SELECT id, task_id, " + content + " AS content, kind, " + EnumColumns(executor_).select("role") +
+                      ", created_at FROM ("
+                      "SELECT *, ROW_NUMBER() OVER (PARTITION BY task_id ORDER BY created_at DESC, rowid DESC) AS rn "
+                      "FROM task_notes WHERE task_id IN (" + placeholders + ")) WHERE rn = 1";
+    std::vector<std::optional<std::string>> params(task_ids.begin(), task_ids.end());
+    for (auto& row : executor_.query(sql.c_str(), params)) {
+        std::string task_id = row["task_id"].value_or("");
+        latest[task_id] = std::move(row);
+    }
+    return latest;
 }
 
 bool NoteRepository::task_exists(const std::string& task_id) {
@@ -15,6 +15,15 @@
 
 namespace taskman {
 
+/** Note à insérer par add_many (mêmes colonnes que add). */
+struct NoteRecord {
+    std::string id;
+    std::string task_id;
+    std::string content;
+    std::optional<std::string> kind;
+    std::optional<std::string> role;
+};
+
 class NoteRepository {
 public:
     /** Constructeur prenant une référence à QueryExecutor. */
@@ -31,6 +40,11 @@ public:
              const std::optional<std::string>& kind,
              const std::optional<std::string>& role);
 
+    /** Insère des notes avec un INSERT préparé une fois (QueryExecutor::run_many), sans
+     * transaction propre. Contrairement à add(), updated_at des tâches n'est pas modifié
+     * (notes créées avec leurs tâches). Retourne true en cas de succès. */
+    bool add_many(const std::vector<NoteRecord>& notes);
+
     /** Récupère une note par son ID.
      * Retourne un map vide si la note n'existe pas. */
     std::map<std::string, std::optional<std::string>> get_by_id(const std::string& id);
@@ -43,6 +57,18 @@ public:
      * Retourne un vecteur de maps (ordre par created_at). Les IDs inexistants sont ignorés. */
     std::vector<std::map<std::string, std::optional<std::string>>> list_by_ids(const std::vector<std::string>& ids);
 
+    /** Comme list_by_task_id, en flux vers sink. Retourne false en cas d'erreur. */
+    bool list_by_task_id_into(const std::string& task_id, RowSink& sink);
+
+    /** Comme list_by_ids, en flux vers sink. Retourne false en cas d'erreur. */
+    bool list_by_ids_into(const std::vector<std::string>& ids, RowSink& sink);
+
+    /** Dernière note (created_at puis ordre d'insertion) de chaque tâche de la liste.
+     * content_max > 0 : contenu tronqué par SQLite à ce nombre de caractères (suffixe "…").
+     * Retourne une map task_id → note ; les tâches sans note sont absentes. */
+    std::map<std::string, std::map<std::string, std::optional<std::string>>> latest_by_task_ids(
+        const std::vector<std::string>& task_ids, int content_max = 0);
+
     /** Vérifie si une tâche existe (pour validation avant d'ajouter une note).
      * Retourne true si la tâche existe, false sinon. */
     bool task_exists(const std::string& task_id);
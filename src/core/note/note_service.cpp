@@ -3,7 +3,7 @@
  */
 
 #include "note_service.hpp"
-#include <iostream>
+#include "util/diagnostics.hpp"
 #include <random>
 #include <uuid.h>
 
@@ -31,12 +31,12 @@ bool NoteService::add_note_with_id(
     const std::optional<std::string>& role) {
     // Vérifier que la tâche existe
     if (!repository_.task_exists(task_id)) {
-        std::cerr << "taskman: task not found: " << task_id << "\n";
+        diag() << "taskman: task not found: " << task_id << "\n";
         return false;
     }
     // Validation du rôle si fourni
     if (role.has_value() && !is_valid_role(*role)) {
-        std::cerr << get_roles_error_message();
+        diag() << get_roles_error_message();
         return false;
     }
     // Insertion dans la base
@@ -55,6 +55,14 @@ std::vector<std::map<std::string, std::optional<std::string>>> NoteService::list
     return repository_.list_by_ids(ids);
 }
 
+bool NoteService::list_notes_into(const std::string& task_id, RowSink& sink) {
+    return repository_.list_by_task_id_into(task_id, sink);
+}
+
+bool NoteService::list_notes_by_ids_into(const std::vector<std::string>& ids, RowSink& sink) {
+    return repository_.list_by_ids_into(ids, sink);
+}
+
 std::string NoteService::generate_uuid_v4() {
     std::random_device rd;
     std::mt19937 rng(rd());
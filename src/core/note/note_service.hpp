@@ -56,6 +56,12 @@ public:
      * Retourne un vecteur de maps (ordre par created_at). Les IDs inexistants sont ignorés. */
     std::vector<std::map<std::string, std::optional<std::string>>> list_notes_by_ids(const std::vector<std::string>& ids);
 
+    /** Liste les notes d'une tâche en flux vers sink (--format ndjson). Retourne false en cas d'erreur. */
+    bool list_notes_into(const std::string& task_id, RowSink& sink);
+
+    /** Liste les notes des IDs fournis en flux vers sink (--format ndjson). Retourne false en cas d'erreur. */
+    bool list_notes_by_ids_into(const std::vector<std::string>& ids, RowSink& sink);
+
     /** Génère un UUID v4.
      * Retourne une chaîne représentant l'UUID. */
     static std::string generate_uuid_v4();
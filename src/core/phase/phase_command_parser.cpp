@@ -3,6 +3,8 @@
  */
 
 #include "phase_command_parser.hpp"
+#include "util/ndjson_writer.hpp"
+#include "util/table_writer.hpp"
 #include <cxxopts.hpp>
 #include <cstring>
 #include <iostream>
@@ -160,14 +162,14 @@ int PhaseCommandParser::parse_edit(int argc, char* argv[]) {
 int PhaseCommandParser::parse_list(int argc, char* argv[]) {
     cxxopts::Options opts("taskman phase:list", "List phases");
     opts.add_options()
-        ("format", "Output: json or text", cxxopts::value<std::string>()->default_value("json"));
+        ("format", "Output: json, text, table or ndjson", cxxopts::value<std::string>()->default_value("json"));
 
     for (int i = 0; i < argc; ++i) {
         if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0) {
             std::cout << "taskman phase:list\n\n"
                          "List all phases as a JSON array, ordered by sort_order.\n"
                          "Options:\n"
-                         "  --format json|text  Output format (default: json)\n\n";
+                         "  --format json|text|table|ndjson  Output format (default: json)\n\n";
             return 0;
         }
     }
@@ -180,11 +182,24 @@ int PhaseCommandParser::parse_list(int argc, char* argv[]) {
     }
 
     std::string format = result["format"].as<std::string>();
-    if (!PhaseFormatter::is_valid_format(format)) {
-        std::cerr << "taskman: --format must be json or text\n";
+    if (!PhaseFormatter::is_valid_list_format(format)) {
+        std::cerr << "taskman: --format must be json, text, table or ndjson\n";
         return 1;
     }
 
+    if (format == "table") {
+        TableWriter table(std::cout);
+        if (!service_.list_phases_into(table)) return 1;
+        table.finish();
+        return 0;
+    }
+    if (format == "ndjson") {
+        NdjsonWriter ndjson(std::cout);
+        bool ok = service_.list_phases_into(ndjson);
+        ndjson.finish();
+        return ok ? 0 : 1;
+    }
+
     auto phases = service_.list_phases();
 
     if (format == "json") {
@@ -8,9 +8,9 @@
 namespace taskman {
 
 void PhaseFormatter::format_json(const std::map<std::string, std::optional<std::string>>& phase, std::ostream& out) {
-    nlohmann::json obj;
-    phase_to_json(obj, phase);
-    out << obj.dump() << "\n";
+    std::string json;
+    append_json<PHASE_FIELDS>(json, phase);
+    out << json << "\n";
 }
 
 void PhaseFormatter::format_text(const std::map<std::string, std::optional<std::string>>& phase, std::ostream& out) {
@@ -31,13 +31,9 @@ void PhaseFormatter::format_text(const std::map<std::string, std::optional<std::
 }
 
 void PhaseFormatter::format_json_list(const std::vector<std::map<std::string, std::optional<std::string>>>& phases, std::ostream& out) {
-    nlohmann::json arr = nlohmann::json::array();
-    for (const auto& phase : phases) {
-        nlohmann::json obj;
-        phase_to_json(obj, phase);
-        arr.push_back(obj);
-    }
-    out << arr.dump() << "\n";
+    std::string json;
+    append_json_array<PHASE_FIELDS>(json, phases);
+    out << json << "\n";
 }
 
 void PhaseFormatter::format_text_list(const std::vector<std::map<std::string, std::optional<std::string>>>& phases, std::ostream& out) {
@@ -51,4 +47,8 @@ bool PhaseFormatter::is_valid_format(const std::string& format) {
     return format == "json" || format == "text";
 }
 
+bool PhaseFormatter::is_valid_list_format(const std::string& format) {
+    return is_valid_format(format) || format == "table" || format == "ndjson";
+}
+
 } // namespace taskman
@@ -39,6 +39,9 @@ public:
     /** Valide un format de sortie.
      * Retourne true si le format est valide (json ou text), false sinon. */
     static bool is_valid_format(const std::string& format);
+
+    /** Valide un format de sortie de liste : json, text, table (voir TableWriter) ou ndjson (voir NdjsonWriter). */
+    static bool is_valid_list_format(const std::string& format);
 };
 
 } // namespace taskman
@@ -3,13 +3,20 @@
  */
 
 #include "phase_repository.hpp"
+#include "infrastructure/db/enum_columns.hpp"
 
 namespace taskman {
 
+namespace {
+    /** "SELECT <colonnes> FROM phases" (status décodé en stockage compact). */
+    std::string select_sql(QueryExecutor& executor) {
+        return "SELECT " + EnumColumns(executor).select_list<PHASE_FIELDS>() + " FROM phases";
+    }
+    const char* const LIST_SUFFIX = " ORDER BY sort_order LIMIT ? OFFSET ?";
+}
+
 std::map<std::string, std::optional<std::string>> PhaseRepository::get_by_id(const std::string& id) {
-    auto rows = executor_.query(
-        "SELECT id, name, status, sort_order, created_at, updated_at FROM phases WHERE id = ?",
-        {id});
+    auto rows = executor_.query((select_sql(executor_) + " WHERE id = ?").c_str(), {id});
     if (rows.empty()) {
         return {};
     }
@@ -24,7 +31,7 @@ bool PhaseRepository::add(const std::string& id,
     std::vector<std::optional<std::string>> params;
     params.push_back(id);
     params.push_back(name);
-    params.push_back(status);
+    params.push_back(EnumColumns(executor_).bind("status", status));
     params.push_back(sort_order.has_value()
                      ? std::optional<std::string>(std::to_string(*sort_order))
                      : std::nullopt);
@@ -32,9 +39,24 @@ bool PhaseRepository::add(const std::string& id,
 }
 
 std::vector<std::map<std::string, std::optional<std::string>>> PhaseRepository::list(int limit, int offset) {
-    return executor_.query(
-        "SELECT id, name, status, sort_order, created_at, updated_at FROM phases ORDER BY sort_order LIMIT ? OFFSET ?",
-        {std::to_string(limit), std::to_string(offset)});
+    return executor_.query((select_sql(executor_) + LIST_SUFFIX).c_str(), {std::to_string(limit), std::to_string(offset)});
+}
+
+bool PhaseRepository::list_into(int limit, int offset, RowSink& sink) {
+    return executor_.query_into((select_sql(executor_) + LIST_SUFFIX).c_str(),
+                                {std::to_string(limit), std::to_string(offset)}, sink);
+}
+
+int PhaseRepository::count() {
+    auto rows = executor_.query("SELECT COUNT(*) AS count FROM phases", {});
+    if (rows.empty() || !rows[0].count("count")) {
+        return 0;
+    }
+    try {
+        return std::stoi(rows[0].at("count").value_or("0"));
+    } catch (...) {
+        return 0;
+    }
 }
 
 bool PhaseRepository::update(const std::string& id,
@@ -50,7 +72,7 @@ bool PhaseRepository::update(const std::string& id,
     }
     if (status.has_value()) {
         set_parts.push_back("status = ?");
-        params.push_back(*status);
+        params.push_back(EnumColumns(executor_).bind("status", status));
     }
     if (sort_order.has_value()) {
         set_parts.push_back("sort_order = ?");
@@ -38,6 +38,12 @@ public:
      * Retourne un vecteur de maps représentant les phases. */
     std::vector<std::map<std::string, std::optional<std::string>>> list(int limit = 30, int offset = 0);
 
+    /** Comme list(), en flux vers sink. Retourne false en cas d'erreur SQL. */
+    bool list_into(int limit, int offset, RowSink& sink);
+
+    /** Nombre total de phases. */
+    int count();
+
     /** Met à jour une phase existante.
      * Retourne true en cas de succès, false en cas d'erreur. */
     bool update(const std::string& id,
@@ -3,7 +3,8 @@
  */
 
 #include "phase_service.hpp"
-#include <iostream>
+#include "util/diagnostics.hpp"
+#include "util/statuses.hpp"
 
 namespace taskman {
 
@@ -13,7 +14,7 @@ bool PhaseService::create_phase(const std::string& id,
                                 std::optional<int> sort_order) {
     // Validation du statut
     if (!is_valid_status(status)) {
-        std::cerr << "taskman: invalid status\n";
+        diag() << "taskman: invalid status\n";
         return false;
     }
     // Insertion dans la base
@@ -29,24 +30,24 @@ std::vector<std::map<std::string, std::optional<std::string>>> PhaseService::lis
     return repository_.list(10000, 0);
 }
 
+bool PhaseService::list_phases_into(RowSink& sink) {
+    return repository_.list_into(10000, 0, sink);
+}
+
 bool PhaseService::update_phase(const std::string& id,
                                  const std::optional<std::string>& name,
                                  const std::optional<std::string>& status,
                                  const std::optional<int>& sort_order) {
     // Validation du statut si fourni
     if (status.has_value() && !is_valid_status(*status)) {
-        std::cerr << "taskman: invalid status\n";
+        diag() << "taskman: invalid status\n";
         return false;
     }
     return repository_.update(id, name, status, sort_order);
 }
 
 bool PhaseService::is_valid_status(const std::string& status) {
-    const char* const STATUS_VALUES[] = {"to_do", "in_progress", "done"};
-    for (const char* v : STATUS_VALUES) {
-        if (status == v) return true;
-    }
-    return false;
+    return STATUS_CODES.code(status) != 0;
 }
 
 } // namespace taskman
@@ -39,6 +39,9 @@ public:
      * Retourne un vecteur de maps représentant les phases. */
     std::vector<std::map<std::string, std::optional<std::string>>> list_phases();
 
+    /** Liste les phases en flux vers sink (--format table, ndjson). Retourne false en cas d'erreur. */
+    bool list_phases_into(RowSink& sink);
+
     /** Met à jour une phase existante.
      * Effectue la validation des données avant mise à jour.
      * Retourne true en cas de succès, false en cas d'erreur. */
@@ -78,6 +78,17 @@ int cmd_task_list(int argc, char* argv[], Database& db) {
     return parser.parse_list(argc, argv);
 }
 
+int cmd_task_wait(int argc, char* argv[], Database& db) {
+    // Utilise les nouvelles classes pour respecter le SRP
+    QueryExecutor& executor = db.get_executor();
+    TaskRepository repository(executor);
+    TaskService service(repository);
+    DataVersion data_version(executor);
+    TaskFormatter formatter;
+    TaskCommandParser parser(service, formatter);
+    return parser.parse_wait(argc, argv, data_version);
+}
+
 int cmd_task_edit(int argc, char* argv[], Database& db) {
     // Utilise les nouvelles classes pour respecter le SRP
     QueryExecutor& executor = db.get_executor();
@@ -108,4 +119,34 @@ int cmd_task_dep_remove(int argc, char* argv[], Database& db) {
     return parser.parse_dep_remove(argc, argv);
 }
 
+int cmd_task_dep_batch(int argc, char* argv[], Database& db) {
+    // Utilise les nouvelles classes pour respecter le SRP
+    QueryExecutor& executor = db.get_executor();
+    TaskRepository repository(executor);
+    TaskService service(repository);
+    TaskFormatter formatter;
+    TaskCommandParser parser(service, formatter);
+    return parser.parse_dep_batch(argc, argv);
+}
+
+int cmd_task_bulk_add(int argc, char* argv[], Database& db) {
+    // Utilise les nouvelles classes pour respecter le SRP
+    QueryExecutor& executor = db.get_executor();
+    TaskRepository repository(executor);
+    TaskService service(repository);
+    TaskFormatter formatter;
+    TaskCommandParser parser(service, formatter);
+    return parser.parse_bulk_add(argc, argv);
+}
+
+int cmd_task_bulk_edit(int argc, char* argv[], Database& db) {
+    // Utilise les nouvelles classes pour respecter le SRP
+    QueryExecutor& executor = db.get_executor();
+    TaskRepository repository(executor);
+    TaskService service(repository);
+    TaskFormatter formatter;
+    TaskCommandParser parser(service, formatter);
+    return parser.parse_bulk_edit(argc, argv);
+}
+
 } // namespace taskman
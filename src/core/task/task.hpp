@@ -34,10 +34,16 @@ int cmd_task_add(int argc, char* argv[], Database& db);
 /** task:get <id> [--format json|text] ; JSON par défaut. */
 int cmd_task_get(int argc, char* argv[], Database& db);
 
-/** task:list [--phase <id>] [--status <s>] [--role <r>] [--blocked-filter blocked|unblocked] [--format json|text] */
+/** task:list [--phase <id>] [--status <s>] [--role <r>] [--blocked-filter blocked|unblocked] [--fields a,b,…] [--summary] [--format json|text]
+ *  --fields / --summary : projection appliquée dans le SELECT (voir TaskService::make_projection). */
 int cmd_task_list(int argc, char* argv[], Database& db);
 
-/** task:edit <id> [--title ...] [--description ...] [--status ...] [--role ...] [--milestone <id>] → UPDATE partiel */
+/** task:wait [--phase <id>] [--role <r>] [--limit <n>] [--timeout <s>] [--format json|text]
+ *  Attend une tâche prête (to_do, non bloquée) ; sortie {"tasks":[...],"timed_out":bool}. */
+int cmd_task_wait(int argc, char* argv[], Database& db);
+
+/** task:edit <id> [--title ...] [--description ...] [--status ...] [--role ...] [--milestone <id>] → UPDATE partiel ;
+ *  avec --status done, affiche {"id","status","unblocked":[...]} (tâches débloquées par la transition). */
 int cmd_task_edit(int argc, char* argv[], Database& db);
 
 /** task:dep:add <task-id> <dep-id> → INSERT dans task_deps ; vérifie existence des tâches. */
@@ -46,6 +52,17 @@ int cmd_task_dep_add(int argc, char* argv[], Database& db);
 /** task:dep:remove <task-id> <dep-id> → DELETE. */
 int cmd_task_dep_remove(int argc, char* argv[], Database& db);
 
+/** task:dep:batch --edges <json|-> [--format json|text] → ajouts/suppressions en une transaction ;
+ *  existence et cycles vérifiés sur tout le lot. --edges - lit le tableau JSON sur stdin. */
+int cmd_task_dep_batch(int argc, char* argv[], Database& db);
+
+/** task:bulk-add --tasks <json|-> [--format json|text] → crée les tâches et leurs dépendances
+ *  en une transaction ; les dépendances citent une clé du lot ou l'ID d'une tâche existante. */
+int cmd_task_bulk_add(int argc, char* argv[], Database& db);
+
+/** task:bulk-edit --tasks <json|-> [--format json|text] → modifie plusieurs tâches en une transaction. */
+int cmd_task_bulk_edit(int argc, char* argv[], Database& db);
+
 } // namespace taskman
 
 #endif /* TASKMAN_TASK_HPP */
@@ -3,9 +3,13 @@
  */
 
 #include "task_command_parser.hpp"
+#include "util/diagnostics.hpp"
+#include "util/ndjson_writer.hpp"
+#include "util/table_writer.hpp"
 #include <cxxopts.hpp>
 #include <cstring>
 #include <iostream>
+#include <iterator>
 
 namespace taskman {
 
@@ -169,7 +173,11 @@ int TaskCommandParser::parse_list(int argc, char* argv[]) {
         ("status", "Filter by status", cxxopts::value<std::string>())
         ("role", "Filter by role", cxxopts::value<std::string>())
         ("blocked-filter", "Filter by blocked state: blocked (only blocked tasks) or unblocked (only non-blocked)", cxxopts::value<std::string>())
-        ("format", "Output: json or text", cxxopts::value<std::string>()->default_value("json"));
+        ("fields", "Comma-separated fields to output (e.g. id,title,status,role)", cxxopts::value<std::string>())
+        ("summary", "Summary preset: id, phase_id, milestone_id, title, status, role and description truncated to 120 characters")
+        ("limit", "Page size (1-1000); output includes nextCursor", cxxopts::value<std::string>())
+        ("cursor", "Continue after the page that returned this nextCursor", cxxopts::value<std::string>())
+        ("format", "Output: json, text, table or ndjson (one object per line, streamed)", cxxopts::value<std::string>()->default_value("json"));
 
     for (int i = 0; i < argc; ++i) {
         if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0) {
@@ -186,8 +194,8 @@ int TaskCommandParser::parse_list(int argc, char* argv[]) {
     }
 
     std::string format = result["format"].as<std::string>();
-    if (!TaskFormatter::is_valid_format(format)) {
-        std::cerr << "taskman: --format must be json or text\n";
+    if (!TaskFormatter::is_valid_list_format(format)) {
+        std::cerr << "taskman: --format must be json, text, table or ndjson\n";
         return 1;
     }
     if (result.count("status")) {
@@ -210,12 +218,132 @@ int TaskCommandParser::parse_list(int argc, char* argv[]) {
     if (result.count("role")) role = result["role"].as<std::string>();
     if (result.count("blocked-filter")) blocked_filter = result["blocked-filter"].as<std::string>();
 
-    auto tasks = service_.list_tasks(phase_id, status, role, blocked_filter);
+    std::optional<std::string> fields;
+    if (result.count("fields")) fields = result["fields"].as<std::string>();
+    TaskProjection projection;
+    if (!TaskService::make_projection(fields, result.count("summary") > 0, projection)) {
+        return 1;
+    }
+
+    // Pagination par curseur : --limit et/ou --cursor
+    if (result.count("limit") || result.count("cursor")) {
+        int limit = TaskService::DEFAULT_PAGE_LIMIT;
+        if (result.count("limit") && !parse_int(result["limit"].as<std::string>(), limit)) {
+            std::cerr << "taskman: --limit must be an integer\n";
+            return 1;
+        }
+        std::optional<std::string> cursor;
+        if (result.count("cursor")) cursor = result["cursor"].as<std::string>();
+        std::optional<std::string> next_cursor;
+        if (format == "table") {
+            TableWriter table(std::cout);
+            if (!service_.list_tasks_page_into(phase_id, status, role, blocked_filter, projection, cursor, limit,
+                                               table, next_cursor)) {
+                return 1;
+            }
+            table.finish(next_cursor);
+            return 0;
+        }
+        if (format == "ndjson") {
+            NdjsonWriter ndjson(std::cout);
+            bool ok = service_.list_tasks_page_into(phase_id, status, role, blocked_filter, projection, cursor, limit,
+                                                    ndjson, next_cursor);
+            if (ok && next_cursor) ndjson.next_cursor(*next_cursor);
+            ndjson.finish();
+            return ok ? 0 : 1;
+        }
+        std::vector<std::map<std::string, std::optional<std::string>>> tasks;
+        if (!service_.list_tasks_page(phase_id, status, role, blocked_filter, projection, cursor, limit,
+                                      tasks, next_cursor)) {
+            return 1;
+        }
+        if (format == "json") {
+            formatter_.format_json_page(tasks, next_cursor, std::cout, projection.fields);
+        } else {
+            formatter_.format_text_page(tasks, next_cursor, std::cout, projection.fields);
+        }
+        return 0;
+    }
+
+    if (format == "table") {
+        TableWriter table(std::cout);
+        if (!service_.list_tasks_into(phase_id, status, role, blocked_filter, projection, table)) return 1;
+        table.finish();
+        return 0;
+    }
+    if (format == "ndjson") {
+        NdjsonWriter ndjson(std::cout);
+        bool ok = service_.list_tasks_into(phase_id, status, role, blocked_filter, projection, ndjson);
+        ndjson.finish();
+        return ok ? 0 : 1;
+    }
+
+    auto tasks = service_.list_tasks(phase_id, status, role, blocked_filter, projection);
 
     if (format == "json") {
-        formatter_.format_json_list(tasks, std::cout);
+        formatter_.format_json_list(tasks, std::cout, projection.fields);
     } else {
-        formatter_.format_text_list(tasks, std::cout);
+        formatter_.format_text_list(tasks, std::cout, projection.fields);
+    }
+    return 0;
+}
+
+int TaskCommandParser::parse_wait(int argc, char* argv[], DataVersion& data_version) {
+    cxxopts::Options opts("taskman task:wait", "Wait until a task is ready (to_do, not blocked)");
+    opts.add_options()
+        ("phase", "Filter by phase ID", cxxopts::value<std::string>())
+        ("role", "Filter by role", cxxopts::value<std::string>())
+        ("limit", "Maximum number of ready tasks returned (1-1000)", cxxopts::value<std::string>()->default_value("1"))
+        ("timeout", "Maximum wait in seconds (0-600, 0 = check once)", cxxopts::value<std::string>()->default_value("30"))
+        ("format", "Output: json or text", cxxopts::value<std::string>()->default_value("json"));
+
+    for (int i = 0; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0) {
+            std::cout << opts.help() << '\n';
+            return 0;
+        }
+    }
+    cxxopts::ParseResult result;
+    try {
+        result = opts.parse(argc, argv);
+    } catch (const cxxopts::exceptions::exception& e) {
+        std::cerr << "taskman: " << e.what() << "\n";
+        return 1;
+    }
+
+    std::string format = result["format"].as<std::string>();
+    if (!TaskFormatter::is_valid_format(format)) {
+        std::cerr << "taskman: --format must be json or text\n";
+        return 1;
+    }
+    int limit = 1;
+    if (!parse_int(result["limit"].as<std::string>(), limit)) {
+        std::cerr << "taskman: --limit must be an integer\n";
+        return 1;
+    }
+    int timeout = TaskService::DEFAULT_WAIT_TIMEOUT;
+    if (!parse_int(result["timeout"].as<std::string>(), timeout)) {
+        std::cerr << "taskman: --timeout must be an integer\n";
+        return 1;
+    }
+    if (timeout < 0 || timeout > TaskService::MAX_WAIT_TIMEOUT) {
+        std::cerr << "taskman: --timeout must be between 0 and " << TaskService::MAX_WAIT_TIMEOUT << "\n";
+        return 1;
+    }
+
+    std::optional<std::string> phase_id, role;
+    if (result.count("phase")) phase_id = result["phase"].as<std::string>();
+    if (result.count("role")) role = result["role"].as<std::string>();
+
+    std::vector<std::map<std::string, std::optional<std::string>>> tasks;
+    bool timed_out = false;
+    if (!service_.wait_ready(data_version, phase_id, role, limit, timeout * 1000, tasks, timed_out)) {
+        return 1;
+    }
+    if (format == "json") {
+        formatter_.format_json_wait(tasks, timed_out, std::cout, TaskService::summary_fields());
+    } else {
+        formatter_.format_text_wait(tasks, timed_out, std::cout, TaskService::summary_fields());
     }
     return 0;
 }
@@ -277,9 +405,16 @@ int TaskCommandParser::parse_edit(int argc, char* argv[]) {
         sort_order = n;
     }
 
-    if (!service_.update_task(id, title, description, status, role, milestone, sort_order, creator)) {
+    // Passage à done : rapporte les tâches dont la dernière dépendance ouverte vient de se fermer
+    std::vector<std::map<std::string, std::optional<std::string>>> unblocked;
+    bool to_done = status.has_value() && *status == "done";
+    if (!service_.update_task(id, title, description, status, role, milestone, sort_order, creator,
+                              to_done ? &unblocked : nullptr)) {
         return 1;
     }
+    if (to_done) {
+        formatter_.format_unblocked_json(id, unblocked, std::cout);
+    }
     return 0;
 }
 
@@ -362,4 +497,272 @@ int TaskCommandParser::parse_dep_remove(int argc, char* argv[]) {
     return 0;
 }
 
+int TaskCommandParser::parse_dep_batch(int argc, char* argv[]) {
+    cxxopts::Options opts("taskman task:dep:batch",
+                          "Add/remove several task dependencies in one transaction (all or nothing)");
+    opts.add_options()
+        ("edges", "JSON array of {\"op\":\"add\"|\"remove\",\"task-id\":...,\"dep-id\":...}; - reads stdin",
+         cxxopts::value<std::string>())
+        ("format", "Output: json or text", cxxopts::value<std::string>()->default_value("json"));
+
+    for (int i = 0; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0) {
+            std::cout << opts.help() << '\n';
+            return 0;
+        }
+    }
+    cxxopts::ParseResult result;
+    try {
+        result = opts.parse(argc, argv);
+    } catch (const cxxopts::exceptions::exception& e) {
+        std::cerr << "taskman: " << e.what() << "\n";
+        return 1;
+    }
+
+    if (!result.count("edges")) {
+        std::cerr << "taskman: --edges is required\n";
+        return 1;
+    }
+    std::string edges_str, format;
+    try {
+        format = result["format"].as<std::string>();
+        edges_str = result["edges"].as<std::string>();
+    } catch (const cxxopts::exceptions::exception& e) {
+        std::cerr << "taskman: " << e.what() << "\n";
+        return 1;
+    }
+    if (!TaskFormatter::is_valid_format(format)) {
+        std::cerr << "taskman: --format must be json or text\n";
+        return 1;
+    }
+    if (edges_str == "-") {
+        edges_str.assign(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+    }
+
+    nlohmann::json edges = nlohmann::json::parse(edges_str, nullptr, false);
+    if (edges.is_discarded() || !edges.is_array()) {
+        std::cerr << "taskman: --edges must be a JSON array\n";
+        return 1;
+    }
+    if (edges.empty()) {
+        std::cerr << "taskman: task:dep:batch requires at least one edge\n";
+        return 1;
+    }
+    std::vector<TaskDependencyEdit> edits;
+    for (size_t i = 0; i < edges.size(); ++i) {
+        const auto& e = edges[i];
+        if (!e.is_object() || !e.contains("task-id") || !e["task-id"].is_string()
+            || !e.contains("dep-id") || !e["dep-id"].is_string()) {
+            std::cerr << "taskman: edge " << i << ": task-id and dep-id are required\n";
+            return 1;
+        }
+        std::string op = "add";
+        if (e.contains("op")) op = e["op"].is_string() ? e["op"].get<std::string>() : "";
+        if (op != "add" && op != "remove") {
+            std::cerr << "taskman: edge " << i << ": op must be add or remove\n";
+            return 1;
+        }
+        TaskDependencyEdit edit;
+        edit.remove = (op == "remove");
+        edit.task_id = e["task-id"].get<std::string>();
+        edit.depends_on = e["dep-id"].get<std::string>();
+        edits.push_back(std::move(edit));
+    }
+
+    int added = 0, removed = 0;
+    if (!service_.apply_dependency_batch(edits, added, removed)) {
+        return 1;
+    }
+    formatter_.format_dep_batch(added, removed, format, std::cout);
+    return 0;
+}
+
+namespace {
+
+/** Valeur chaîne d'un élément de lot : absente ou null → nullopt ; false si ce n'est pas une chaîne. */
+bool item_string(const nlohmann::json& item, const char* key, std::optional<std::string>& out) {
+    auto it = item.find(key);
+    if (it == item.end() || it->is_null()) return true;
+    if (!it->is_string()) return false;
+    out = it->get<std::string>();
+    return true;
+}
+
+/** sort-order d'un élément de lot : entier JSON ou chaîne décimale. */
+bool item_int(const nlohmann::json& item, const char* key, std::optional<int>& out) {
+    auto it = item.find(key);
+    if (it == item.end() || it->is_null()) return true;
+    if (it->is_number_integer()) {
+        out = it->get<int>();
+        return true;
+    }
+    if (!it->is_string()) return false;
+    try {
+        size_t pos = 0;
+        out = std::stoi(it->get<std::string>(), &pos);
+        return pos == it->get<std::string>().size();
+    } catch (...) {
+        return false;
+    }
+}
+
+/** Vérifie qu'un élément de lot est un objet dont toutes les clés sont connues (fautes de frappe). */
+bool item_keys(const nlohmann::json& item, size_t index, std::initializer_list<const char*> allowed) {
+    if (!item.is_object()) {
+        diag() << "taskman: task " << index << ": must be an object\n";
+        return false;
+    }
+    for (const auto& [key, value] : item.items()) {
+        bool known = false;
+        for (const char* k : allowed) known = known || key == k;
+        if (!known) {
+            diag() << "taskman: task " << index << ": unknown key: " << key << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool TaskCommandParser::bulk_add_items(const nlohmann::json& tasks, std::vector<TaskBulkAddItem>& items) {
+    items.clear();
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        const auto& t = tasks[i];
+        if (!item_keys(t, i, {"key", "title", "phase", "description", "role", "creator", "milestone",
+                              "sort-order", "deps"})) {
+            return false;
+        }
+        TaskBulkAddItem item;
+        std::optional<std::string> title, phase;
+        if (!item_string(t, "key", item.key) || !item_string(t, "title", title) || !item_string(t, "phase", phase)
+            || !item_string(t, "description", item.task.description) || !item_string(t, "role", item.task.role)
+            || !item_string(t, "creator", item.task.creator) || !item_string(t, "milestone", item.task.milestone_id)) {
+            diag() << "taskman: task " << i << ": values must be strings\n";
+            return false;
+        }
+        if (!item_int(t, "sort-order", item.task.sort_order)) {
+            diag() << "taskman: task " << i << ": sort-order must be an integer\n";
+            return false;
+        }
+        item.task.title = title.value_or("");
+        item.task.phase_id = phase.value_or("");
+        if (t.contains("deps")) {
+            const auto& deps = t["deps"];
+            if (!deps.is_array()) {
+                diag() << "taskman: task " << i << ": deps must be an array of keys or task IDs\n";
+                return false;
+            }
+            for (const auto& dep : deps) {
+                if (!dep.is_string() || dep.get<std::string>().empty()) {
+                    diag() << "taskman: task " << i << ": deps must be an array of keys or task IDs\n";
+                    return false;
+                }
+                item.deps.push_back(dep.get<std::string>());
+            }
+        }
+        items.push_back(std::move(item));
+    }
+    return true;
+}
+
+bool TaskCommandParser::bulk_edit_items(const nlohmann::json& tasks, std::vector<TaskChanges>& changes) {
+    changes.clear();
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        const auto& t = tasks[i];
+        if (!item_keys(t, i, {"id", "title", "description", "status", "role", "creator", "milestone", "sort-order"})) {
+            return false;
+        }
+        TaskChanges c;
+        std::optional<std::string> id;
+        if (!item_string(t, "id", id) || !item_string(t, "title", c.title)
+            || !item_string(t, "description", c.description) || !item_string(t, "status", c.status)
+            || !item_string(t, "role", c.role) || !item_string(t, "creator", c.creator)
+            || !item_string(t, "milestone", c.milestone_id)) {
+            diag() << "taskman: task " << i << ": values must be strings\n";
+            return false;
+        }
+        if (!item_int(t, "sort-order", c.sort_order)) {
+            diag() << "taskman: task " << i << ": sort-order must be an integer\n";
+            return false;
+        }
+        c.id = id.value_or("");
+        changes.push_back(std::move(c));
+    }
+    return true;
+}
+
+int TaskCommandParser::parse_bulk_options(int argc, char* argv[], const char* command, const char* description,
+                                          nlohmann::json& tasks, std::string& format) {
+    cxxopts::Options opts(std::string("taskman ") + command, description);
+    opts.add_options()
+        ("tasks", "JSON array of task objects; - reads stdin", cxxopts::value<std::string>())
+        ("format", "Output: json or text", cxxopts::value<std::string>()->default_value("json"));
+
+    for (int i = 0; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0) {
+            std::cout << opts.help() << '\n';
+            return 0;
+        }
+    }
+    cxxopts::ParseResult result;
+    std::string tasks_str;
+    try {
+        result = opts.parse(argc, argv);
+        if (!result.count("tasks")) {
+            std::cerr << "taskman: --tasks is required\n";
+            return 1;
+        }
+        format = result["format"].as<std::string>();
+        tasks_str = result["tasks"].as<std::string>();
+    } catch (const cxxopts::exceptions::exception& e) {
+        std::cerr << "taskman: " << e.what() << "\n";
+        return 1;
+    }
+    if (!TaskFormatter::is_valid_format(format)) {
+        std::cerr << "taskman: --format must be json or text\n";
+        return 1;
+    }
+    if (tasks_str == "-") {
+        tasks_str.assign(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+    }
+    tasks = nlohmann::json::parse(tasks_str, nullptr, false);
+    if (tasks.is_discarded() || !tasks.is_array()) {
+        std::cerr << "taskman: --tasks must be a JSON array\n";
+        return 1;
+    }
+    return -1;
+}
+
+int TaskCommandParser::parse_bulk_add(int argc, char* argv[]) {
+    nlohmann::json tasks;
+    std::string format;
+    int rc = parse_bulk_options(argc, argv, "task:bulk-add",
+                                "Create several tasks and their dependencies in one transaction (all or nothing)",
+                                tasks, format);
+    if (rc >= 0) return rc;
+    std::vector<TaskBulkAddItem> items;
+    std::vector<std::string> ids;
+    if (!bulk_add_items(tasks, items) || !service_.bulk_add(items, ids)) {
+        return 1;
+    }
+    formatter_.format_bulk_add(items, ids, format, std::cout);
+    return 0;
+}
+
+int TaskCommandParser::parse_bulk_edit(int argc, char* argv[]) {
+    nlohmann::json tasks;
+    std::string format;
+    int rc = parse_bulk_options(argc, argv, "task:bulk-edit",
+                                "Edit several tasks in one transaction (all or nothing)", tasks, format);
+    if (rc >= 0) return rc;
+    std::vector<TaskChanges> changes;
+    std::vector<std::map<std::string, std::optional<std::string>>> unblocked;
+    if (!bulk_edit_items(tasks, changes) || !service_.bulk_edit(changes, unblocked)) {
+        return 1;
+    }
+    formatter_.format_bulk_edit(static_cast<int>(changes.size()), unblocked, format, std::cout);
+    return 0;
+}
+
 } // namespace taskman
@@ -10,7 +10,9 @@
 
 #include "task_service.hpp"
 #include "task_formatter.hpp"
+#include <nlohmann/json.hpp>
 #include <string>
+#include <vector>
 
 namespace taskman {
 
@@ -35,6 +37,10 @@ public:
      * Retourne 0 en cas de succès, 1 en cas d'erreur. */
     int parse_list(int argc, char* argv[]);
 
+    /** Parse et exécute la commande task:wait (détection des changements par data_version).
+     * Retourne 0 en cas de succès (tâche prête ou délai expiré), 1 en cas d'erreur. */
+    int parse_wait(int argc, char* argv[], DataVersion& data_version);
+
     /** Parse et exécute la commande task:edit.
      * Retourne 0 en cas de succès, 1 en cas d'erreur. */
     int parse_edit(int argc, char* argv[]);
@@ -47,10 +53,36 @@ public:
      * Retourne 0 en cas de succès, 1 en cas d'erreur. */
     int parse_dep_remove(int argc, char* argv[]);
 
+    /** Parse et exécute la commande task:dep:batch (arêtes JSON via --edges ou stdin).
+     * Retourne 0 en cas de succès, 1 en cas d'erreur. */
+    int parse_dep_batch(int argc, char* argv[]);
+
+    /** Parse et exécute la commande task:bulk-add (tâches JSON via --tasks ou stdin).
+     * Retourne 0 en cas de succès, 1 en cas d'erreur. */
+    int parse_bulk_add(int argc, char* argv[]);
+
+    /** Parse et exécute la commande task:bulk-edit (modifications JSON via --tasks ou stdin).
+     * Retourne 0 en cas de succès, 1 en cas d'erreur. */
+    int parse_bulk_edit(int argc, char* argv[]);
+
+    /** Convertit le tableau JSON de task:bulk-add (clés de task:add, plus key et deps).
+     * Partagé avec le handler MCP. Retourne false sur un élément invalide (message sur diag()). */
+    static bool bulk_add_items(const nlohmann::json& tasks, std::vector<TaskBulkAddItem>& items);
+
+    /** Convertit le tableau JSON de task:bulk-edit (clés de task:edit, id requis).
+     * Partagé avec le handler MCP. Retourne false sur un élément invalide (message sur diag()). */
+    static bool bulk_edit_items(const nlohmann::json& tasks, std::vector<TaskChanges>& changes);
+
 private:
     TaskService& service_;
     TaskFormatter& formatter_;
 
+    /** Options communes de task:bulk-add / task:bulk-edit : --tasks (tableau JSON, - = stdin) et --format.
+     * Retourne -1 si la commande doit continuer (tasks et format remplis), sinon le code de sortie
+     * (0 pour --help, 1 en cas d'erreur). */
+    static int parse_bulk_options(int argc, char* argv[], const char* command, const char* description,
+                                  nlohmann::json& tasks, std::string& format);
+
     /** Parse un entier depuis une chaîne.
      * Retourne true si le parsing réussit, false sinon. */
     static bool parse_int(const std::string& s, int& out);
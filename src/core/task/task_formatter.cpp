@@ -7,30 +7,194 @@
 
 namespace taskman {
 
+namespace {
+
+/** Tableau JSON des tâches écrit sans DOM (append_json), fields non vide : projection. */
+void append_tasks_json(std::string& out, const std::vector<std::map<std::string, std::optional<std::string>>>& tasks,
+                       const std::vector<std::string>& fields) {
+    if (fields.empty()) {
+        append_json_array<TASK_FIELDS>(out, tasks);
+        return;
+    }
+    out += '[';
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        if (i) out += ',';
+        append_json<TASK_FIELDS>(out, tasks[i], fields);
+    }
+    out += ']';
+}
+
+} // namespace
+
 void TaskFormatter::format_json(const std::map<std::string, std::optional<std::string>>& task, std::ostream& out) {
-    nlohmann::json obj;
-    task_to_json(obj, task);
-    out << obj.dump() << "\n";
+    std::string json;
+    append_json<TASK_FIELDS>(json, task);
+    out << json << "\n";
 }
 
 void TaskFormatter::format_text(const std::map<std::string, std::optional<std::string>>& task, std::ostream& out) {
-    print_task_text(task);
+    print_task_text(task, out);
+}
+
+void TaskFormatter::format_json_list(const std::vector<std::map<std::string, std::optional<std::string>>>& tasks, std::ostream& out,
+                                     const std::vector<std::string>& fields) {
+    std::string json;
+    append_tasks_json(json, tasks, fields);
+    out << json << "\n";
 }
 
-void TaskFormatter::format_json_list(const std::vector<std::map<std::string, std::optional<std::string>>>& tasks, std::ostream& out) {
-    nlohmann::json arr = nlohmann::json::array();
+void TaskFormatter::format_text_list(const std::vector<std::map<std::string, std::optional<std::string>>>& tasks, std::ostream& out,
+                                     const std::vector<std::string>& fields) {
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        if (i) out << "---\n";
+        if (fields.empty()) {
+            print_task_text(tasks[i], out);
+            continue;
+        }
+        for (const auto& field : fields) {
+            auto it = tasks[i].find(field);
+            out << field << ": " << (it != tasks[i].end() && it->second ? *it->second : "") << "\n";
+        }
+    }
+}
+
+nlohmann::json TaskFormatter::page_to_json(const std::vector<std::map<std::string, std::optional<std::string>>>& tasks,
+                                           const std::optional<std::string>& next_cursor,
+                                           const std::vector<std::string>& fields) {
+    nlohmann::json page;
+    nlohmann::json& arr = page["tasks"] = nlohmann::json::array();
     for (const auto& task : tasks) {
         nlohmann::json obj;
-        task_to_json(obj, task);
-        arr.push_back(obj);
+        if (fields.empty()) task_to_json(obj, task);
+        else task_to_json(obj, task, fields);
+        arr.push_back(std::move(obj));
     }
-    out << arr.dump() << "\n";
+    page["nextCursor"] = next_cursor ? nlohmann::json(*next_cursor) : nlohmann::json();
+    return page;
 }
 
-void TaskFormatter::format_text_list(const std::vector<std::map<std::string, std::optional<std::string>>>& tasks, std::ostream& out) {
-    for (size_t i = 0; i < tasks.size(); ++i) {
-        if (i) out << "---\n";
-        print_task_text(tasks[i]);
+void TaskFormatter::format_json_page(const std::vector<std::map<std::string, std::optional<std::string>>>& tasks,
+                                     const std::optional<std::string>& next_cursor, std::ostream& out,
+                                     const std::vector<std::string>& fields) {
+    // Même texte que page_to_json(…).dump() : clés triées, nextCursor avant tasks
+    std::string json = "{\"nextCursor\":";
+    if (next_cursor) append_json_string(json, *next_cursor);
+    else json += "null";
+    json += ",\"tasks\":";
+    append_tasks_json(json, tasks, fields);
+    json += '}';
+    out << json << "\n";
+}
+
+void TaskFormatter::format_text_page(const std::vector<std::map<std::string, std::optional<std::string>>>& tasks,
+                                     const std::optional<std::string>& next_cursor, std::ostream& out,
+                                     const std::vector<std::string>& fields) {
+    format_text_list(tasks, out, fields);
+    if (next_cursor) out << (tasks.empty() ? "" : "---\n") << "nextCursor: " << *next_cursor << "\n";
+}
+
+nlohmann::json TaskFormatter::wait_to_json(const std::vector<std::map<std::string, std::optional<std::string>>>& tasks,
+                                           bool timed_out, const std::vector<std::string>& fields) {
+    nlohmann::json result = page_to_json(tasks, std::nullopt, fields);
+    result.erase("nextCursor");
+    result["timed_out"] = timed_out;
+    return result;
+}
+
+void TaskFormatter::format_json_wait(const std::vector<std::map<std::string, std::optional<std::string>>>& tasks,
+                                     bool timed_out, std::ostream& out, const std::vector<std::string>& fields) {
+    out << wait_to_json(tasks, timed_out, fields).dump() << "\n";
+}
+
+void TaskFormatter::format_text_wait(const std::vector<std::map<std::string, std::optional<std::string>>>& tasks,
+                                     bool timed_out, std::ostream& out, const std::vector<std::string>& fields) {
+    if (timed_out) {
+        out << "timed out: no ready task\n";
+        return;
+    }
+    format_text_list(tasks, out, fields);
+}
+
+nlohmann::json TaskFormatter::unblocked_to_json(const std::string& id,
+                                                const std::vector<std::map<std::string, std::optional<std::string>>>& unblocked) {
+    nlohmann::json obj;
+    obj["id"] = id;
+    obj["status"] = "done";
+    obj["unblocked"] = nlohmann::json::array();
+    for (const auto& row : unblocked) {
+        nlohmann::json t;
+        for (const char* key : {"id", "title", "role"}) {
+            auto it = row.find(key);
+            if (it != row.end() && it->second.has_value()) t[key] = *it->second;
+            else t[key] = nullptr;
+        }
+        obj["unblocked"].push_back(t);
+    }
+    return obj;
+}
+
+void TaskFormatter::format_unblocked_json(const std::string& id,
+                                          const std::vector<std::map<std::string, std::optional<std::string>>>& unblocked,
+                                          std::ostream& out) {
+    out << unblocked_to_json(id, unblocked).dump() << "\n";
+}
+
+void TaskFormatter::format_dep_batch(int added, int removed, const std::string& format, std::ostream& out) {
+    if (format == "text") {
+        out << "added: " << added << "\nremoved: " << removed << "\n";
+        return;
+    }
+    nlohmann::json obj;
+    obj["added"] = added;
+    obj["removed"] = removed;
+    out << obj.dump() << "\n";
+}
+
+nlohmann::json TaskFormatter::bulk_add_to_json(const std::vector<TaskBulkAddItem>& items,
+                                               const std::vector<std::string>& ids) {
+    nlohmann::json obj;
+    obj["ids"] = ids;
+    obj["keys"] = nlohmann::json::object();
+    for (size_t i = 0; i < items.size() && i < ids.size(); ++i) {
+        if (items[i].key) obj["keys"][*items[i].key] = ids[i];
+    }
+    return obj;
+}
+
+void TaskFormatter::format_bulk_add(const std::vector<TaskBulkAddItem>& items, const std::vector<std::string>& ids,
+                                    const std::string& format, std::ostream& out) {
+    if (format != "text") {
+        out << bulk_add_to_json(items, ids).dump() << "\n";
+        return;
+    }
+    for (size_t i = 0; i < items.size() && i < ids.size(); ++i) {
+        if (items[i].key) out << *items[i].key << ": ";
+        out << ids[i] << "\n";
+    }
+}
+
+nlohmann::json TaskFormatter::bulk_edit_to_json(int updated,
+                                                const std::vector<std::map<std::string, std::optional<std::string>>>& unblocked) {
+    nlohmann::json obj = unblocked_to_json("", unblocked);
+    obj.erase("id");
+    obj.erase("status");
+    obj["updated"] = updated;
+    return obj;
+}
+
+void TaskFormatter::format_bulk_edit(int updated,
+                                     const std::vector<std::map<std::string, std::optional<std::string>>>& unblocked,
+                                     const std::string& format, std::ostream& out) {
+    if (format != "text") {
+        out << bulk_edit_to_json(updated, unblocked).dump() << "\n";
+        return;
+    }
+    out << "updated: " << updated << "\n";
+    for (const auto& row : unblocked) {
+        auto id = row.find("id");
+        auto title = row.find("title");
+        out << "unblocked: " << (id != row.end() ? id->second.value_or("") : "") << " "
+            << (title != row.end() ? title->second.value_or("") : "") << "\n";
     }
 }
 
@@ -38,4 +202,8 @@ bool TaskFormatter::is_valid_format(const std::string& format) {
     return format == "json" || format == "text";
 }
 
+bool TaskFormatter::is_valid_list_format(const std::string& format) {
+    return is_valid_format(format) || format == "table" || format == "ndjson";
+}
+
 } // namespace taskman
@@ -8,6 +8,7 @@
 #ifndef TASKMAN_TASK_FORMATTER_HPP
 #define TASKMAN_TASK_FORMATTER_HPP
 
+#include "task_service.hpp"
 #include "util/formats.hpp"
 #include <map>
 #include <nlohmann/json.hpp>
@@ -29,16 +30,89 @@ public:
     static void format_text(const std::map<std::string, std::optional<std::string>>& task, std::ostream& out);
 
     /** Formate une liste de tâches en JSON.
+     * fields non vide : seuls ces champs sont émis (projection --fields).
      * Écrit le résultat dans le stream fourni. */
-    static void format_json_list(const std::vector<std::map<std::string, std::optional<std::string>>>& tasks, std::ostream& out);
+    static void format_json_list(const std::vector<std::map<std::string, std::optional<std::string>>>& tasks, std::ostream& out,
+                                 const std::vector<std::string>& fields = {});
 
     /** Formate une liste de tâches en texte lisible.
+     * fields non vide : une ligne "champ: valeur" par champ, dans l'ordre donné.
      * Écrit le résultat dans le stream fourni. */
-    static void format_text_list(const std::vector<std::map<std::string, std::optional<std::string>>>& tasks, std::ostream& out);
+    static void format_text_list(const std::vector<std::map<std::string, std::optional<std::string>>>& tasks, std::ostream& out,
+                                 const std::vector<std::string>& fields = {});
+
+    /** Construit une page de task:list --limit/--cursor : {"tasks":[…], "nextCursor": jeton ou null}.
+     * fields : voir format_json_list. */
+    static nlohmann::json page_to_json(const std::vector<std::map<std::string, std::optional<std::string>>>& tasks,
+                                       const std::optional<std::string>& next_cursor,
+                                       const std::vector<std::string>& fields = {});
+
+    /** Formate une page de tâches en JSON (voir page_to_json).
+     * Écrit le résultat dans le stream fourni. */
+    static void format_json_page(const std::vector<std::map<std::string, std::optional<std::string>>>& tasks,
+                                 const std::optional<std::string>& next_cursor, std::ostream& out,
+                                 const std::vector<std::string>& fields = {});
+
+    /** Formate une page de tâches en texte : format_text_list, puis "nextCursor: jeton" s'il reste des tâches.
+     * Écrit le résultat dans le stream fourni. */
+    static void format_text_page(const std::vector<std::map<std::string, std::optional<std::string>>>& tasks,
+                                 const std::optional<std::string>& next_cursor, std::ostream& out,
+                                 const std::vector<std::string>& fields = {});
+
+    /** Construit le résultat de task:wait : {"tasks":[…], "timed_out": bool}.
+     * fields : voir format_json_list. */
+    static nlohmann::json wait_to_json(const std::vector<std::map<std::string, std::optional<std::string>>>& tasks,
+                                       bool timed_out, const std::vector<std::string>& fields = {});
+
+    /** Formate le résultat de task:wait en JSON (voir wait_to_json).
+     * Écrit le résultat dans le stream fourni. */
+    static void format_json_wait(const std::vector<std::map<std::string, std::optional<std::string>>>& tasks,
+                                 bool timed_out, std::ostream& out, const std::vector<std::string>& fields = {});
+
+    /** Formate le résultat de task:wait en texte : format_text_list, ou "timed out: no ready task".
+     * Écrit le résultat dans le stream fourni. */
+    static void format_text_wait(const std::vector<std::map<std::string, std::optional<std::string>>>& tasks,
+                                 bool timed_out, std::ostream& out, const std::vector<std::string>& fields = {});
+
+    /** Construit le résultat de task:edit --status done : {"id", "status":"done", "unblocked":[{id, title, role}]}. */
+    static nlohmann::json unblocked_to_json(const std::string& id,
+                                            const std::vector<std::map<std::string, std::optional<std::string>>>& unblocked);
+
+    /** Formate le résultat de task:edit --status done (voir unblocked_to_json).
+     * Écrit le résultat dans le stream fourni. */
+    static void format_unblocked_json(const std::string& id,
+                                      const std::vector<std::map<std::string, std::optional<std::string>>>& unblocked,
+                                      std::ostream& out);
+
+    /** Formate le résultat de task:dep:batch ({"added":N,"removed":M} ou texte).
+     * Écrit le résultat dans le stream fourni. */
+    static void format_dep_batch(int added, int removed, const std::string& format, std::ostream& out);
+
+    /** Construit le résultat de task:bulk-add : {"ids":[…], "keys":{clé: id}} (ids dans l'ordre du lot,
+     * keys pour les éléments qui ont une clé temporaire). */
+    static nlohmann::json bulk_add_to_json(const std::vector<TaskBulkAddItem>& items, const std::vector<std::string>& ids);
+
+    /** Formate le résultat de task:bulk-add (JSON, ou une ligne par tâche "[clé: ]id").
+     * Écrit le résultat dans le stream fourni. */
+    static void format_bulk_add(const std::vector<TaskBulkAddItem>& items, const std::vector<std::string>& ids,
+                                const std::string& format, std::ostream& out);
+
+    /** Construit le résultat de task:bulk-edit : {"updated": N, "unblocked":[{id, title, role}]}. */
+    static nlohmann::json bulk_edit_to_json(int updated,
+                                            const std::vector<std::map<std::string, std::optional<std::string>>>& unblocked);
+
+    /** Formate le résultat de task:bulk-edit (JSON, ou "updated: N" puis une ligne par tâche débloquée).
+     * Écrit le résultat dans le stream fourni. */
+    static void format_bulk_edit(int updated,
+                                 const std::vector<std::map<std::string, std::optional<std::string>>>& unblocked,
+                                 const std::string& format, std::ostream& out);
 
     /** Valide un format de sortie.
      * Retourne true si le format est valide (json ou text), false sinon. */
     static bool is_valid_format(const std::string& format);
+
+    /** Valide un format de sortie de liste : json, text, table (voir TableWriter) ou ndjson (voir NdjsonWriter). */
+    static bool is_valid_list_format(const std::string& format);
 };
 
 } // namespace taskman
@@ -3,10 +3,232 @@
  */
 
 #include "task_repository.hpp"
-#include <iostream>
+#include "infrastructure/db/transaction.hpp"
+#include "infrastructure/db/enum_columns.hpp"
+#include "util/diagnostics.hpp"
+#include <algorithm>
+#include <set>
 
 namespace taskman {
 
+namespace {
+    /** Nombre max d'éléments par requête IN / VALUES (reste sous la limite SQLITE_MAX_VARIABLE_NUMBER historique de 999). */
+    constexpr size_t IN_CHUNK = 400;
+
+    /** "?, ?, …" (n placeholders). */
+    std::string placeholders(size_t n) {
+        std::string s;
+        for (size_t i = 0; i < n; ++i) {
+            if (i) s += ", ";
+            s += "?";
+        }
+        return s;
+    }
+
+    /** "(?, ?), (?, ?), …" (n paires). */
+    std::string pair_placeholders(size_t n) {
+        std::string s;
+        for (size_t i = 0; i < n; ++i) {
+            if (i) s += ", ";
+            s += "(?, ?)";
+        }
+        return s;
+    }
+
+    /** Liste de colonnes du SELECT pour une projection (champs déjà validés contre columns()). */
+    std::string select_list(const TaskProjection& projection, const EnumColumns& enums) {
+        const auto& fields = projection.fields.empty() ? TaskRepository::columns() : projection.fields;
+        std::string sql;
+        for (const auto& field : fields) {
+            if (!sql.empty()) sql += ", ";
+            if (field == "description" && projection.description_max > 0) {
+                std::string n = std::to_string(projection.description_max);
+                sql += "CASE WHEN length(description) > " + n + " THEN substr(description, 1, " + n +
+                       ") || '…' ELSE description END AS description";
+            } else {
+                sql += enums.select(field);
+            }
+        }
+        return sql;
+    }
+
+    /** Colonnes de la clé de tri, ajoutées en fin de SELECT par list_page (voir PageSink). */
+    constexpr int KEY_COLUMNS = 4;
+    const char* const KEY_SELECT =
+        ", phase_id AS _key_phase_id, milestone_id AS _key_milestone_id, sort_order AS _key_sort_order, id AS _key_id";
+
+    /**
+     * Tâches situées après `after` dans l'ordre phase_id, milestone_id, sort_order, id (NULL en premier).
+     * Le premier terme borne le parcours de l'index sur le plus long préfixe non NULL de la clé ;
+     * le reste compare la clé colonne par colonne.
+     */
+    std::string after_condition(const TaskListKey& after, std::vector<std::optional<std::string>>& params) {
+        std::string sql;
+        params.push_back(after.phase_id);
+        if (!after.milestone_id.has_value()) {
+            sql = "phase_id >= ?";
+        } else if (!after.sort_order.has_value()) {
+            sql = "(phase_id, milestone_id) >= (?, ?)";
+            params.push_back(after.milestone_id);
+        } else {
+            sql = "(phase_id, milestone_id, sort_order) >= (?, ?, ?)";
+            params.push_back(after.milestone_id);
+            params.push_back(after.sort_order);
+        }
+        sql += " AND (phase_id > ? OR (phase_id = ? AND (";
+        params.push_back(after.phase_id);
+        params.push_back(after.phase_id);
+        if (after.milestone_id.has_value()) {
+            sql += "milestone_id > ?";
+            params.push_back(after.milestone_id);
+        } else {
+            sql += "milestone_id IS NOT NULL";
+        }
+        sql += " OR (milestone_id IS ? AND (";
+        params.push_back(after.milestone_id);
+        if (after.sort_order.has_value()) {
+            sql += "sort_order > ?";
+            params.push_back(after.sort_order);
+        } else {
+            sql += "sort_order IS NOT NULL";
+        }
+        sql += " OR (sort_order IS ? AND id > ?))))))";
+        params.push_back(after.sort_order);
+        params.push_back(after.id);
+        return sql;
+    }
+
+    /** Clause WHERE des listes et du comptage (vide sans filtre) ; ajoute les paramètres liés.
+     * after (optionnel) : seules les tâches situées après cette clé (pagination par curseur). */
+    std::string where_clause(const std::optional<std::string>& phase_id,
+                             const std::optional<std::string>& milestone_id,
+                             const std::optional<std::string>& status,
+                             const std::optional<std::string>& role,
+                             const std::optional<std::string>& blocked_filter,
+                             const std::optional<std::string>& done_filter,
+                             const EnumColumns& enums,
+                             std::vector<std::optional<std::string>>& params,
+                             const TaskListKey* after = nullptr) {
+        std::vector<std::string> where_parts;
+        if (phase_id.has_value()) {
+            where_parts.push_back("phase_id = ?");
+            params.push_back(*phase_id);
+        }
+        if (milestone_id.has_value()) {
+            where_parts.push_back("milestone_id = ?");
+            params.push_back(*milestone_id);
+        }
+        if (status.has_value()) {
+            where_parts.push_back("status = ?");
+            params.push_back(enums.bind("status", status));
+        }
+        if (role.has_value()) {
+            where_parts.push_back("role = ?");
+            params.push_back(enums.bind("role", role));
+        }
+        const std::string done = enums.literal("status", "done");
+        if (done_filter.has_value()) {
+            if (*done_filter == "done") {
+                where_parts.push_back("status = " + done);
+            } else if (*done_filter == "not_done") {
+                where_parts.push_back("(status IS NULL OR status != " + done + ")");
+            }
+        }
+        if (blocked_filter.has_value()) {
+            std::string sub = "SELECT 1 FROM task_deps d JOIN tasks dep ON dep.id = d.depends_on WHERE d.task_id = tasks.id "
+                              "AND (dep.status IS NULL OR dep.status != " + done + ")";
+            if (*blocked_filter == "blocked") {
+                where_parts.push_back("EXISTS (" + sub + ")");
+            } else if (*blocked_filter == "unblocked") {
+                where_parts.push_back("NOT EXISTS (" + sub + ")");
+            }
+        }
+        if (after) {
+            where_parts.push_back(after_condition(*after, params));
+        }
+        std::string sql;
+        for (size_t i = 0; i < where_parts.size(); ++i) {
+            sql += i ? " AND " : " WHERE ";
+            sql += where_parts[i];
+        }
+        return sql;
+    }
+
+    /** SELECT des listes de tâches (projection, filtres, tri), sans LIMIT. */
+    std::string list_sql(const std::optional<std::string>& phase_id,
+                         const std::optional<std::string>& milestone_id,
+                         const std::optional<std::string>& status,
+                         const std::optional<std::string>& role,
+                         const std::optional<std::string>& blocked_filter,
+                         const std::optional<std::string>& done_filter,
+                         const TaskProjection& projection,
+                         const EnumColumns& enums,
+                         std::vector<std::optional<std::string>>& params) {
+        return "SELECT " + select_list(projection, enums) + " FROM tasks" +
+               where_clause(phase_id, milestone_id, status, role, blocked_filter, done_filter, enums, params) +
+               " ORDER BY phase_id, milestone_id, sort_order, id";
+    }
+
+    /**
+     * RowSink d'une page (list_page) : transmet au plus limit lignes à inner, sans les KEY_COLUMNS
+     * colonnes de clé, et retient la clé de la dernière ligne transmise si une ligne suit.
+     */
+    class PageSink : public RowSink {
+    public:
+        PageSink(RowSink& inner, int limit) : inner_(inner), limit_(limit) {}
+
+        void columns(const RowCursor& cursor) override {
+            inner_.columns(cursor.first_columns(cursor.size() - KEY_COLUMNS));
+        }
+
+        void row(const RowCursor& cursor) override {
+            if (rows_ == limit_) {
+                has_more_ = true;
+                return;
+            }
+            ++rows_;
+            int n = cursor.size() - KEY_COLUMNS;
+            inner_.row(cursor.first_columns(n));
+            if (rows_ < limit_) return;
+            last_.phase_id = std::string(cursor.text(n));
+            last_.milestone_id = cursor.is_null(n + 1) ? std::nullopt
+                                                       : std::optional<std::string>(std::string(cursor.text(n + 1)));
+            last_.sort_order = cursor.is_null(n + 2) ? std::nullopt
+                                                     : std::optional<std::string>(std::string(cursor.text(n + 2)));
+            last_.id = std::string(cursor.text(n + 3));
+        }
+
+        std::optional<TaskListKey> next() const {
+            return has_more_ ? std::optional<TaskListKey>(last_) : std::nullopt;
+        }
+
+    private:
+        RowSink& inner_;
+        int limit_;
+        int rows_ = 0;
+        bool has_more_ = false;
+        TaskListKey last_;
+    };
+
+    /** RowSink qui construit les maps colonne → valeur (comme QueryExecutor::query). */
+    class MapSink : public RowSink {
+    public:
+        explicit MapSink(std::vector<std::map<std::string, std::optional<std::string>>>& rows) : rows_(rows) {}
+
+        void row(const RowCursor& cursor) override {
+            std::map<std::string, std::optional<std::string>> row;
+            for (int i = 0; i < cursor.size(); ++i) {
+                row[cursor.name(i)] = cursor.is_null(i) ? std::nullopt
+                                                        : std::optional<std::string>(std::string(cursor.text(i)));
+            }
+            rows_.push_back(std::move(row));
+        }
+
+    private:
+        std::vector<std::map<std::string, std::optional<std::string>>>& rows_;
+    };
+}
+
 bool TaskRepository::add(const std::string& id,
                          const std::string& phase_id,
                          const std::optional<std::string>& milestone_id,
@@ -24,76 +246,82 @@ bool TaskRepository::add(const std::string& id,
     params.push_back(milestone_id);
     params.push_back(title);
     params.push_back(description);
-    params.push_back(status);
+    EnumColumns enums(executor_);
+    params.push_back(enums.bind("status", status));
     params.push_back(sort_order.has_value()
                      ? std::optional<std::string>(std::to_string(*sort_order))
                      : std::nullopt);
-    params.push_back(role);
-    params.push_back(creator);
+    params.push_back(enums.bind("role", role));
+    params.push_back(enums.bind("creator", creator));
     return executor_.run(sql, params);
 }
 
+const std::vector<std::string>& TaskRepository::columns() {
+    static const std::vector<std::string> cols = [] {
+        std::vector<std::string> names;
+        for (const auto& field : TASK_FIELDS) {
+            if (field.sql_type) names.emplace_back(field.column);
+        }
+        return names;
+    }();
+    return cols;
+}
+
 std::map<std::string, std::optional<std::string>> TaskRepository::get_by_id(const std::string& id) {
-    auto rows = executor_.query(
-        "SELECT id, phase_id, milestone_id, title, description, status, sort_order, role, creator, created_at, updated_at FROM tasks WHERE id = ?",
-        {id});
+    std::string sql = "SELECT " + EnumColumns(executor_).select_list<TASK_FIELDS>() + " FROM tasks WHERE id = ?";
+    auto rows = executor_.query(sql.c_str(), {id});
     if (rows.empty()) {
         return {};
     }
     return rows[0];
 }
 
+std::vector<std::map<std::string, std::optional<std::string>>> TaskRepository::get_by_ids(
+    const std::vector<std::string>& ids) {
+    std::map<std::string, std::map<std::string, std::optional<std::string>>> found;
+    const std::string select = "SELECT " + EnumColumns(executor_).select_list<TASK_FIELDS>() + " FROM tasks WHERE id IN (";
+    for (size_t start = 0; start < ids.size(); start += IN_CHUNK) {
+        size_t n = std::min(IN_CHUNK, ids.size() - start);
+        std::string sql = select + placeholders(n) + ")";
+        std::vector<std::optional<std::string>> params(ids.begin() + start, ids.begin() + start + n);
+        for (auto& row : executor_.query(sql.c_str(), params)) {
+            std::string id = row["id"].value_or("");
+            found.emplace(std::move(id), std::move(row));
+        }
+    }
+    std::vector<std::map<std::string, std::optional<std::string>>> tasks;
+    for (const auto& id : ids) {
+        auto it = found.find(id);
+        if (it != found.end()) tasks.push_back(it->second);
+    }
+    return tasks;
+}
+
 std::vector<std::map<std::string, std::optional<std::string>>> TaskRepository::list(
     const std::optional<std::string>& phase_id,
     const std::optional<std::string>& status,
     const std::optional<std::string>& role,
     const std::optional<std::string>& blocked_filter,
-    const std::optional<std::string>& done_filter) {
-    std::string sql = "SELECT id, phase_id, milestone_id, title, description, status, sort_order, role, creator, created_at, updated_at FROM tasks";
-    std::vector<std::string> where_parts;
+    const std::optional<std::string>& done_filter,
+    const TaskProjection& projection) {
     std::vector<std::optional<std::string>> params;
+    std::string sql = list_sql(phase_id, std::nullopt, status, role, blocked_filter, done_filter, projection,
+                               EnumColumns(executor_), params);
+    return executor_.query(sql.c_str(), params);
+}
 
-    if (phase_id.has_value()) {
-        where_parts.push_back("phase_id = ?");
-        params.push_back(*phase_id);
-    }
-    if (status.has_value()) {
-        where_parts.push_back("status = ?");
-        params.push_back(*status);
-    }
-    if (role.has_value()) {
-        where_parts.push_back("role = ?");
-        params.push_back(*role);
-    }
-    if (done_filter.has_value()) {
-        if (*done_filter == "done") {
-            where_parts.push_back("status = 'done'");
-        } else if (*done_filter == "not_done") {
-            where_parts.push_back("(status IS NULL OR status != 'done')");
-        }
-    }
-    if (blocked_filter.has_value()) {
-        const char* sub = "SELECT 1 FROM task_deps d JOIN tasks dep ON dep.id = d.depends_on WHERE d.task_id = tasks.id AND (dep.status IS NULL OR dep.status != 'done')";
-        if (*blocked_filter == "blocked") {
-            where_parts.push_back(std::string("EXISTS (") + sub + ")");
-        } else if (*blocked_filter == "unblocked") {
-            where_parts.push_back(std::string("NOT EXISTS (") + sub + ")");
-        }
-    }
-    if (!where_parts.empty()) {
-        sql += " WHERE ";
-        for (size_t i = 0; i < where_parts.size(); ++i) {
-            if (i) sql += " AND ";
-            sql += where_parts[i];
-        }
-    }
-    sql += " ORDER BY phase_id, milestone_id, sort_order, id";
-
-    if (params.empty()) {
-        return executor_.query(sql.c_str());
-    } else {
-        return executor_.query(sql.c_str(), params);
-    }
+bool TaskRepository::list_into(
+    const std::optional<std::string>& phase_id,
+    const std::optional<std::string>& status,
+    const std::optional<std::string>& role,
+    const std::optional<std::string>& blocked_filter,
+    const std::optional<std::string>& done_filter,
+    const TaskProjection& projection,
+    RowSink& sink) {
+    std::vector<std::optional<std::string>> params;
+    std::string sql = list_sql(phase_id, std::nullopt, status, role, blocked_filter, done_filter, projection,
+                               EnumColumns(executor_), params);
+    return executor_.query_into(sql.c_str(), params, sink);
 }
 
 std::vector<std::map<std::string, std::optional<std::string>>> TaskRepository::list_paginated(
@@ -104,106 +332,91 @@ std::vector<std::map<std::string, std::optional<std::string>>> TaskRepository::l
     const std::optional<std::string>& blocked_filter,
     const std::optional<std::string>& done_filter,
     int limit,
-    int offset) {
-    std::string sql = "SELECT id, phase_id, milestone_id, title, description, status, sort_order, role, creator, created_at, updated_at FROM tasks";
-    std::vector<std::string> where_parts;
+    int offset,
+    const TaskProjection& projection) {
     std::vector<std::optional<std::string>> params;
-
-    if (phase_id.has_value()) {
-        where_parts.push_back("phase_id = ?");
-        params.push_back(*phase_id);
-    }
-    if (milestone_id.has_value()) {
-        where_parts.push_back("milestone_id = ?");
-        params.push_back(*milestone_id);
-    }
-    if (status.has_value()) {
-        where_parts.push_back("status = ?");
-        params.push_back(*status);
-    }
-    if (role.has_value()) {
-        where_parts.push_back("role = ?");
-        params.push_back(*role);
-    }
-    if (done_filter.has_value()) {
-        if (*done_filter == "done") {
-            where_parts.push_back("status = 'done'");
-        } else if (*done_filter == "not_done") {
-            where_parts.push_back("(status IS NULL OR status != 'done')");
-        }
-    }
-    if (blocked_filter.has_value()) {
-        const char* sub = "SELECT 1 FROM task_deps d JOIN tasks dep ON dep.id = d.depends_on WHERE d.task_id = tasks.id AND (dep.status IS NULL OR dep.status != 'done')";
-        if (*blocked_filter == "blocked") {
-            where_parts.push_back(std::string("EXISTS (") + sub + ")");
-        } else if (*blocked_filter == "unblocked") {
-            where_parts.push_back(std::string("NOT EXISTS (") + sub + ")");
-        }
-    }
-    if (!where_parts.empty()) {
-        sql += " WHERE ";
-        for (size_t i = 0; i < where_parts.size(); ++i) {
-            if (i) sql += " AND ";
-            sql += where_parts[i];
-        }
-    }
-    sql += " ORDER BY phase_id, milestone_id, sort_order, id LIMIT ? OFFSET ?";
+    std::string sql = list_sql(phase_id, milestone_id, status, role, blocked_filter, done_filter, projection,
+                               EnumColumns(executor_), params);
+    sql += " LIMIT ? OFFSET ?";
     params.push_back(std::to_string(limit));
     params.push_back(std::to_string(offset));
-
     return executor_.query(sql.c_str(), params);
 }
 
-int TaskRepository::count(
+bool TaskRepository::list_paginated_into(
     const std::optional<std::string>& phase_id,
     const std::optional<std::string>& milestone_id,
     const std::optional<std::string>& status,
     const std::optional<std::string>& role,
     const std::optional<std::string>& blocked_filter,
-    const std::optional<std::string>& done_filter) {
-    std::string sql = "SELECT COUNT(*) as count FROM tasks";
-    std::vector<std::string> where_parts;
+    const std::optional<std::string>& done_filter,
+    int limit,
+    int offset,
+    const TaskProjection& projection,
+    RowSink& sink) {
     std::vector<std::optional<std::string>> params;
+    std::string sql = list_sql(phase_id, milestone_id, status, role, blocked_filter, done_filter, projection,
+                               EnumColumns(executor_), params);
+    sql += " LIMIT ? OFFSET ?";
+    params.push_back(std::to_string(limit));
+    params.push_back(std::to_string(offset));
+    return executor_.query_into(sql.c_str(), params, sink);
+}
 
-    if (phase_id.has_value()) {
-        where_parts.push_back("phase_id = ?");
-        params.push_back(*phase_id);
-    }
-    if (milestone_id.has_value()) {
-        where_parts.push_back("milestone_id = ?");
-        params.push_back(*milestone_id);
-    }
-    if (status.has_value()) {
-        where_parts.push_back("status = ?");
-        params.push_back(*status);
-    }
-    if (role.has_value()) {
-        where_parts.push_back("role = ?");
-        params.push_back(*role);
-    }
-    if (done_filter.has_value()) {
-        if (*done_filter == "done") {
-            where_parts.push_back("status = 'done'");
-        } else if (*done_filter == "not_done") {
-            where_parts.push_back("(status IS NULL OR status != 'done')");
-        }
-    }
-    if (blocked_filter.has_value()) {
-        const char* sub = "SELECT 1 FROM task_deps d JOIN tasks dep ON dep.id = d.depends_on WHERE d.task_id = tasks.id AND (dep.status IS NULL OR dep.status != 'done')";
-        if (*blocked_filter == "blocked") {
-            where_parts.push_back(std::string("EXISTS (") + sub + ")");
-        } else if (*blocked_filter == "unblocked") {
-            where_parts.push_back(std::string("NOT EXISTS (") + sub + ")");
-        }
-    }
-    if (!where_parts.empty()) {
-        sql += " WHERE ";
-        for (size_t i = 0; i < where_parts.size(); ++i) {
-            if (i) sql += " AND ";
-            sql += where_parts[i];
-        }
+std::vector<std::map<std::string, std::optional<std::string>>> TaskRepository::list_page(
+    const std::optional<std::string>& phase_id,
+    const std::optional<std::string>& status,
+    const std::optional<std::string>& role,
+    const std::optional<std::string>& blocked_filter,
+    const std::optional<std::string>& done_filter,
+    const std::optional<TaskListKey>& after,
+    int limit,
+    const TaskProjection& projection,
+    std::optional<TaskListKey>& next) {
+    std::vector<std::map<std::string, std::optional<std::string>>> rows;
+    MapSink sink(rows);
+    if (!list_page_into(phase_id, status, role, blocked_filter, done_filter, after, limit, projection, sink, next)) {
+        return {};
     }
+    return rows;
+}
+
+bool TaskRepository::list_page_into(
+    const std::optional<std::string>& phase_id,
+    const std::optional<std::string>& status,
+    const std::optional<std::string>& role,
+    const std::optional<std::string>& blocked_filter,
+    const std::optional<std::string>& done_filter,
+    const std::optional<TaskListKey>& after,
+    int limit,
+    const TaskProjection& projection,
+    RowSink& sink,
+    std::optional<TaskListKey>& next) {
+    next.reset();
+    std::vector<std::optional<std::string>> params;
+    EnumColumns enums(executor_);
+    std::string sql = "SELECT " + select_list(projection, enums) + KEY_SELECT + " FROM tasks" +
+                      where_clause(phase_id, std::nullopt, status, role, blocked_filter, done_filter, enums, params,
+                                   after ? &*after : nullptr) +
+                      " ORDER BY phase_id, milestone_id, sort_order, id LIMIT ?";
+    params.push_back(std::to_string(limit + 1));
+    PageSink page(sink, limit);
+    if (!executor_.query_into(sql.c_str(), params, page)) return false;
+    next = page.next();
+    return true;
+}
 
+int TaskRepository::count(
+    const std::optional<std::string>& phase_id,
+    const std::optional<std::string>& milestone_id,
+    const std::optional<std::string>& status,
+    const std::optional<std::string>& role,
+    const std::optional<std::string>& blocked_filter,
+    const std::optional<std::string>& done_filter) {
+    std::vector<std::optional<std::string>> params;
+    std::string sql = "SELECT COUNT(*) as count FROM tasks" +
+                      where_clause(phase_id, milestone_id, status, role, blocked_filter, done_filter,
+                                   EnumColumns(executor_), params);
     auto rows = executor_.query(sql.c_str(), params);
     if (rows.empty() || !rows[0].count("count")) {
         return 0;
@@ -222,9 +435,12 @@ bool TaskRepository::update(const std::string& id,
                             const std::optional<std::string>& role,
                             const std::optional<std::string>& milestone_id,
                             const std::optional<int>& sort_order,
-                            const std::optional<std::string>& creator) {
+                            const std::optional<std::string>& creator,
+                            std::vector<std::map<std::string, std::optional<std::string>>>* newly_unblocked) {
+    if (newly_unblocked) newly_unblocked->clear();
     std::vector<std::string> set_parts;
     std::vector<std::optional<std::string>> params;
+    EnumColumns enums(executor_);
 
     if (title.has_value()) {
         set_parts.push_back("title = ?");
@@ -236,11 +452,11 @@ bool TaskRepository::update(const std::string& id,
     }
     if (status.has_value()) {
         set_parts.push_back("status = ?");
-        params.push_back(*status);
+        params.push_back(enums.bind("status", status));
     }
     if (role.has_value()) {
         set_parts.push_back("role = ?");
-        params.push_back(*role);
+        params.push_back(enums.bind("role", role));
     }
     if (milestone_id.has_value()) {
         set_parts.push_back("milestone_id = ?");
@@ -252,7 +468,7 @@ bool TaskRepository::update(const std::string& id,
     }
     if (creator.has_value()) {
         set_parts.push_back("creator = ?");
-        params.push_back(*creator);
+        params.push_back(enums.bind("creator", creator));
     }
 
     if (set_parts.empty()) {
@@ -269,7 +485,129 @@ bool TaskRepository::update(const std::string& id,
     sql += " WHERE id = ?";
     params.push_back(id);
 
-    return executor_.run(sql.c_str(), params);
+    if (!newly_unblocked || !status.has_value() || *status != "done") {
+        return executor_.run(sql.c_str(), params);
+    }
+
+    // Passage à done : statut précédent, UPDATE et tâches débloquées dans la même transaction
+    Transaction tx(executor_);
+    if (!tx.active()) return false;
+    auto prev = executor_.query(("SELECT " + enums.select("status") + " FROM tasks WHERE id = ?").c_str(), {id});
+    if (!executor_.run(sql.c_str(), params)) return false;
+    if (!prev.empty() && prev[0]["status"] != std::optional<std::string>("done")) {
+        *newly_unblocked = find_newly_unblocked(id);
+    }
+    return tx.commit();
+}
+
+bool TaskRepository::add_many(const std::vector<TaskRecord>& tasks,
+                              const std::vector<TaskDependencyEdge>& deps,
+                              std::optional<TaskDependencyEdge>& cycle) {
+    cycle = std::nullopt;
+    std::vector<std::vector<std::optional<std::string>>> rows;
+    rows.reserve(tasks.size());
+    EnumColumns enums(executor_);
+    for (const auto& t : tasks) {
+        rows.push_back({t.id, t.phase_id, t.milestone_id, t.title, t.description, enums.bind("status", t.status),
+                        t.sort_order ? std::optional<std::string>(std::to_string(*t.sort_order)) : std::nullopt,
+                        enums.bind("role", t.role), enums.bind("creator", t.creator)});
+    }
+    std::vector<std::vector<std::optional<std::string>>> edges;
+    edges.reserve(deps.size());
+    for (const auto& edge : deps) edges.push_back({edge.first, edge.second});
+
+    Transaction tx(executor_);
+    if (!tx.active()) return false;
+    if (!executor_.run_many("INSERT INTO tasks (id, phase_id, milestone_id, title, description, status, sort_order, "
+                            "role, creator) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)", rows)) {
+        return false;
+    }
+    if (!edges.empty()) {
+        if (!executor_.run_many("INSERT INTO task_deps (task_id, depends_on) VALUES (?, ?)", edges)) return false;
+        cycle = find_dependency_cycle(deps);
+        if (cycle) return false;
+    }
+    return tx.commit();
+}
+
+bool TaskRepository::update_many(const std::vector<TaskChanges>& changes,
+                                 std::vector<std::map<std::string, std::optional<std::string>>>& newly_unblocked) {
+    newly_unblocked.clear();
+    std::vector<std::string> ids;
+    std::vector<std::vector<std::optional<std::string>>> rows;
+    rows.reserve(changes.size());
+    EnumColumns enums(executor_);
+    for (const auto& c : changes) {
+        ids.push_back(c.id);
+        rows.push_back({c.title, c.description, enums.bind("status", c.status), enums.bind("role", c.role),
+                        c.milestone_id,
+                        c.sort_order ? std::optional<std::string>(std::to_string(*c.sort_order)) : std::nullopt,
+                        enums.bind("creator", c.creator), c.id});
+    }
+
+    Transaction tx(executor_);
+    if (!tx.active()) return false;
+    // Statuts avant le lot : seuls les vrais passages à done débloquent des tâches
+    std::set<std::string> was_done;
+    for (const auto& row : get_by_ids(ids)) {
+        auto status = row.find("status");
+        if (status != row.end() && status->second == std::optional<std::string>("done")) {
+            was_done.insert(row.at("id").value_or(""));
+        }
+    }
+    if (!executor_.run_many("UPDATE tasks SET title = COALESCE(?, title), description = COALESCE(?, description), "
+                            "status = COALESCE(?, status), role = COALESCE(?, role), "
+                            "milestone_id = COALESCE(?, milestone_id), sort_order = COALESCE(?, sort_order), "
+                            "creator = COALESCE(?, creator), updated_at = datetime('now') WHERE id = ?", rows)) {
+        return false;
+    }
+    std::set<std::string> done_now, seen;
+    for (const auto& c : changes) {
+        if (c.status && *c.status == "done" && !was_done.count(c.id)) done_now.insert(c.id);
+    }
+    for (const auto& id : done_now) {
+        for (auto& row : find_newly_unblocked(id)) {
+            if (seen.insert(row["id"].value_or("")).second) newly_unblocked.push_back(std::move(row));
+        }
+    }
+    return tx.commit();
+}
+
+std::vector<std::map<std::string, std::optional<std::string>>> TaskRepository::find_newly_unblocked(const std::string& done_task_id) {
+    EnumColumns enums(executor_);
+    const std::string done = enums.literal("status", "done");
+    std::string sql = "SELECT t.id, t.title, " + enums.select("role", "t.") + " FROM task_deps d "
+                      "JOIN tasks t ON t.id = d.task_id "
+                      "WHERE d.depends_on = ? AND (t.status IS NULL OR t.status != " + done + ") "
+                      "AND NOT EXISTS (SELECT 1 FROM task_deps o JOIN tasks dep ON dep.id = o.depends_on "
+                      "WHERE o.task_id = t.id AND (dep.status IS NULL OR dep.status != " + done + ")) "
+                      "ORDER BY t.sort_order, t.id";
+    return executor_.query(sql.c_str(), {done_task_id});
+}
+
+std::vector<std::map<std::string, std::optional<std::string>>> TaskRepository::count_by_milestone_and_status() {
+    std::string sql = "SELECT phase_id, milestone_id, " + EnumColumns(executor_).select("status") +
+                      ", COUNT(*) AS count FROM tasks GROUP BY phase_id, milestone_id, tasks.status";
+    return executor_.query(sql.c_str(), {});
+}
+
+std::vector<std::map<std::string, std::optional<std::string>>> TaskRepository::find_open_dependencies(
+    const std::vector<std::string>& task_ids) {
+    std::vector<std::map<std::string, std::optional<std::string>>> rows;
+    EnumColumns enums(executor_);
+    const std::string select = "SELECT d.task_id, dep.id, dep.title, " + enums.select("status", "dep.") + ", " +
+                               enums.select("role", "dep.") + " FROM task_deps d JOIN tasks dep ON dep.id = d.depends_on "
+                               "WHERE d.task_id IN (";
+    const std::string done = enums.literal("status", "done");
+    for (size_t start = 0; start < task_ids.size(); start += IN_CHUNK) {
+        size_t n = std::min(IN_CHUNK, task_ids.size() - start);
+        std::string sql = select + placeholders(n) + ") AND (dep.status IS NULL OR dep.status != " + done + ") "
+                          "ORDER BY d.task_id, dep.sort_order, dep.id";
+        std::vector<std::optional<std::string>> params(task_ids.begin() + start, task_ids.begin() + start + n);
+        auto chunk = executor_.query(sql.c_str(), params);
+        rows.insert(rows.end(), std::make_move_iterator(chunk.begin()), std::make_move_iterator(chunk.end()));
+    }
+    return rows;
 }
 
 bool TaskRepository::add_dependency(const std::string& task_id, const std::string& depends_on) {
@@ -278,7 +616,7 @@ bool TaskRepository::add_dependency(const std::string& task_id, const std::strin
         "SELECT 1 FROM task_deps WHERE task_id = ? AND depends_on = ?",
         {task_id, depends_on});
     if (!rows_exist.empty()) {
-        std::cerr << "taskman: dependency already exists\n";
+        diag() << "taskman: dependency already exists\n";
         return false;
     }
     return executor_.run("INSERT INTO task_deps (task_id, depends_on) VALUES (?, ?)", {task_id, depends_on});
@@ -293,6 +631,93 @@ bool TaskRepository::exists(const std::string& id) {
     return !rows.empty();
 }
 
+std::vector<std::string> TaskRepository::find_missing_ids(const std::vector<std::string>& ids) {
+    std::set<std::string> found;
+    for (size_t start = 0; start < ids.size(); start += IN_CHUNK) {
+        size_t n = std::min(IN_CHUNK, ids.size() - start);
+        std::string sql = "SELECT id FROM tasks WHERE id IN (" + placeholders(n) + ")";
+        std::vector<std::optional<std::string>> params(ids.begin() + start, ids.begin() + start + n);
+        for (const auto& row : executor_.query(sql.c_str(), params)) {
+            auto it = row.find("id");
+            if (it != row.end() && it->second.has_value()) found.insert(*it->second);
+        }
+    }
+    std::vector<std::string> missing;
+    for (const auto& id : ids) {
+        if (!found.count(id)) missing.push_back(id);
+    }
+    return missing;
+}
+
+std::vector<TaskDependencyEdge> TaskRepository::find_existing_dependencies(const std::vector<TaskDependencyEdge>& edges) {
+    std::vector<TaskDependencyEdge> existing;
+    for (size_t start = 0; start < edges.size(); start += IN_CHUNK / 2) {
+        size_t n = std::min(IN_CHUNK / 2, edges.size() - start);
+        std::string sql = "SELECT task_id, depends_on FROM task_deps WHERE (task_id, depends_on) IN (VALUES "
+                          + pair_placeholders(n) + ")";
+        std::vector<std::optional<std::string>> params;
+        for (size_t i = start; i < start + n; ++i) {
+            params.push_back(edges[i].first);
+            params.push_back(edges[i].second);
+        }
+        for (const auto& row : executor_.query(sql.c_str(), params)) {
+            existing.emplace_back(row.at("task_id").value_or(""), row.at("depends_on").value_or(""));
+        }
+    }
+    return existing;
+}
+
+std::optional<TaskDependencyEdge> TaskRepository::find_dependency_cycle(const std::vector<TaskDependencyEdge>& edges) {
+    // Parcours en largeur depuis depends_on de chaque arête ; UNION déduplique donc termine même sur un cycle.
+    for (size_t start = 0; start < edges.size(); start += IN_CHUNK / 2) {
+        size_t n = std::min(IN_CHUNK / 2, edges.size() - start);
+        std::string sql =
+            "WITH RECURSIVE seed(task_id, depends_on) AS (VALUES " + pair_placeholders(n) + "), "
+            "reach(task_id, depends_on, node) AS ("
+            " SELECT task_id, depends_on, depends_on FROM seed"
+            " UNION"
+            " SELECT r.task_id, r.depends_on, d.depends_on FROM reach r JOIN task_deps d ON d.task_id = r.node"
+            ") "
+            "SELECT task_id, depends_on FROM reach WHERE node = task_id LIMIT 1";
+        std::vector<std::optional<std::string>> params;
+        for (size_t i = start; i < start + n; ++i) {
+            params.push_back(edges[i].first);
+            params.push_back(edges[i].second);
+        }
+        auto rows = executor_.query(sql.c_str(), params);
+        if (!rows.empty()) {
+            return TaskDependencyEdge(rows[0].at("task_id").value_or(""), rows[0].at("depends_on").value_or(""));
+        }
+    }
+    return std::nullopt;
+}
+
+bool TaskRepository::add_dependencies_unchecked(const std::vector<TaskDependencyEdge>& edges) {
+    std::vector<std::vector<std::optional<std::string>>> rows;
+    rows.reserve(edges.size());
+    for (const auto& edge : edges) rows.push_back({edge.first, edge.second});
+    return executor_.run_many("INSERT INTO task_deps (task_id, depends_on) VALUES (?, ?)", rows);
+}
+
+bool TaskRepository::apply_dependency_changes(const std::vector<TaskDependencyEdge>& to_remove,
+                                              const std::vector<TaskDependencyEdge>& to_add,
+                                              std::optional<TaskDependencyEdge>& cycle) {
+    cycle = std::nullopt;
+    Transaction tx(executor_);
+    if (!tx.active()) return false;
+    for (const auto& edge : to_remove) {
+        if (!remove_dependency(edge.first, edge.second)) return false;
+    }
+    for (const auto& edge : to_add) {
+        if (!executor_.run("INSERT INTO task_deps (task_id, depends_on) VALUES (?, ?)", {edge.first, edge.second})) {
+            return false;
+        }
+    }
+    cycle = find_dependency_cycle(to_add);
+    if (cycle) return false;
+    return tx.commit();
+}
+
 std::vector<std::map<std::string, std::optional<std::string>>> TaskRepository::get_dependencies(const std::string& task_id) {
     return executor_.query(
         "SELECT task_id, depends_on FROM task_deps WHERE task_id = ? ORDER BY depends_on",
@@ -313,6 +738,25 @@ std::vector<std::string> TaskRepository::get_note_ids_by_task_id(const std::stri
     return ids;
 }
 
+std::map<std::string, std::vector<std::string>> TaskRepository::get_note_ids_by_task_ids(
+    const std::vector<std::string>& task_ids) {
+    std::map<std::string, std::vector<std::string>> note_ids;
+    for (size_t start = 0; start < task_ids.size(); start += IN_CHUNK) {
+        size_t n = std::min(IN_CHUNK, task_ids.size() - start);
+        std::string sql = "SELECT task_id, id FROM task_notes WHERE task_id IN (" + placeholders(n)
+                          + ") ORDER BY task_id, created_at, id";
+        std::vector<std::optional<std::string>> params(task_ids.begin() + start, task_ids.begin() + start + n);
+        for (const auto& row : executor_.query(sql.c_str(), params)) {
+            auto task_it = row.find("task_id");
+            auto id_it = row.find("id");
+            if (task_it == row.end() || !task_it->second || id_it == row.end() || !id_it->second
+                || id_it->second->empty()) continue;
+            note_ids[*task_it->second].push_back(*id_it->second);
+        }
+    }
+    return note_ids;
+}
+
 std::vector<std::map<std::string, std::optional<std::string>>> TaskRepository::list_dependencies(
     const std::optional<std::string>& task_id,
     int limit,
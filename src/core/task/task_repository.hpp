@@ -11,10 +11,56 @@
 #include <map>
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace taskman {
 
+/** Arête de dépendance : first = task_id, second = depends_on. */
+using TaskDependencyEdge = std::pair<std::string, std::string>;
+
+/** Projection d'une liste de tâches, appliquée dans la liste de colonnes du SELECT.
+ * fields : colonnes lues, dans l'ordre de sortie (vide = toutes les colonnes).
+ * description_max : si > 0, description tronquée par SQLite à ce nombre de caractères (suffixe "…"). */
+struct TaskProjection {
+    std::vector<std::string> fields;
+    int description_max = 0;
+};
+
+/** Position dans l'ordre des listes (phase_id, milestone_id, sort_order, id), clé de reprise
+ * d'une pagination par curseur. Un milestone_id ou sort_order NULL est trié en premier (comme SQLite). */
+struct TaskListKey {
+    std::string phase_id;
+    std::optional<std::string> milestone_id;
+    std::optional<std::string> sort_order;
+    std::string id;
+};
+
+/** Tâche à insérer par add_many (mêmes colonnes que add). */
+struct TaskRecord {
+    std::string id;
+    std::string phase_id;
+    std::optional<std::string> milestone_id;
+    std::string title;
+    std::optional<std::string> description;
+    std::string status = "to_do";
+    std::optional<int> sort_order;
+    std::optional<std::string> role;
+    std::optional<std::string> creator;
+};
+
+/** Modification d'une tâche par update_many : les champs absents (nullopt) sont inchangés. */
+struct TaskChanges {
+    std::string id;
+    std::optional<std::string> title;
+    std::optional<std::string> description;
+    std::optional<std::string> status;
+    std::optional<std::string> role;
+    std::optional<std::string> milestone_id;
+    std::optional<int> sort_order;
+    std::optional<std::string> creator;
+};
+
 class TaskRepository {
 public:
     /** Constructeur prenant une référence à QueryExecutor. */
@@ -39,19 +85,28 @@ public:
      * Retourne un map vide si la tâche n'existe pas. */
     std::map<std::string, std::optional<std::string>> get_by_id(const std::string& id);
 
+    /** Récupère plusieurs tâches par ID (requête IN, par lots), dans l'ordre de la liste.
+     * Les IDs inconnus sont ignorés. */
+    std::vector<std::map<std::string, std::optional<std::string>>> get_by_ids(const std::vector<std::string>& ids);
+
+    /** Colonnes de la table tasks, dans l'ordre de TASK_FIELDS (noms acceptés par TaskProjection). */
+    static const std::vector<std::string>& columns();
+
     /** Liste les tâches avec filtres optionnels.
      * blocked_filter: "blocked" = only tasks blocked by a non-done dependency, "unblocked" = only non-blocked.
-     * done_filter: "done" = only status=done, "not_done" = only status != done, "all" or empty = no filter. */
+     * done_filter: "done" = only status=done, "not_done" = only status != done, "all" or empty = no filter.
+     * projection : colonnes lues (les autres ne sont pas dans le SELECT) ; les champs doivent appartenir à columns(). */
     std::vector<std::map<std::string, std::optional<std::string>>> list(
         const std::optional<std::string>& phase_id = std::nullopt,
         const std::optional<std::string>& status = std::nullopt,
         const std::optional<std::string>& role = std::nullopt,
         const std::optional<std::string>& blocked_filter = std::nullopt,
-        const std::optional<std::string>& done_filter = std::nullopt);
+        const std::optional<std::string>& done_filter = std::nullopt,
+        const TaskProjection& projection = {});
 
     /** Liste les tâches avec filtres optionnels et pagination.
      * blocked_filter: "blocked" = only blocked tasks, "unblocked" = only non-blocked.
-     * done_filter: "done" | "not_done" | "all" (or empty). */
+     * done_filter: "done" | "not_done" | "all" (or empty). projection : voir list(). */
     std::vector<std::map<std::string, std::optional<std::string>>> list_paginated(
         const std::optional<std::string>& phase_id = std::nullopt,
         const std::optional<std::string>& milestone_id = std::nullopt,
@@ -60,7 +115,57 @@ public:
         const std::optional<std::string>& blocked_filter = std::nullopt,
         const std::optional<std::string>& done_filter = std::nullopt,
         int limit = 50,
-        int offset = 0);
+        int offset = 0,
+        const TaskProjection& projection = {});
+
+    /** Comme list(), en flux : les lignes vont directement du curseur SQLite à sink.
+     * Retourne false en cas d'erreur SQL. */
+    bool list_into(const std::optional<std::string>& phase_id,
+                   const std::optional<std::string>& status,
+                   const std::optional<std::string>& role,
+                   const std::optional<std::string>& blocked_filter,
+                   const std::optional<std::string>& done_filter,
+                   const TaskProjection& projection,
+                   RowSink& sink);
+
+    /** Comme list_paginated(), en flux vers sink. Retourne false en cas d'erreur SQL. */
+    bool list_paginated_into(const std::optional<std::string>& phase_id,
+                             const std::optional<std::string>& milestone_id,
+                             const std::optional<std::string>& status,
+                             const std::optional<std::string>& role,
+                             const std::optional<std::string>& blocked_filter,
+                             const std::optional<std::string>& done_filter,
+                             int limit,
+                             int offset,
+                             const TaskProjection& projection,
+                             RowSink& sink);
+
+    /** Page de list() : au plus limit tâches situées strictement après `after` (nullopt = début)
+     * dans l'ordre des listes, lues par l'index idx_tasks_list_order sans OFFSET.
+     * next reçoit la clé de la dernière tâche de la page s'il reste des tâches après elle, nullopt sinon.
+     * Les colonnes de la clé sont lues en plus de la projection mais ne figurent pas dans les lignes. */
+    std::vector<std::map<std::string, std::optional<std::string>>> list_page(
+        const std::optional<std::string>& phase_id,
+        const std::optional<std::string>& status,
+        const std::optional<std::string>& role,
+        const std::optional<std::string>& blocked_filter,
+        const std::optional<std::string>& done_filter,
+        const std::optional<TaskListKey>& after,
+        int limit,
+        const TaskProjection& projection,
+        std::optional<TaskListKey>& next);
+
+    /** Comme list_page(), en flux vers sink. Retourne false en cas d'erreur SQL. */
+    bool list_page_into(const std::optional<std::string>& phase_id,
+                        const std::optional<std::string>& status,
+                        const std::optional<std::string>& role,
+                        const std::optional<std::string>& blocked_filter,
+                        const std::optional<std::string>& done_filter,
+                        const std::optional<TaskListKey>& after,
+                        int limit,
+                        const TaskProjection& projection,
+                        RowSink& sink,
+                        std::optional<TaskListKey>& next);
 
     /** Compte les tâches avec filtres optionnels.
      * blocked_filter: "blocked" | "unblocked". done_filter: "done" | "not_done" | "all". */
@@ -73,6 +178,9 @@ public:
         const std::optional<std::string>& done_filter = std::nullopt);
 
     /** Met à jour une tâche existante.
+     * Si newly_unblocked est fourni et que status passe à "done" (statut précédent différent),
+     * il reçoit les tâches débloquées par cette transition (voir find_newly_unblocked),
+     * calculées dans la même transaction que l'UPDATE.
      * Retourne true en cas de succès, false en cas d'erreur. */
     bool update(const std::string& id,
                 const std::optional<std::string>& title = std::nullopt,
@@ -81,7 +189,39 @@ public:
                 const std::optional<std::string>& role = std::nullopt,
                 const std::optional<std::string>& milestone_id = std::nullopt,
                 const std::optional<int>& sort_order = std::nullopt,
-                const std::optional<std::string>& creator = std::nullopt);
+                const std::optional<std::string>& creator = std::nullopt,
+                std::vector<std::map<std::string, std::optional<std::string>>>* newly_unblocked = nullptr);
+
+    /** Insère des tâches puis des dépendances dans une seule transaction, chaque INSERT étant
+     * préparé une fois pour tout le lot (QueryExecutor::run_many). Vérifie l'absence de cycle sur
+     * les arêtes insérées avant de valider. Tout ou rien : en cas de cycle, `cycle` reçoit l'arête
+     * fautive et rien n'est écrit. Retourne true si la transaction est validée. */
+    bool add_many(const std::vector<TaskRecord>& tasks,
+                  const std::vector<TaskDependencyEdge>& deps,
+                  std::optional<TaskDependencyEdge>& cycle);
+
+    /** Applique des modifications dans une seule transaction, avec un UPDATE préparé une fois
+     * (COALESCE : un champ absent garde sa valeur). updated_at est mis à jour pour chaque tâche.
+     * newly_unblocked reçoit les tâches débloquées par les passages à "done" du lot (sans doublon,
+     * calculées sur l'état final). Les IDs doivent exister (vérifié par l'appelant).
+     * Tout ou rien ; retourne true si la transaction est validée. */
+    bool update_many(const std::vector<TaskChanges>& changes,
+                     std::vector<std::map<std::string, std::optional<std::string>>>& newly_unblocked);
+
+    /** Tâches non terminées qui dépendent de done_task_id et n'ont plus aucune dépendance non-done.
+     * Parcourt l'index inverse idx_task_deps_depends_on : coût proportionnel au nombre de
+     * dépendants directs de done_task_id, pas à la taille du projet.
+     * Retourne des maps id, title, role, ordonnées par sort_order puis id. */
+    std::vector<std::map<std::string, std::optional<std::string>>> find_newly_unblocked(const std::string& done_task_id);
+
+    /** Nombre de tâches par (phase_id, milestone_id, status), en un seul GROUP BY.
+     * Retourne des maps phase_id, milestone_id, status, count. */
+    std::vector<std::map<std::string, std::optional<std::string>>> count_by_milestone_and_status();
+
+    /** Dépendances non terminées des tâches de la liste (requête IN, par lots).
+     * Retourne des maps task_id, id, title, status, role (la dépendance), ordonnées par task_id,
+     * puis sort_order et id de la dépendance. */
+    std::vector<std::map<std::string, std::optional<std::string>>> find_open_dependencies(const std::vector<std::string>& task_ids);
 
     /** Ajoute une dépendance entre deux tâches.
      * Retourne true en cas de succès, false en cas d'erreur. */
@@ -91,10 +231,35 @@ public:
      * Retourne true en cas de succès, false en cas d'erreur. */
     bool remove_dependency(const std::string& task_id, const std::string& depends_on);
 
+    /** Insère des arêtes avec un INSERT préparé une fois, sans contrôle de cycle : l'appelant
+     * garantit un graphe acyclique (demo:generate --scale : arêtes vers des tâches déjà créées).
+     * Pas de transaction propre. Retourne true en cas de succès. */
+    bool add_dependencies_unchecked(const std::vector<TaskDependencyEdge>& edges);
+
     /** Vérifie si une tâche existe.
      * Retourne true si la tâche existe, false sinon. */
     bool exists(const std::string& id);
 
+    /** Retourne les IDs de la liste qui ne correspondent à aucune tâche (requête IN, par lots).
+     * L'ordre de la liste d'entrée est conservé ; un vecteur vide signifie que toutes existent. */
+    std::vector<std::string> find_missing_ids(const std::vector<std::string>& ids);
+
+    /** Retourne les arêtes de la liste déjà présentes dans task_deps (requête IN sur (task_id, depends_on)). */
+    std::vector<TaskDependencyEdge> find_existing_dependencies(const std::vector<TaskDependencyEdge>& edges);
+
+    /** Cherche une arête de la liste qui ferme un cycle dans task_deps (CTE récursive).
+     * Pour a → b, il y a cycle si a est atteignable depuis b en suivant depends_on.
+     * Les arêtes à tester peuvent déjà être insérées (vérification après écriture, dans une transaction).
+     * Retourne la première arête fautive, ou nullopt si le graphe reste acyclique. */
+    std::optional<TaskDependencyEdge> find_dependency_cycle(const std::vector<TaskDependencyEdge>& edges);
+
+    /** Supprime puis insère des arêtes dans une seule transaction, et vérifie l'absence de cycle
+     * sur les arêtes insérées avant de valider. Tout ou rien : en cas de cycle, `cycle` reçoit
+     * l'arête fautive et rien n'est écrit. Retourne true si la transaction est validée. */
+    bool apply_dependency_changes(const std::vector<TaskDependencyEdge>& to_remove,
+                                  const std::vector<TaskDependencyEdge>& to_add,
+                                  std::optional<TaskDependencyEdge>& cycle);
+
     /** Récupère les dépendances d'une tâche.
      * Retourne un vecteur de maps avec task_id et depends_on. */
     std::vector<std::map<std::string, std::optional<std::string>>> get_dependencies(const std::string& task_id);
@@ -103,6 +268,10 @@ public:
      * Retourne un vecteur d'IDs de notes, ordonné par created_at puis id. */
     std::vector<std::string> get_note_ids_by_task_id(const std::string& task_id);
 
+    /** Comme get_note_ids_by_task_id pour plusieurs tâches (requête IN, par lots) : task_id → IDs de notes.
+     * Les tâches sans note sont absentes du résultat. */
+    std::map<std::string, std::vector<std::string>> get_note_ids_by_task_ids(const std::vector<std::string>& task_ids);
+
     /** Liste toutes les dépendances avec pagination.
      * Retourne un vecteur de maps avec task_id et depends_on. */
     std::vector<std::map<std::string, std::optional<std::string>>> list_dependencies(
@@ -3,13 +3,87 @@
  */
 
 #include "task_service.hpp"
+#include "util/diagnostics.hpp"
 #include "util/roles.hpp"
-#include <iostream>
+#include "util/statuses.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <random>
+#include <set>
+#include <thread>
 #include <uuid.h>
 
 namespace taskman {
 
+namespace {
+    const char BASE64URL[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+    /** Base64url sans padding. */
+    std::string base64url_encode(const std::string& in) {
+        std::string out;
+        out.reserve((in.size() + 2) / 3 * 4);
+        unsigned bits = 0;
+        int n = 0;
+        for (unsigned char c : in) {
+            bits = (bits << 8) | c;
+            n += 8;
+            while (n >= 6) {
+                n -= 6;
+                out += BASE64URL[(bits >> n) & 0x3F];
+            }
+        }
+        if (n > 0) out += BASE64URL[(bits << (6 - n)) & 0x3F];
+        return out;
+    }
+
+    /** Décodage base64url sans padding. Retourne false sur un caractère invalide. */
+    bool base64url_decode(const std::string& in, std::string& out) {
+        out.clear();
+        unsigned bits = 0;
+        int n = 0;
+        for (char ch : in) {
+            const char* p = std::strchr(BASE64URL, ch);
+            if (ch == '\0' || !p) return false;
+            bits = (bits << 6) | static_cast<unsigned>(p - BASE64URL);
+            n += 6;
+            if (n >= 8) {
+                n -= 8;
+                out += static_cast<char>((bits >> n) & 0xFF);
+            }
+        }
+        return true;
+    }
+
+    /** Vérifie la taille de page et décode le curseur (diagnostic sur stderr en cas d'erreur). */
+    bool page_arguments(const std::optional<std::string>& cursor, int limit, std::optional<TaskListKey>& after) {
+        if (limit < 1 || limit > TaskService::MAX_PAGE_LIMIT) {
+            diag() << "taskman: --limit must be between 1 and " << TaskService::MAX_PAGE_LIMIT << "\n";
+            return false;
+        }
+        after.reset();
+        if (!cursor.has_value()) return true;
+        TaskListKey key;
+        if (!TaskService::decode_cursor(*cursor, key)) {
+            diag() << "taskman: invalid --cursor\n";
+            return false;
+        }
+        after = std::move(key);
+        return true;
+    }
+
+    /** note_ids de task:get : IDs séparés par des virgules (chaîne vide si aucune note). */
+    std::optional<std::string> join_note_ids(const std::vector<std::string>& note_ids) {
+        std::string joined;
+        for (size_t i = 0; i < note_ids.size(); ++i) {
+            if (i) joined += ',';
+            joined += note_ids[i];
+        }
+        return joined;
+    }
+}
+
 std::optional<std::string> TaskService::create_task(
     const std::string& phase_id,
     const std::optional<std::string>& milestone_id,
@@ -40,17 +114,17 @@ bool TaskService::add_task_with_id(
     const std::optional<std::string>& creator) {
     // Validation du statut
     if (!is_valid_status(status)) {
-        std::cerr << "taskman: invalid status\n";
+        diag() << "taskman: invalid status\n";
         return false;
     }
     // Validation du rôle si fourni
     if (role.has_value() && !is_valid_role(*role)) {
-        std::cerr << get_roles_error_message();
+        diag() << get_roles_error_message();
         return false;
     }
     // Validation du créateur (rôle) si fourni
     if (creator.has_value() && !is_valid_role(*creator)) {
-        std::cerr << get_roles_error_message();
+        diag() << get_roles_error_message();
         return false;
     }
     // Insertion dans la base
@@ -62,26 +136,130 @@ std::map<std::string, std::optional<std::string>> TaskService::get_task(const st
     if (task.empty()) {
         return task;
     }
-    std::vector<std::string> note_ids = repository_.get_note_ids_by_task_id(id);
-    if (note_ids.empty()) {
-        task["note_ids"] = std::optional<std::string>(std::string{});
-    } else {
-        std::string joined;
-        for (size_t i = 0; i < note_ids.size(); ++i) {
-            if (i) joined += ',';
-            joined += note_ids[i];
-        }
-        task["note_ids"] = joined;
-    }
+    task["note_ids"] = join_note_ids(repository_.get_note_ids_by_task_id(id));
     return task;
 }
 
+std::vector<std::map<std::string, std::optional<std::string>>> TaskService::get_tasks(
+    const std::vector<std::string>& ids) {
+    auto tasks = repository_.get_by_ids(ids);
+    if (tasks.empty()) {
+        return tasks;
+    }
+    auto note_ids = repository_.get_note_ids_by_task_ids(ids);
+    for (auto& task : tasks) {
+        auto it = note_ids.find(task["id"].value_or(""));
+        task["note_ids"] = join_note_ids(it != note_ids.end() ? it->second : std::vector<std::string>{});
+    }
+    return tasks;
+}
+
 std::vector<std::map<std::string, std::optional<std::string>>> TaskService::list_tasks(
     const std::optional<std::string>& phase_id,
     const std::optional<std::string>& status,
     const std::optional<std::string>& role,
-    const std::optional<std::string>& blocked_filter) {
-    return repository_.list(phase_id, status, role, blocked_filter, std::nullopt);
+    const std::optional<std::string>& blocked_filter,
+    const TaskProjection& projection) {
+    return repository_.list(phase_id, status, role, blocked_filter, std::nullopt, projection);
+}
+
+bool TaskService::list_tasks_into(const std::optional<std::string>& phase_id,
+                                  const std::optional<std::string>& status,
+                                  const std::optional<std::string>& role,
+                                  const std::optional<std::string>& blocked_filter,
+                                  const TaskProjection& projection,
+                                  RowSink& sink) {
+    return repository_.list_into(phase_id, status, role, blocked_filter, std::nullopt, projection, sink);
+}
+
+bool TaskService::list_tasks_page(const std::optional<std::string>& phase_id,
+                                  const std::optional<std::string>& status,
+                                  const std::optional<std::string>& role,
+                                  const std::optional<std::string>& blocked_filter,
+                                  const TaskProjection& projection,
+                                  const std::optional<std::string>& cursor,
+                                  int limit,
+                                  std::vector<std::map<std::string, std::optional<std::string>>>& tasks,
+                                  std::optional<std::string>& next_cursor) {
+    next_cursor.reset();
+    std::optional<TaskListKey> after, next;
+    if (!page_arguments(cursor, limit, after)) return false;
+    tasks = repository_.list_page(phase_id, status, role, blocked_filter, std::nullopt, after, limit, projection, next);
+    if (next) next_cursor = encode_cursor(*next);
+    return true;
+}
+
+bool TaskService::wait_ready(DataVersion& data_version,
+                             const std::optional<std::string>& phase_id,
+                             const std::optional<std::string>& role,
+                             int limit,
+                             int timeout_ms,
+                             std::vector<std::map<std::string, std::optional<std::string>>>& tasks,
+                             bool& timed_out) {
+    tasks.clear();
+    timed_out = false;
+    if (role.has_value() && !is_valid_role(*role)) {
+        diag() << get_roles_error_message();
+        return false;
+    }
+    if (limit < 1 || limit > MAX_PAGE_LIMIT) {
+        diag() << "taskman: --limit must be between 1 and " << MAX_PAGE_LIMIT << "\n";
+        return false;
+    }
+    if (timeout_ms < 0 || timeout_ms > MAX_WAIT_TIMEOUT * 1000) {
+        diag() << "taskman: --timeout must be between 0 and " << MAX_WAIT_TIMEOUT << "\n";
+        return false;
+    }
+    TaskProjection summary;
+    summary.fields = summary_fields();
+    summary.description_max = SUMMARY_DESCRIPTION_MAX;
+    const std::optional<std::string> to_do = std::string("to_do");
+    const std::optional<std::string> unblocked = std::string("unblocked");
+
+    using clock = std::chrono::steady_clock;
+    const auto deadline = clock::now() + std::chrono::milliseconds(timeout_ms);
+    std::optional<std::string> seen;
+    for (;;) {
+        std::optional<std::string> token = data_version.token();
+        if (!token) {
+            diag() << "taskman: task:wait needs the change counter of the database: run taskman init\n";
+            return false;
+        }
+        // Requête complète seulement après une écriture (ou au premier tour)
+        if (token != seen) {
+            seen = token;
+            std::optional<TaskListKey> next;
+            tasks = repository_.list_page(phase_id, to_do, role, unblocked, std::nullopt, std::nullopt, limit,
+                                          summary, next);
+            if (!tasks.empty()) return true;
+        }
+        auto now = clock::now();
+        if (now >= deadline) {
+            timed_out = true;
+            return true;
+        }
+        std::this_thread::sleep_for(std::min<clock::duration>(std::chrono::milliseconds(WAIT_POLL_MS), deadline - now));
+    }
+}
+
+bool TaskService::list_tasks_page_into(const std::optional<std::string>& phase_id,
+                                       const std::optional<std::string>& status,
+                                       const std::optional<std::string>& role,
+                                       const std::optional<std::string>& blocked_filter,
+                                       const TaskProjection& projection,
+                                       const std::optional<std::string>& cursor,
+                                       int limit,
+                                       RowSink& sink,
+                                       std::optional<std::string>& next_cursor) {
+    next_cursor.reset();
+    std::optional<TaskListKey> after, next;
+    if (!page_arguments(cursor, limit, after)) return false;
+    if (!repository_.list_page_into(phase_id, status, role, blocked_filter, std::nullopt, after, limit,
+                                    projection, sink, next)) {
+        return false;
+    }
+    if (next) next_cursor = encode_cursor(*next);
+    return true;
 }
 
 bool TaskService::update_task(const std::string& id,
@@ -91,38 +269,44 @@ bool TaskService::update_task(const std::string& id,
                                const std::optional<std::string>& role,
                                const std::optional<std::string>& milestone_id,
                                const std::optional<int>& sort_order,
-                               const std::optional<std::string>& creator) {
+                               const std::optional<std::string>& creator,
+                               std::vector<std::map<std::string, std::optional<std::string>>>* newly_unblocked) {
     // Validation du statut si fourni
     if (status.has_value() && !is_valid_status(*status)) {
-        std::cerr << "taskman: invalid status\n";
+        diag() << "taskman: invalid status\n";
         return false;
     }
     // Validation du rôle si fourni
     if (role.has_value() && !is_valid_role(*role)) {
-        std::cerr << get_roles_error_message();
+        diag() << get_roles_error_message();
         return false;
     }
     // Validation du créateur (rôle) si fourni
     if (creator.has_value() && !is_valid_role(*creator)) {
-        std::cerr << get_roles_error_message();
+        diag() << get_roles_error_message();
         return false;
     }
-    return repository_.update(id, title, description, status, role, milestone_id, sort_order, creator);
+    return repository_.update(id, title, description, status, role, milestone_id, sort_order, creator, newly_unblocked);
 }
 
 bool TaskService::add_task_dependency(const std::string& task_id, const std::string& depends_on) {
     // Vérifier qu'une tâche ne dépend pas d'elle-même
     if (task_id == depends_on) {
-        std::cerr << "taskman: a task cannot depend on itself\n";
+        diag() << "taskman: a task cannot depend on itself\n";
         return false;
     }
     // Vérifier que les deux tâches existent
     if (!repository_.exists(task_id)) {
-        std::cerr << "taskman: task not found: " << task_id << "\n";
+        diag() << "taskman: task not found: " << task_id << "\n";
         return false;
     }
     if (!repository_.exists(depends_on)) {
-        std::cerr << "taskman: task not found: " << depends_on << "\n";
+        diag() << "taskman: task not found: " << depends_on << "\n";
+        return false;
+    }
+    // Vérifier que depends_on ne dépend pas déjà (transitivement) de task_id
+    if (repository_.find_dependency_cycle({{task_id, depends_on}})) {
+        diag() << "taskman: dependency cycle: " << task_id << " -> " << depends_on << "\n";
         return false;
     }
     return repository_.add_dependency(task_id, depends_on);
@@ -132,12 +316,249 @@ bool TaskService::remove_task_dependency(const std::string& task_id, const std::
     return repository_.remove_dependency(task_id, depends_on);
 }
 
+bool TaskService::apply_dependency_batch(const std::vector<TaskDependencyEdit>& edits, int& added, int& removed) {
+    added = 0;
+    removed = 0;
+
+    // Validation unitaire (sans accès DB)
+    std::vector<std::string> ids;
+    std::set<std::string> seen_ids;
+    std::vector<TaskDependencyEdge> edges;
+    std::set<TaskDependencyEdge> seen_edges;
+    for (size_t i = 0; i < edits.size(); ++i) {
+        const auto& e = edits[i];
+        if (e.task_id.empty() || e.depends_on.empty()) {
+            diag() << "taskman: edge " << i << ": task-id and dep-id are required\n";
+            return false;
+        }
+        if (e.task_id == e.depends_on) {
+            diag() << "taskman: a task cannot depend on itself: " << e.task_id << "\n";
+            return false;
+        }
+        TaskDependencyEdge edge(e.task_id, e.depends_on);
+        if (seen_edges.insert(edge).second) edges.push_back(edge);
+        if (e.remove) continue;
+        for (const auto& id : {e.task_id, e.depends_on}) {
+            if (seen_ids.insert(id).second) ids.push_back(id);
+        }
+    }
+
+    // Existence des tâches référencées par les ajouts : une requête pour tout le lot
+    auto missing = repository_.find_missing_ids(ids);
+    if (!missing.empty()) {
+        diag() << "taskman: task not found: " << missing.front() << "\n";
+        return false;
+    }
+
+    // État initial des arêtes touchées, puis application du lot dans l'ordre (en mémoire)
+    std::map<TaskDependencyEdge, bool> initial;
+    for (const auto& edge : edges) initial[edge] = false;
+    for (const auto& edge : repository_.find_existing_dependencies(edges)) initial[edge] = true;
+    std::map<TaskDependencyEdge, bool> state = initial;
+    for (const auto& e : edits) {
+        TaskDependencyEdge edge(e.task_id, e.depends_on);
+        if (!e.remove && state[edge]) {
+            diag() << "taskman: dependency already exists: " << e.task_id << " -> " << e.depends_on << "\n";
+            return false;
+        }
+        state[edge] = !e.remove;
+    }
+
+    std::vector<TaskDependencyEdge> to_remove, to_add;
+    for (const auto& edge : edges) {
+        if (initial[edge] && !state[edge]) to_remove.push_back(edge);
+        if (!initial[edge] && state[edge]) to_add.push_back(edge);
+    }
+
+    std::optional<TaskDependencyEdge> cycle;
+    if (!repository_.apply_dependency_changes(to_remove, to_add, cycle)) {
+        if (cycle) {
+            diag() << "taskman: dependency cycle: " << cycle->first << " -> " << cycle->second << "\n";
+        }
+        return false;
+    }
+    added = static_cast<int>(to_add.size());
+    removed = static_cast<int>(to_remove.size());
+    return true;
+}
+
+bool TaskService::bulk_add(const std::vector<TaskBulkAddItem>& items, std::vector<std::string>& ids) {
+    ids.clear();
+    if (items.empty() || items.size() > MAX_BULK_ITEMS) {
+        diag() << "taskman: task:bulk-add takes 1 to " << MAX_BULK_ITEMS << " tasks\n";
+        return false;
+    }
+
+    // Validation unitaire et index des clés temporaires (sans accès DB)
+    std::map<std::string, size_t> keys;
+    for (size_t i = 0; i < items.size(); ++i) {
+        const auto& item = items[i];
+        const auto& t = item.task;
+        if (t.title.empty() || t.phase_id.empty()) {
+            diag() << "taskman: task " << i << ": title and phase are required\n";
+            return false;
+        }
+        if ((t.role && !is_valid_role(*t.role)) || (t.creator && !is_valid_role(*t.creator))) {
+            diag() << get_roles_error_message();
+            return false;
+        }
+        if (item.key && (item.key->empty() || !keys.emplace(*item.key, i).second)) {
+            diag() << "taskman: task " << i << ": key must be non-empty and unique: " << item.key.value_or("") << "\n";
+            return false;
+        }
+    }
+
+    std::vector<TaskRecord> records;
+    records.reserve(items.size());
+    for (const auto& item : items) {
+        records.push_back(item.task);
+        records.back().id = generate_uuid_v4();
+        records.back().status = "to_do";
+    }
+
+    // Dépendances : clé du lot → ID généré, sinon ID d'une tâche existante
+    std::vector<TaskDependencyEdge> deps;
+    std::set<TaskDependencyEdge> seen_deps;
+    std::vector<std::string> external;
+    std::set<std::string> seen_external;
+    for (size_t i = 0; i < items.size(); ++i) {
+        for (const auto& dep : items[i].deps) {
+            auto key = keys.find(dep);
+            if (key != keys.end() && key->second == i) {
+                diag() << "taskman: task " << i << ": a task cannot depend on itself\n";
+                return false;
+            }
+            std::string depends_on = key != keys.end() ? records[key->second].id : dep;
+            if (key == keys.end() && seen_external.insert(dep).second) external.push_back(dep);
+            TaskDependencyEdge edge(records[i].id, depends_on);
+            if (seen_deps.insert(edge).second) deps.push_back(edge);
+        }
+    }
+    auto missing = repository_.find_missing_ids(external);
+    if (!missing.empty()) {
+        diag() << "taskman: dependency not found (neither a key of the batch nor a task): " << missing.front() << "\n";
+        return false;
+    }
+
+    std::optional<TaskDependencyEdge> cycle;
+    if (!repository_.add_many(records, deps, cycle)) {
+        if (cycle) {
+            diag() << "taskman: dependency cycle: " << cycle->first << " -> " << cycle->second << "\n";
+        }
+        return false;
+    }
+    for (const auto& r : records) ids.push_back(r.id);
+    return true;
+}
+
+bool TaskService::bulk_edit(const std::vector<TaskChanges>& changes,
+                            std::vector<std::map<std::string, std::optional<std::string>>>& unblocked) {
+    unblocked.clear();
+    if (changes.empty() || changes.size() > MAX_BULK_ITEMS) {
+        diag() << "taskman: task:bulk-edit takes 1 to " << MAX_BULK_ITEMS << " tasks\n";
+        return false;
+    }
+    std::vector<std::string> ids;
+    std::set<std::string> seen;
+    for (size_t i = 0; i < changes.size(); ++i) {
+        const auto& c = changes[i];
+        if (c.id.empty()) {
+            diag() << "taskman: task " << i << ": id is required\n";
+            return false;
+        }
+        if (!seen.insert(c.id).second) {
+            diag() << "taskman: task " << i << ": task listed twice: " << c.id << "\n";
+            return false;
+        }
+        if (!c.title && !c.description && !c.status && !c.role && !c.milestone_id && !c.sort_order && !c.creator) {
+            diag() << "taskman: task " << i << ": nothing to change\n";
+            return false;
+        }
+        if (c.status && !is_valid_status(*c.status)) {
+            diag() << "taskman: task " << i << ": invalid status\n";
+            return false;
+        }
+        if ((c.role && !is_valid_role(*c.role)) || (c.creator && !is_valid_role(*c.creator))) {
+            diag() << get_roles_error_message();
+            return false;
+        }
+        ids.push_back(c.id);
+    }
+    auto missing = repository_.find_missing_ids(ids);
+    if (!missing.empty()) {
+        diag() << "taskman: task not found: " << missing.front() << "\n";
+        return false;
+    }
+    return repository_.update_many(changes, unblocked);
+}
+
 bool TaskService::is_valid_status(const std::string& status) {
-    const char* const STATUS_VALUES[] = {"to_do", "in_progress", "done"};
-    for (const char* v : STATUS_VALUES) {
-        if (status == v) return true;
+    return STATUS_CODES.code(status) != 0;
+}
+
+const std::vector<std::string>& TaskService::summary_fields() {
+    static const std::vector<std::string> fields = {
+        "id", "phase_id", "milestone_id", "title", "description", "status", "role"};
+    return fields;
+}
+
+bool TaskService::make_projection(const std::optional<std::string>& fields, bool summary, TaskProjection& out) {
+    out = TaskProjection{};
+    if (summary) {
+        out.description_max = SUMMARY_DESCRIPTION_MAX;
+        if (!fields.has_value()) out.fields = summary_fields();
+    }
+    if (!fields.has_value()) return true;
+
+    const auto& columns = TaskRepository::columns();
+    size_t start = 0;
+    while (start <= fields->size()) {
+        size_t end = fields->find(',', start);
+        if (end == std::string::npos) end = fields->size();
+        std::string name = fields->substr(start, end - start);
+        name.erase(0, name.find_first_not_of(" \t"));
+        name.erase(name.find_last_not_of(" \t") + 1);
+        if (!name.empty()) {
+            if (std::find(columns.begin(), columns.end(), name) == columns.end()) {
+                diag() << "taskman: unknown field '" << name << "' (allowed: ";
+                for (size_t i = 0; i < columns.size(); ++i) diag() << (i ? ", " : "") << columns[i];
+                diag() << ")\n";
+                return false;
+            }
+            if (std::find(out.fields.begin(), out.fields.end(), name) == out.fields.end())
+                out.fields.push_back(name);
+        }
+        start = end + 1;
+    }
+    if (out.fields.empty()) {
+        diag() << "taskman: --fields must list at least one field\n";
+        return false;
+    }
+    return true;
+}
+
+std::string TaskService::encode_cursor(const TaskListKey& key) {
+    nlohmann::json arr = nlohmann::json::array();
+    arr.push_back(key.phase_id);
+    arr.push_back(key.milestone_id ? nlohmann::json(*key.milestone_id) : nlohmann::json());
+    arr.push_back(key.sort_order ? nlohmann::json(*key.sort_order) : nlohmann::json());
+    arr.push_back(key.id);
+    return base64url_encode(arr.dump());
+}
+
+bool TaskService::decode_cursor(const std::string& cursor, TaskListKey& key) {
+    std::string raw;
+    if (cursor.empty() || !base64url_decode(cursor, raw)) return false;
+    nlohmann::json arr = nlohmann::json::parse(raw, nullptr, false);
+    if (!arr.is_array() || arr.size() != 4 || !arr[0].is_string() || !arr[3].is_string()) return false;
+    for (int i : {1, 2}) {
+        if (!arr[i].is_null() && !arr[i].is_string()) return false;
     }
-    return false;
+    key.phase_id = arr[0].get<std::string>();
+    key.milestone_id = arr[1].is_null() ? std::nullopt : std::optional<std::string>(arr[1].get<std::string>());
+    key.sort_order = arr[2].is_null() ? std::nullopt : std::optional<std::string>(arr[2].get<std::string>());
+    key.id = arr[3].get<std::string>();
+    return true;
 }
 
 std::string TaskService::generate_uuid_v4() {
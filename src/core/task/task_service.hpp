@@ -9,6 +9,7 @@
 #define TASKMAN_TASK_SERVICE_HPP
 
 #include "task_repository.hpp"
+#include "infrastructure/db/data_version.hpp"
 #include <map>
 #include <optional>
 #include <string>
@@ -16,6 +17,21 @@
 
 namespace taskman {
 
+/** Une opération d'un lot task:dep:batch : ajout (défaut) ou suppression de task_id → depends_on. */
+struct TaskDependencyEdit {
+    bool remove = false;
+    std::string task_id;
+    std::string depends_on;
+};
+
+/** Une tâche d'un lot task:bulk-add. key : clé temporaire choisie par le client, utilisable
+ * dans deps des autres éléments du lot ; deps : clés du lot ou IDs de tâches existantes. */
+struct TaskBulkAddItem {
+    std::optional<std::string> key;
+    TaskRecord task;
+    std::vector<std::string> deps;
+};
+
 class TaskService {
 public:
     /** Constructeur prenant une référence à TaskRepository. */
@@ -55,17 +71,77 @@ public:
      * Retourne un map vide si la tâche n'existe pas. */
     std::map<std::string, std::optional<std::string>> get_task(const std::string& id);
 
+    /** Comme get_task pour plusieurs IDs, en deux requêtes (tâches puis note_ids).
+     * Ordre de la liste ; les IDs inconnus sont ignorés. */
+    std::vector<std::map<std::string, std::optional<std::string>>> get_tasks(const std::vector<std::string>& ids);
+
     /** Liste les tâches avec filtres optionnels.
      * blocked_filter: "blocked" = only blocked tasks, "unblocked" = only non-blocked.
+     * projection : colonnes lues (voir make_projection).
      * Retourne un vecteur de maps représentant les tâches. */
     std::vector<std::map<std::string, std::optional<std::string>>> list_tasks(
         const std::optional<std::string>& phase_id = std::nullopt,
         const std::optional<std::string>& status = std::nullopt,
         const std::optional<std::string>& role = std::nullopt,
-        const std::optional<std::string>& blocked_filter = std::nullopt);
+        const std::optional<std::string>& blocked_filter = std::nullopt,
+        const TaskProjection& projection = {});
+
+    /** Comme list_tasks(), en flux vers sink (--format table, ndjson). Retourne false en cas d'erreur. */
+    bool list_tasks_into(const std::optional<std::string>& phase_id,
+                         const std::optional<std::string>& status,
+                         const std::optional<std::string>& role,
+                         const std::optional<std::string>& blocked_filter,
+                         const TaskProjection& projection,
+                         RowSink& sink);
+
+    /** Page de list_tasks() : au plus limit tâches (1 à MAX_PAGE_LIMIT) après cursor, jeton next_cursor
+     * d'une page précédente (nullopt = première page). next_cursor reçoit le jeton de la page suivante,
+     * ou nullopt sur la dernière page. Retourne false si limit ou cursor est invalide (message sur stderr). */
+    bool list_tasks_page(const std::optional<std::string>& phase_id,
+                         const std::optional<std::string>& status,
+                         const std::optional<std::string>& role,
+                         const std::optional<std::string>& blocked_filter,
+                         const TaskProjection& projection,
+                         const std::optional<std::string>& cursor,
+                         int limit,
+                         std::vector<std::map<std::string, std::optional<std::string>>>& tasks,
+                         std::optional<std::string>& next_cursor);
+
+    /** Comme list_tasks_page(), en flux vers sink (--format table, ndjson). */
+    bool list_tasks_page_into(const std::optional<std::string>& phase_id,
+                              const std::optional<std::string>& status,
+                              const std::optional<std::string>& role,
+                              const std::optional<std::string>& blocked_filter,
+                              const TaskProjection& projection,
+                              const std::optional<std::string>& cursor,
+                              int limit,
+                              RowSink& sink,
+                              std::optional<std::string>& next_cursor);
+
+    /** Attend qu'au moins une tâche prête existe (to_do, non bloquée, filtres phase_id et role), au plus
+     * timeout_ms (0 = une seule vérification). Le jeton data_version est relu toutes les WAIT_POLL_MS ;
+     * la requête de tâches n'est relancée que s'il a changé. tasks reçoit au plus limit tâches (projection
+     * summary), dans l'ordre de task:list ; timed_out est vrai si le délai a expiré sans tâche prête.
+     * Retourne false si role, limit (1 à MAX_PAGE_LIMIT) ou timeout_ms est invalide, ou si la base n'a
+     * pas de compteur data_version (message sur stderr). */
+    bool wait_ready(DataVersion& data_version,
+                    const std::optional<std::string>& phase_id,
+                    const std::optional<std::string>& role,
+                    int limit,
+                    int timeout_ms,
+                    std::vector<std::map<std::string, std::optional<std::string>>>& tasks,
+                    bool& timed_out);
+
+    /** Intervalle de relecture du jeton data_version par wait_ready() (millisecondes). */
+    static constexpr int WAIT_POLL_MS = 100;
+
+    /** Délai d'attente de task:wait (secondes) : valeur par défaut et maximum. */
+    static constexpr int DEFAULT_WAIT_TIMEOUT = 30;
+    static constexpr int MAX_WAIT_TIMEOUT = 600;
 
     /** Met à jour une tâche existante.
      * Effectue la validation des données avant mise à jour.
+     * newly_unblocked (optionnel) : tâches débloquées si status passe à "done" (voir TaskRepository::update).
      * Retourne true en cas de succès, false en cas d'erreur. */
     bool update_task(const std::string& id,
                      const std::optional<std::string>& title = std::nullopt,
@@ -74,7 +150,8 @@ public:
                      const std::optional<std::string>& role = std::nullopt,
                      const std::optional<std::string>& milestone_id = std::nullopt,
                      const std::optional<int>& sort_order = std::nullopt,
-                     const std::optional<std::string>& creator = std::nullopt);
+                     const std::optional<std::string>& creator = std::nullopt,
+                     std::vector<std::map<std::string, std::optional<std::string>>>* newly_unblocked = nullptr);
 
     /** Ajoute une dépendance entre deux tâches.
      * Effectue la validation (tâches existantes, pas de dépendance circulaire).
@@ -85,10 +162,58 @@ public:
      * Retourne true en cas de succès, false en cas d'erreur. */
     bool remove_task_dependency(const std::string& task_id, const std::string& depends_on);
 
+    /** Applique un lot d'ajouts/suppressions de dépendances, dans l'ordre, en une seule transaction.
+     * Validation ensembliste sur tout le lot : existence des tâches (une requête IN), doublons,
+     * puis détection de cycle (CTE récursive) après écriture. Tout ou rien : en cas d'erreur,
+     * aucune arête n'est modifiée. added/removed reçoivent le nombre d'arêtes effectivement
+     * insérées/supprimées. Retourne true en cas de succès, false en cas d'erreur (stderr). */
+    bool apply_dependency_batch(const std::vector<TaskDependencyEdit>& edits, int& added, int& removed);
+
+    /** Nombre maximal d'éléments d'un lot task:bulk-add / task:bulk-edit. */
+    static constexpr size_t MAX_BULK_ITEMS = 1000;
+
+    /** Crée un lot de tâches (statut to_do, id généré) et leurs dépendances en une seule transaction.
+     * Tout le lot est validé avant d'écrire : titre et phase requis, rôles, clés uniques, deps résolues
+     * (clé du lot, sinon tâche existante : une requête IN pour tout le lot), pas d'auto-dépendance ;
+     * puis absence de cycle après insertion. ids reçoit les IDs créés, dans l'ordre des éléments.
+     * Tout ou rien. Retourne false en cas d'erreur (stderr, préfixe "task <index>:"). */
+    bool bulk_add(const std::vector<TaskBulkAddItem>& items, std::vector<std::string>& ids);
+
+    /** Modifie un lot de tâches en une seule transaction (voir TaskRepository::update_many).
+     * Validation préalable : ID présent, unique dans le lot et existant, au moins un champ, statut et rôles.
+     * unblocked reçoit les tâches débloquées par les passages à done du lot.
+     * Tout ou rien. Retourne false en cas d'erreur (stderr, préfixe "task <index>:"). */
+    bool bulk_edit(const std::vector<TaskChanges>& changes,
+                   std::vector<std::map<std::string, std::optional<std::string>>>& unblocked);
+
     /** Valide un statut de tâche.
      * Retourne true si le statut est valide, false sinon. */
     static bool is_valid_status(const std::string& status);
 
+    /** Champs du preset summary (utilisé si --fields est absent). */
+    static const std::vector<std::string>& summary_fields();
+
+    /** Longueur maximale de la description en mode summary (caractères). */
+    static constexpr int SUMMARY_DESCRIPTION_MAX = 120;
+
+    /** Construit la projection de task:list à partir de --fields (noms séparés par des virgules,
+     * parmi TaskRepository::columns(), doublons ignorés) et --summary (preset summary_fields()
+     * si fields est absent, description tronquée à SUMMARY_DESCRIPTION_MAX caractères).
+     * Retourne false si un champ est inconnu ou si la liste est vide (message sur stderr). */
+    static bool make_projection(const std::optional<std::string>& fields, bool summary, TaskProjection& out);
+
+    /** Taille de page de task:list si --cursor est donné sans --limit. */
+    static constexpr int DEFAULT_PAGE_LIMIT = 100;
+
+    /** Taille de page maximale (--limit). */
+    static constexpr int MAX_PAGE_LIMIT = 1000;
+
+    /** Jeton de curseur opaque (base64url d'un tableau JSON) pour une clé de liste. */
+    static std::string encode_cursor(const TaskListKey& key);
+
+    /** Décode un jeton produit par encode_cursor. Retourne false si le jeton est invalide. */
+    static bool decode_cursor(const std::string& cursor, TaskListKey& key);
+
     /** Génère un UUID v4.
      * Retourne une chaîne représentant l'UUID. */
     static std::string generate_uuid_v4();
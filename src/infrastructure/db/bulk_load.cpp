@@ -0,0 +1,25 @@
+/**
+ * Implémentation de BulkLoad.
+ */
+
+#include "bulk_load.hpp"
+#include "db.hpp"
+
+namespace taskman {
+
+BulkLoad::BulkLoad(Database& db) : db_(db) {
+    active_ = db_.begin_bulk_load();
+}
+
+BulkLoad::~BulkLoad() {
+    finish();
+}
+
+bool BulkLoad::finish() {
+    if (!pending_) return true;
+    pending_ = false;
+    active_ = false;
+    return db_.end_bulk_load();
+}
+
+} // namespace taskman
@@ -0,0 +1,42 @@
+/**
+ * BulkLoad — portée RAII d'un chargement en masse (Database::begin_bulk_load).
+ * Responsabilité unique : garantir que index secondaires et triggers data_version, supprimés
+ * pour le chargement, sont recréés sur tous les chemins de sortie (retour anticipé, exception).
+ * Sans finish() explicite, le destructeur appelle end_bulk_load().
+ */
+
+#ifndef TASKMAN_BULK_LOAD_HPP
+#define TASKMAN_BULK_LOAD_HPP
+
+namespace taskman {
+
+class Database;
+
+class BulkLoad {
+public:
+    /** Commence le chargement (begin_bulk_load). En échec : stderr, active() == false ; la fin
+     * reste due (une partie des index ou triggers a pu être supprimée). */
+    explicit BulkLoad(Database& db);
+
+    /** Termine le chargement si finish() n'a pas été appelé. */
+    ~BulkLoad();
+
+    BulkLoad(const BulkLoad&) = delete;
+    BulkLoad& operator=(const BulkLoad&) = delete;
+
+    /** Vrai si begin_bulk_load a réussi et que finish() n'a pas encore été appelé. */
+    bool active() const { return active_; }
+
+    /** Termine le chargement (end_bulk_load). Retourne false en cas d'erreur (stderr déjà écrit).
+     * No-op (true) si déjà terminé. */
+    bool finish();
+
+private:
+    Database& db_;
+    bool active_ = false;
+    bool pending_ = true;  // end_bulk_load pas encore appelé
+};
+
+} // namespace taskman
+
+#endif /* TASKMAN_BULK_LOAD_HPP */
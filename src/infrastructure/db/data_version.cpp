@@ -0,0 +1,18 @@
+/**
+ * Implémentation de DataVersion.
+ */
+
+#include "data_version.hpp"
+#include "util/diagnostics.hpp"
+
+namespace taskman {
+
+std::optional<std::string> DataVersion::token() {
+    // Table absente : pas de message SQLite, l'appelant explique quoi faire
+    DiagnosticCapture silent;
+    auto rows = executor_.query("SELECT epoch || '.' || version AS token FROM data_version WHERE id = 1");
+    if (rows.empty()) return std::nullopt;
+    return rows[0]["token"];
+}
+
+} // namespace taskman
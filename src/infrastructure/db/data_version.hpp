@@ -0,0 +1,36 @@
+/**
+ * DataVersion — jeton de version de la base (lectures conditionnelles --if-none-match).
+ * Responsabilité unique : lire le compteur de changements data_version, incrémenté par
+ * les triggers de SchemaManager à chaque écriture sur phases, milestones, tasks,
+ * task_deps et task_notes.
+ */
+
+#ifndef TASKMAN_DATA_VERSION_HPP
+#define TASKMAN_DATA_VERSION_HPP
+
+#include "query_executor.hpp"
+#include <optional>
+#include <string>
+
+namespace taskman {
+
+class DataVersion {
+public:
+    /** Constructeur prenant une référence à QueryExecutor. */
+    explicit DataVersion(QueryExecutor& executor) : executor_(executor) {}
+
+    DataVersion(const DataVersion&) = delete;
+    DataVersion& operator=(const DataVersion&) = delete;
+
+    /** Jeton opaque "<epoch>.<compteur>" : change à chaque écriture et à chaque recréation de la base.
+     * À lire avant les données : une écriture concurrente rend le jeton périmé, jamais les données.
+     * nullopt si data_version est absente (base créée avant ce compteur : relancer init). */
+    std::optional<std::string> token();
+
+private:
+    QueryExecutor& executor_;
+};
+
+} // namespace taskman
+
+#endif /* TASKMAN_DATA_VERSION_HPP */
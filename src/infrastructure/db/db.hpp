@@ -36,6 +36,16 @@ public:
      * En échec : message sur stderr, retour false. */
     bool open(const char* path) { return connection_.open(path); }
 
+    /** Ouverture différée : la base n'est ouverte (et créée) qu'à la première requête. */
+    void open_deferred(const char* path) { connection_.open_deferred(path); }
+
+    /** Ouvre maintenant la connexion différée (ex. avant de démarrer des threads).
+     * En échec : message sur stderr, retour false. */
+    bool ensure_open() { return connection_.ensure_open(); }
+
+    /** Vrai si l'ouverture différée a échoué (main retourne alors 1). */
+    bool open_failed() const { return connection_.open_failed(); }
+
     /** Ferme la connexion. No-op si déjà fermée. */
     void close() { connection_.close(); }
 
@@ -68,6 +78,14 @@ public:
      * Retourne false en cas d'erreur (stderr déjà écrit par executor). */
     bool init_schema() { return schema_manager_.init_schema(); }
 
+    /** Passe status, role et creator en codes entiers (init --compact-enums, voir SchemaManager). */
+    bool compact_enums() { return schema_manager_.compact_enums(); }
+
+    /** Début / fin d'un chargement en masse : index secondaires et triggers data_version
+     * supprimés puis recréés (voir SchemaManager). */
+    bool begin_bulk_load() { return schema_manager_.begin_bulk_load(); }
+    bool end_bulk_load() { return schema_manager_.end_bulk_load(); }
+
     /** Obtient une référence à QueryExecutor pour utilisation par les repositories.
      * Permet aux nouvelles classes (TaskRepository, etc.) d'accéder à QueryExecutor
      * sans violer l'encapsulation. */
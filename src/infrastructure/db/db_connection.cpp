@@ -3,9 +3,9 @@
  */
 
 #include "db_connection.hpp"
+#include "util/diagnostics.hpp"
 #include <sqlite3.h>
 #include <cstdlib>
-#include <iostream>
 
 namespace taskman {
 
@@ -30,11 +30,12 @@ bool DatabaseConnection::open(const char* path) {
     if (db_ != nullptr) {
         return true;
     }
+    set_compact_enums(std::nullopt);
     int rc = sqlite3_open_v2(path, &db_,
                             SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE,
                             nullptr);
     if (rc != SQLITE_OK) {
-        std::cerr << "taskman: " << (db_ ? sqlite3_errmsg(db_) : "sqlite3_open") << "\n";
+        diag() << "taskman: " << (db_ ? sqlite3_errmsg(db_) : "sqlite3_open") << "\n";
         if (db_) {
             sqlite3_close(db_);
             db_ = nullptr;
@@ -42,21 +43,134 @@ bool DatabaseConnection::open(const char* path) {
         return false;
     }
     /* Attendre jusqu'à 3 s si la base est verrouillée (ex. récupération d'un -journal). */
-    (void)sqlite3_exec(db_, "PRAGMA busy_timeout=3000", nullptr, nullptr, nullptr);
+    (void)sqlite3_busy_timeout(db_, 3000);
     if (use_memory_journal()) {
         (void)sqlite3_exec(db_, "PRAGMA journal_mode=MEMORY", nullptr, nullptr, nullptr);
     }
     return true;
 }
 
+void DatabaseConnection::open_deferred(const char* path) {
+    deferred_path_ = path;
+    open_failed_ = false;
+}
+
+bool DatabaseConnection::ensure_open() {
+    if (db_ != nullptr) {
+        return true;
+    }
+    if (open_failed_) {
+        return false; // Erreur déjà signalée par open()
+    }
+    if (deferred_path_.empty()) {
+        diag() << "taskman: database not open\n";
+        return false;
+    }
+    if (!open(deferred_path_.c_str())) {
+        open_failed_ = true;
+        return false;
+    }
+    return true;
+}
+
 void DatabaseConnection::close() {
+    deferred_path_.clear();
+    set_compact_enums(std::nullopt);
+    clear_statements();
     if (db_) {
         int rc = sqlite3_close(db_);
         if (rc != SQLITE_OK) {
-            std::cerr << "taskman: sqlite3_close: " << sqlite3_errmsg(db_) << "\n";
+            diag() << "taskman: sqlite3_close: " << sqlite3_errmsg(db_) << "\n";
         }
         db_ = nullptr;
     }
 }
 
+PreparedStatement DatabaseConnection::prepare(const char* sql) {
+    std::unique_lock<std::mutex> lock(statements_mutex_);
+    auto it = statements_.find(sql);
+    if (it != statements_.end() && !it->second.in_use) {
+        it->second.in_use = true;
+        it->second.last_use = ++statement_clock_;
+        return PreparedStatement(this, it->second.stmt, true);
+    }
+    bool cache = it == statements_.end();
+    if (cache && statements_.size() >= STATEMENT_CACHE_SIZE) {
+        // Plein : finaliser la requête libre la moins récemment utilisée (aucune libre : pas de mise en cache)
+        auto oldest = statements_.end();
+        for (auto e = statements_.begin(); e != statements_.end(); ++e) {
+            if (!e->second.in_use && (oldest == statements_.end() || e->second.last_use < oldest->second.last_use)) {
+                oldest = e;
+            }
+        }
+        if (oldest != statements_.end()) {
+            sqlite3_finalize(oldest->second.stmt);
+            statements_.erase(oldest);
+        } else {
+            cache = false;
+        }
+    }
+    lock.unlock();
+
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        sqlite3_finalize(stmt);
+        return PreparedStatement();
+    }
+    if (cache) {
+        lock.lock();
+        // Un autre thread a pu mettre le même texte en cache entre-temps : garder la sienne
+        auto inserted = statements_.emplace(sql, CacheEntry{stmt, true, ++statement_clock_});
+        cache = inserted.second;
+    }
+    return PreparedStatement(this, stmt, cache);
+}
+
+size_t DatabaseConnection::cached_statements() const {
+    std::lock_guard<std::mutex> lock(statements_mutex_);
+    return statements_.size();
+}
+
+void DatabaseConnection::give_back(sqlite3_stmt* stmt) {
+    std::lock_guard<std::mutex> lock(statements_mutex_);
+    for (auto& [sql, entry] : statements_) {
+        if (entry.stmt == stmt) {
+            entry.in_use = false;
+            return;
+        }
+    }
+    sqlite3_finalize(stmt);  // retirée du cache pendant l'emprunt (fermeture)
+}
+
+void DatabaseConnection::clear_statements() {
+    std::lock_guard<std::mutex> lock(statements_mutex_);
+    for (auto& [sql, entry] : statements_) {
+        if (!entry.in_use) sqlite3_finalize(entry.stmt);  // empruntée : finalisée par give_back
+    }
+    statements_.clear();
+}
+
+PreparedStatement& PreparedStatement::operator=(PreparedStatement&& other) noexcept {
+    if (this != &other) {
+        release();
+        connection_ = other.connection_;
+        stmt_ = other.stmt_;
+        cached_ = other.cached_;
+        other.stmt_ = nullptr;
+    }
+    return *this;
+}
+
+void PreparedStatement::release() {
+    if (!stmt_) return;
+    sqlite3_reset(stmt_);
+    sqlite3_clear_bindings(stmt_);
+    if (cached_) {
+        connection_->give_back(stmt_);
+    } else {
+        sqlite3_finalize(stmt_);
+    }
+    stmt_ = nullptr;
+}
+
 } // namespace taskman
@@ -1,15 +1,60 @@
 /**
  * DatabaseConnection — gestion de la connexion SQLite uniquement.
- * Responsabilité unique : ouvrir/fermer la connexion et vérifier son état.
+ * Responsabilité unique : ouvrir/fermer la connexion, vérifier son état et conserver ses
+ * requêtes préparées (cache par texte SQL, finalisé à la fermeture).
  */
 
 #ifndef TASKMAN_DB_CONNECTION_HPP
 #define TASKMAN_DB_CONNECTION_HPP
 
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
 struct sqlite3;
+struct sqlite3_stmt;
 
 namespace taskman {
 
+class DatabaseConnection;
+
+/** Requêtes préparées conservées par connexion ; au-delà, la moins récemment utilisée est finalisée. */
+inline constexpr size_t STATEMENT_CACHE_SIZE = 64;
+
+/**
+ * Requête préparée empruntée à une connexion (voir DatabaseConnection::prepare).
+ * À la destruction : reset et bindings effacés, puis rendue au cache (ou finalisée si elle
+ * n'en fait pas partie). Vide (get() == nullptr) si la préparation a échoué.
+ */
+class PreparedStatement {
+public:
+    PreparedStatement() = default;
+    PreparedStatement(DatabaseConnection* connection, sqlite3_stmt* stmt, bool cached)
+        : connection_(connection), stmt_(stmt), cached_(cached) {}
+    ~PreparedStatement() { release(); }
+
+    PreparedStatement(PreparedStatement&& other) noexcept
+        : connection_(other.connection_), stmt_(other.stmt_), cached_(other.cached_) {
+        other.stmt_ = nullptr;
+    }
+    PreparedStatement& operator=(PreparedStatement&& other) noexcept;
+    PreparedStatement(const PreparedStatement&) = delete;
+    PreparedStatement& operator=(const PreparedStatement&) = delete;
+
+    sqlite3_stmt* get() const { return stmt_; }
+    explicit operator bool() const { return stmt_ != nullptr; }
+
+private:
+    void release();
+
+    DatabaseConnection* connection_ = nullptr;
+    sqlite3_stmt* stmt_ = nullptr;
+    bool cached_ = false;
+};
+
 class DatabaseConnection {
 public:
     DatabaseConnection() : db_(nullptr) {}
@@ -22,7 +67,19 @@ public:
      * En échec : message sur stderr, retour false. */
     bool open(const char* path);
 
-    /** Ferme la connexion. No-op si déjà fermée. */
+    /** Ouverture différée : retient le chemin ; la connexion s'ouvre au premier ensure_open()
+     * (première requête). Une commande qui échoue sur ses arguments n'ouvre ni ne crée la base. */
+    void open_deferred(const char* path);
+
+    /** Ouvre la connexion différée si besoin. Vrai si une connexion est ouverte.
+     * En échec (aucun chemin, ou ouverture impossible — retenu, sans nouvel essai) :
+     * message sur stderr, retour false. */
+    bool ensure_open();
+
+    /** Vrai si l'ouverture différée a échoué. */
+    bool open_failed() const { return open_failed_; }
+
+    /** Ferme la connexion et oublie le chemin différé. No-op si déjà fermée. */
     void close();
 
     /** Vrai si une connexion est ouverte. */
@@ -32,8 +89,53 @@ public:
      * Retourne nullptr si non connecté. */
     sqlite3* get() const { return db_; }
 
+    /** Stockage de status et role lu pour cette connexion (voir QueryExecutor::compact_enums) ;
+     * nullopt : pas encore lu. Oublié à l'ouverture et à la fermeture. Atomique : la première
+     * lecture peut venir de plusieurs threads du serveur web à la fois (même valeur écrite). */
+    std::optional<bool> compact_enums() const {
+        int mode = compact_enums_.load(std::memory_order_acquire);
+        if (mode == ENUMS_UNKNOWN) return std::nullopt;
+        return mode == ENUMS_COMPACT;
+    }
+    void set_compact_enums(std::optional<bool> compact) {
+        compact_enums_.store(!compact ? ENUMS_UNKNOWN : (*compact ? ENUMS_COMPACT : ENUMS_TEXT),
+                             std::memory_order_release);
+    }
+
+    /** Requête préparée pour sql (connexion ouverte) : reprise du cache si elle y est et libre,
+     * préparée sinon (et mise en cache si le texte n'y est pas encore). Une requête déjà empruntée
+     * (ex. même SELECT imbriqué dans un RowSink, ou autre thread) donne une copie hors cache.
+     * En échec de préparation : PreparedStatement vide, sqlite3_errmsg(get()) renseigné. */
+    PreparedStatement prepare(const char* sql);
+
+    /** Nombre de requêtes conservées (tests). */
+    size_t cached_statements() const;
+
 private:
+    friend class PreparedStatement;
+
+    struct CacheEntry {
+        sqlite3_stmt* stmt = nullptr;
+        bool in_use = false;
+        uint64_t last_use = 0;
+    };
+
+    /** Rend au cache une requête empruntée (déjà reset). */
+    void give_back(sqlite3_stmt* stmt);
+    /** Finalise toutes les requêtes du cache (avant sqlite3_close). */
+    void clear_statements();
+
     struct sqlite3* db_;
+    std::string deferred_path_;
+    bool open_failed_ = false;
+    /** Mode de stockage de compact_enums() : pas encore lu, texte ou codes entiers. */
+    enum : int { ENUMS_UNKNOWN, ENUMS_TEXT, ENUMS_COMPACT };
+    std::atomic<int> compact_enums_{ENUMS_UNKNOWN};
+    /** Cache texte SQL → requête ; protégé par statements_mutex_ (connexion partagée par les
+     * threads du serveur web). */
+    std::unordered_map<std::string, CacheEntry> statements_;
+    uint64_t statement_clock_ = 0;
+    mutable std::mutex statements_mutex_;
 };
 
 } // namespace taskman
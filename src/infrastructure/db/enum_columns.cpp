@@ -0,0 +1,50 @@
+/**
+ * Implémentation de EnumColumns.
+ */
+
+#include "enum_columns.hpp"
+#include "util/roles.hpp"
+#include "util/statuses.hpp"
+
+namespace taskman {
+
+const EnumTable* EnumColumns::table_of(std::string_view column) {
+    if (column == "status") return &STATUS_CODES;
+    if (column == "role" || column == "creator") return &ROLE_CODES;
+    return nullptr;
+}
+
+std::string EnumColumns::select(std::string_view column, std::string_view prefix) const {
+    std::string qualified(prefix);
+    qualified += column;
+    const EnumTable* table = compact_ ? table_of(column) : nullptr;
+    if (!table) return qualified;
+    std::string sql = "CASE " + qualified;
+    for (size_t code = 1; code <= table->size(); ++code) {
+        sql += " WHEN " + std::to_string(code) + " THEN '";
+        sql += table->name(static_cast<int>(code));
+        sql += "'";
+    }
+    sql += " ELSE " + qualified + " END AS ";
+    sql += column;
+    return sql;
+}
+
+std::optional<std::string> EnumColumns::bind(std::string_view column, const std::optional<std::string>& value) const {
+    const EnumTable* table = compact_ ? table_of(column) : nullptr;
+    if (!table || !value) return value;
+    int code = table->code(*value);
+    return code ? std::to_string(code) : *value;
+}
+
+std::string EnumColumns::literal(std::string_view column, std::string_view value) const {
+    const EnumTable* table = compact_ ? table_of(column) : nullptr;
+    int code = table ? table->code(value) : 0;
+    if (code) return std::to_string(code);
+    std::string sql = "'";
+    sql += value;
+    sql += "'";
+    return sql;
+}
+
+} // namespace taskman
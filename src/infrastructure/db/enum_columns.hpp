@@ -0,0 +1,64 @@
+/**
+ * EnumColumns — colonnes énumérées (status ; role, creator) à la frontière des repositories.
+ * Responsabilité unique : écrire le SQL de ces colonnes selon leur stockage, texte (par défaut)
+ * ou codes entiers (init --compact-enums, voir SchemaManager::compact_enums).
+ *
+ * En stockage compact, les paramètres liés et les littéraux deviennent des codes (filtres en
+ * comparaisons d'entiers) et les SELECT décodent les codes en texte : les Row, et donc les
+ * sorties CLI, MCP et web, sont identiques dans les deux modes.
+ */
+
+#ifndef TASKMAN_ENUM_COLUMNS_HPP
+#define TASKMAN_ENUM_COLUMNS_HPP
+
+#include "query_executor.hpp"
+#include "util/entity_fields.hpp"
+#include "util/enum_table.hpp"
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace taskman {
+
+class EnumColumns {
+public:
+    /** Lit le mode de stockage de la connexion (mis en cache par QueryExecutor). */
+    explicit EnumColumns(QueryExecutor& executor) : compact_(executor.compact_enums()) {}
+
+    /** Vrai en stockage compact (codes entiers). */
+    bool compact() const { return compact_; }
+
+    /** Table de codes de column (status → STATUS_CODES ; role, creator → ROLE_CODES), nullptr sinon. */
+    static const EnumTable* table_of(std::string_view column);
+
+    /** Expression SELECT de column préfixée (ex. "t.") ; en stockage compact, une colonne
+     * énumérée est décodée : CASE t.status WHEN 1 THEN 'to_do' … ELSE t.status END AS status. */
+    std::string select(std::string_view column, std::string_view prefix = {}) const;
+
+    /** Liste du SELECT de Fields : select_list<Fields>() (calculée à la compilation) en stockage
+     * texte, colonnes énumérées décodées en stockage compact. */
+    template <const auto& Fields>
+    std::string select_list() const {
+        if (!compact_) return taskman::select_list<Fields>();
+        std::string sql;
+        for (const auto& field : Fields) {
+            if (!field.sql_type) continue;
+            if (!sql.empty()) sql += ", ";
+            sql += select(field.column);
+        }
+        return sql;
+    }
+
+    /** Valeur liée pour column : son code en stockage compact (NULL et valeur inconnue inchangés). */
+    std::optional<std::string> bind(std::string_view column, const std::optional<std::string>& value) const;
+
+    /** Littéral SQL de value pour column : 'done', ou son code (3) en stockage compact. */
+    std::string literal(std::string_view column, std::string_view value) const;
+
+private:
+    bool compact_;
+};
+
+} // namespace taskman
+
+#endif /* TASKMAN_ENUM_COLUMNS_HPP */
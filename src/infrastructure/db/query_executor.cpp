@@ -3,21 +3,42 @@
  */
 
 #include "query_executor.hpp"
+#include "util/diagnostics.hpp"
 #include <sqlite3.h>
-#include <iostream>
 
 namespace taskman {
 
+int RowCursor::size() const {
+    return size_ >= 0 ? size_ : sqlite3_column_count(stmt_);
+}
+
+const char* RowCursor::name(int i) const {
+    return sqlite3_column_name(stmt_, i);
+}
+
+bool RowCursor::is_null(int i) const {
+    return sqlite3_column_type(stmt_, i) == SQLITE_NULL;
+}
+
+bool RowCursor::is_integer(int i) const {
+    return sqlite3_column_type(stmt_, i) == SQLITE_INTEGER;
+}
+
+std::string_view RowCursor::text(int i) const {
+    const char* p = reinterpret_cast<const char*>(sqlite3_column_text(stmt_, i));
+    if (!p) return {};
+    return std::string_view(p, static_cast<size_t>(sqlite3_column_bytes(stmt_, i)));
+}
+
 bool QueryExecutor::exec(const char* sql) {
-    if (!connection_.is_open()) {
-        std::cerr << "taskman: database not open\n";
+    if (!connection_.ensure_open()) {
         return false;
     }
     sqlite3* db = connection_.get();
     char* err = nullptr;
     int rc = sqlite3_exec(db, sql, nullptr, nullptr, &err);
     if (rc != SQLITE_OK) {
-        std::cerr << "taskman: " << (err ? err : "sqlite3_exec failed") << "\n";
+        diag() << "taskman: " << (err ? err : "sqlite3_exec failed") << "\n";
         if (err) {
             sqlite3_free(err);
         }
@@ -27,16 +48,16 @@ bool QueryExecutor::exec(const char* sql) {
 }
 
 bool QueryExecutor::run(const char* sql, const std::vector<std::optional<std::string>>& params) {
-    if (!connection_.is_open()) {
-        std::cerr << "taskman: database not open\n";
+    if (!connection_.ensure_open()) {
         return false;
     }
     sqlite3* db = connection_.get();
-    sqlite3_stmt* stmt = nullptr;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
-        std::cerr << "taskman: " << sqlite3_errmsg(db) << "\n";
+    PreparedStatement prepared = connection_.prepare(sql);
+    if (!prepared) {
+        diag() << "taskman: " << sqlite3_errmsg(db) << "\n";
         return false;
     }
+    sqlite3_stmt* stmt = prepared.get();
     for (size_t i = 0; i < params.size(); ++i) {
         if (params[i].has_value()) {
             const std::string& s = *params[i];
@@ -46,29 +67,60 @@ bool QueryExecutor::run(const char* sql, const std::vector<std::optional<std::st
             sqlite3_bind_null(stmt, static_cast<int>(i + 1));
         }
     }
-    int rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
-    if (rc != SQLITE_DONE) {
-        std::cerr << "taskman: " << sqlite3_errmsg(db) << "\n";
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+        diag() << "taskman: " << sqlite3_errmsg(db) << "\n";
         return false;
     }
     return true;
 }
 
+bool QueryExecutor::run_many(const char* sql, const std::vector<std::vector<std::optional<std::string>>>& rows) {
+    if (!connection_.ensure_open()) {
+        return false;
+    }
+    sqlite3* db = connection_.get();
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        diag() << "taskman: " << sqlite3_errmsg(db) << "\n";
+        return false;
+    }
+    for (const auto& params : rows) {
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+        for (size_t i = 0; i < params.size(); ++i) {
+            if (params[i].has_value()) {
+                const std::string& s = *params[i];
+                sqlite3_bind_text(stmt, static_cast<int>(i + 1), s.c_str(),
+                                  static_cast<int>(s.size()), SQLITE_STATIC);
+            } else {
+                sqlite3_bind_null(stmt, static_cast<int>(i + 1));
+            }
+        }
+        if (sqlite3_step(stmt) != SQLITE_DONE) {
+            diag() << "taskman: " << sqlite3_errmsg(db) << "\n";
+            sqlite3_finalize(stmt);
+            return false;
+        }
+    }
+    sqlite3_finalize(stmt);
+    return true;
+}
+
 std::vector<std::map<std::string, std::optional<std::string>>> QueryExecutor::query(const char* sql) {
     std::vector<std::map<std::string, std::optional<std::string>>> rows;
-    if (!connection_.is_open()) {
-        std::cerr << "taskman: database not open\n";
+    if (!connection_.ensure_open()) {
         return rows;
     }
     sqlite3* db = connection_.get();
-    sqlite3_stmt* stmt = nullptr;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
-        std::cerr << "taskman: " << sqlite3_errmsg(db) << "\n";
+    PreparedStatement prepared = connection_.prepare(sql);
+    if (!prepared) {
+        diag() << "taskman: " << sqlite3_errmsg(db) << "\n";
         return rows;
     }
-    int ncol = sqlite3_column_count(stmt);
+    sqlite3_stmt* stmt = prepared.get();
     while (sqlite3_step(stmt) == SQLITE_ROW) {
+        // Colonnes lues après step : une requête reprise du cache est recompilée par step si le schéma a changé
+        int ncol = sqlite3_column_count(stmt);
         std::map<std::string, std::optional<std::string>> row;
         for (int i = 0; i < ncol; ++i) {
             const char* name = sqlite3_column_name(stmt, i);
@@ -82,23 +134,22 @@ std::vector<std::map<std::string, std::optional<std::string>>> QueryExecutor::qu
         }
         rows.push_back(std::move(row));
     }
-    sqlite3_finalize(stmt);
     return rows;
 }
 
 std::vector<std::map<std::string, std::optional<std::string>>> QueryExecutor::query(
     const char* sql, const std::vector<std::optional<std::string>>& params) {
     std::vector<std::map<std::string, std::optional<std::string>>> rows;
-    if (!connection_.is_open()) {
-        std::cerr << "taskman: database not open\n";
+    if (!connection_.ensure_open()) {
         return rows;
     }
     sqlite3* db = connection_.get();
-    sqlite3_stmt* stmt = nullptr;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
-        std::cerr << "taskman: " << sqlite3_errmsg(db) << "\n";
+    PreparedStatement prepared = connection_.prepare(sql);
+    if (!prepared) {
+        diag() << "taskman: " << sqlite3_errmsg(db) << "\n";
         return rows;
     }
+    sqlite3_stmt* stmt = prepared.get();
     for (size_t i = 0; i < params.size(); ++i) {
         if (params[i].has_value()) {
             const std::string& s = *params[i];
@@ -108,8 +159,9 @@ std::vector<std::map<std::string, std::optional<std::string>>> QueryExecutor::qu
             sqlite3_bind_null(stmt, static_cast<int>(i + 1));
         }
     }
-    int ncol = sqlite3_column_count(stmt);
     while (sqlite3_step(stmt) == SQLITE_ROW) {
+        // Colonnes lues après step : une requête reprise du cache est recompilée par step si le schéma a changé
+        int ncol = sqlite3_column_count(stmt);
         std::map<std::string, std::optional<std::string>> row;
         for (int i = 0; i < ncol; ++i) {
             const char* name = sqlite3_column_name(stmt, i);
@@ -123,8 +175,49 @@ std::vector<std::map<std::string, std::optional<std::string>>> QueryExecutor::qu
         }
         rows.push_back(std::move(row));
     }
-    sqlite3_finalize(stmt);
     return rows;
 }
 
+bool QueryExecutor::query_into(const char* sql, const std::vector<std::optional<std::string>>& params,
+                               RowSink& sink) {
+    if (!connection_.ensure_open()) {
+        return false;
+    }
+    sqlite3* db = connection_.get();
+    PreparedStatement prepared = connection_.prepare(sql);
+    if (!prepared) {
+        diag() << "taskman: " << sqlite3_errmsg(db) << "\n";
+        return false;
+    }
+    sqlite3_stmt* stmt = prepared.get();
+    for (size_t i = 0; i < params.size(); ++i) {
+        if (params[i].has_value()) {
+            const std::string& s = *params[i];
+            sqlite3_bind_text(stmt, static_cast<int>(i + 1), s.c_str(),
+                              static_cast<int>(s.size()), SQLITE_TRANSIENT);
+        } else {
+            sqlite3_bind_null(stmt, static_cast<int>(i + 1));
+        }
+    }
+    RowCursor cursor(stmt);
+    int rc = sqlite3_step(stmt);
+    sink.columns(cursor);  // après le premier step (recompilation éventuelle, voir query)
+    for (; rc == SQLITE_ROW; rc = sqlite3_step(stmt)) {
+        sink.row(cursor);
+    }
+    if (rc != SQLITE_DONE) {
+        diag() << "taskman: " << sqlite3_errmsg(db) << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool QueryExecutor::compact_enums() {
+    if (auto cached = connection_.compact_enums()) return *cached;
+    if (!connection_.ensure_open()) return false;
+    bool compact = !query("SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = 'status_codes'").empty();
+    connection_.set_compact_enums(compact);
+    return compact;
+}
+
 } // namespace taskman
@@ -1,7 +1,9 @@
 /**
  * QueryExecutor — exécution de requêtes SQL uniquement.
  * Responsabilité unique : exécuter des requêtes SQL (DDL, DML, SELECT).
- * Nécessite une DatabaseConnection pour fonctionner.
+ * Nécessite une DatabaseConnection pour fonctionner. run, query et query_into reprennent les
+ * requêtes préparées de la connexion (DatabaseConnection::prepare) : chaque texte SQL n'est
+ * préparé qu'une fois par connexion.
  */
 
 #ifndef TASKMAN_QUERY_EXECUTOR_HPP
@@ -11,10 +13,51 @@
 #include <map>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
+struct sqlite3_stmt;
+
 namespace taskman {
 
+/** Vue sur la ligne courante d'un SELECT (valide uniquement pendant l'appel de RowSink). */
+class RowCursor {
+public:
+    explicit RowCursor(sqlite3_stmt* stmt) : stmt_(stmt) {}
+
+    /** Vue réduite aux n premières colonnes (colonnes techniques en fin de SELECT masquées). */
+    RowCursor first_columns(int n) const {
+        RowCursor view(stmt_);
+        view.size_ = n;
+        return view;
+    }
+
+    /** Nombre de colonnes du résultat. */
+    int size() const;
+    /** Nom de la colonne i (alias AS compris). */
+    const char* name(int i) const;
+    /** Vrai si la valeur de la colonne i est SQL NULL. */
+    bool is_null(int i) const;
+    /** Vrai si la valeur de la colonne i est stockée en entier. */
+    bool is_integer(int i) const;
+    /** Valeur texte de la colonne i (vide si NULL), sans copie. */
+    std::string_view text(int i) const;
+
+private:
+    sqlite3_stmt* stmt_;
+    int size_ = -1;  // -1 : toutes les colonnes
+};
+
+/** Consommateur de lignes d'un SELECT, alimenté directement par le curseur SQLite (sans map). */
+class RowSink {
+public:
+    virtual ~RowSink() = default;
+    /** Appelé une fois avant les lignes (noms de colonnes disponibles, même sans ligne). */
+    virtual void columns(const RowCursor&) {}
+    /** Appelé pour chaque ligne. */
+    virtual void row(const RowCursor& cursor) = 0;
+};
+
 class QueryExecutor {
 public:
     /** Constructeur prenant une référence à DatabaseConnection.
@@ -32,6 +75,11 @@ public:
      * En échec : message sur stderr, retour false. */
     bool run(const char* sql, const std::vector<std::optional<std::string>>& params);
 
+    /** Exécute la même requête pour chaque jeu de paramètres : une seule préparation, puis
+     * bind/step/reset par ligne (insertions en masse, à appeler dans une transaction).
+     * S'arrête à la première erreur : message sur stderr, retour false. */
+    bool run_many(const char* sql, const std::vector<std::vector<std::optional<std::string>>>& rows);
+
     /** SELECT : retourne les lignes en map nom_colonne → valeur (nullopt = SQL NULL).
      * En échec : message sur stderr, retour vector vide. */
     std::vector<std::map<std::string, std::optional<std::string>>> query(const char* sql);
@@ -40,6 +88,17 @@ public:
     std::vector<std::map<std::string, std::optional<std::string>>> query(
         const char* sql, const std::vector<std::optional<std::string>>& params);
 
+    /** SELECT paramétré en flux : sink.columns() puis sink.row() pour chaque ligne.
+     * En échec : message sur stderr, retour false. */
+    bool query_into(const char* sql, const std::vector<std::optional<std::string>>& params, RowSink& sink);
+
+    /** Vrai si status et role sont stockés en codes entiers (table status_codes, voir
+     * SchemaManager::compact_enums) ; lu une fois par connexion. */
+    bool compact_enums();
+
+    /** Oublie le mode lu par compact_enums() (après migration du schéma). */
+    void forget_compact_enums() { connection_.set_compact_enums(std::nullopt); }
+
 private:
     DatabaseConnection& connection_;
 };
@@ -3,6 +3,10 @@
  */
 
 #include "schema_manager.hpp"
+#include "transaction.hpp"
+#include "util/diagnostics.hpp"
+#include "util/roles.hpp"
+#include "util/statuses.hpp"
 #include <string>
 
 namespace taskman {
@@ -31,6 +35,37 @@ bool SchemaManager::ensure_timestamps(const char* table) {
     return true;
 }
 
+bool SchemaManager::ensure_data_version() {
+    static const char* const data_version_sql =
+        "CREATE TABLE IF NOT EXISTS data_version (\n"
+        "  id INTEGER PRIMARY KEY CHECK (id = 1),\n"
+        "  epoch TEXT NOT NULL,\n"
+        "  version INTEGER NOT NULL DEFAULT 0\n"
+        ");";
+    if (!executor_.exec(data_version_sql)) return false;
+    // epoch aléatoire : une base recréée (demo:generate) ne reprend pas les jetons de l'ancienne
+    if (!executor_.exec("INSERT OR IGNORE INTO data_version (id, epoch, version) "
+                        "VALUES (1, lower(hex(randomblob(8))), 0)")) return false;
+
+    static const char* const tables[] = {"phases", "milestones", "tasks", "task_deps", "task_notes"};
+    static const char* const operations[] = {"INSERT", "UPDATE", "DELETE"};
+    for (const char* table : tables) {
+        for (const char* operation : operations) {
+            std::string sql = "CREATE TRIGGER IF NOT EXISTS trg_";
+            sql += table;
+            sql += "_";
+            sql += operation;
+            sql += "_version AFTER ";
+            sql += operation;
+            sql += " ON ";
+            sql += table;
+            sql += " BEGIN UPDATE data_version SET version = version + 1 WHERE id = 1; END";
+            if (!executor_.exec(sql.c_str())) return false;
+        }
+    }
+    return true;
+}
+
 bool SchemaManager::init_schema() {
     static const char* const phases_sql =
         "CREATE TABLE IF NOT EXISTS phases (\n"
@@ -83,6 +118,9 @@ bool SchemaManager::init_schema() {
         ");";
     if (!executor_.exec(task_deps_sql)) return false;
 
+    // Index inverse : « qui dépend de X ? » (tâches débloquées quand X passe à done)
+    if (!executor_.exec("CREATE INDEX IF NOT EXISTS idx_task_deps_depends_on ON task_deps(depends_on)")) return false;
+
     static const char* const task_notes_sql =
         "CREATE TABLE IF NOT EXISTS task_notes (\n"
         "  id TEXT PRIMARY KEY,\n"
@@ -95,15 +133,135 @@ bool SchemaManager::init_schema() {
         ");";
     if (!executor_.exec(task_notes_sql)) return false;
 
+    // Notes d'une tâche (task:note:list, dernière note de context)
+    if (!executor_.exec("CREATE INDEX IF NOT EXISTS idx_task_notes_task_id ON task_notes(task_id, created_at)")) return false;
+
     if (!ensure_timestamps("phases")) return false;
     if (!ensure_timestamps("milestones")) return false;
     if (!ensure_timestamps("tasks")) return false;
 
+    // Ordre des listes de tâches : tri sans étape de TEMP B-TREE et reprise par clé (list_page)
+    if (!executor_.exec("CREATE INDEX IF NOT EXISTS idx_tasks_list_order ON tasks(phase_id, milestone_id, sort_order, id)")) return false;
+
     if (!table_has_column("tasks", "creator")) {
         if (!executor_.exec("ALTER TABLE tasks ADD COLUMN creator TEXT")) return false;
     }
 
+    if (!ensure_data_version()) return false;
+    return !executor_.compact_enums() || ensure_enum_code_tables();
+}
+
+bool SchemaManager::begin_bulk_load() {
+    for (const char* table : {"tasks", "task_deps", "task_notes"}) {
+        std::string sql = std::string("DROP TRIGGER IF EXISTS trg_") + table + "_INSERT_version";
+        if (!executor_.exec(sql.c_str())) return false;
+    }
+    for (const char* index : {"idx_tasks_list_order", "idx_task_deps_depends_on", "idx_task_notes_task_id"}) {
+        std::string sql = std::string("DROP INDEX IF EXISTS ") + index;
+        if (!executor_.exec(sql.c_str())) return false;
+    }
     return true;
 }
 
+bool SchemaManager::end_bulk_load() {
+    if (!init_schema()) return false;
+    return executor_.exec("UPDATE data_version SET version = version + 1 WHERE id = 1");
+}
+
+namespace {
+
+/** Colonne énumérée et sa table de codes ; default_name : valeur DEFAULT du schéma texte. */
+struct EnumColumn {
+    const char* table;
+    const char* column;
+    const EnumTable* codes;
+    const char* default_name;
+};
+
+const EnumColumn ENUM_COLUMNS[] = {
+    {"phases", "status", &STATUS_CODES, "to_do"},
+    {"tasks", "status", &STATUS_CODES, "to_do"},
+    {"tasks", "role", &ROLE_CODES, nullptr},
+    {"tasks", "creator", &ROLE_CODES, nullptr},
+    {"task_notes", "role", &ROLE_CODES, nullptr},
+};
+
+/** 'a', 'b', … : les noms d'une table de codes en littéraux SQL. */
+std::string name_list(const EnumTable& codes) {
+    std::string sql;
+    for (size_t code = 1; code <= codes.size(); ++code) {
+        if (code > 1) sql += ", ";
+        sql += "'";
+        sql += codes.name(static_cast<int>(code));
+        sql += "'";
+    }
+    return sql;
+}
+
+} // namespace
+
+bool SchemaManager::ensure_enum_code_tables() {
+    static const struct {
+        const char* table;
+        const EnumTable* codes;
+    } tables[] = {{"status_codes", &STATUS_CODES}, {"role_codes", &ROLE_CODES}};
+    for (const auto& t : tables) {
+        std::string sql = "CREATE TABLE IF NOT EXISTS ";
+        sql += t.table;
+        sql += " (code INTEGER PRIMARY KEY, name TEXT NOT NULL UNIQUE)";
+        if (!executor_.exec(sql.c_str())) return false;
+        std::vector<std::vector<std::optional<std::string>>> rows;
+        for (size_t code = 1; code <= t.codes->size(); ++code) {
+            rows.push_back({std::to_string(code), std::string(t.codes->name(static_cast<int>(code)))});
+        }
+        sql = "INSERT OR IGNORE INTO ";
+        sql += t.table;
+        sql += " (code, name) VALUES (?, ?)";
+        if (!executor_.run_many(sql.c_str(), rows)) return false;
+    }
+    return true;
+}
+
+bool SchemaManager::compact_enums() {
+    if (executor_.compact_enums()) return true;
+
+    // Valeurs hors liste : pas de code, la migration les perdrait
+    for (const auto& c : ENUM_COLUMNS) {
+        std::string sql = std::string("SELECT DISTINCT ") + c.column + " AS value FROM " + c.table + " WHERE " +
+                          c.column + " IS NOT NULL AND " + c.column + " NOT IN (" + name_list(*c.codes) + ") LIMIT 1";
+        auto rows = executor_.query(sql.c_str());
+        if (!rows.empty()) {
+            diag() << "taskman: cannot compact " << c.table << "." << c.column << ": unknown value '"
+                   << rows[0]["value"].value_or("") << "'\n";
+            return false;
+        }
+    }
+
+    Transaction tx(executor_);
+    if (!tx.active()) return false;
+    if (!ensure_enum_code_tables()) return false;
+    for (const auto& c : ENUM_COLUMNS) {
+        // SQLite ne change pas le type d'une colonne : nouvelle colonne INTEGER, copie, remplacement
+        std::string coded = std::string(c.column) + "_code";
+        std::string sql = std::string("ALTER TABLE ") + c.table + " ADD COLUMN " + coded + " INTEGER";
+        if (c.default_name) sql += " DEFAULT " + std::to_string(c.codes->code(c.default_name));
+        if (!executor_.exec(sql.c_str())) return false;
+        sql = std::string("UPDATE ") + c.table + " SET " + coded + " = CASE " + c.column;
+        for (size_t code = 1; code <= c.codes->size(); ++code) {
+            sql += " WHEN '";
+            sql += c.codes->name(static_cast<int>(code));
+            sql += "' THEN " + std::to_string(code);
+        }
+        sql += " END";
+        if (!executor_.exec(sql.c_str())) return false;
+        sql = std::string("ALTER TABLE ") + c.table + " DROP COLUMN " + c.column;
+        if (!executor_.exec(sql.c_str())) return false;
+        sql = std::string("ALTER TABLE ") + c.table + " RENAME COLUMN " + coded + " TO " + c.column;
+        if (!executor_.exec(sql.c_str())) return false;
+    }
+    bool ok = tx.commit();
+    executor_.forget_compact_enums();
+    return ok;
+}
+
 } // namespace taskman
@@ -24,6 +24,22 @@ public:
      * Retourne false en cas d'erreur (stderr déjà écrit par executor). */
     bool init_schema();
 
+    /** Migration optionnelle (init --compact-enums) : status (phases, tasks), role et creator
+     * (tasks), role (task_notes) passent de TEXT à des codes INTEGER (index + 1 dans STATUS_VALUES
+     * et ROLE_VALUES), avec les tables de correspondance status_codes et role_codes. Une seule
+     * transaction ; refusée (stderr, false) si une colonne contient une valeur hors liste.
+     * Sans effet si la base est déjà migrée. */
+    bool compact_enums();
+
+    /** Chargement en masse (demo:generate --scale) : supprime les index secondaires de tasks,
+     * task_deps et task_notes et les triggers INSERT du compteur data_version, qui coûtent une
+     * écriture par ligne insérée. */
+    bool begin_bulk_load();
+
+    /** Fin du chargement en masse : recrée index et triggers (init_schema, un tri par index
+     * au lieu d'une insertion par ligne) et incrémente le compteur data_version une fois. */
+    bool end_bulk_load();
+
 private:
     QueryExecutor& executor_;
 
@@ -32,6 +48,13 @@ private:
 
     /** Assure que les colonnes created_at et updated_at existent dans une table. */
     bool ensure_timestamps(const char* table);
+
+    /** Crée le compteur de changements data_version (une ligne) et les triggers qui l'incrémentent
+     * à chaque INSERT/UPDATE/DELETE sur les tables de données (voir DataVersion). */
+    bool ensure_data_version();
+
+    /** Crée et complète status_codes et role_codes (codes ajoutés par une version plus récente). */
+    bool ensure_enum_code_tables();
 };
 
 } // namespace taskman
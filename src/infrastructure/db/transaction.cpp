@@ -0,0 +1,34 @@
+/**
+ * Implémentation de Transaction.
+ */
+
+#include "transaction.hpp"
+
+namespace taskman {
+
+Transaction::Transaction(QueryExecutor& executor) : executor_(executor) {
+    active_ = executor_.exec("SAVEPOINT taskman_tx");
+}
+
+Transaction::~Transaction() {
+    rollback();
+}
+
+bool Transaction::commit() {
+    if (!active_) return false;
+    if (!executor_.exec("RELEASE taskman_tx")) {
+        rollback();
+        return false;
+    }
+    active_ = false;
+    return true;
+}
+
+void Transaction::rollback() {
+    if (!active_) return;
+    active_ = false;
+    executor_.exec("ROLLBACK TO taskman_tx");
+    executor_.exec("RELEASE taskman_tx");
+}
+
+} // namespace taskman
@@ -0,0 +1,43 @@
+/**
+ * Transaction — portée transactionnelle RAII sur un QueryExecutor.
+ * Responsabilité unique : regrouper plusieurs écritures en « tout ou rien ».
+ * Implémentée par SAVEPOINT : une Transaction ouverte à l'intérieur d'une autre
+ * devient un point de sauvegarde imbriqué au lieu d'échouer sur BEGIN.
+ * Sans commit() explicite, le destructeur annule les écritures.
+ */
+
+#ifndef TASKMAN_TRANSACTION_HPP
+#define TASKMAN_TRANSACTION_HPP
+
+#include "query_executor.hpp"
+
+namespace taskman {
+
+class Transaction {
+public:
+    /** Ouvre la transaction (SAVEPOINT). En échec : stderr, active() == false. */
+    explicit Transaction(QueryExecutor& executor);
+
+    /** Annule les écritures si commit() n'a pas été appelé. */
+    ~Transaction();
+
+    Transaction(const Transaction&) = delete;
+    Transaction& operator=(const Transaction&) = delete;
+
+    /** Vrai si la transaction est ouverte et ni validée ni annulée. */
+    bool active() const { return active_; }
+
+    /** Valide les écritures (RELEASE). Retourne false en cas d'erreur (stderr déjà écrit). */
+    bool commit();
+
+    /** Annule les écritures (ROLLBACK TO + RELEASE). No-op si déjà terminée. */
+    void rollback();
+
+private:
+    QueryExecutor& executor_;
+    bool active_ = false;
+};
+
+} // namespace taskman
+
+#endif /* TASKMAN_TRANSACTION_HPP */
@@ -56,7 +56,13 @@ void print_usage(const taskman::CommandRegistry& registry) {
 } // namespace
 
 int main(int argc, char* argv[]) {
-    // Initialiser le registre de commandes
+    // --version : sans registre ni base
+    if (argc >= 2 && (std::strcmp(argv[1], "-v") == 0 || std::strcmp(argv[1], "--version") == 0)) {
+        std::cout << "taskman " << TASKMAN_VERSION << "\n";
+        return 0;
+    }
+
+    // Initialiser le registre de commandes (construction paresseuse : rien n'est instancié ici)
     taskman::CommandRegistry registry;
     taskman::register_all_commands(registry);
 
@@ -68,10 +74,6 @@ int main(int argc, char* argv[]) {
     const char* cmd = argv[1];
     
     // Gestion des options globales
-    if (std::strcmp(cmd, "-v") == 0 || std::strcmp(cmd, "--version") == 0) {
-        std::cout << "taskman " << TASKMAN_VERSION << "\n";
-        return 0;
-    }
 
     if (std::strcmp(cmd, "-h") == 0 || std::strcmp(cmd, "--help") == 0) {
         print_usage(registry);
@@ -91,9 +93,8 @@ int main(int argc, char* argv[]) {
     
     if (registry.command_requires_database(cmd)) {
         db = std::make_unique<taskman::Database>();
-        if (!db->open(get_db_path())) {
-            return 1;
-        }
+        // Ouverture à la première requête : --help et arguments invalides n'ouvrent pas la base
+        db->open_deferred(get_db_path());
         db_ptr = db.get();
     }
 
@@ -105,6 +106,9 @@ int main(int argc, char* argv[]) {
         print_usage(registry);
         return 1;
     }
+    if (db && db->open_failed()) {
+        return 1;
+    }
 
     return result;
 }
@@ -1,16 +1,32 @@
 /**
  * MCP server — boucle stdio, parse JSON-RPC, dispatch (squelette + lifecycle).
- * Refactorisé selon SRP : utilisation de McpProtocolHandler, McpToolRegistry et McpToolExecutor.
+ * Refactorisé selon SRP : le routage et l'exécution sont dans McpDispatcher (partagé avec le
+ * transport HTTP), le protocole dans McpProtocolHandler.
+ * Chaque ligne est parsée une fois (McpProtocolHandler::parse_line) ; tools/list est sérialisé
+ * au démarrage. stdin/stdout sont bufferisés (pas de synchro stdio, cin non lié à cout).
+ * Lots JSON-RPC : un lot d'appels en lecture seule s'exécute sur un seul snapshot de la base.
+ *
+ * Concurrence : voir McpDispatcher (lectures en parallèle, voie d'écriture unique, attentes
+ * détachées). Les réponses sont écrites par McpResponseWriter, dans l'ordre de fin d'exécution ;
+ * la lecture de stdin est suspendue au-delà de TASKMAN_MCP_MAX_IN_FLIGHT requêtes en cours
+ * (attentes non comprises : limitées par TASKMAN_MCP_MAX_WAITS, sans suspendre la lecture).
+ * Ressources : resources/subscribe et resources/unsubscribe passent par la voie d'écriture
+ * (la référence d'un abonnement voit les écritures reçues avant lui) ; McpResourceWatcher
+ * émet notifications/resources/updated.
+ * TASKMAN_MCP_RECORD : chaque ligne reçue et le temps de sa réponse sont ajoutés à un fichier
+ * JSONL (McpSessionRecorder), rejouable par `taskman bench:mcp --replay`.
  */
 
 #include "mcp.hpp"
+#include "mcp_dispatcher.hpp"
 #include "mcp_protocol_handler.hpp"
-#include "mcp_tool_registry.hpp"
-#include "mcp_tool_executor.hpp"
-#include "cli/command.hpp"
+#include "mcp_resource_watcher.hpp"
+#include "mcp_response_writer.hpp"
+#include "mcp_session_recorder.hpp"
 #include <nlohmann/json.hpp>
 #include <cstdlib>
 #include <iostream>
+#include <memory>
 #include <string>
 
 namespace taskman {
@@ -26,74 +42,54 @@ std::string get_db_path() {
 } // namespace
 
 int run_mcp_server() {
-    // Initialiser les composants
-    McpProtocolHandler protocol_handler;
-    McpToolRegistry tool_registry;
-    
-    // Créer le registre de commandes CLI
-    CommandRegistry command_registry;
-    register_all_commands(command_registry);
-    
-    // Créer l'exécuteur d'outils MCP
-    McpToolExecutor tool_executor(tool_registry, command_registry, get_db_path());
-
-    // Boucle principale : lire les requêtes JSON-RPC depuis stdin
-    std::string line;
-    while (std::getline(std::cin, line)) {
-        // Traiter la requête via le protocole handler
-        bool handled = protocol_handler.process_request(line);
-        
-        if (!handled) {
-            // La requête nécessite un traitement spécial (tools/list ou tools/call)
-            // On doit parser manuellement pour obtenir les détails
-            nlohmann::json j;
-            try {
-                // Trim trailing \r (Windows CRLF)
-                std::string trimmed_line = line;
-                while (!trimmed_line.empty() && trimmed_line.back() == '\r')
-                    trimmed_line.pop_back();
-                j = nlohmann::json::parse(trimmed_line);
-            } catch (const nlohmann::json::exception&) {
-                // Déjà géré par process_request
-                continue;
-            }
+    // E/S bufferisées : le flush est fait explicitement après les réponses
+    std::ios::sync_with_stdio(false);
+    std::cin.tie(nullptr);
 
-            if (!j.contains("id") || !j.contains("method")) {
-                continue;
-            }
+    // stdout d'origine, conservé même quand une commande CLI redirige std::cout
+    McpResponseWriter writer(std::cout.rdbuf());
+    // Détruit après dispatcher : les dernières réponses sont encore enregistrées
+    std::unique_ptr<McpSessionRecorder> recorder = McpSessionRecorder::from_env();
 
-            nlohmann::json id = j["id"];
-            std::string method = j["method"].get<std::string>();
+    // Détruit avant writer : les messages en cours sont terminés avant la fin des écritures
+    McpDispatcher dispatcher(get_db_path());
+    McpProtocolHandler protocol_handler;
+    dispatcher.register_methods(protocol_handler);
 
-            if (method == "tools/list") {
-                // Obtenir la liste des outils depuis le registre
-                auto tools_json = tool_registry.list_tools_json();
-                protocol_handler.handle_tools_list(id, tools_json);
-            } else if (method == "tools/call") {
-                // Exécuter l'outil via l'exécuteur
-                nlohmann::json params = j.contains("params") ? j["params"] : nlohmann::json();
-                if (!params.is_object() || !params.contains("name")) {
-                    continue; // Déjà validé par process_request
-                }
-                
-                std::string tool_name = params["name"].get<std::string>();
-                nlohmann::json arguments = params.contains("arguments") && params["arguments"].is_object()
-                    ? params["arguments"] : nlohmann::json::object();
+    // Abonnements : connexion propre au watcher
+    auto watcher_executor = dispatcher.make_executor();
+    McpResourceWatcher watcher(*watcher_executor, [&writer](std::string notification) {
+        writer.write(std::move(notification));
+    });
+    McpDispatcher::register_subscriptions(protocol_handler, watcher);
+    dispatcher.set_release_hook([&watcher] { watcher.release_database(); });
 
-                std::string output;
-                bool is_error = false;
-                int result = tool_executor.execute_tool(tool_name, arguments, output, is_error);
+    auto reply = [&writer](std::string response) {
+        if (!response.empty()) writer.write(std::move(response));
+    };
 
-                if (result == -1) {
-                    // Outil inconnu → erreur JSON-RPC avec code -32602
-                    protocol_handler.send_tool_error(id, "Unknown tool: " + tool_name);
-                } else {
-                    // Succès ou erreur métier → réponse normale
-                    protocol_handler.handle_tools_call(id, params, output, is_error);
-                }
-            }
+    // Boucle principale : lire les requêtes JSON-RPC depuis stdin
+    std::string line;
+    std::string response;
+    nlohmann::json message;
+    while (std::getline(std::cin, line)) {
+        McpSessionRecorder::Pending pending;
+        if (recorder) pending = recorder->record_message(line);
+        if (!protocol_handler.parse_line(line, message, response)) {
+            if (recorder) recorder->record_response(pending, response.size());
+            if (!response.empty()) writer.write(std::move(response));
+            continue;
+        }
+        if (!recorder) {
+            dispatcher.submit(protocol_handler, std::move(message), reply);
+            continue;
         }
+        dispatcher.submit(protocol_handler, std::move(message), [&reply, &recorder, pending](std::string response) {
+            recorder->record_response(pending, response.size());
+            reply(std::move(response));
+        });
     }
+    dispatcher.wait_idle();
     return 0;
 }
 
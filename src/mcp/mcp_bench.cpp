@@ -0,0 +1,234 @@
+/**
+ * Implémentation bench:mcp.
+ */
+
+#include "mcp_bench.hpp"
+#include "mcp_dispatcher.hpp"
+#include "mcp_protocol_handler.hpp"
+#include "mcp_resource_watcher.hpp"
+#include <nlohmann/json.hpp>
+#include <cxxopts.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace taskman {
+
+namespace {
+
+/** Message à rejouer : texte reçu et session d'origine (vide en stdio). */
+struct ReplayMessage {
+    std::string line;
+    std::string session;
+};
+
+double round3(double v) {
+    return std::round(v * 1000.0) / 1000.0;
+}
+
+/** {mean_ms, p50_ms, p95_ms, p99_ms, max_ms} de latences en millisecondes (triées ici). */
+nlohmann::json latency_summary(std::vector<double>& ms) {
+    if (ms.empty()) return nlohmann::json::object();
+    std::sort(ms.begin(), ms.end());
+    auto percentile = [&ms](double q) {
+        size_t rank = static_cast<size_t>(std::ceil(q * static_cast<double>(ms.size())));
+        return round3(ms[std::max<size_t>(rank, 1) - 1]);
+    };
+    double total = 0;
+    for (double v : ms) total += v;
+    return {
+        {"mean_ms", round3(total / static_cast<double>(ms.size()))},
+        {"p50_ms", percentile(0.50)},
+        {"p95_ms", percentile(0.95)},
+        {"p99_ms", percentile(0.99)},
+        {"max_ms", round3(ms.back())},
+    };
+}
+
+/** Réponses d'erreur JSON-RPC (membre error de premier niveau) et résultats d'outil isError d'une
+ * réponse, ou de chaque réponse d'un lot. Le texte d'un résultat (titre, note…) n'est pas examiné. */
+void count_errors(const std::string& response, size_t& errors, size_t& tool_errors) {
+    nlohmann::json parsed = nlohmann::json::parse(response, nullptr, false);
+    auto count = [&](const nlohmann::json& reply) {
+        if (!reply.is_object()) return;
+        if (reply.contains("error")) ++errors;
+        auto result = reply.find("result");
+        if (result != reply.end() && result->is_object() && result->value("isError", false)) ++tool_errors;
+    };
+    if (parsed.is_array()) {
+        for (const auto& reply : parsed) count(reply);
+    } else {
+        count(parsed);
+    }
+}
+
+/**
+ * Lit le fichier à rejouer. Ligne {"line": …} (TASKMAN_MCP_RECORD) : message, avec sa session ;
+ * ligne {"latency_ms": …} : latence enregistrée ; autre ligne non vide : message JSON-RPC brut.
+ */
+bool load_replay(const std::string& path, std::vector<ReplayMessage>& messages, std::vector<double>& recorded_ms) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        std::cerr << "taskman: cannot read --replay file: " << path << "\n";
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.find_first_not_of(" \t") == std::string::npos) continue;
+        nlohmann::json entry = nlohmann::json::parse(line, nullptr, false);
+        if (entry.is_object() && entry.contains("line") && entry["line"].is_string()) {
+            auto session = entry.find("session");
+            messages.push_back({entry["line"].get<std::string>(),
+                                session != entry.end() && session->is_string() ? session->get<std::string>() : ""});
+        } else if (entry.is_object() && entry.contains("latency_ms") && entry["latency_ms"].is_number()) {
+            recorded_ms.push_back(entry["latency_ms"].get<double>());
+        } else {
+            messages.push_back({line, ""});
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int cmd_bench_mcp(int argc, char* argv[]) {
+    cxxopts::Options opts("taskman bench:mcp", "Replay a recorded MCP session in-process and report latency");
+    opts.add_options()
+        ("replay", "JSONL file from TASKMAN_MCP_RECORD, or one JSON-RPC message per line", cxxopts::value<std::string>())
+        ("db", "Database to run the session on (modified by the replayed writes: use a copy)", cxxopts::value<std::string>())
+        ("repeat", "Replay the session N times (1-1000)", cxxopts::value<std::string>()->default_value("1"))
+        ("help", "Show help");
+
+    for (int i = 0; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0) {
+            std::cout << opts.help() << '\n';
+            std::cout << "\nExample:\n"
+                      << "  TASKMAN_MCP_RECORD=session.jsonl taskman mcp    # record an agent session\n"
+                      << "  cp project_tasks.db /tmp/copy.db\n"
+                      << "  taskman bench:mcp --replay session.jsonl --db /tmp/copy.db --repeat 10\n";
+            return 0;
+        }
+    }
+
+    cxxopts::ParseResult result;
+    try {
+        result = opts.parse(argc, argv);
+    } catch (const cxxopts::exceptions::exception& e) {
+        std::cerr << "taskman: " << e.what() << "\n";
+        return 1;
+    }
+    if (!result.count("replay")) {
+        std::cerr << "taskman: --replay is required\n";
+        return 1;
+    }
+    if (!result.count("db")) {
+        std::cerr << "taskman: --db is required\n";
+        return 1;
+    }
+    int repeat = 0;
+    try {
+        size_t pos = 0;
+        std::string value = result["repeat"].as<std::string>();
+        repeat = std::stoi(value, &pos);
+        if (pos != value.size()) repeat = 0;
+    } catch (...) {}
+    if (repeat < 1 || repeat > 1000) {
+        std::cerr << "taskman: --repeat must be between 1 and 1000\n";
+        return 1;
+    }
+
+    std::string replay_path = result["replay"].as<std::string>();
+    std::string db_path = result["db"].as<std::string>();
+    std::vector<ReplayMessage> messages;
+    std::vector<double> recorded_ms;
+    if (!load_replay(replay_path, messages, recorded_ms)) return 1;
+    if (messages.empty()) {
+        std::cerr << "taskman: no message to replay in " << replay_path << "\n";
+        return 1;
+    }
+
+    std::mutex mutex;
+    std::vector<double> latencies;
+    latencies.reserve(messages.size() * static_cast<size_t>(repeat));
+    size_t responses = 0, errors = 0, tool_errors = 0, response_bytes = 0;
+    std::atomic<size_t> notifications{0};
+    auto record = [&](std::chrono::steady_clock::time_point received, const std::string& response) {
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - received).count();
+        std::lock_guard<std::mutex> lock(mutex);
+        latencies.push_back(ms);
+        if (response.empty()) return;
+        ++responses;
+        response_bytes += response.size();
+        count_errors(response, errors, tool_errors);
+    };
+
+    double elapsed_s = 0;
+    {
+        // Même assemblage que run_mcp_server ; un gestionnaire de protocole par session enregistrée
+        McpDispatcher dispatcher(db_path);
+        auto watcher_executor = dispatcher.make_executor();
+        McpResourceWatcher watcher(*watcher_executor, [&notifications](std::string) { ++notifications; });
+        dispatcher.set_release_hook([&watcher] { watcher.release_database(); });
+        std::map<std::string, std::unique_ptr<McpProtocolHandler>> handlers;
+        for (const auto& message : messages) {
+            auto& handler = handlers[message.session];
+            if (handler) continue;
+            handler = std::make_unique<McpProtocolHandler>();
+            dispatcher.register_methods(*handler);
+            McpDispatcher::register_subscriptions(*handler, watcher);
+        }
+
+        auto started = std::chrono::steady_clock::now();
+        nlohmann::json parsed;
+        std::string response;
+        for (int r = 0; r < repeat; ++r) {
+            for (const auto& message : messages) {
+                auto received = std::chrono::steady_clock::now();
+                McpProtocolHandler& handler = *handlers[message.session];
+                if (!handler.parse_line(message.line, parsed, response)) {
+                    record(received, response);
+                    continue;
+                }
+                dispatcher.submit(handler, std::move(parsed),
+                                  [&record, received](std::string reply) { record(received, reply); });
+            }
+        }
+        dispatcher.wait_idle();
+        elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    }
+
+    size_t submitted = latencies.size();
+    nlohmann::json out = {
+        {"replay", replay_path},
+        {"db", db_path},
+        {"repeat", repeat},
+        {"messages", submitted},
+        {"responses", responses},
+        {"errors", errors},
+        {"tool_errors", tool_errors},
+        {"notifications", notifications.load()},
+        {"response_bytes", response_bytes},
+        {"elapsed_s", round3(elapsed_s)},
+        {"messages_per_s", elapsed_s > 0 ? std::round(static_cast<double>(submitted) / elapsed_s) : 0.0},
+    };
+    out.update(latency_summary(latencies));
+    if (!recorded_ms.empty()) {
+        nlohmann::json recorded = latency_summary(recorded_ms);
+        recorded["responses"] = recorded_ms.size();
+        out["recorded"] = std::move(recorded);
+    }
+    std::cout << out.dump() << "\n";
+    return 0;
+}
+
+} // namespace taskman
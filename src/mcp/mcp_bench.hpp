@@ -0,0 +1,23 @@
+/**
+ * Commande bench:mcp : rejoue une session MCP enregistrée dans le serveur, en processus.
+ */
+
+#ifndef TASKMAN_MCP_BENCH_HPP
+#define TASKMAN_MCP_BENCH_HPP
+
+namespace taskman {
+
+/** bench:mcp --replay <fichier> --db <base> [--repeat N]
+ *  Lit un fichier JSONL de TASKMAN_MCP_RECORD (lignes {"line"} ; les lignes de réponse donnent
+ *  les latences enregistrées) ou une session brute (un message JSON-RPC par ligne), puis soumet
+ *  les messages à un McpDispatcher sur --db, dans l'ordre d'arrivée et sans attendre les
+ *  réponses (comme un client qui enchaîne ses requêtes). Un McpProtocolHandler par session
+ *  enregistrée. Écrit sur stdout en JSON le débit et les percentiles de latence (de la
+ *  réception d'une ligne à sa réponse), et ceux de l'enregistrement s'il en contient.
+ *  --db est modifiée par les écritures rejouées : passer une copie.
+ */
+int cmd_bench_mcp(int argc, char* argv[]);
+
+} // namespace taskman
+
+#endif /* TASKMAN_MCP_BENCH_HPP */
@@ -0,0 +1,403 @@
+/**
+ * Implémentation de McpDispatcher.
+ */
+
+#include "mcp_dispatcher.hpp"
+#include "mcp_protocol_handler.hpp"
+#include "mcp_resource_watcher.hpp"
+#include "mcp_resources.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+namespace taskman {
+
+namespace {
+
+/**
+ * tools/call : validation des params puis exécution via McpToolExecutor. Chaque appel d'un outil
+ * connu est compté dans stats (latence jusqu'à la réponse sérialisée, tailles des arguments et
+ * de la réponse) ; taskman_server_stats retourne ces métriques sans accès à la base.
+ */
+std::string handle_tools_call(McpToolExecutor& executor, McpToolStats& stats, const nlohmann::json& id,
+                              const nlohmann::json& params) {
+    if (!params.is_object()) {
+        return McpProtocolHandler::make_error(id, McpProtocolHandler::INVALID_PARAMS, "Invalid arguments");
+    }
+    auto name_it = params.find("name");
+    if (name_it == params.end() || !name_it->is_string()) {
+        return McpProtocolHandler::make_error(id, McpProtocolHandler::INVALID_PARAMS,
+                                              "Invalid arguments: missing or invalid 'name'");
+    }
+    // Vérifier que arguments est un objet s'il est présent
+    auto args_it = params.find("arguments");
+    if (args_it != params.end() && !args_it->is_object()) {
+        return McpProtocolHandler::make_error(id, McpProtocolHandler::INVALID_PARAMS,
+                                              "Invalid arguments: 'arguments' must be an object");
+    }
+    static const nlohmann::json no_arguments = nlohmann::json::object();
+    const std::string& tool_name = name_it->get_ref<const std::string&>();
+    const nlohmann::json& arguments = args_it != params.end() ? *args_it : no_arguments;
+    auto started = std::chrono::steady_clock::now();
+
+    std::string output;
+    bool is_error = false;
+    nlohmann::json structured;
+    if (tool_name == McpToolStats::TOOL_NAME) {
+        structured = stats.to_json();
+        output = structured.dump() + "\n";
+    } else if (executor.execute_tool(tool_name, arguments, output, is_error, &structured) == -1) {
+        // Outil inconnu → erreur JSON-RPC avec code -32602 (non compté)
+        return McpProtocolHandler::make_error(id, McpProtocolHandler::INVALID_PARAMS, "Unknown tool: " + tool_name);
+    }
+    // Succès ou erreur métier → réponse normale
+    std::string response =
+        McpProtocolHandler::make_result(id, McpProtocolHandler::make_tool_result(output, is_error, structured));
+    stats.record(tool_name, std::chrono::steady_clock::now() - started, arguments.dump().size(), response.size(),
+                 is_error);
+    return response;
+}
+
+/**
+ * resources/read : params.uri (une ressource, -32002 si elle n'existe pas) ou params.uris
+ * (au plus McpResources::MAX_READ_URIS, lues ensemble ; les URI sans ressource sont listées
+ * dans "missing"). Contenus dans l'ordre des URI demandées.
+ */
+std::string handle_resources_read(McpToolExecutor& executor, const nlohmann::json& id, const nlohmann::json& params) {
+    if (!params.is_object()) {
+        return McpProtocolHandler::make_error(id, McpProtocolHandler::INVALID_PARAMS, "Invalid arguments");
+    }
+    std::vector<std::string> uris;
+    auto uri_it = params.find("uri");
+    auto uris_it = params.find("uris");
+    bool single = uri_it != params.end();
+    if (single && uri_it->is_string()) {
+        uris.push_back(uri_it->get<std::string>());
+    } else if (!single && uris_it != params.end() && uris_it->is_array() && !uris_it->empty()
+               && uris_it->size() <= McpResources::MAX_READ_URIS) {
+        for (const auto& uri : *uris_it) {
+            if (!uri.is_string()) {
+                return McpProtocolHandler::make_error(id, McpProtocolHandler::INVALID_PARAMS,
+                                                      "Invalid arguments: 'uris' must contain strings");
+            }
+            uris.push_back(uri.get<std::string>());
+        }
+    } else {
+        return McpProtocolHandler::make_error(
+            id, McpProtocolHandler::INVALID_PARAMS,
+            "Invalid arguments: expected 'uri' (string) or 'uris' (1 to "
+                + std::to_string(McpResources::MAX_READ_URIS) + " strings)");
+    }
+    std::string type, entity_id;
+    for (const auto& uri : uris) {
+        if (!McpResources::parse_uri(uri, type, entity_id)) {
+            return McpProtocolHandler::make_error(id, McpProtocolHandler::INVALID_PARAMS, "Invalid resource URI: " + uri);
+        }
+    }
+    std::map<std::string, std::string> contents;
+    if (!executor.read_resources(uris, contents)) {
+        return McpProtocolHandler::make_error(id, McpProtocolHandler::INTERNAL_ERROR, "Failed to open database");
+    }
+    nlohmann::json result;
+    result["contents"] = nlohmann::json::array();
+    nlohmann::json missing = nlohmann::json::array();
+    for (const auto& uri : uris) {
+        auto it = contents.find(uri);
+        if (it == contents.end()) {
+            missing.push_back(uri);
+            continue;
+        }
+        result["contents"].push_back({{"uri", uri}, {"mimeType", McpResources::MIME_TYPE}, {"text", it->second}});
+    }
+    if (single && !missing.empty()) {
+        return McpProtocolHandler::make_error(id, McpProtocolHandler::RESOURCE_NOT_FOUND,
+                                              "Resource not found: " + uris.front());
+    }
+    if (!single) result["missing"] = std::move(missing);
+    return McpProtocolHandler::make_result(id, result);
+}
+
+/** resources/list : phases et jalons (les tâches et les notes passent par resources/templates/list). */
+std::string handle_resources_list(McpToolExecutor& executor, const nlohmann::json& id) {
+    nlohmann::json resources;
+    if (!executor.list_resources(resources)) {
+        return McpProtocolHandler::make_error(id, McpProtocolHandler::INTERNAL_ERROR, "Failed to open database");
+    }
+    return McpProtocolHandler::make_result(id, nlohmann::json{{"resources", std::move(resources)}});
+}
+
+/** resources/subscribe et resources/unsubscribe : params.uri. */
+std::string handle_resources_subscribe(McpResourceWatcher& watcher, const nlohmann::json& id,
+                                       const nlohmann::json& params, bool subscribe) {
+    if (!params.is_object() || !params.contains("uri") || !params["uri"].is_string()) {
+        return McpProtocolHandler::make_error(id, McpProtocolHandler::INVALID_PARAMS,
+                                              "Invalid arguments: missing or invalid 'uri'");
+    }
+    const std::string& uri = params["uri"].get_ref<const std::string&>();
+    if (!subscribe) {
+        watcher.unsubscribe(uri);
+        return McpProtocolHandler::make_result(id, nlohmann::json::object());
+    }
+    std::string error;
+    if (!watcher.subscribe(uri, error)) {
+        return McpProtocolHandler::make_error(id, McpProtocolHandler::INVALID_PARAMS, error);
+    }
+    return McpProtocolHandler::make_result(id, nlohmann::json::object());
+}
+
+/** Requête de la voie de lecture : resources/read, resources/list ou tools/call. */
+std::string handle_read_request(McpToolExecutor& executor, McpToolStats& stats, const nlohmann::json& message) {
+    static const nlohmann::json no_params;
+    auto params_it = message.find("params");
+    const nlohmann::json& params = params_it != message.end() ? *params_it : no_params;
+    const std::string& method = message["method"].get_ref<const std::string&>();
+    if (method == "resources/read") return handle_resources_read(executor, message["id"], params);
+    if (method == "resources/list") return handle_resources_list(executor, message["id"]);
+    return handle_tools_call(executor, stats, message["id"], params);
+}
+
+/** Vrai pour les méthodes de lecture des ressources (voie de lecture, lots en snapshot). */
+bool is_resource_read(const std::string& method) {
+    return method == "resources/read" || method == "resources/list";
+}
+
+/**
+ * Vrai si le lot ne contient que des lectures (tools/call d'outils read_only, resources/read,
+ * resources/list, tools/list, resources/templates/list, ping, notifications) et au moins un
+ * tools/call ou une lecture de ressources : il peut alors partager un snapshot de la base.
+ */
+bool is_read_only_batch(const McpToolRegistry& registry, const nlohmann::json& batch) {
+    bool has_call = false;
+    for (const auto& message : batch) {
+        if (!message.is_object()) return false;
+        auto method_it = message.find("method");
+        if (method_it == message.end() || !method_it->is_string()) return false;
+        const std::string& method = method_it->get_ref<const std::string&>();
+        if (!message.contains("id") || method == "tools/list" || method == "resources/templates/list"
+            || method == "ping") continue;
+        if (is_resource_read(method)) {
+            has_call = true;
+            continue;
+        }
+        if (method != "tools/call") return false;
+        auto params_it = message.find("params");
+        if (params_it == message.end() || !params_it->is_object()) return false;
+        auto name_it = params_it->find("name");
+        if (name_it == params_it->end() || !name_it->is_string()
+            || !registry.is_read_only(name_it->get<std::string>())) return false;
+        has_call = true;
+    }
+    return has_call;
+}
+
+/** Entier positif lu dans l'environnement, ou valeur par défaut. */
+size_t env_size(const char* name, size_t default_value) {
+    const char* env = std::getenv(name);
+    if (!env || env[0] == '\0') return default_value;
+    char* end = nullptr;
+    unsigned long v = std::strtoul(env, &end, 10);
+    return (end && *end == '\0') ? static_cast<size_t>(v) : default_value;
+}
+
+/** Voie d'exécution d'un message. */
+enum class Route { Inline, Read, Write, Wait };
+
+/**
+ * Inline : pas d'accès à la base (initialize, ping, tools/list, resources/templates/list,
+ * taskman_server_stats, notifications, erreurs). Read : tools/call d'un outil read_only à handler typé, resources/read,
+ * resources/list. Wait : tools/call d'un outil bloquant (taskman_task_wait) à handler typé.
+ * Write : autres tools/call, resources/subscribe, resources/unsubscribe et lots.
+ */
+Route route_message(const nlohmann::json& message, const McpToolRegistry& registry,
+                    const McpToolExecutor& executor) {
+    if (message.is_array()) return Route::Write;
+    if (!message.is_object() || !message.contains("id")) return Route::Inline;
+    auto rpc_it = message.find("jsonrpc");
+    auto method_it = message.find("method");
+    if (rpc_it == message.end() || *rpc_it != "2.0"
+        || method_it == message.end() || !method_it->is_string()) return Route::Inline;
+    const std::string& method = method_it->get_ref<const std::string&>();
+    if (is_resource_read(method)) return Route::Read;
+    if (method == "resources/subscribe" || method == "resources/unsubscribe") return Route::Write;
+    if (method != "tools/call") return Route::Inline;
+    auto params_it = message.find("params");
+    if (params_it == message.end() || !params_it->is_object()) return Route::Inline;
+    auto name_it = params_it->find("name");
+    if (name_it == params_it->end() || !name_it->is_string()) return Route::Inline;
+    const std::string& name = name_it->get_ref<const std::string&>();
+    if (name == McpToolStats::TOOL_NAME) return Route::Inline;
+    static const nlohmann::json no_arguments = nlohmann::json::object();
+    auto args_it = params_it->find("arguments");
+    const nlohmann::json& args = args_it != params_it->end() ? *args_it : no_arguments;
+    if (args.is_object() && registry.is_read_only(name) && executor.has_typed_handler(name, args))
+        return Route::Read;
+    if (args.is_object() && registry.is_blocking(name) && executor.has_typed_handler(name, args))
+        return Route::Wait;
+    return Route::Write;
+}
+
+/** Vrai si le message (ou un élément du lot) appelle taskman_demo_generate, qui remplace le fichier. */
+bool calls_demo_generate(const nlohmann::json& message) {
+    if (message.is_array()) {
+        for (const auto& item : message) {
+            if (calls_demo_generate(item)) return true;
+        }
+        return false;
+    }
+    if (!message.is_object()) return false;
+    auto params_it = message.find("params");
+    return params_it != message.end() && params_it->is_object()
+        && params_it->value("name", nlohmann::json()) == "taskman_demo_generate";
+}
+
+/** Réponse -32603 si une exécution lève une exception inattendue. */
+std::string internal_error(const nlohmann::json& message) {
+    nlohmann::json id;
+    if (message.is_object() && message.contains("id")) id = message["id"];
+    return McpProtocolHandler::make_error(id, McpProtocolHandler::INTERNAL_ERROR, "Internal error");
+}
+
+} // namespace
+
+McpDispatcher::McpDispatcher(const std::string& db_path)
+    : db_path_(db_path), executor_(tool_registry_, command_registry_, db_path) {
+    register_all_commands(command_registry_);
+
+    // tools/list et resources/templates/list sont sérialisés une seule fois
+    tools_list_result_ = tool_registry_.tools_list_result_json();
+    templates_list_result_ = McpResources::templates_list_result().dump();
+
+    // Workers de lecture : un exécuteur (donc une connexion) par worker
+    unsigned hw = std::thread::hardware_concurrency();
+    size_t workers = env_size("TASKMAN_MCP_WORKERS", std::min<size_t>(4, std::max<unsigned>(2, hw)));
+    size_t max_in_flight = env_size("TASKMAN_MCP_MAX_IN_FLIGHT", 64);
+    max_waits_ = std::max<size_t>(1, env_size("TASKMAN_MCP_MAX_WAITS", 16));
+    for (size_t i = 0; i < workers; ++i) {
+        readers_.push_back(make_executor());
+    }
+    scheduler_ = std::make_unique<McpScheduler>(workers, max_in_flight, max_waits_);
+
+    const char* stats_file = std::getenv("TASKMAN_MCP_STATS_FILE");
+    if (stats_file && stats_file[0] != '\0') {
+        stats_.start_dump(stats_file, static_cast<unsigned>(env_size("TASKMAN_MCP_STATS_INTERVAL", 60)));
+    }
+}
+
+McpDispatcher::~McpDispatcher() {
+    scheduler_.reset();
+}
+
+void McpDispatcher::register_methods(McpProtocolHandler& handler) {
+    handler.register_method("tools/list", [this](const nlohmann::json& id, const nlohmann::json&) {
+        return McpProtocolHandler::make_raw_result(id, tools_list_result_);
+    });
+    handler.register_method("tools/call", [this](const nlohmann::json& id, const nlohmann::json& params) {
+        return handle_tools_call(executor_, stats_, id, params);
+    });
+    handler.register_method("resources/templates/list", [this](const nlohmann::json& id, const nlohmann::json&) {
+        return McpProtocolHandler::make_raw_result(id, templates_list_result_);
+    });
+    handler.register_method("resources/read", [this](const nlohmann::json& id, const nlohmann::json& params) {
+        return handle_resources_read(executor_, id, params);
+    });
+    handler.register_method("resources/list", [this](const nlohmann::json& id, const nlohmann::json&) {
+        return handle_resources_list(executor_, id);
+    });
+    handler.set_batch_hooks(
+        [this](const nlohmann::json& batch) {
+            if (is_read_only_batch(tool_registry_, batch)) {
+                executor_.begin_snapshot();
+            }
+        },
+        [this]() { executor_.end_snapshot(); });
+}
+
+void McpDispatcher::register_subscriptions(McpProtocolHandler& handler, McpResourceWatcher& watcher) {
+    handler.register_method("resources/subscribe", [&watcher](const nlohmann::json& id, const nlohmann::json& params) {
+        return handle_resources_subscribe(watcher, id, params, true);
+    });
+    handler.register_method("resources/unsubscribe", [&watcher](const nlohmann::json& id, const nlohmann::json& params) {
+        return handle_resources_subscribe(watcher, id, params, false);
+    });
+}
+
+std::unique_ptr<McpToolExecutor> McpDispatcher::make_executor() const {
+    return std::make_unique<McpToolExecutor>(tool_registry_, command_registry_, db_path_);
+}
+
+void McpDispatcher::set_release_hook(std::function<void()> hook) {
+    release_hook_ = std::move(hook);
+}
+
+void McpDispatcher::wait_idle() {
+    scheduler_->wait_idle();
+}
+
+void McpDispatcher::submit(McpProtocolHandler& handler, nlohmann::json message, Reply reply) {
+    Route route = route_message(message, tool_registry_, executor_);
+    if (route == Route::Read && readers_.empty()) route = Route::Write;
+    switch (route) {
+    case Route::Inline: {
+        std::string response;
+        if (!handler.handle_message(message, response)) response.clear();
+        reply(std::move(response));
+        break;
+    }
+    case Route::Read:
+        scheduler_->submit(McpScheduler::Lane::Read,
+                           [this, reply = std::move(reply), msg = std::move(message)](size_t worker) {
+            std::string response;
+            try {
+                response = handle_read_request(*readers_[worker], stats_, msg);
+            } catch (...) {
+                response = internal_error(msg);
+            }
+            reply(std::move(response));
+        });
+        break;
+    case Route::Wait: {
+        // Connexion propre à l'attente : elle voit les écritures soumises après elle.
+        // reply reste ici si l'attente est refusée (limite atteinte) : erreur d'outil immédiate
+        auto shared_reply = std::make_shared<Reply>(std::move(reply));
+        nlohmann::json id = message.value("id", nlohmann::json());
+        bool started = scheduler_->submit(McpScheduler::Lane::Detached,
+                                          [this, shared_reply, msg = std::move(message)](size_t) {
+            std::string response;
+            try {
+                auto waiter = make_executor();
+                response = handle_tools_call(*waiter, stats_, msg["id"], msg["params"]);
+            } catch (...) {
+                response = internal_error(msg);
+            }
+            (*shared_reply)(std::move(response));
+        });
+        if (!started) {
+            std::string output = "taskman: too many pending waits (" + std::to_string(max_waits_)
+                               + ", TASKMAN_MCP_MAX_WAITS); retry later";
+            (*shared_reply)(McpProtocolHandler::make_result(id, McpProtocolHandler::make_tool_result(output, true)));
+        }
+        break;
+    }
+    case Route::Write:
+        scheduler_->submit(McpScheduler::Lane::Write,
+                           [this, &handler, reply = std::move(reply), msg = std::move(message)](size_t) {
+            // Aucune lecture en cours sur la voie d'écriture : demo:generate peut remplacer le
+            // fichier après fermeture des connexions des workers (rouvertes au prochain appel)
+            if (calls_demo_generate(msg)) {
+                for (auto& reader : readers_) reader->release_database();
+                if (release_hook_) release_hook_();
+            }
+            std::string response;
+            try {
+                if (!handler.handle_message(msg, response)) response.clear();
+            } catch (...) {
+                response = internal_error(msg);
+            }
+            reply(std::move(response));
+        });
+        break;
+    }
+}
+
+} // namespace taskman
@@ -0,0 +1,110 @@
+/**
+ * Répartiteur des messages MCP, commun aux transports stdio et HTTP.
+ * Responsabilité unique : router chaque message JSON-RPC parsé vers sa voie d'exécution
+ * (McpScheduler) et rendre la réponse sérialisée à l'appelant.
+ *
+ * Le répartiteur possède ce que les sessions partagent : registres, exécuteur de la voie
+ * d'écriture, un exécuteur (donc une connexion et ses requêtes préparées) par worker de lecture,
+ * et l'ordonnanceur. L'état propre à une session (phase d'initialisation, abonnements) reste
+ * dans son McpProtocolHandler et son McpResourceWatcher : plusieurs sessions HTTP partagent
+ * ainsi un seul processus et une seule voie d'écriture.
+ *
+ * Voies : initialize, ping, tools/list, resources/templates/list, taskman_server_stats,
+ * notifications et erreurs de protocole sont traités sur le thread appelant ; les tools/call en
+ * lecture seule à handler typé, resources/read et resources/list sur les workers de lecture ; les
+ * attentes (outils bloquants) sur leur propre thread ; le reste (écritures, abonnements, lots)
+ * sur la voie d'écriture.
+ * TASKMAN_MCP_WORKERS : nombre de workers de lecture (0 = tout sur la voie d'écriture) ;
+ * TASKMAN_MCP_MAX_IN_FLIGHT : requêtes en cours au maximum, hors attentes (submit bloque au-delà) ;
+ * TASKMAN_MCP_MAX_WAITS : attentes en cours au maximum (au-delà, erreur d'outil immédiate).
+ *
+ * Les appels d'outils de toutes les voies et de toutes les sessions alimentent un seul
+ * McpToolStats (outil taskman_server_stats). TASKMAN_MCP_STATS_FILE : fichier JSON réécrit
+ * toutes les TASKMAN_MCP_STATS_INTERVAL secondes (60 par défaut) et à l'arrêt.
+ */
+
+#ifndef TASKMAN_MCP_DISPATCHER_HPP
+#define TASKMAN_MCP_DISPATCHER_HPP
+
+#include "mcp_scheduler.hpp"
+#include "mcp_tool_executor.hpp"
+#include "mcp_tool_registry.hpp"
+#include "mcp_tool_stats.hpp"
+#include "cli/command.hpp"
+#include <nlohmann/json.hpp>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace taskman {
+
+class McpProtocolHandler;
+class McpResourceWatcher;
+
+class McpDispatcher {
+public:
+    /** Reçoit la réponse sérialisée d'un message, ou une chaîne vide s'il n'en produit pas. */
+    using Reply = std::function<void(std::string response)>;
+
+    /** @param db_path Chemin de la base (ouverte par chaque exécuteur au premier besoin) */
+    explicit McpDispatcher(const std::string& db_path);
+
+    /** Attend la fin des messages en cours. */
+    ~McpDispatcher();
+
+    McpDispatcher(const McpDispatcher&) = delete;
+    McpDispatcher& operator=(const McpDispatcher&) = delete;
+
+    /**
+     * Enregistre sur le gestionnaire de protocole d'une session les méthodes partagées
+     * (tools/list, tools/call, resources/templates/list, resources/read, resources/list)
+     * et les hooks de lot (snapshot pour les lots en lecture seule).
+     */
+    void register_methods(McpProtocolHandler& handler);
+
+    /** Enregistre resources/subscribe et resources/unsubscribe, liés au watcher de la session. */
+    static void register_subscriptions(McpProtocolHandler& handler, McpResourceWatcher& watcher);
+
+    /** Nouvel exécuteur sur la même base (connexion propre, ex. pour un McpResourceWatcher). */
+    std::unique_ptr<McpToolExecutor> make_executor() const;
+
+    /**
+     * Traite un message parsé (objet ou lot) d'une session. reply est appelé exactement une fois,
+     * sur le thread appelant ou sur un thread de l'ordonnanceur. handler doit rester valide
+     * jusqu'à cet appel. Bloque si TASKMAN_MCP_MAX_IN_FLIGHT messages sont en cours (jamais pour
+     * une attente : refusée par une erreur d'outil si TASKMAN_MCP_MAX_WAITS attentes sont en cours).
+     */
+    void submit(McpProtocolHandler& handler, nlohmann::json message, Reply reply);
+
+    /**
+     * Hook appelé sur la voie d'écriture avant taskman_demo_generate, après la fermeture des
+     * connexions des workers : le transport y ferme celles de ses watchers.
+     */
+    void set_release_hook(std::function<void()> hook);
+
+    /** Attend que tous les messages soumis soient traités. */
+    void wait_idle();
+
+private:
+    McpToolRegistry tool_registry_;
+    CommandRegistry command_registry_;
+    std::string db_path_;
+    /** Exécuteur de la voie d'écriture (et des messages traités sur le thread appelant). */
+    McpToolExecutor executor_;
+    /** Un exécuteur par worker de lecture. */
+    std::vector<std::unique_ptr<McpToolExecutor>> readers_;
+    std::string tools_list_result_;
+    std::string templates_list_result_;
+    std::function<void()> release_hook_;
+    /** Attentes (voie Detached) en cours au maximum (TASKMAN_MCP_MAX_WAITS). */
+    size_t max_waits_ = 16;
+    /** Métriques des appels d'outils, partagées par tous les exécuteurs. */
+    McpToolStats stats_;
+    /** Déclaré en dernier : détruit (threads joints) avant les exécuteurs qu'il utilise. */
+    std::unique_ptr<McpScheduler> scheduler_;
+};
+
+} // namespace taskman
+
+#endif /* TASKMAN_MCP_DISPATCHER_HPP */
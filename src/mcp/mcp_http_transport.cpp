@@ -0,0 +1,289 @@
+/**
+ * Implémentation du transport MCP Streamable HTTP.
+ */
+
+#include "mcp_http_transport.hpp"
+#include "mcp_protocol_handler.hpp"
+#include "mcp_resource_watcher.hpp"
+#include <nlohmann/json.hpp>
+#include <uuid.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <random>
+
+namespace taskman {
+
+/** État d'une session HTTP. Le watcher est déclaré en dernier : arrêté avant le reste. */
+struct McpHttpSession {
+    /** Messages du serveur gardés au plus en attente d'un flux SSE (les plus anciens sont perdus). */
+    static constexpr size_t MAX_PENDING = 1000;
+
+    explicit McpHttpSession(std::string session_id) : id(std::move(session_id)) {}
+
+    /** Ajoute un message au flux SSE de la session. */
+    void push(std::string message) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (closed) return;
+        if (outbox.size() >= MAX_PENDING) outbox.pop_front();
+        outbox.push_back(std::move(message));
+        cv.notify_all();
+    }
+
+    /** Ferme la session : le flux SSE ouvert se termine, les requêtes suivantes reçoivent 404. */
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        cv.notify_all();
+    }
+
+    void touch() {
+        std::lock_guard<std::mutex> lock(mutex);
+        last_seen = std::chrono::steady_clock::now();
+    }
+
+    /** Sans flux SSE ni requête depuis SESSION_IDLE_SECONDS. */
+    bool is_idle(std::chrono::steady_clock::time_point now) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return !streaming && now - last_seen > std::chrono::seconds(McpHttpTransport::SESSION_IDLE_SECONDS);
+    }
+
+    const std::string id;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::string> outbox;
+    bool streaming = false;
+    bool closed = false;
+    std::chrono::steady_clock::time_point last_seen = std::chrono::steady_clock::now();
+    McpProtocolHandler handler;
+    std::unique_ptr<McpToolExecutor> watcher_executor;
+    std::unique_ptr<McpResourceWatcher> watcher;
+};
+
+namespace {
+
+/** Id de session : UUID v4 aléatoire. */
+std::string generate_session_id() {
+    std::random_device rd;
+    std::mt19937 rng(rd());
+    uuids::uuid_random_generator gen(rng);
+    return uuids::to_string(gen());
+}
+
+/** Réponse d'erreur HTTP avec un corps JSON-RPC (id null) qui en donne la raison. */
+void set_error(httplib::Response& res, int status, int code, const std::string& message) {
+    res.status = status;
+    res.set_content(McpProtocolHandler::make_error(nullptr, code, message), "application/json");
+}
+
+/** Vrai si le message est une requête initialize (objet seul, pas un lot). */
+bool is_initialize(const nlohmann::json& message) {
+    return message.is_object() && message.value("method", nlohmann::json()) == "initialize";
+}
+
+} // namespace
+
+McpHttpTransport::McpHttpTransport(const std::string& db_path)
+    : recorder_(McpSessionRecorder::from_env()), dispatcher_(db_path) {
+    // demo:generate remplace le fichier : les watchers des sessions ferment aussi leur connexion
+    dispatcher_.set_release_hook([this] {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& [id, session] : sessions_) session->watcher->release_database();
+    });
+}
+
+McpHttpTransport::~McpHttpTransport() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& [id, session] : sessions_) session->close();
+    sessions_.clear();
+}
+
+void McpHttpTransport::register_routes(httplib::Server& svr) {
+    svr.Post(ENDPOINT, [this](const httplib::Request& req, httplib::Response& res) { handle_post(req, res); });
+    svr.Get(ENDPOINT, [this](const httplib::Request& req, httplib::Response& res) { handle_get(req, res); });
+    svr.Delete(ENDPOINT, [this](const httplib::Request& req, httplib::Response& res) { handle_delete(req, res); });
+}
+
+bool McpHttpTransport::is_allowed_origin(const std::string& origin) {
+    if (origin.empty()) return true;
+    auto scheme_end = origin.find("://");
+    if (scheme_end == std::string::npos) return false;
+    std::string host = origin.substr(scheme_end + 3);
+    if (!host.empty() && host.front() == '[') {
+        auto close = host.find(']');
+        if (close == std::string::npos) return false;
+        host = host.substr(0, close + 1);
+    } else {
+        host = host.substr(0, host.find_first_of(":/"));
+    }
+    return host == "localhost" || host == "127.0.0.1" || host == "[::1]";
+}
+
+bool McpHttpTransport::check_headers(const httplib::Request& req, httplib::Response& res) {
+    if (!is_allowed_origin(req.get_header_value("Origin"))) {
+        set_error(res, 403, McpProtocolHandler::INVALID_REQUEST, "Forbidden origin");
+        return false;
+    }
+    std::string version = req.get_header_value("MCP-Protocol-Version");
+    if (!version.empty() && version != McpProtocolHandler::PROTOCOL_VERSION) {
+        set_error(res, 400, McpProtocolHandler::INVALID_REQUEST, "Unsupported MCP-Protocol-Version: " + version);
+        return false;
+    }
+    return true;
+}
+
+std::shared_ptr<McpHttpSession> McpHttpTransport::find_session(const httplib::Request& req, httplib::Response& res) {
+    std::string id = req.get_header_value(SESSION_HEADER);
+    if (id.empty()) {
+        set_error(res, 400, McpProtocolHandler::INVALID_REQUEST,
+                  std::string("Missing ") + SESSION_HEADER + " header (send initialize first)");
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sessions_.find(id);
+    if (it == sessions_.end()) {
+        set_error(res, 404, McpProtocolHandler::INVALID_REQUEST, "Session not found: " + id);
+        return nullptr;
+    }
+    return it->second;
+}
+
+std::shared_ptr<McpHttpSession> McpHttpTransport::create_session() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = std::chrono::steady_clock::now();
+    for (auto it = sessions_.begin(); it != sessions_.end();) {
+        if (it->second->is_idle(now)) {
+            it->second->close();
+            it = sessions_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (sessions_.size() >= MAX_SESSIONS) return nullptr;
+
+    auto session = std::make_shared<McpHttpSession>(generate_session_id());
+    dispatcher_.register_methods(session->handler);
+    // Abonnements : connexion propre ; les notifications partent sur le flux SSE de la session
+    session->watcher_executor = dispatcher_.make_executor();
+    McpHttpSession* target = session.get();
+    session->watcher = std::make_unique<McpResourceWatcher>(
+        *session->watcher_executor, [target](std::string notification) { target->push(std::move(notification)); });
+    McpDispatcher::register_subscriptions(session->handler, *session->watcher);
+    sessions_[session->id] = session;
+    return session;
+}
+
+void McpHttpTransport::close_session(const std::string& id) {
+    std::shared_ptr<McpHttpSession> session;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = sessions_.find(id);
+        if (it == sessions_.end()) return;
+        session = std::move(it->second);
+        sessions_.erase(it);
+    }
+    session->close();
+}
+
+void McpHttpTransport::handle_post(const httplib::Request& req, httplib::Response& res) {
+    if (!check_headers(req, res)) return;
+    nlohmann::json message = nlohmann::json::parse(req.body, nullptr, false);
+    if (message.is_discarded()) {
+        set_error(res, 400, McpProtocolHandler::PARSE_ERROR, "Parse error");
+        return;
+    }
+
+    std::shared_ptr<McpHttpSession> session;
+    bool created = false;
+    if (is_initialize(message) && !req.has_header(SESSION_HEADER)) {
+        session = create_session();
+        if (!session) {
+            set_error(res, 503, McpProtocolHandler::INTERNAL_ERROR,
+                      "Too many MCP sessions (at most " + std::to_string(MAX_SESSIONS) + ")");
+            return;
+        }
+        created = true;
+    } else {
+        session = find_session(req, res);
+        if (!session) return;
+    }
+    session->touch();
+    McpSessionRecorder::Pending pending;
+    if (recorder_) pending = recorder_->record_message(req.body, session->id);
+
+    // La requête HTTP attend la réponse : la session reste valide pendant l'exécution
+    auto promise = std::make_shared<std::promise<std::string>>();
+    std::future<std::string> future = promise->get_future();
+    dispatcher_.submit(session->handler, std::move(message),
+                       [promise](std::string response) { promise->set_value(std::move(response)); });
+    std::string response = future.get();
+    if (recorder_) recorder_->record_response(pending, response.size());
+    session->touch();
+
+    if (created) {
+        // initialize refusé (version non supportée…) : pas de session
+        if (nlohmann::json::parse(response, nullptr, false).contains("error")) {
+            close_session(session->id);
+        } else {
+            res.set_header(SESSION_HEADER, session->id);
+        }
+    }
+    if (response.empty()) {
+        res.status = 202;  // notifications seules
+        return;
+    }
+    res.set_content(response, "application/json");
+}
+
+void McpHttpTransport::handle_get(const httplib::Request& req, httplib::Response& res) {
+    if (!check_headers(req, res)) return;
+    if (req.get_header_value("Accept").find("text/event-stream") == std::string::npos) {
+        set_error(res, 406, McpProtocolHandler::INVALID_REQUEST, "GET requires Accept: text/event-stream");
+        return;
+    }
+    auto session = find_session(req, res);
+    if (!session) return;
+    {
+        std::lock_guard<std::mutex> lock(session->mutex);
+        if (session->streaming) {
+            set_error(res, 409, McpProtocolHandler::INVALID_REQUEST, "An event stream is already open for this session");
+            return;
+        }
+        session->streaming = true;
+    }
+    res.set_header("Cache-Control", "no-store");
+    res.set_chunked_content_provider(
+        "text/event-stream",
+        [session](size_t, httplib::DataSink& sink) {
+            std::unique_lock<std::mutex> lock(session->mutex);
+            session->cv.wait_for(lock, std::chrono::seconds(KEEPALIVE_SECONDS),
+                                 [&session] { return session->closed || !session->outbox.empty(); });
+            if (session->closed) {
+                lock.unlock();
+                sink.done();
+                return true;
+            }
+            std::string chunk;
+            if (session->outbox.empty()) chunk = ": keepalive\n\n";
+            for (const auto& message : session->outbox) chunk += "event: message\ndata: " + message + "\n\n";
+            session->outbox.clear();
+            lock.unlock();
+            return sink.write(chunk.data(), chunk.size());
+        },
+        [session](bool) {
+            std::lock_guard<std::mutex> lock(session->mutex);
+            session->streaming = false;
+            session->last_seen = std::chrono::steady_clock::now();
+        });
+}
+
+void McpHttpTransport::handle_delete(const httplib::Request& req, httplib::Response& res) {
+    if (!check_headers(req, res)) return;
+    auto session = find_session(req, res);
+    if (!session) return;
+    close_session(session->id);
+    res.status = 200;
+}
+
+} // namespace taskman
@@ -0,0 +1,103 @@
+/**
+ * Transport MCP Streamable HTTP, servi par le serveur httplib de `taskman web --mcp`.
+ * Responsabilité unique : sessions MCP sur HTTP (en-tête Mcp-Session-Id) et flux SSE des
+ * messages du serveur ; l'exécution est déléguée à un McpDispatcher partagé par toutes les
+ * sessions (un processus, une connexion par worker, une seule voie d'écriture).
+ *
+ * Un seul point d'accès (ENDPOINT) :
+ * - POST : un message ou un lot JSON-RPC. initialize sans en-tête crée la session et retourne
+ *   son id dans Mcp-Session-Id ; les autres messages doivent le porter (400 sans, 404 si la
+ *   session est inconnue ou fermée). Réponse application/json, ou 202 sans corps si le corps
+ *   ne contient que des notifications ou des réponses.
+ * - GET (Accept: text/event-stream) : flux SSE des messages du serveur pour la session
+ *   (notifications/resources/updated), un seul par session ; commentaire keepalive périodique.
+ * - DELETE : ferme la session (abonnements et flux SSE compris).
+ * Chaque session a son McpProtocolHandler (initialisation) et son McpResourceWatcher
+ * (abonnements). Origin, si présent, doit désigner localhost (protection contre le DNS
+ * rebinding) ; MCP-Protocol-Version, si présent, doit être la version négociée.
+ * TASKMAN_MCP_RECORD : les corps POST des sessions sont enregistrés (McpSessionRecorder, avec
+ * l'id de session).
+ */
+
+#ifndef TASKMAN_MCP_HTTP_TRANSPORT_HPP
+#define TASKMAN_MCP_HTTP_TRANSPORT_HPP
+
+#include "mcp_dispatcher.hpp"
+#include "mcp_session_recorder.hpp"
+#include <httplib.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace taskman {
+
+struct McpHttpSession;
+
+class McpHttpTransport {
+public:
+    /** Chemin du point d'accès MCP. */
+    static constexpr const char* ENDPOINT = "/mcp";
+    /** En-tête portant l'id de session. */
+    static constexpr const char* SESSION_HEADER = "Mcp-Session-Id";
+    /** Nombre maximal de sessions ouvertes (503 au-delà, après purge des sessions inactives). */
+    static constexpr size_t MAX_SESSIONS = 32;
+    /** Une session sans requête ni flux SSE depuis ce délai est fermée à la création suivante. */
+    static constexpr int SESSION_IDLE_SECONDS = 3600;
+    /** Intervalle des commentaires keepalive sur un flux SSE sans message. */
+    static constexpr int KEEPALIVE_SECONDS = 15;
+    /** Threads du serveur web avec --mcp (WebServer::start, toutes les routes) : un flux SSE par
+     * session, qui occupe son thread pendant toute sa durée, plus les requêtes en cours. */
+    static constexpr size_t HTTP_THREADS = 2 * MAX_SESSIONS;
+
+    /** @param db_path Chemin de la base utilisée par les sessions MCP */
+    explicit McpHttpTransport(const std::string& db_path);
+
+    /** Ferme les sessions (fin des flux SSE) puis attend les messages en cours. */
+    ~McpHttpTransport();
+
+    McpHttpTransport(const McpHttpTransport&) = delete;
+    McpHttpTransport& operator=(const McpHttpTransport&) = delete;
+
+    /** Enregistre POST/GET/DELETE sur ENDPOINT. Le pool de threads (HTTP_THREADS) est choisi par
+     * WebServer::start. */
+    void register_routes(httplib::Server& svr);
+
+    /** POST ENDPOINT : messages JSON-RPC du client. */
+    void handle_post(const httplib::Request& req, httplib::Response& res);
+
+    /** GET ENDPOINT : flux SSE des messages du serveur. */
+    void handle_get(const httplib::Request& req, httplib::Response& res);
+
+    /** DELETE ENDPOINT : fermeture de la session. */
+    void handle_delete(const httplib::Request& req, httplib::Response& res);
+
+    /** Vrai si Origin est absent ou désigne localhost, 127.0.0.1 ou [::1]. */
+    static bool is_allowed_origin(const std::string& origin);
+
+private:
+    /** Vérifie Origin et MCP-Protocol-Version ; sinon remplit res (403 / 400) et retourne false. */
+    static bool check_headers(const httplib::Request& req, httplib::Response& res);
+
+    /**
+     * Session désignée par l'en-tête Mcp-Session-Id ; sinon remplit res (400 sans en-tête,
+     * 404 si inconnue) et retourne nullptr.
+     */
+    std::shared_ptr<McpHttpSession> find_session(const httplib::Request& req, httplib::Response& res);
+
+    /** Crée une session (nullptr si MAX_SESSIONS sont ouvertes après purge des inactives). */
+    std::shared_ptr<McpHttpSession> create_session();
+
+    /** Retire la session de la table et la ferme. */
+    void close_session(const std::string& id);
+
+    /** Déclaré avant dispatcher_ : détruit après les derniers messages. */
+    std::unique_ptr<McpSessionRecorder> recorder_;
+    McpDispatcher dispatcher_;
+    std::mutex mutex_;
+    std::map<std::string, std::shared_ptr<McpHttpSession>> sessions_;
+};
+
+} // namespace taskman
+
+#endif /* TASKMAN_MCP_HTTP_TRANSPORT_HPP */
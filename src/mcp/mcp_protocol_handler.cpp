@@ -4,212 +4,177 @@
 
 #include "mcp_protocol_handler.hpp"
 #include "version.h"
-#include <iostream>
-#include <vector>
 
 namespace taskman {
 
 McpProtocolHandler::McpProtocolHandler() : operational_(false) {
+    methods_["initialize"] = [this](const nlohmann::json& id, const nlohmann::json& params) {
+        return handle_initialize(id, params);
+    };
+    methods_["ping"] = [](const nlohmann::json& id, const nlohmann::json&) {
+        return make_result(id, nlohmann::json::object());
+    };
 }
 
-void McpProtocolHandler::send_response(const nlohmann::json& response) {
-    std::cout << response.dump() << "\n";
-    std::cout.flush();
+void McpProtocolHandler::register_method(const std::string& method, MethodHandler handler) {
+    methods_[method] = std::move(handler);
 }
 
-bool McpProtocolHandler::is_blank(const std::string& s) const {
-    for (char c : s) {
-        if (c != ' ' && c != '\t' && c != '\r') return false;
-    }
-    return true;
-}
-
-void McpProtocolHandler::send_parse_error() {
-    nlohmann::json err;
-    err["jsonrpc"] = "2.0";
-    err["id"] = nullptr;
-    err["error"]["code"] = -32700;
-    err["error"]["message"] = "Parse error";
-    send_response(err);
+void McpProtocolHandler::set_batch_hooks(BatchBeginHook on_begin, BatchEndHook on_end) {
+    batch_begin_ = std::move(on_begin);
+    batch_end_ = std::move(on_end);
 }
 
-void McpProtocolHandler::send_invalid_request(const nlohmann::json& id) {
-    nlohmann::json err;
-    err["jsonrpc"] = "2.0";
-    err["id"] = id;
-    err["error"]["code"] = -32600;
-    err["error"]["message"] = "Invalid Request";
-    send_response(err);
-}
-
-void McpProtocolHandler::send_method_not_found(const nlohmann::json& id) {
-    nlohmann::json err;
-    err["jsonrpc"] = "2.0";
-    err["id"] = id;
-    err["error"]["code"] = -32601;
-    err["error"]["message"] = "Method not found";
-    send_response(err);
+std::string McpProtocolHandler::make_result(const nlohmann::json& id, const nlohmann::json& result) {
+    nlohmann::json resp;
+    resp["jsonrpc"] = "2.0";
+    resp["id"] = id;
+    resp["result"] = result;
+    return resp.dump();
 }
 
-void McpProtocolHandler::send_unsupported_protocol_version(const nlohmann::json& id) {
-    nlohmann::json err;
-    err["jsonrpc"] = "2.0";
-    err["id"] = id;
-    err["error"]["code"] = -32602;
-    err["error"]["message"] = "Unsupported protocol version";
-    send_response(err);
+std::string McpProtocolHandler::make_raw_result(const nlohmann::json& id, const std::string& result_json) {
+    return "{\"id\":" + id.dump() + ",\"jsonrpc\":\"2.0\",\"result\":" + result_json + "}";
 }
 
-void McpProtocolHandler::send_invalid_params(const nlohmann::json& id, const std::string& message) {
+std::string McpProtocolHandler::make_error(const nlohmann::json& id, int code, const std::string& message) {
     nlohmann::json err;
     err["jsonrpc"] = "2.0";
     err["id"] = id;
-    err["error"]["code"] = -32602;
+    err["error"]["code"] = code;
     err["error"]["message"] = message;
-    send_response(err);
-}
-
-void McpProtocolHandler::send_initialize_result(const nlohmann::json& id) {
-    nlohmann::json resp;
-    resp["jsonrpc"] = "2.0";
-    resp["id"] = id;
-    resp["result"]["protocolVersion"] = "2025-11-25";
-    resp["result"]["capabilities"]["tools"]["listChanged"] = false;
-    resp["result"]["serverInfo"]["name"] = "taskman";
-    resp["result"]["serverInfo"]["version"] = TASKMAN_VERSION;
-    send_response(resp);
+    return err.dump();
 }
 
-void McpProtocolHandler::send_ping_result(const nlohmann::json& id) {
-    nlohmann::json resp;
-    resp["jsonrpc"] = "2.0";
-    resp["id"] = id;
-    resp["result"] = nlohmann::json::object();
-    send_response(resp);
-}
-
-void McpProtocolHandler::handle_initialize(const nlohmann::json& request, const nlohmann::json& id) {
-    nlohmann::json params = request.contains("params") ? request["params"] : nlohmann::json();
-    if (!params.is_object() || !params.contains("protocolVersion")) {
-        send_invalid_request(id);
-        return;
-    }
-    if (params["protocolVersion"] != "2025-11-25") {
-        send_unsupported_protocol_version(id);
-        return;
+nlohmann::json McpProtocolHandler::make_tool_result(const std::string& output, bool is_error,
+                                                    const nlohmann::json& structured) {
+    // Succès ou erreur métier → result avec content
+    nlohmann::json result;
+    nlohmann::json content_item;
+    content_item["type"] = "text";
+    content_item["text"] = output.empty() ? (is_error ? "Error" : "") : output;
+    result["content"] = nlohmann::json::array({content_item});
+    if (structured.is_object()) {
+        result["structuredContent"] = structured;
     }
-    send_initialize_result(id);
-}
-
-void McpProtocolHandler::handle_initialized() {
-    operational_ = true;
+    result["isError"] = is_error;
+    return result;
 }
 
-void McpProtocolHandler::handle_tools_list(const nlohmann::json& id, const std::vector<nlohmann::json>& tools_list) {
-    nlohmann::json resp;
-    resp["jsonrpc"] = "2.0";
-    resp["id"] = id;
-    resp["result"]["tools"] = nlohmann::json::array();
-    for (const auto& tool : tools_list) {
-        resp["result"]["tools"].push_back(tool);
+bool McpProtocolHandler::is_blank(const std::string& s) const {
+    for (char c : s) {
+        if (c != ' ' && c != '\t' && c != '\r') return false;
     }
-    send_response(resp);
+    return true;
 }
 
-void McpProtocolHandler::handle_tools_call(const nlohmann::json& id, const nlohmann::json& params,
-                                          const std::string& output, bool is_error) {
-    if (!params.is_object()) {
-        send_invalid_params(id, "Invalid arguments");
-        return;
+std::string McpProtocolHandler::handle_initialize(const nlohmann::json& id, const nlohmann::json& params) const {
+    if (!params.is_object() || !params.contains("protocolVersion")) {
+        return make_error(id, INVALID_REQUEST, "Invalid Request");
     }
-    if (!params.contains("name") || !params["name"].is_string()) {
-        send_invalid_params(id, "Invalid arguments: missing or invalid 'name'");
-        return;
+    if (params["protocolVersion"] != PROTOCOL_VERSION) {
+        return make_error(id, INVALID_PARAMS, "Unsupported protocol version");
     }
-    // Vérifier que arguments est un objet s'il est présent
-    if (params.contains("arguments") && !params["arguments"].is_object()) {
-        send_invalid_params(id, "Invalid arguments: 'arguments' must be an object");
-        return;
+    nlohmann::json result;
+    result["protocolVersion"] = PROTOCOL_VERSION;
+    result["capabilities"]["tools"]["listChanged"] = false;
+    result["capabilities"]["resources"]["subscribe"] = true;
+    result["capabilities"]["resources"]["listChanged"] = false;
+    result["serverInfo"]["name"] = "taskman";
+    result["serverInfo"]["version"] = TASKMAN_VERSION;
+    return make_result(id, result);
+}
+
+bool McpProtocolHandler::parse_line(const std::string& line, nlohmann::json& message,
+                                    std::string& error_response) const {
+    error_response.clear();
+    if (is_blank(line))
+        return false;
+
+    /* CR final (Windows CRLF) ignoré sans copier la ligne. */
+    auto end = line.end();
+    while (end != line.begin() && *(end - 1) == '\r')
+        --end;
+
+    message = nlohmann::json::parse(line.begin(), end, nullptr, false);
+    if (message.is_discarded()) {
+        error_response = make_error(nullptr, PARSE_ERROR, "Parse error");
+        return false;
     }
-
-    nlohmann::json resp;
-    resp["jsonrpc"] = "2.0";
-    resp["id"] = id;
-
-    // Succès ou erreur métier → result avec content
-    resp["result"]["content"] = nlohmann::json::array();
-    nlohmann::json content_item;
-    content_item["type"] = "text";
-    content_item["text"] = output.empty() ? (is_error ? "Error" : "") : output;
-    resp["result"]["content"].push_back(content_item);
-    resp["result"]["isError"] = is_error;
-
-    send_response(resp);
+    return true;
 }
 
-void McpProtocolHandler::send_tool_error(const nlohmann::json& id, const std::string& message) {
-    send_invalid_params(id, message);
+bool McpProtocolHandler::handle_message(const nlohmann::json& message, std::string& response) {
+    if (message.is_array())
+        return dispatch_batch(message, response);
+    return dispatch(message, response);
 }
 
-bool McpProtocolHandler::process_request(const std::string& line) {
-    /* Trim trailing \r (Windows CRLF) pour que le JSON parse. */
-    std::string trimmed_line = line;
-    while (!trimmed_line.empty() && trimmed_line.back() == '\r')
-        trimmed_line.pop_back();
-    if (is_blank(trimmed_line))
-        return true;
-
-    nlohmann::json j;
-    try {
-        j = nlohmann::json::parse(trimmed_line);
-    } catch (const nlohmann::json::exception&) {
-        send_parse_error();
+bool McpProtocolHandler::dispatch_batch(const nlohmann::json& batch, std::string& response) {
+    if (batch.empty()) {
+        response = make_error(nullptr, INVALID_REQUEST, "Invalid Request");
         return true;
     }
+    if (batch_begin_)
+        batch_begin_(batch);
+    /* batch_end_ sur tous les chemins de sortie, exception d'un handler comprise : le snapshot
+     * ouvert par batch_begin_ ne doit pas rester ouvert sur la connexion partagée. */
+    struct BatchEndGuard {
+        const BatchEndHook& hook;
+        ~BatchEndGuard() {
+            if (hook)
+                hook();
+        }
+    } batch_end_guard{batch_end_};
+    response = "[";
+    std::string item;
+    bool any = false;
+    for (const auto& message : batch) {
+        /* Un élément non objet (y compris un tableau imbriqué) produit Invalid Request. */
+        if (!dispatch(message, item))
+            continue;
+        if (any)
+            response += ',';
+        response += item;
+        any = true;
+    }
+    response += ']';
+    return any;
+}
 
+bool McpProtocolHandler::dispatch(const nlohmann::json& j, std::string& response) {
     if (!j.is_object()) {
-        send_invalid_request(nlohmann::json());
+        response = make_error(nullptr, INVALID_REQUEST, "Invalid Request");
         return true;
     }
-    if (!j.contains("jsonrpc") || j["jsonrpc"] != "2.0") {
-        nlohmann::json id = j.contains("id") ? j["id"] : nlohmann::json();
-        send_invalid_request(id);
+    auto id_it = j.find("id");
+    auto rpc_it = j.find("jsonrpc");
+    if (rpc_it == j.end() || *rpc_it != "2.0") {
+        response = make_error(id_it != j.end() ? *id_it : nlohmann::json(), INVALID_REQUEST, "Invalid Request");
         return true;
     }
 
     /* method (pour notifications et requêtes) */
-    std::string method;
-    if (j.contains("method") && j["method"].is_string())
-        method = j["method"].get<std::string>();
+    auto method_it = j.find("method");
+    const std::string* method = (method_it != j.end() && method_it->is_string())
+        ? method_it->get_ptr<const std::string*>() : nullptr;
 
     /* Notification : pas d'id → on ne répond pas. */
-    if (!j.contains("id")) {
-        if (method == "notifications/initialized")
-            handle_initialized();
-        return true;
+    if (id_it == j.end()) {
+        if (method && *method == "notifications/initialized")
+            operational_ = true;
+        return false;
     }
 
-    nlohmann::json id = j["id"];
-
-    /* initialize */
-    if (method == "initialize") {
-        handle_initialize(j, id);
+    auto handler = method ? methods_.find(*method) : methods_.end();
+    if (handler == methods_.end()) {
+        /* Méthode inconnue : -32601 Method not found. */
+        response = make_error(*id_it, METHOD_NOT_FOUND, "Method not found");
         return true;
     }
-
-    /* tools/list et tools/call sont gérés par le code appelant via les méthodes publiques */
-    if (method == "tools/list" || method == "tools/call") {
-        return false; // Indique que la méthode doit être gérée par le code appelant
-    }
-
-    /* ping */
-    if (method == "ping") {
-        send_ping_result(id);
-        return true;
-    }
-
-    /* Autres méthodes : -32601 Method not found. */
-    send_method_not_found(id);
+    auto params_it = j.find("params");
+    static const nlohmann::json no_params;
+    response = handler->second(*id_it, params_it != j.end() ? *params_it : no_params);
     return true;
 }
 
@@ -2,14 +2,22 @@
  * Gestionnaire du protocole JSON-RPC pour MCP.
  * Responsabilité unique : parsing, validation et construction de réponses JSON-RPC.
  * Respecte le principe SRP : séparation du protocole de la logique métier.
+ * Chaque message est parsé une seule fois puis dispatché sur une table de méthodes ;
+ * les réponses sont retournées sérialisées, l'écriture sur stdout revient à l'appelant.
+ * Les lots JSON-RPC 2.0 (tableau de messages) sont acceptés : une réponse tableau,
+ * sans entrée pour les notifications.
+ * Après l'enregistrement des méthodes, handle_message peut être appelé depuis plusieurs threads
+ * si les méthodes elles-mêmes le permettent (la table n'est plus modifiée).
  */
 
 #ifndef TASKMAN_MCP_PROTOCOL_HANDLER_HPP
 #define TASKMAN_MCP_PROTOCOL_HANDLER_HPP
 
 #include <nlohmann/json.hpp>
+#include <atomic>
+#include <functional>
 #include <string>
-#include <vector>
+#include <unordered_map>
 
 namespace taskman {
 
@@ -19,102 +27,121 @@ namespace taskman {
  */
 class McpProtocolHandler {
 public:
-    McpProtocolHandler();
-    ~McpProtocolHandler() = default;
-
     /**
-     * Traite une ligne JSON-RPC reçue sur stdin.
-     * @param line Ligne JSON à traiter
-     * @return true si le serveur doit continuer, false pour arrêter
+     * Méthode JSON-RPC (requête avec id).
+     * Reçoit l'id et params (null si absent) ; retourne la réponse complète sérialisée
+     * (voir make_result / make_raw_result / make_error).
      */
-    bool process_request(const std::string& line);
+    using MethodHandler = std::function<std::string(const nlohmann::json& id, const nlohmann::json& params)>;
 
-    /**
-     * Indique si le serveur est en phase opérationnelle (après initialized).
-     */
-    bool is_operational() const { return operational_; }
+    /** Hooks appelés autour de l'exécution d'un lot : début (reçoit le tableau), fin. */
+    using BatchBeginHook = std::function<void(const nlohmann::json& batch)>;
+    using BatchEndHook = std::function<void()>;
 
-    /**
-     * Traite une requête tools/list.
-     * @param id ID de la requête
-     * @param tools_list Liste des outils au format JSON
-     */
-    void handle_tools_list(const nlohmann::json& id, const std::vector<nlohmann::json>& tools_list);
+    /** Codes d'erreur JSON-RPC utilisés par le serveur. */
+    static constexpr int PARSE_ERROR = -32700;
+    static constexpr int INVALID_REQUEST = -32600;
+    static constexpr int METHOD_NOT_FOUND = -32601;
+    static constexpr int INVALID_PARAMS = -32602;
+    static constexpr int INTERNAL_ERROR = -32603;
+    /** Erreur MCP : ressource inconnue (resources/read). */
+    static constexpr int RESOURCE_NOT_FOUND = -32002;
+
+    /** Version du protocole MCP acceptée par initialize (et attendue dans MCP-Protocol-Version en HTTP). */
+    static constexpr const char* PROTOCOL_VERSION = "2025-11-25";
+
+    /** Enregistre initialize et ping ; notifications/initialized est traitée par dispatch(). */
+    McpProtocolHandler();
+    ~McpProtocolHandler() = default;
+
+    McpProtocolHandler(const McpProtocolHandler&) = delete;
+    McpProtocolHandler& operator=(const McpProtocolHandler&) = delete;
 
     /**
-     * Traite une requête tools/call.
-     * @param id ID de la requête
-     * @param params Paramètres de la requête
-     * @param output Sortie de l'exécution de l'outil
-     * @param is_error Indique si l'exécution a échoué
+     * Enregistre (ou remplace) une méthode de requête (ex: "tools/list", "tools/call").
      */
-    void handle_tools_call(const nlohmann::json& id, const nlohmann::json& params,
-                          const std::string& output, bool is_error);
+    void register_method(const std::string& method, MethodHandler handler);
 
     /**
-     * Envoie une erreur JSON-RPC pour un outil inconnu ou des paramètres invalides.
-     * @param id ID de la requête
-     * @param message Message d'erreur
+     * Définit les hooks de lot (ex. snapshot DB partagé par les lectures d'un lot).
      */
-    void send_tool_error(const nlohmann::json& id, const std::string& message);
+    void set_batch_hooks(BatchBeginHook on_begin, BatchEndHook on_end);
 
-private:
     /**
-     * Envoie une réponse JSON-RPC sur stdout.
+     * Parse une ligne JSON-RPC reçue sur stdin (un seul parse, CR final toléré).
+     * @param line Ligne JSON
+     * @param message Message parsé (objet ou tableau de lot)
+     * @param error_response Réponse -32700 si la ligne n'est pas du JSON valide
+     * @return true si message est à traiter (handle_message), false sinon (ligne vide ou erreur de parse)
      */
-    void send_response(const nlohmann::json& response);
+    bool parse_line(const std::string& line, nlohmann::json& message, std::string& error_response) const;
 
     /**
-     * Vérifie si une ligne est vide ou uniquement des espaces.
+     * Traite un message parsé : dispatch() pour un objet, dispatch_batch() pour un tableau.
+     * @param response Réponse sérialisée, sans fin de ligne
+     * @return true si une réponse doit être écrite, false sinon (notification,
+     *         lot composé uniquement de notifications)
      */
-    bool is_blank(const std::string& s) const;
+    bool handle_message(const nlohmann::json& message, std::string& response);
 
     /**
-     * Erreur JSON-RPC : -32700 Parse error (id = null).
+     * Traite un message déjà parsé (objet JSON-RPC).
+     * @return true si une réponse a été produite, false pour une notification
      */
-    void send_parse_error();
+    bool dispatch(const nlohmann::json& message, std::string& response);
 
     /**
-     * Erreur -32600 Invalid Request.
+     * Traite un lot JSON-RPC (tableau). Les messages sont exécutés dans l'ordre, entre les hooks
+     * de lot ; les réponses forment un tableau dans le même ordre. Lot vide : une erreur
+     * Invalid Request (pas de tableau).
+     * @return true si une réponse a été produite, false si le lot ne contenait que des notifications
      */
-    void send_invalid_request(const nlohmann::json& id);
+    bool dispatch_batch(const nlohmann::json& batch, std::string& response);
 
     /**
-     * Erreur -32601 Method not found.
+     * Indique si le serveur est en phase opérationnelle (après initialized).
      */
-    void send_method_not_found(const nlohmann::json& id);
+    bool is_operational() const { return operational_.load(); }
 
     /**
-     * Erreur -32602 Unsupported protocol version.
+     * Réponse de succès sérialisée : {"jsonrpc":"2.0","id":…,"result":…}.
      */
-    void send_unsupported_protocol_version(const nlohmann::json& id);
+    static std::string make_result(const nlohmann::json& id, const nlohmann::json& result);
 
     /**
-     * Erreur -32602 Invalid params (avec message détaillé).
+     * Réponse de succès dont le result est déjà sérialisé (ex. tools/list calculé au démarrage).
      */
-    void send_invalid_params(const nlohmann::json& id, const std::string& message);
+    static std::string make_raw_result(const nlohmann::json& id, const std::string& result_json);
 
     /**
-     * Réponse initialize.
+     * Réponse d'erreur JSON-RPC sérialisée.
      */
-    void send_initialize_result(const nlohmann::json& id);
+    static std::string make_error(const nlohmann::json& id, int code, const std::string& message);
 
     /**
-     * Réponse ping.
+     * Result d'un tools/call : content texte, structuredContent (si objet) et isError.
+     * @param output Sortie de l'outil ("Error" si vide en cas d'erreur)
+     * @param is_error Indique si l'exécution a échoué
+     * @param structured structuredContent à joindre au résultat (objet), ou null
      */
-    void send_ping_result(const nlohmann::json& id);
+    static nlohmann::json make_tool_result(const std::string& output, bool is_error,
+                                           const nlohmann::json& structured = nullptr);
 
+private:
     /**
-     * Traite une requête initialize.
+     * Vérifie si une ligne est vide ou uniquement des espaces.
      */
-    void handle_initialize(const nlohmann::json& request, const nlohmann::json& id);
+    bool is_blank(const std::string& s) const;
 
     /**
-     * Traite une notification initialized.
+     * Traite une requête initialize.
      */
-    void handle_initialized();
+    std::string handle_initialize(const nlohmann::json& id, const nlohmann::json& params) const;
 
-    bool operational_;
+    std::unordered_map<std::string, MethodHandler> methods_;
+    BatchBeginHook batch_begin_;
+    BatchEndHook batch_end_;
+    std::atomic<bool> operational_;
 };
 
 } // namespace taskman
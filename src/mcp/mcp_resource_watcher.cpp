@@ -0,0 +1,114 @@
+/**
+ * Implémentation des abonnements aux ressources MCP.
+ */
+
+#include "mcp_resource_watcher.hpp"
+#include "mcp_resources.hpp"
+#include "mcp_tool_executor.hpp"
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <vector>
+
+namespace taskman {
+
+McpResourceWatcher::McpResourceWatcher(McpToolExecutor& executor, Notify notify)
+    : executor_(executor), notify_(std::move(notify)) {
+    thread_ = std::thread([this] { run(); });
+}
+
+McpResourceWatcher::~McpResourceWatcher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_one();
+    thread_.join();
+}
+
+std::string McpResourceWatcher::make_updated_notification(const std::string& uri) {
+    nlohmann::json notification;
+    notification["jsonrpc"] = "2.0";
+    notification["method"] = "notifications/resources/updated";
+    notification["params"]["uri"] = uri;
+    return notification.dump();
+}
+
+bool McpResourceWatcher::subscribe(const std::string& uri, std::string& error) {
+    std::string type, id;
+    if (!McpResources::parse_uri(uri, type, id)) {
+        error = "Invalid resource URI: " + uri;
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (subscriptions_.count(uri)) {
+        return true;
+    }
+    if (subscriptions_.size() >= MAX_SUBSCRIPTIONS) {
+        error = "Too many subscriptions (at most " + std::to_string(MAX_SUBSCRIPTIONS) + ")";
+        return false;
+    }
+    // Jeton lu avant le contenu : une écriture concurrente déclenche une relecture, jamais un oubli
+    std::optional<std::string> token;
+    std::map<std::string, std::string> contents;
+    if (!executor_.data_version_token(token) || !executor_.read_resources({uri}, contents)) {
+        error = "Failed to open database";
+        return false;
+    }
+    if (!token) {
+        error = "resources/subscribe needs the change counter of the database: run taskman init";
+        return false;
+    }
+    auto it = contents.find(uri);
+    subscriptions_[uri] = it != contents.end() ? std::optional<std::string>(it->second) : std::nullopt;
+    if (subscriptions_.size() == 1) {
+        token_ = token;
+    }
+    cv_.notify_one();
+    return true;
+}
+
+void McpResourceWatcher::unsubscribe(const std::string& uri) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    subscriptions_.erase(uri);
+}
+
+void McpResourceWatcher::release_database() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    executor_.release_database();
+}
+
+void McpResourceWatcher::run() {
+    std::vector<std::string> updated;
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        cv_.wait(lock, [this] { return stopping_ || !subscriptions_.empty(); });
+        if (cv_.wait_for(lock, std::chrono::milliseconds(POLL_MS), [this] { return stopping_; })) {
+            return;
+        }
+        std::optional<std::string> token;
+        if (subscriptions_.empty() || !executor_.data_version_token(token) || !token || token == token_) {
+            continue;
+        }
+        std::vector<std::string> uris;
+        for (const auto& [uri, content] : subscriptions_) uris.push_back(uri);
+        std::map<std::string, std::string> contents;
+        if (!executor_.read_resources(uris, contents)) {
+            continue;
+        }
+        token_ = token;
+        for (auto& [uri, content] : subscriptions_) {
+            auto it = contents.find(uri);
+            std::optional<std::string> current =
+                it != contents.end() ? std::optional<std::string>(std::move(it->second)) : std::nullopt;
+            if (current == content) continue;
+            content = std::move(current);
+            updated.push_back(uri);
+        }
+        lock.unlock();
+        for (const auto& uri : updated) notify_(make_updated_notification(uri));
+        updated.clear();
+        lock.lock();
+    }
+}
+
+} // namespace taskman
@@ -0,0 +1,86 @@
+/**
+ * Abonnements aux ressources MCP (resources/subscribe, notifications/resources/updated).
+ * Responsabilité unique : surveiller les ressources abonnées et notifier celles qui ont changé.
+ *
+ * Un thread relit le jeton DataVersion toutes les POLL_MS millisecondes tant qu'il y a des
+ * abonnements. Quand le jeton change, les ressources abonnées sont relues en une lecture
+ * (McpResources::read) et comparées au dernier contenu connu : seules celles dont le contenu
+ * diffère (ou qui ont disparu, ou sont apparues) sont notifiées. Une écriture qui ne touche
+ * pas une ressource abonnée ne produit donc aucune notification.
+ * Le watcher a son propre McpToolExecutor (donc sa propre connexion), protégé par un mutex :
+ * subscribe() est appelé depuis la voie d'écriture, la surveillance depuis le thread du watcher.
+ */
+
+#ifndef TASKMAN_MCP_RESOURCE_WATCHER_HPP
+#define TASKMAN_MCP_RESOURCE_WATCHER_HPP
+
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+namespace taskman {
+
+class McpToolExecutor;
+
+class McpResourceWatcher {
+public:
+    /** Intervalle de relecture du jeton DataVersion (millisecondes). */
+    static constexpr int POLL_MS = 100;
+    /** Nombre maximal de ressources abonnées (borne le coût d'une relecture). */
+    static constexpr size_t MAX_SUBSCRIPTIONS = 1000;
+
+    /** Sortie d'une notification sérialisée (stdout en stdio, flux SSE de la session en HTTP). */
+    using Notify = std::function<void(std::string notification)>;
+
+    /**
+     * @param executor Exécuteur réservé au watcher (connexion propre)
+     * @param notify Sortie des notifications, appelée depuis le thread du watcher
+     */
+    McpResourceWatcher(McpToolExecutor& executor, Notify notify);
+
+    /** Arrête le thread de surveillance. */
+    ~McpResourceWatcher();
+
+    McpResourceWatcher(const McpResourceWatcher&) = delete;
+    McpResourceWatcher& operator=(const McpResourceWatcher&) = delete;
+
+    /**
+     * Abonne l'URI (déjà abonnée : no-op). Le contenu actuel est lu tout de suite et sert de
+     * référence : seules les écritures suivantes sont notifiées. Une URI sans ressource est
+     * acceptée (notifiée à la création).
+     * Retourne false avec un message dans error (URI invalide, trop d'abonnements, base
+     * inaccessible ou sans compteur de changements).
+     */
+    bool subscribe(const std::string& uri, std::string& error);
+
+    /** Désabonne l'URI (non abonnée : no-op). */
+    void unsubscribe(const std::string& uri);
+
+    /** Ferme la connexion du watcher (remplacement du fichier par demo:generate ; rouverte ensuite). */
+    void release_database();
+
+    /** Notification JSON-RPC sérialisée notifications/resources/updated pour l'URI. */
+    static std::string make_updated_notification(const std::string& uri);
+
+private:
+    void run();
+
+    McpToolExecutor& executor_;
+    Notify notify_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    /** URI → dernier contenu connu (nullopt : ressource absente). */
+    std::map<std::string, std::optional<std::string>> subscriptions_;
+    /** Jeton DataVersion de la dernière relecture. */
+    std::optional<std::string> token_;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+} // namespace taskman
+
+#endif /* TASKMAN_MCP_RESOURCE_WATCHER_HPP */
@@ -0,0 +1,133 @@
+/**
+ * Implémentation des ressources MCP.
+ */
+
+#include "mcp_resources.hpp"
+#include "core/milestone/milestone_repository.hpp"
+#include "core/milestone/milestone_service.hpp"
+#include "core/note/note_repository.hpp"
+#include "core/phase/phase_repository.hpp"
+#include "core/phase/phase_service.hpp"
+#include "core/task/task_repository.hpp"
+#include "core/task/task_service.hpp"
+#include "infrastructure/db/db.hpp"
+#include "util/formats.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace taskman {
+
+namespace {
+
+using json = nlohmann::json;
+
+/** Types de ressources, dans l'ordre de resources/templates/list. */
+const char* const TYPES[] = {"phase", "milestone", "task", "note"};
+
+/** Ajoute le contenu d'une ligne (vide = ressource absente). */
+template <class ToJson>
+void add_content(std::map<std::string, std::string>& contents, const std::string& type, const Row& row,
+                 ToJson to_json) {
+    if (row.empty()) return;
+    auto id = row.find("id");
+    if (id == row.end() || !id->second) return;
+    json obj;
+    to_json(obj, row);
+    contents[McpResources::make_uri(type, *id->second)] = obj.dump();
+}
+
+} // namespace
+
+bool McpResources::parse_uri(const std::string& uri, std::string& type, std::string& id) {
+    const size_t scheme_len = std::strlen(SCHEME);
+    if (uri.compare(0, scheme_len, SCHEME) != 0) return false;
+    size_t slash = uri.find('/', scheme_len);
+    if (slash == std::string::npos) return false;
+    type = uri.substr(scheme_len, slash - scheme_len);
+    id = uri.substr(slash + 1);
+    if (id.empty() || id.find('/') != std::string::npos) return false;
+    return std::any_of(std::begin(TYPES), std::end(TYPES), [&type](const char* t) { return type == t; });
+}
+
+std::string McpResources::make_uri(const std::string& type, const std::string& id) {
+    return std::string(SCHEME) + type + "/" + id;
+}
+
+json McpResources::templates_list_result() {
+    static const char* const descriptions[] = {
+        "Phase (same object as phase:list)",
+        "Milestone (same object as milestone:list)",
+        "Task with note_ids (same object as task:get)",
+        "Task note (same object as task:note:list)",
+    };
+    json templates = json::array();
+    for (size_t i = 0; i < std::size(TYPES); ++i) {
+        json t;
+        t["uriTemplate"] = std::string(SCHEME) + TYPES[i] + "/{id}";
+        t["name"] = TYPES[i];
+        t["description"] = descriptions[i];
+        t["mimeType"] = MIME_TYPE;
+        templates.push_back(std::move(t));
+    }
+    return json{{"resourceTemplates", std::move(templates)}};
+}
+
+void McpResources::read(Database& db, const std::vector<std::string>& uris,
+                        std::map<std::string, std::string>& contents) {
+    std::map<std::string, std::vector<std::string>> ids;
+    std::string type, id;
+    for (const auto& uri : uris) {
+        if (parse_uri(uri, type, id)) ids[type].push_back(id);
+    }
+    auto& executor = db.get_executor();
+    if (ids.count("phase")) {
+        PhaseRepository phases(executor);
+        for (const auto& phase_id : ids["phase"]) add_content(contents, "phase", phases.get_by_id(phase_id), phase_to_json);
+    }
+    if (ids.count("milestone")) {
+        MilestoneRepository milestones(executor);
+        for (const auto& milestone_id : ids["milestone"]) {
+            add_content(contents, "milestone", milestones.get_by_id(milestone_id), milestone_to_json);
+        }
+    }
+    if (ids.count("task")) {
+        TaskRepository repository(executor);
+        TaskService tasks(repository);
+        auto to_json = [](json& out, const Row& row) { task_to_json(out, row); };
+        for (const auto& row : tasks.get_tasks(ids["task"])) add_content(contents, "task", row, to_json);
+    }
+    if (ids.count("note")) {
+        NoteRepository notes(executor);
+        const auto& note_ids = ids["note"];
+        for (size_t start = 0; start < note_ids.size(); start += MAX_READ_URIS) {
+            size_t n = std::min(MAX_READ_URIS, note_ids.size() - start);
+            std::vector<std::string> chunk(note_ids.begin() + start, note_ids.begin() + start + n);
+            for (const auto& row : notes.list_by_ids(chunk)) add_content(contents, "note", row, note_to_json);
+        }
+    }
+}
+
+json McpResources::list(Database& db) {
+    json resources = json::array();
+    PhaseRepository phase_repository(db.get_executor());
+    PhaseService phases(phase_repository);
+    for (const auto& row : phases.list_phases()) {
+        std::string id = row.at("id").value_or("");
+        auto name = row.find("name");
+        resources.push_back(json{{"uri", make_uri("phase", id)},
+                                 {"name", "Phase " + id + ": " + (name != row.end() ? name->second.value_or("") : "")},
+                                 {"mimeType", MIME_TYPE}});
+    }
+    MilestoneRepository milestone_repository(db.get_executor());
+    MilestoneService milestones(milestone_repository);
+    for (const auto& row : milestones.list_milestones(std::nullopt)) {
+        std::string id = row.at("id").value_or("");
+        auto name = row.find("name");
+        resources.push_back(json{{"uri", make_uri("milestone", id)},
+                                 {"name", "Milestone " + id + ": " + (name != row.end() ? name->second.value_or("") : "")},
+                                 {"mimeType", MIME_TYPE}});
+    }
+    return resources;
+}
+
+} // namespace taskman
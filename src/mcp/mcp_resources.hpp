@@ -0,0 +1,60 @@
+/**
+ * Ressources MCP : phases, jalons, tâches et notes adressés par URI stable.
+ * Responsabilité unique : analyser les URI taskman://<type>/<id> et lire leur contenu JSON
+ * (le même que phase:list, milestone:list, task:get et task:note:list). Une lecture de plusieurs
+ * URI regroupe les IDs par type : tâches et notes sont lues par requêtes IN, phases et jalons
+ * (tables courtes) par ID.
+ * Le contenu sert aussi de référence aux abonnements (McpResourceWatcher) : une ressource
+ * a changé si son texte a changé.
+ */
+
+#ifndef TASKMAN_MCP_RESOURCES_HPP
+#define TASKMAN_MCP_RESOURCES_HPP
+
+#include <nlohmann/json.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace taskman {
+
+class Database;
+
+class McpResources {
+public:
+    /** Préfixe des URI ("taskman://task/<id>"). */
+    static constexpr const char* SCHEME = "taskman://";
+    /** Type MIME du contenu des ressources. */
+    static constexpr const char* MIME_TYPE = "application/json";
+    /** Nombre maximal d'URI par resources/read. */
+    static constexpr size_t MAX_READ_URIS = 100;
+
+    /**
+     * Analyse une URI taskman://<type>/<id> (type : phase, milestone, task ou note).
+     * Retourne false si le schéma, le type ou l'ID est invalide.
+     */
+    static bool parse_uri(const std::string& uri, std::string& type, std::string& id);
+
+    /** URI d'une ressource : taskman://<type>/<id>. */
+    static std::string make_uri(const std::string& type, const std::string& id);
+
+    /** Result de resources/templates/list : un modèle d'URI par type. */
+    static nlohmann::json templates_list_result();
+
+    /**
+     * Lit plusieurs ressources (URI déjà validées par parse_uri) sur la connexion fournie.
+     * contents : URI → contenu JSON sérialisé (sans fin de ligne) ; les URI sans ressource
+     * n'y figurent pas. À appeler dans une transaction pour une lecture cohérente.
+     */
+    static void read(Database& db, const std::vector<std::string>& uris, std::map<std::string, std::string>& contents);
+
+    /**
+     * Liste des ressources de structure du projet (phases puis jalons) pour resources/list :
+     * [{uri, name, mimeType}]. Les tâches et les notes passent par les modèles d'URI.
+     */
+    static nlohmann::json list(Database& db);
+};
+
+} // namespace taskman
+
+#endif /* TASKMAN_MCP_RESOURCES_HPP */
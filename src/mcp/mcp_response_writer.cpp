@@ -0,0 +1,49 @@
+/**
+ * Implémentation de l'écriture des réponses MCP.
+ */
+
+#include "mcp_response_writer.hpp"
+
+namespace taskman {
+
+McpResponseWriter::McpResponseWriter(std::streambuf* out) : out_(out) {
+    thread_ = std::thread([this] { run(); });
+}
+
+McpResponseWriter::~McpResponseWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_one();
+    thread_.join();
+}
+
+void McpResponseWriter::write(std::string response) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.push_back(std::move(response));
+    }
+    cv_.notify_one();
+}
+
+void McpResponseWriter::run() {
+    std::vector<std::string> batch;
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        cv_.wait(lock, [this] { return stopping_ || !pending_.empty(); });
+        if (pending_.empty()) {
+            return;  // stopping_, tout est écrit
+        }
+        batch.swap(pending_);
+        lock.unlock();
+        for (const auto& response : batch) {
+            out_ << response << '\n';
+        }
+        out_.flush();
+        batch.clear();
+        lock.lock();
+    }
+}
+
+} // namespace taskman
@@ -0,0 +1,51 @@
+/**
+ * Écriture des réponses MCP sur stdout.
+ * Responsabilité unique : sérialiser l'accès à stdout depuis plusieurs threads.
+ * Un thread dédié écrit les réponses en attente puis vide le flux une fois par lot :
+ * les réponses produites ensemble partent en une seule écriture.
+ */
+
+#ifndef TASKMAN_MCP_RESPONSE_WRITER_HPP
+#define TASKMAN_MCP_RESPONSE_WRITER_HPP
+
+#include <condition_variable>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace taskman {
+
+class McpResponseWriter {
+public:
+    /**
+     * @param out Tampon de sortie (stdout d'origine). Il est conservé tel quel : une redirection
+     *            ultérieure de std::cout (capture des commandes CLI) ne le détourne pas.
+     */
+    explicit McpResponseWriter(std::streambuf* out);
+
+    /** Écrit les réponses restantes, vide le flux et arrête le thread. */
+    ~McpResponseWriter();
+
+    McpResponseWriter(const McpResponseWriter&) = delete;
+    McpResponseWriter& operator=(const McpResponseWriter&) = delete;
+
+    /** Ajoute une réponse (une ligne, sans fin de ligne). Appelable depuis n'importe quel thread. */
+    void write(std::string response);
+
+private:
+    void run();
+
+    std::ostream out_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<std::string> pending_;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+} // namespace taskman
+
+#endif /* TASKMAN_MCP_RESPONSE_WRITER_HPP */
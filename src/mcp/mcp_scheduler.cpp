@@ -0,0 +1,123 @@
+/**
+ * Implémentation de l'ordonnanceur des requêtes MCP.
+ */
+
+#include "mcp_scheduler.hpp"
+#include <algorithm>
+
+namespace taskman {
+
+McpScheduler::McpScheduler(size_t read_workers, size_t max_in_flight, size_t max_detached)
+    : max_in_flight_(std::max<size_t>(1, max_in_flight)), max_detached_(std::max<size_t>(1, max_detached)) {
+    for (size_t i = 0; i < read_workers; ++i) {
+        readers_.emplace_back([this, i] { read_loop(i); });
+    }
+    writer_ = std::thread([this] { write_loop(); });
+}
+
+McpScheduler::~McpScheduler() {
+    wait_idle();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto& t : readers_) t.join();
+    writer_.join();
+    for (auto& t : detached_) t.join();
+}
+
+bool McpScheduler::submit(Lane lane, Job job) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (lane == Lane::Detached) {
+        // Jamais d'attente ici : le lecteur des requêtes doit pouvoir recevoir l'écriture qui réveille
+        if (detached_in_flight_ >= max_detached_) return false;
+        ++detached_in_flight_;
+        join_finished_detached();
+        detached_.emplace_back([this, task = Task{std::move(job), 0}]() mutable {
+            run(task, 0);
+            std::lock_guard<std::mutex> done(mutex_);
+            detached_finished_.push_back(std::this_thread::get_id());
+            --detached_in_flight_;
+            cv_.notify_all();
+        });
+        return true;
+    }
+    cv_.wait(lock, [this] { return in_flight_ < max_in_flight_; });
+    ++in_flight_;
+    if (lane == Lane::Read && !readers_.empty()) {
+        read_queue_.push_back(Task{std::move(job), writes_submitted_});
+        ++reads_submitted_;
+    } else {
+        write_queue_.push_back(Task{std::move(job), reads_submitted_});
+        ++writes_submitted_;
+    }
+    lock.unlock();
+    cv_.notify_all();
+    return true;
+}
+
+void McpScheduler::wait_idle() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return in_flight_ == 0 && detached_in_flight_ == 0; });
+}
+
+void McpScheduler::join_finished_detached() {
+    for (auto id : detached_finished_) {
+        auto it = std::find_if(detached_.begin(), detached_.end(), [id](const std::thread& t) { return t.get_id() == id; });
+        if (it == detached_.end()) continue;
+        it->join();
+        detached_.erase(it);
+    }
+    detached_finished_.clear();
+}
+
+void McpScheduler::run(Task& task, size_t worker) {
+    try {
+        task.job(worker);
+    } catch (...) {
+        // La tâche produit elle-même sa réponse d'erreur ; ne jamais bloquer le compteur
+    }
+}
+
+void McpScheduler::read_loop(size_t worker) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        cv_.wait(lock, [this] {
+            return stopping_ || (!read_queue_.empty() && writes_done_ >= read_queue_.front().barrier);
+        });
+        if (read_queue_.empty() || writes_done_ < read_queue_.front().barrier) {
+            return;  // stopping_
+        }
+        Task task = std::move(read_queue_.front());
+        read_queue_.pop_front();
+        lock.unlock();
+        run(task, worker);
+        lock.lock();
+        ++reads_done_;
+        --in_flight_;
+        cv_.notify_all();
+    }
+}
+
+void McpScheduler::write_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        cv_.wait(lock, [this] {
+            return stopping_ || (!write_queue_.empty() && reads_done_ >= write_queue_.front().barrier);
+        });
+        if (write_queue_.empty() || reads_done_ < write_queue_.front().barrier) {
+            return;  // stopping_
+        }
+        Task task = std::move(write_queue_.front());
+        write_queue_.pop_front();
+        lock.unlock();
+        run(task, 0);
+        lock.lock();
+        ++writes_done_;
+        --in_flight_;
+        cv_.notify_all();
+    }
+}
+
+} // namespace taskman
@@ -0,0 +1,93 @@
+/**
+ * Ordonnanceur des requêtes MCP.
+ * Responsabilité unique : exécuter les requêtes sur des threads, lectures en parallèle,
+ * écritures sérialisées, avec une limite de requêtes en cours.
+ *
+ * Ordre observable identique à une exécution séquentielle : une lecture attend la fin des
+ * écritures soumises avant elle, une écriture attend la fin des lectures et écritures soumises
+ * avant elle. Seules les lectures consécutives s'exécutent en parallèle ; les réponses peuvent
+ * donc sortir dans le désordre (le client les associe par id).
+ * Les attentes (voie Detached, taskman_task_wait) sortent de cet ordre : chacune démarre
+ * aussitôt sur son propre thread, et les écritures suivantes ne l'attendent pas. Elles ont leur
+ * propre limite et ne bloquent jamais submit : des attentes longues ne doivent pas suspendre la
+ * lecture des requêtes, dont l'écriture qui les réveille.
+ */
+
+#ifndef TASKMAN_MCP_SCHEDULER_HPP
+#define TASKMAN_MCP_SCHEDULER_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace taskman {
+
+class McpScheduler {
+public:
+    enum class Lane { Read, Write, Detached };
+
+    /** Tâche : reçoit l'index du worker de lecture (0..read_workers-1) ; 0 sur les autres voies. */
+    using Job = std::function<void(size_t worker)>;
+
+    /**
+     * @param read_workers Nombre de threads de lecture (0 : les lectures passent par la voie d'écriture)
+     * @param max_in_flight Nombre maximal de requêtes soumises et non terminées, hors voie Detached (minimum 1)
+     * @param max_detached Nombre maximal de tâches Detached en cours (minimum 1)
+     */
+    McpScheduler(size_t read_workers, size_t max_in_flight, size_t max_detached);
+
+    /** Attend la fin des requêtes en cours puis arrête les threads. */
+    ~McpScheduler();
+
+    McpScheduler(const McpScheduler&) = delete;
+    McpScheduler& operator=(const McpScheduler&) = delete;
+
+    /** Soumet une tâche. Voies Read et Write : bloque tant que max_in_flight requêtes sont en
+     * cours, retourne true. Voie Detached : ne bloque pas ; retourne false (tâche non exécutée)
+     * si max_detached tâches Detached sont en cours. */
+    bool submit(Lane lane, Job job);
+
+    /** Attend que toutes les tâches soumises soient terminées (Detached comprises). */
+    void wait_idle();
+
+    size_t read_workers() const { return readers_.size(); }
+
+private:
+    struct Task {
+        Job job;
+        uint64_t barrier;  // lecture : écritures à attendre ; écriture : lectures à attendre
+    };
+
+    void read_loop(size_t worker);
+    void write_loop();
+    void run(Task& task, size_t worker);
+    /** Joint les threads Detached terminés (mutex_ tenu). */
+    void join_finished_detached();
+
+    size_t max_in_flight_;
+    size_t max_detached_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Task> read_queue_;
+    std::deque<Task> write_queue_;
+    uint64_t reads_submitted_ = 0;
+    uint64_t reads_done_ = 0;
+    uint64_t writes_submitted_ = 0;
+    uint64_t writes_done_ = 0;
+    size_t in_flight_ = 0;
+    size_t detached_in_flight_ = 0;
+    bool stopping_ = false;
+    std::vector<std::thread> readers_;
+    std::thread writer_;
+    std::vector<std::thread> detached_;
+    std::vector<std::thread::id> detached_finished_;
+};
+
+} // namespace taskman
+
+#endif /* TASKMAN_MCP_SCHEDULER_HPP */
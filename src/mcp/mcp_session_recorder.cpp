@@ -0,0 +1,65 @@
+/**
+ * Implémentation de McpSessionRecorder.
+ */
+
+#include "mcp_session_recorder.hpp"
+#include <nlohmann/json.hpp>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+namespace taskman {
+
+namespace {
+
+double round3(double v) {
+    return std::round(v * 1000.0) / 1000.0;
+}
+
+} // namespace
+
+McpSessionRecorder::McpSessionRecorder(const std::string& path)
+    : started_(std::chrono::steady_clock::now()), out_(path, std::ios::binary | std::ios::app) {}
+
+std::unique_ptr<McpSessionRecorder> McpSessionRecorder::from_env() {
+    const char* path = std::getenv(ENV_VAR);
+    if (!path || path[0] == '\0') return nullptr;
+    auto recorder = std::make_unique<McpSessionRecorder>(path);
+    if (!recorder->is_open()) {
+        std::cerr << "taskman: cannot open " << ENV_VAR << " file: " << path << "\n";
+        return nullptr;
+    }
+    return recorder;
+}
+
+double McpSessionRecorder::elapsed_ms(std::chrono::steady_clock::time_point t) const {
+    return round3(std::chrono::duration<double, std::milli>(t - started_).count());
+}
+
+McpSessionRecorder::Pending McpSessionRecorder::record_message(const std::string& line, const std::string& session) {
+    Pending pending;
+    pending.received = std::chrono::steady_clock::now();
+    nlohmann::json entry = {{"t_ms", elapsed_ms(pending.received)}, {"line", line}};
+    if (!session.empty()) entry["session"] = session;
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending.seq = next_seq_++;
+    entry["seq"] = pending.seq;
+    out_ << entry.dump() << "\n";
+    out_.flush();
+    return pending;
+}
+
+void McpSessionRecorder::record_response(const Pending& pending, size_t response_bytes) {
+    auto now = std::chrono::steady_clock::now();
+    nlohmann::json entry = {
+        {"seq", pending.seq},
+        {"t_ms", elapsed_ms(now)},
+        {"latency_ms", round3(std::chrono::duration<double, std::milli>(now - pending.received).count())},
+        {"response_bytes", response_bytes},
+    };
+    std::lock_guard<std::mutex> lock(mutex_);
+    out_ << entry.dump() << "\n";
+    out_.flush();
+}
+
+} // namespace taskman
@@ -0,0 +1,66 @@
+/**
+ * Enregistrement des sessions MCP (TASKMAN_MCP_RECORD=<fichier>).
+ * Responsabilité unique : ajouter au fichier JSONL chaque message reçu, puis le temps de sa
+ * réponse, pour rejouer le trafic réel avec `taskman bench:mcp --replay`.
+ *
+ * Deux types de lignes, reliées par seq :
+ * - message reçu : {"seq", "t_ms", "line"} (+ "session" pour le transport HTTP), écrit à la
+ *   réception, dans l'ordre d'arrivée ; line est le texte reçu tel quel ;
+ * - réponse : {"seq", "t_ms", "latency_ms", "response_bytes"}, écrite quand la réponse est prête
+ *   (dans l'ordre de fin d'exécution ; response_bytes = 0 sans réponse).
+ * t_ms : millisecondes depuis l'ouverture de l'enregistreur. Chaque ligne est écrite et vidée
+ * sous un mutex (plusieurs threads de réponse, plusieurs sessions HTTP).
+ */
+
+#ifndef TASKMAN_MCP_SESSION_RECORDER_HPP
+#define TASKMAN_MCP_SESSION_RECORDER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace taskman {
+
+class McpSessionRecorder {
+public:
+    /** Variable d'environnement : chemin du fichier d'enregistrement. */
+    static constexpr const char* ENV_VAR = "TASKMAN_MCP_RECORD";
+
+    /** Message reçu en attente de sa réponse. */
+    struct Pending {
+        uint64_t seq = 0;
+        std::chrono::steady_clock::time_point received;
+    };
+
+    /** Ouvre path en ajout (is_open() indique le succès). */
+    explicit McpSessionRecorder(const std::string& path);
+
+    /**
+     * Enregistreur désigné par TASKMAN_MCP_RECORD, ou nullptr si la variable est absente ou
+     * si le fichier ne s'ouvre pas (message sur stderr).
+     */
+    static std::unique_ptr<McpSessionRecorder> from_env();
+
+    bool is_open() const { return out_.is_open(); }
+
+    /** Enregistre un message reçu (session : id de session HTTP, vide en stdio). */
+    Pending record_message(const std::string& line, const std::string& session = "");
+
+    /** Enregistre la réponse d'un message (response_bytes = 0 s'il n'en produit pas). */
+    void record_response(const Pending& pending, size_t response_bytes);
+
+private:
+    double elapsed_ms(std::chrono::steady_clock::time_point t) const;
+
+    const std::chrono::steady_clock::time_point started_;
+    std::mutex mutex_;
+    std::ofstream out_;
+    uint64_t next_seq_ = 1;
+};
+
+} // namespace taskman
+
+#endif /* TASKMAN_MCP_SESSION_RECORDER_HPP */
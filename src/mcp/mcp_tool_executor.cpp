@@ -3,18 +3,144 @@
  */
 
 #include "mcp_tool_executor.hpp"
+#include "mcp_resources.hpp"
 #include "cli/command.hpp"
+#include "cli/conditional_read.hpp"
+#include "infrastructure/db/data_version.hpp"
 #include "infrastructure/db/db.hpp"
-#include <sstream>
+#include "infrastructure/db/transaction.hpp"
+#include "util/output_capture.hpp"
 #include <iostream>
 #include <cstdlib>
 #include <cstring>
+#if defined(_WIN32) || defined(_WIN64)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <filesystem>
+#else
+#include <sys/stat.h>
+#endif
 
 namespace taskman {
 
 McpToolExecutor::McpToolExecutor(const McpToolRegistry& registry, const CommandRegistry& command_registry,
                                  const std::string& db_path)
-    : tool_registry_(registry), command_registry_(command_registry), db_path_(db_path) {
+    : tool_registry_(registry), command_registry_(command_registry), db_path_(db_path),
+      db_(std::make_unique<Database>()) {
+}
+
+McpToolExecutor::~McpToolExecutor() {
+    end_snapshot();
+}
+
+McpToolExecutor::FileIdentity McpToolExecutor::file_identity(const std::string& path) {
+    FileIdentity id;
+#if defined(_WIN32) || defined(_WIN64)
+    // st_ino vaut toujours 0 sous Windows : numéro de volume et index de fichier (NTFS, ReFS)
+    HANDLE h = CreateFileW(std::filesystem::u8path(path).wstring().c_str(), 0,
+                           FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                           FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+    if (h == INVALID_HANDLE_VALUE) return id;
+    BY_HANDLE_FILE_INFORMATION info;
+    if (GetFileInformationByHandle(h, &info)) {
+        id.exists = true;
+        id.dev = info.dwVolumeSerialNumber;
+        id.ino = (static_cast<unsigned long long>(info.nFileIndexHigh) << 32) | info.nFileIndexLow;
+    }
+    CloseHandle(h);
+#else
+    struct stat st;
+    if (stat(path.c_str(), &st) == 0) {
+        id.exists = true;
+        id.dev = static_cast<unsigned long long>(st.st_dev);
+        id.ino = static_cast<unsigned long long>(st.st_ino);
+    }
+#endif
+    return id;
+}
+
+Database* McpToolExecutor::acquire_database() {
+    if (snapshot_) {
+        // Pendant un snapshot, la connexion (et sa transaction) reste celle du début du lot
+        return db_.get();
+    }
+    if (db_->is_open() && !(file_identity(db_path_) == db_identity_)) {
+        // Fichier supprimé ou remplacé depuis l'ouverture : la connexion pointe encore vers l'ancien.
+        db_->close();
+    }
+    if (!db_->is_open()) {
+        if (!db_->open(db_path_.c_str())) {
+            return nullptr;
+        }
+        db_identity_ = file_identity(db_path_);
+    }
+    return db_.get();
+}
+
+bool McpToolExecutor::begin_snapshot() {
+    if (snapshot_) {
+        return true;
+    }
+    Database* db = acquire_database();
+    if (!db) {
+        return false;
+    }
+    snapshot_ = std::make_unique<Transaction>(db->get_executor());
+    if (!snapshot_->active()) {
+        snapshot_.reset();
+        return false;
+    }
+    return true;
+}
+
+void McpToolExecutor::end_snapshot() {
+    if (!snapshot_) {
+        return;
+    }
+    snapshot_->commit();
+    snapshot_.reset();
+}
+
+void McpToolExecutor::release_database() {
+    end_snapshot();
+    db_->close();
+}
+
+bool McpToolExecutor::read_resources(const std::vector<std::string>& uris,
+                                     std::map<std::string, std::string>& contents) {
+    Database* db = acquire_database();
+    if (!db) {
+        return false;
+    }
+    if (snapshot_) {
+        McpResources::read(*db, uris, contents);
+        return true;
+    }
+    // Toutes les ressources demandées viennent du même état de la base
+    Transaction read(db->get_executor());
+    McpResources::read(*db, uris, contents);
+    read.commit();
+    return true;
+}
+
+bool McpToolExecutor::list_resources(nlohmann::json& resources) {
+    Database* db = acquire_database();
+    if (!db) {
+        return false;
+    }
+    resources = McpResources::list(*db);
+    return true;
+}
+
+bool McpToolExecutor::data_version_token(std::optional<std::string>& token) {
+    Database* db = acquire_database();
+    if (!db) {
+        return false;
+    }
+    DataVersion data_version(db->get_executor());
+    token = data_version.token();
+    return true;
 }
 
 std::string McpToolExecutor::json_to_string(const nlohmann::json& val) const {
@@ -62,6 +188,13 @@ std::vector<std::string> McpToolExecutor::build_argv(const McpToolDefinition& to
             }
             if (is_positional) continue;
 
+            // Option booléenne du schéma : --key si true, rien si false
+            if (prop.is_object() && prop.value("type", nlohmann::json()) == "boolean") {
+                if (arguments.contains(key) && arguments[key].is_boolean() && arguments[key].get<bool>()) {
+                    argv.push_back("--" + key);
+                }
+                continue;
+            }
             // Si la clé est présente dans arguments et non nulle, ajouter --key value
             if (arguments.contains(key) && !arguments[key].is_null()) {
                 std::string val = json_to_string(arguments[key]);
@@ -85,23 +218,76 @@ std::vector<std::string> McpToolExecutor::build_argv(const McpToolDefinition& to
     return argv;
 }
 
-McpToolExecutor::CaptureGuard::CaptureGuard() {
-    old_out = std::cout.rdbuf(oss_out.rdbuf());
-    old_err = std::cerr.rdbuf(oss_err.rdbuf());
-}
+int McpToolExecutor::execute_conditional(const std::string& mcp_tool_name, const nlohmann::json& arguments,
+                                         std::string& output, bool& is_error, nlohmann::json* structured) {
+    std::string expected = json_to_string(arguments[IF_NONE_MATCH_KEY]);
+    Database* db_ptr = acquire_database();
+    if (!db_ptr) {
+        output = "Failed to open database";
+        is_error = true;
+        return 1;
+    }
+    DataVersion data_version(db_ptr->get_executor());
+    std::optional<std::string> token = data_version.token();
+    if (!token) {
+        output = DATA_VERSION_MISSING_MESSAGE;
+        is_error = true;
+        return 1;
+    }
+    if (*token == expected) {
+        output = unchanged_response(*token) + "\n";
+        is_error = false;
+        if (structured) {
+            *structured = nlohmann::json{{"unchanged", true}, {"version", *token}};
+        }
+        return 0;
+    }
 
-McpToolExecutor::CaptureGuard::~CaptureGuard() {
-    std::cout.rdbuf(old_out);
-    std::cerr.rdbuf(old_err);
+    nlohmann::json rest = arguments;
+    rest.erase(IF_NONE_MATCH_KEY);
+    int exit_code = execute_tool(mcp_tool_name, rest, output, is_error, structured);
+    if (exit_code != 0) {
+        return exit_code;
+    }
+    auto format = rest.find("format");
+    bool is_text = format != rest.end() && format->is_string() && format->get<std::string>() == "text";
+    output = changed_response(*token, output, !is_text) + "\n";
+    if (structured && !structured->is_null()) {
+        *structured = nlohmann::json{{"unchanged", false}, {"version", *token}, {"result", std::move(*structured)}};
+    }
+    return exit_code;
 }
 
 int McpToolExecutor::execute_tool(const std::string& mcp_tool_name, const nlohmann::json& arguments,
-                                   std::string& output, bool& is_error) {
+                                   std::string& output, bool& is_error, nlohmann::json* structured) {
     // Obtenir la définition de l'outil
     const McpToolDefinition* tool = tool_registry_.get_tool(mcp_tool_name);
     if (!tool) {
         return -1; // Outil inconnu
     }
+    if (structured) {
+        *structured = nullptr;
+    }
+    if (tool->read_only && arguments.is_object() && arguments.contains(IF_NONE_MATCH_KEY)) {
+        return execute_conditional(mcp_tool_name, arguments, output, is_error, structured);
+    }
+
+    // Handler typé : appel direct des services, sans argv ni capture des flux globaux
+    if (handlers_.handles(mcp_tool_name, arguments)) {
+        Database* db_ptr = acquire_database();
+        if (!db_ptr) {
+            output = "Failed to open database";
+            is_error = true;
+            return 1;
+        }
+        McpToolResult result = handlers_.call(mcp_tool_name, *db_ptr, arguments);
+        output = std::move(result.text);
+        is_error = result.is_error;
+        if (structured) {
+            *structured = std::move(result.structured);
+        }
+        return is_error ? 1 : 0;
+    }
 
     // Obtenir la commande CLI correspondante
     std::string cli_command = tool_registry_.get_cli_command(mcp_tool_name);
@@ -123,31 +309,25 @@ int McpToolExecutor::execute_tool(const std::string& mcp_tool_name, const nlohma
         argv_ptrs.push_back(const_cast<char*>(s.c_str()));
     }
 
-    // Ouvrir la DB seulement si la commande en a besoin (évite de créer une DB vide pour rules/agents:generate)
-    Database db;
+    // Connexion persistante, ouverte seulement si la commande en a besoin
+    // (évite de créer une DB vide pour rules/agents:generate)
     Database* db_ptr = nullptr;
     if (command_registry_.command_requires_database(cli_command)) {
-        if (!db.open(db_path_.c_str())) {
+        db_ptr = acquire_database();
+        if (!db_ptr) {
             output = "Failed to open database";
             is_error = true;
             return 1;
         }
-        db_ptr = &db;
     }
 
-    // Cas spécial pour demo:generate qui doit fermer la DB avant de supprimer le fichier
-    bool needs_db_close = (cli_command == "demo:generate");
-
     // Capture stdout/stderr
-    CaptureGuard guard;
+    OutputCapture capture;
     int exit_code = 0;
 
     try {
-        if (needs_db_close && db_ptr) {
-            db.close();
-        }
-
-        // Exécuter via CommandRegistry
+        // Exécuter via CommandRegistry (demo:generate ferme la connexion persistante,
+        // supprime le fichier puis rouvre la même instance)
         exit_code = command_registry_.execute(cli_command, static_cast<int>(argv_ptrs.size()),
                                               argv_ptrs.data(), db_ptr);
 
@@ -160,10 +340,14 @@ int McpToolExecutor::execute_tool(const std::string& mcp_tool_name, const nlohma
     } catch (...) {
         exit_code = 1;
     }
+    if (cli_command == "demo:generate") {
+        // Nouveau fichier : éviter que le prochain appel ne le prenne pour un remplacement externe
+        db_identity_ = file_identity(db_path_);
+    }
 
     // Récupérer la sortie
-    output = guard.get_out();
-    std::string err_str = guard.get_err();
+    output = capture.out();
+    std::string err_str = capture.err();
     if (!err_str.empty()) {
         if (!output.empty()) {
             output += "\n";
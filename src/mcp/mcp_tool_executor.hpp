@@ -2,22 +2,29 @@
  * Exécuteur d'outils MCP.
  * Responsabilité unique : conversion JSON → argv et exécution via CommandRegistry.
  * Respecte le principe SRP : séparation de l'exécution des outils de leur définition.
+ * La connexion SQLite est conservée d'un appel à l'autre (durée de vie de run_mcp_server).
+ * Les outils ayant un handler typé (McpToolHandlers) appellent directement les services ;
+ * seuls les autres passent par argv et la capture de std::cout/std::cerr.
  */
 
 #ifndef TASKMAN_MCP_TOOL_EXECUTOR_HPP
 #define TASKMAN_MCP_TOOL_EXECUTOR_HPP
 
+#include "mcp_tool_handlers.hpp"
 #include "mcp_tool_registry.hpp"
 #include <nlohmann/json.hpp>
+#include <map>
+#include <memory>
+#include <optional>
 #include <string>
 #include <vector>
-#include <sstream>
 #include <iostream>
 
 namespace taskman {
 
 class CommandRegistry;
 class Database;
+class Transaction;
 
 /**
  * Exécuteur d'outils MCP.
@@ -28,11 +35,14 @@ public:
     /**
      * @param registry Registre des outils MCP
      * @param command_registry Registre des commandes CLI
-     * @param db_path Chemin vers la base de données
+     * @param db_path Chemin vers la base de données (ouverte au premier outil qui en a besoin)
      */
     McpToolExecutor(const McpToolRegistry& registry, const CommandRegistry& command_registry,
                     const std::string& db_path);
-    ~McpToolExecutor() = default;
+    ~McpToolExecutor();
+
+    McpToolExecutor(const McpToolExecutor&) = delete;
+    McpToolExecutor& operator=(const McpToolExecutor&) = delete;
 
     /**
      * Exécute un outil MCP.
@@ -40,12 +50,76 @@ public:
      * @param arguments Arguments JSON de l'outil
      * @param output Sortie de l'exécution (stdout + stderr)
      * @param is_error Indique si l'exécution a échoué
+     * @param structured Si non nul, reçoit le structuredContent (handlers typés ; null sinon)
      * @return Code de sortie (0 = succès, != 0 = erreur, -1 = outil inconnu)
      */
     int execute_tool(const std::string& mcp_tool_name, const nlohmann::json& arguments,
-                     std::string& output, bool& is_error);
+                     std::string& output, bool& is_error, nlohmann::json* structured = nullptr);
+
+    /**
+     * Ouvre un snapshot de lecture (transaction différée) utilisé par les appels suivants
+     * jusqu'à end_snapshot() : toutes les lectures voient le même état de la base.
+     * Réservé aux lots d'outils en lecture seule. Retourne false si la base ne s'ouvre pas.
+     */
+    bool begin_snapshot();
+
+    /** Termine le snapshot ouvert par begin_snapshot() (no-op sinon). */
+    void end_snapshot();
+
+    /**
+     * Vrai si l'appel passe par un handler typé (pas de capture de std::cout/std::cerr) :
+     * il peut alors s'exécuter en parallèle d'autres appels, sur une autre instance.
+     */
+    bool has_typed_handler(const std::string& mcp_tool_name, const nlohmann::json& arguments) const {
+        return handlers_.handles(mcp_tool_name, arguments);
+    }
+
+    /** Ferme la connexion persistante (rouverte au prochain appel). */
+    void release_database();
+
+    /**
+     * Lit des ressources MCP (McpResources::read) sur la connexion persistante, dans une
+     * transaction de lecture (ou le snapshot du lot en cours). contents : URI → contenu JSON.
+     * Retourne false si la base ne s'ouvre pas.
+     */
+    bool read_resources(const std::vector<std::string>& uris, std::map<std::string, std::string>& contents);
+
+    /** Liste des ressources de structure (McpResources::list). Retourne false si la base ne s'ouvre pas. */
+    bool list_resources(nlohmann::json& resources);
+
+    /**
+     * Jeton DataVersion de la base (nullopt si le compteur est absent).
+     * Retourne false si la base ne s'ouvre pas.
+     */
+    bool data_version_token(std::optional<std::string>& token);
 
 private:
+    /** Identité du fichier de base (device + inode ; sous Windows, volume + index de fichier), pour
+     * détecter un fichier supprimé ou remplacé. */
+    struct FileIdentity {
+        bool exists = false;
+        unsigned long long dev = 0;
+        unsigned long long ino = 0;
+        bool operator==(const FileIdentity& o) const { return exists == o.exists && dev == o.dev && ino == o.ino; }
+    };
+
+    static FileIdentity file_identity(const std::string& path);
+
+    /**
+     * Outil read_only appelé avec if-none-match : compare le jeton DataVersion (lu avant les données)
+     * au jeton fourni ; égal → {"unchanged":true,"version"}, sinon exécute l'outil sans cette clé
+     * et enveloppe texte et structuredContent dans {"unchanged":false,"version","result"}.
+     */
+    int execute_conditional(const std::string& mcp_tool_name, const nlohmann::json& arguments,
+                            std::string& output, bool& is_error, nlohmann::json* structured);
+
+    /**
+     * Retourne la connexion persistante, (ré)ouverte si nécessaire : premier appel, connexion
+     * fermée par une commande (demo:generate), ou fichier remplacé/supprimé depuis l'ouverture.
+     * Retourne nullptr si l'ouverture échoue (stderr déjà écrit).
+     */
+    Database* acquire_database();
+
     /**
      * Convertit une valeur JSON en string pour argv.
      */
@@ -56,24 +130,13 @@ private:
      */
     std::vector<std::string> build_argv(const McpToolDefinition& tool, const nlohmann::json& arguments) const;
 
-    /**
-     * Capture stdout/stderr pendant l'exécution d'une commande.
-     */
-    class CaptureGuard {
-    public:
-        CaptureGuard();
-        ~CaptureGuard();
-        std::string get_out() const { return oss_out.str(); }
-        std::string get_err() const { return oss_err.str(); }
-    private:
-        std::ostringstream oss_out, oss_err;
-        std::streambuf* old_out;
-        std::streambuf* old_err;
-    };
-
     const McpToolRegistry& tool_registry_;
     const CommandRegistry& command_registry_;
+    McpToolHandlers handlers_;
     std::string db_path_;
+    std::unique_ptr<Database> db_;
+    FileIdentity db_identity_;
+    std::unique_ptr<Transaction> snapshot_;
 };
 
 } // namespace taskman
@@ -0,0 +1,527 @@
+/**
+ * Implémentation des handlers MCP typés.
+ */
+
+#include "mcp_tool_handlers.hpp"
+#include "core/context/context_formatter.hpp"
+#include "core/context/context_service.hpp"
+#include "core/milestone/milestone_repository.hpp"
+#include "core/milestone/milestone_service.hpp"
+#include "core/note/note_repository.hpp"
+#include "core/note/note_service.hpp"
+#include "core/phase/phase_repository.hpp"
+#include "core/phase/phase_service.hpp"
+#include "core/task/task_command_parser.hpp"
+#include "core/task/task_formatter.hpp"
+#include "core/task/task_repository.hpp"
+#include "core/task/task_service.hpp"
+#include "infrastructure/db/data_version.hpp"
+#include "infrastructure/db/db.hpp"
+#include "util/diagnostics.hpp"
+#include "util/formats.hpp"
+#include "util/roles.hpp"
+#include "util/table_writer.hpp"
+#include <exception>
+#include <optional>
+#include <sstream>
+#include <vector>
+
+namespace taskman {
+
+namespace {
+
+using json = nlohmann::json;
+
+/**
+ * Argument chaîne : mêmes conversions que le chemin CLI (nombre → décimal, bool → "0"/"1").
+ * Absent, null ou vide → nullopt (le chemin CLI n'émettait pas l'option).
+ */
+std::optional<std::string> arg_string(const json& args, const char* key) {
+    auto it = args.find(key);
+    if (it == args.end() || it->is_null()) return std::nullopt;
+    std::string s;
+    if (it->is_string()) s = it->get<std::string>();
+    else if (it->is_boolean()) s = it->get<bool>() ? "1" : "0";
+    else if (it->is_number_integer()) s = std::to_string(it->get<long long>());
+    else s = it->dump();
+    if (s.empty()) return std::nullopt;
+    return s;
+}
+
+/** Argument entier (entier JSON ou chaîne décimale). Retourne false si présent mais invalide. */
+bool arg_int(const json& args, const char* key, std::optional<int>& out) {
+    auto it = args.find(key);
+    if (it == args.end() || it->is_null()) return true;
+    if (it->is_number_integer()) {
+        out = it->get<int>();
+        return true;
+    }
+    auto s = arg_string(args, key);
+    if (!s) return true;
+    try {
+        size_t pos = 0;
+        int n = std::stoi(*s, &pos);
+        if (pos != s->size()) return false;
+        out = n;
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+/** Formats acceptés par les handlers typés : le texte reste sur le chemin CLI. */
+bool is_json_format(const json& args) {
+    auto f = arg_string(args, "format");
+    return !f || *f == "json";
+}
+
+/** Format texte demandé. */
+bool is_text_format(const json& args) {
+    auto f = arg_string(args, "format");
+    return f && *f == "text";
+}
+
+/** Format colonnaire demandé (équivalent de --format table). */
+bool is_columns_format(const json& args) {
+    auto f = arg_string(args, "format");
+    return f && *f == "columns";
+}
+
+/** Résultat colonnaire : texte seul, écrit par TableWriter (pas de DOM ni de structuredContent). */
+template <class ListInto>
+bool set_table_result(McpToolResult& result, ListInto list_into) {
+    std::ostringstream out;
+    TableWriter table(out);
+    if (!list_into(table)) return false;
+    table.finish();
+    result.text = out.str();
+    return true;
+}
+
+/** Résultat liste : texte = tableau (comme la CLI), structuredContent = {key: tableau}. */
+void set_list_result(McpToolResult& result, const char* key, json arr) {
+    result.text = arr.dump() + "\n";
+    result.structured = json::object();
+    result.structured[key] = std::move(arr);
+}
+
+/** Résultat objet : texte = objet (comme la CLI), structuredContent = objet. */
+void set_object_result(McpToolResult& result, json obj) {
+    result.text = obj.dump() + "\n";
+    result.structured = std::move(obj);
+}
+
+bool handle_phase_list(Database& db, const json& args, McpToolResult& result) {
+    PhaseRepository repository(db.get_executor());
+    PhaseService service(repository);
+    if (is_columns_format(args)) {
+        return set_table_result(result, [&](TableWriter& table) { return service.list_phases_into(table); });
+    }
+    json arr = json::array();
+    for (const auto& row : service.list_phases()) {
+        json obj;
+        phase_to_json(obj, row);
+        arr.push_back(std::move(obj));
+    }
+    set_list_result(result, "phases", std::move(arr));
+    return true;
+}
+
+bool handle_milestone_list(Database& db, const json& args, McpToolResult& result) {
+    MilestoneRepository repository(db.get_executor());
+    MilestoneService service(repository);
+    if (is_columns_format(args)) {
+        return set_table_result(result, [&](TableWriter& table) {
+            return service.list_milestones_into(arg_string(args, "phase"), table);
+        });
+    }
+    json arr = json::array();
+    for (const auto& row : service.list_milestones(arg_string(args, "phase"))) {
+        json obj;
+        milestone_to_json(obj, row);
+        arr.push_back(std::move(obj));
+    }
+    set_list_result(result, "milestones", std::move(arr));
+    return true;
+}
+
+bool handle_task_add(Database& db, const json& args, McpToolResult& result) {
+    auto title = arg_string(args, "title");
+    auto phase = arg_string(args, "phase");
+    if (!title) {
+        diag() << "taskman: --title is required\n";
+        return false;
+    }
+    if (!phase) {
+        diag() << "taskman: --phase is required\n";
+        return false;
+    }
+    std::optional<int> sort_order;
+    if (!arg_int(args, "sort-order", sort_order)) {
+        diag() << "taskman: --sort-order must be an integer\n";
+        return false;
+    }
+    TaskRepository repository(db.get_executor());
+    TaskService service(repository);
+    auto id = service.create_task(*phase, arg_string(args, "milestone"), *title,
+                                  arg_string(args, "description"), "to_do", sort_order,
+                                  arg_string(args, "role"), arg_string(args, "creator"));
+    if (!id) return false;
+    auto task = service.get_task(*id);
+    if (task.empty()) {
+        diag() << "taskman: failed to read created task\n";
+        return false;
+    }
+    json obj;
+    task_to_json(obj, task);
+    set_object_result(result, std::move(obj));
+    return true;
+}
+
+bool handle_task_get(Database& db, const json& args, McpToolResult& result) {
+    auto id = arg_string(args, "id");
+    if (!id) {
+        diag() << "taskman: task id is required\n";
+        return false;
+    }
+    TaskRepository repository(db.get_executor());
+    TaskService service(repository);
+    auto task = service.get_task(*id);
+    if (task.empty()) {
+        diag() << "taskman: task not found: " << *id << "\n";
+        return false;
+    }
+    json obj;
+    task_to_json(obj, task);
+    set_object_result(result, std::move(obj));
+    return true;
+}
+
+bool handle_task_list(Database& db, const json& args, McpToolResult& result) {
+    auto status = arg_string(args, "status");
+    auto blocked_filter = arg_string(args, "blocked-filter");
+    if (status && !TaskService::is_valid_status(*status)) {
+        diag() << "taskman: --status must be one of: to_do, in_progress, done\n";
+        return false;
+    }
+    if (blocked_filter && *blocked_filter != "blocked" && *blocked_filter != "unblocked") {
+        diag() << "taskman: --blocked-filter must be blocked or unblocked\n";
+        return false;
+    }
+    auto summary = args.find("summary");
+    TaskProjection projection;
+    if (!TaskService::make_projection(arg_string(args, "fields"),
+                                      summary != args.end() && summary->is_boolean() && summary->get<bool>(),
+                                      projection)) {
+        return false;
+    }
+    TaskRepository repository(db.get_executor());
+    TaskService service(repository);
+    // Pagination par curseur : {"tasks": […], "nextCursor": …} (ou table avec nextCursor)
+    if (args.contains("limit") || args.contains("cursor")) {
+        std::optional<int> limit;
+        if (!arg_int(args, "limit", limit)) {
+            diag() << "taskman: --limit must be an integer\n";
+            return false;
+        }
+        auto cursor = arg_string(args, "cursor");
+        std::optional<std::string> next_cursor;
+        if (is_columns_format(args)) {
+            std::ostringstream out;
+            TableWriter table(out);
+            if (!service.list_tasks_page_into(arg_string(args, "phase"), status, arg_string(args, "role"),
+                                              blocked_filter, projection, cursor,
+                                              limit.value_or(TaskService::DEFAULT_PAGE_LIMIT), table, next_cursor)) {
+                return false;
+            }
+            table.finish(next_cursor);
+            result.text = out.str();
+            return true;
+        }
+        std::vector<Row> tasks;
+        if (!service.list_tasks_page(arg_string(args, "phase"), status, arg_string(args, "role"), blocked_filter,
+                                     projection, cursor, limit.value_or(TaskService::DEFAULT_PAGE_LIMIT),
+                                     tasks, next_cursor)) {
+            return false;
+        }
+        set_object_result(result, TaskFormatter::page_to_json(tasks, next_cursor, projection.fields));
+        return true;
+    }
+    if (is_columns_format(args)) {
+        return set_table_result(result, [&](TableWriter& table) {
+            return service.list_tasks_into(arg_string(args, "phase"), status, arg_string(args, "role"),
+                                           blocked_filter, projection, table);
+        });
+    }
+    json arr = json::array();
+    for (const auto& row : service.list_tasks(arg_string(args, "phase"), status,
+                                              arg_string(args, "role"), blocked_filter, projection)) {
+        json obj;
+        if (projection.fields.empty()) task_to_json(obj, row);
+        else task_to_json(obj, row, projection.fields);
+        arr.push_back(std::move(obj));
+    }
+    set_list_result(result, "tasks", std::move(arr));
+    return true;
+}
+
+bool handle_task_edit(Database& db, const json& args, McpToolResult& result) {
+    auto id = arg_string(args, "id");
+    if (!id) {
+        diag() << "taskman: task id is required\n";
+        return false;
+    }
+    std::optional<int> sort_order;
+    if (!arg_int(args, "sort-order", sort_order)) {
+        diag() << "taskman: --sort-order must be an integer\n";
+        return false;
+    }
+    auto status = arg_string(args, "status");
+    bool to_done = status && *status == "done";
+    std::vector<Row> unblocked;
+    TaskRepository repository(db.get_executor());
+    TaskService service(repository);
+    if (!service.update_task(*id, arg_string(args, "title"), arg_string(args, "description"), status,
+                             arg_string(args, "role"), arg_string(args, "milestone"), sort_order,
+                             arg_string(args, "creator"), to_done ? &unblocked : nullptr)) {
+        return false;
+    }
+    if (!to_done) return true;  // comme task:edit : pas de sortie hors passage à done
+    set_object_result(result, TaskFormatter::unblocked_to_json(*id, unblocked));
+    return true;
+}
+
+/** Arguments communs de task_dep_add / task_dep_remove. */
+bool dep_ids(const json& args, const char* command, std::string& task_id, std::string& dep_id) {
+    auto t = arg_string(args, "task-id");
+    auto d = arg_string(args, "dep-id");
+    if (!t || !d) {
+        diag() << "taskman: " << command << " requires <task-id> and <dep-id>\n";
+        return false;
+    }
+    task_id = *t;
+    dep_id = *d;
+    return true;
+}
+
+bool handle_task_dep_add(Database& db, const json& args, McpToolResult&) {
+    std::string task_id, dep_id;
+    if (!dep_ids(args, "task:dep:add", task_id, dep_id)) return false;
+    TaskRepository repository(db.get_executor());
+    TaskService service(repository);
+    return service.add_task_dependency(task_id, dep_id);
+}
+
+bool handle_task_dep_remove(Database& db, const json& args, McpToolResult&) {
+    std::string task_id, dep_id;
+    if (!dep_ids(args, "task:dep:remove", task_id, dep_id)) return false;
+    TaskRepository repository(db.get_executor());
+    TaskService service(repository);
+    return service.remove_task_dependency(task_id, dep_id);
+}
+
+/** Tableau tasks des outils de lot (la taille est vérifiée par le service). */
+const json* bulk_tasks(const json& args) {
+    auto it = args.find("tasks");
+    if (it == args.end() || !it->is_array()) {
+        diag() << "taskman: tasks must be a JSON array\n";
+        return nullptr;
+    }
+    return &*it;
+}
+
+bool handle_task_bulk_add(Database& db, const json& args, McpToolResult& result) {
+    const json* tasks = bulk_tasks(args);
+    std::vector<TaskBulkAddItem> items;
+    if (!tasks || !TaskCommandParser::bulk_add_items(*tasks, items)) return false;
+    std::vector<std::string> ids;
+    TaskRepository repository(db.get_executor());
+    TaskService service(repository);
+    if (!service.bulk_add(items, ids)) return false;
+    set_object_result(result, TaskFormatter::bulk_add_to_json(items, ids));
+    return true;
+}
+
+bool handle_task_bulk_edit(Database& db, const json& args, McpToolResult& result) {
+    const json* tasks = bulk_tasks(args);
+    std::vector<TaskChanges> changes;
+    if (!tasks || !TaskCommandParser::bulk_edit_items(*tasks, changes)) return false;
+    std::vector<Row> unblocked;
+    TaskRepository repository(db.get_executor());
+    TaskService service(repository);
+    if (!service.bulk_edit(changes, unblocked)) return false;
+    set_object_result(result, TaskFormatter::bulk_edit_to_json(static_cast<int>(changes.size()), unblocked));
+    return true;
+}
+
+bool handle_note_add(Database& db, const json& args, McpToolResult& result) {
+    auto task_id = arg_string(args, "task-id");
+    auto content = arg_string(args, "content");
+    if (!task_id) {
+        diag() << "taskman: task:note:add requires <task-id>\n";
+        return false;
+    }
+    if (!content) {
+        diag() << "taskman: --content is required\n";
+        return false;
+    }
+    auto role = arg_string(args, "role");
+    if (role && !is_valid_role(*role)) {
+        diag() << get_roles_error_message();
+        return false;
+    }
+    NoteRepository repository(db.get_executor());
+    NoteService service(repository);
+    auto id = service.create_note(*task_id, *content, arg_string(args, "kind"), role);
+    if (!id) return false;
+    auto note = service.get_note(*id);
+    if (note.empty()) {
+        diag() << "taskman: failed to read created note\n";
+        return false;
+    }
+    json obj;
+    note_to_json(obj, note);
+    set_object_result(result, std::move(obj));
+    return true;
+}
+
+/** Notes → résultat liste {"notes": [...]}. */
+void set_notes_result(McpToolResult& result, const std::vector<Row>& notes) {
+    json arr = json::array();
+    for (const auto& row : notes) {
+        json obj;
+        note_to_json(obj, row);
+        arr.push_back(std::move(obj));
+    }
+    set_list_result(result, "notes", std::move(arr));
+}
+
+bool handle_note_list(Database& db, const json& args, McpToolResult& result) {
+    auto task_id = arg_string(args, "task-id");
+    if (!task_id) {
+        diag() << "taskman: task:note:list requires <task-id>\n";
+        return false;
+    }
+    NoteRepository repository(db.get_executor());
+    NoteService service(repository);
+    set_notes_result(result, service.list_notes(*task_id));
+    return true;
+}
+
+bool handle_note_list_by_ids(Database& db, const json& args, McpToolResult& result) {
+    auto ids_str = arg_string(args, "ids");
+    if (!ids_str) {
+        diag() << "taskman: task:note:list-by-ids requires --ids <id1,id2,...>\n";
+        return false;
+    }
+    std::vector<std::string> ids;
+    std::stringstream ss(*ids_str);
+    std::string id;
+    while (std::getline(ss, id, ',')) {
+        auto start = id.find_first_not_of(" \t");
+        if (start == std::string::npos) continue;
+        auto end = id.find_last_not_of(" \t");
+        ids.push_back(id.substr(start, end - start + 1));
+    }
+    NoteRepository repository(db.get_executor());
+    NoteService service(repository);
+    set_notes_result(result, service.list_notes_by_ids(ids));
+    return true;
+}
+
+bool handle_task_wait(Database& db, const json& args, McpToolResult& result) {
+    std::optional<int> limit, timeout;
+    if (!arg_int(args, "limit", limit)) {
+        diag() << "taskman: --limit must be an integer\n";
+        return false;
+    }
+    if (!arg_int(args, "timeout", timeout)) {
+        diag() << "taskman: --timeout must be an integer\n";
+        return false;
+    }
+    int seconds = timeout.value_or(TaskService::DEFAULT_WAIT_TIMEOUT);
+    if (seconds < 0 || seconds > TaskService::MAX_WAIT_TIMEOUT) {
+        diag() << "taskman: --timeout must be between 0 and " << TaskService::MAX_WAIT_TIMEOUT << "\n";
+        return false;
+    }
+    TaskRepository repository(db.get_executor());
+    TaskService service(repository);
+    DataVersion data_version(db.get_executor());
+    std::vector<Row> tasks;
+    bool timed_out = false;
+    if (!service.wait_ready(data_version, arg_string(args, "phase"), arg_string(args, "role"), limit.value_or(1),
+                            seconds * 1000, tasks, timed_out)) {
+        return false;
+    }
+    if (is_text_format(args)) {
+        std::ostringstream out;
+        TaskFormatter::format_text_wait(tasks, timed_out, out, TaskService::summary_fields());
+        result.text = out.str();
+        return true;
+    }
+    set_object_result(result, TaskFormatter::wait_to_json(tasks, timed_out, TaskService::summary_fields()));
+    return true;
+}
+
+bool handle_context(Database& db, const json& args, McpToolResult& result) {
+    std::optional<int> limit;
+    if (!arg_int(args, "limit", limit)) {
+        diag() << "taskman: --limit must be an integer\n";
+        return false;
+    }
+    ContextService service(db.get_executor());
+    ProjectContext context;
+    if (!service.load(arg_string(args, "role"), limit.value_or(ContextService::DEFAULT_LIMIT), context)) {
+        return false;
+    }
+    set_object_result(result, ContextFormatter::to_json(context));
+    return true;
+}
+
+} // namespace
+
+McpToolHandlers::McpToolHandlers() {
+    handlers_["taskman_phase_list"] = &handle_phase_list;
+    handlers_["taskman_milestone_list"] = &handle_milestone_list;
+    handlers_["taskman_task_add"] = &handle_task_add;
+    handlers_["taskman_task_get"] = &handle_task_get;
+    handlers_["taskman_task_list"] = &handle_task_list;
+    handlers_["taskman_task_edit"] = &handle_task_edit;
+    handlers_["taskman_task_dep_add"] = &handle_task_dep_add;
+    handlers_["taskman_task_dep_remove"] = &handle_task_dep_remove;
+    handlers_["taskman_task_bulk_add"] = &handle_task_bulk_add;
+    handlers_["taskman_task_bulk_edit"] = &handle_task_bulk_edit;
+    handlers_["taskman_task_note_add"] = &handle_note_add;
+    handlers_["taskman_task_note_list"] = &handle_note_list;
+    handlers_["taskman_task_note_list_by_ids"] = &handle_note_list_by_ids;
+    handlers_["taskman_task_wait"] = &handle_task_wait;
+    handlers_["taskman_context"] = &handle_context;
+    columns_handlers_ = {"taskman_phase_list", "taskman_milestone_list", "taskman_task_list"};
+    text_handlers_ = {"taskman_task_wait"};
+}
+
+bool McpToolHandlers::handles(const std::string& mcp_tool_name, const nlohmann::json& arguments) const {
+    if (handlers_.count(mcp_tool_name) == 0) return false;
+    return is_json_format(arguments) || (is_columns_format(arguments) && columns_handlers_.count(mcp_tool_name) != 0)
+        || (is_text_format(arguments) && text_handlers_.count(mcp_tool_name) != 0);
+}
+
+McpToolResult McpToolHandlers::call(const std::string& mcp_tool_name, Database& db,
+                                    const nlohmann::json& arguments) const {
+    McpToolResult result;
+    DiagnosticCapture capture;
+    bool ok = false;
+    try {
+        ok = handlers_.at(mcp_tool_name)(db, arguments, result);
+    } catch (const std::exception& e) {
+        diag() << "taskman: " << e.what() << "\n";
+    }
+    if (!ok) {
+        result.is_error = true;
+        result.text = capture.str();
+        result.structured = nullptr;
+    }
+    return result;
+}
+
+} // namespace taskman
@@ -0,0 +1,62 @@
+/**
+ * Handlers MCP typés.
+ * Responsabilité unique : exécuter les outils MCP courants en appelant directement les services,
+ * avec des arguments JSON typés, et retourner un résultat JSON (MCP structuredContent).
+ * Pas de reconstruction d'argv ni de capture de std::cout/std::cerr : les diagnostics des
+ * services sont capturés par thread (DiagnosticCapture). Les outils de liste acceptent aussi
+ * format "columns" (TableWriter, sans structuredContent). Les autres outils, et les autres
+ * formats, restent sur le chemin CLI de McpToolExecutor.
+ */
+
+#ifndef TASKMAN_MCP_TOOL_HANDLERS_HPP
+#define TASKMAN_MCP_TOOL_HANDLERS_HPP
+
+#include <nlohmann/json.hpp>
+#include <map>
+#include <set>
+#include <string>
+
+namespace taskman {
+
+class Database;
+
+/** Résultat d'un handler typé. */
+struct McpToolResult {
+    bool is_error = false;
+    /** Contenu texte : JSON identique à la sortie de la commande CLI, ou diagnostics en cas d'erreur. */
+    std::string text;
+    /** structuredContent (objet JSON), null si l'outil ne retourne rien (ex. task_dep_add). */
+    nlohmann::json structured;
+};
+
+class McpToolHandlers {
+public:
+    McpToolHandlers();
+
+    McpToolHandlers(const McpToolHandlers&) = delete;
+    McpToolHandlers& operator=(const McpToolHandlers&) = delete;
+
+    /** Vrai si l'outil a un handler typé pour ces arguments (format absent ou "json" ;
+     * "columns" pour phase_list, milestone_list et task_list ; "text" pour task_wait). */
+    bool handles(const std::string& mcp_tool_name, const nlohmann::json& arguments) const;
+
+    /**
+     * Exécute le handler typé de l'outil (handles() doit être vrai).
+     * Les diagnostics écrits par les services pendant l'appel deviennent le texte d'erreur.
+     */
+    McpToolResult call(const std::string& mcp_tool_name, Database& db, const nlohmann::json& arguments) const;
+
+private:
+    /** Handler : remplit result et retourne false en cas d'erreur (diagnostic déjà écrit sur diag()). */
+    using Handler = bool (*)(Database& db, const nlohmann::json& arguments, McpToolResult& result);
+
+    std::map<std::string, Handler> handlers_;
+    /** Outils dont le handler produit aussi le format "columns". */
+    std::set<std::string> columns_handlers_;
+    /** Outils dont le handler produit aussi le format "text" (jamais par la capture de std::cout). */
+    std::set<std::string> text_handlers_;
+};
+
+} // namespace taskman
+
+#endif /* TASKMAN_MCP_TOOL_HANDLERS_HPP */
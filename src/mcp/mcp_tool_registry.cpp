@@ -3,6 +3,8 @@
  */
 
 #include "mcp_tool_registry.hpp"
+#include "cli/conditional_read.hpp"
+#include "core/task/task_service.hpp"
 #include "util/roles.hpp"
 #include <algorithm>
 
@@ -82,8 +84,11 @@ void McpToolRegistry::initialize_tools() {
         McpToolDefinition t;
         t.name = "taskman_phase_list";
         t.cli_command = "phase:list";
+        t.read_only = true;
         t.description = "List all phases in JSON format.";
-        t.inputSchema = make_schema({});
+        std::map<std::string, nlohmann::json> props;
+        props["format"] = nlohmann::json{{"type", "string"}, {"enum", nlohmann::json::array({"json", "columns"})}, {"description", "columns: compact table {columns, rows, dicts}; status/role/creator cells are indexes into dicts"}};
+        t.inputSchema = make_schema(props);
         t.inputSchema["additionalProperties"] = false;
         t.positional_keys = {};
         tools_.push_back(t);
@@ -131,9 +136,11 @@ void McpToolRegistry::initialize_tools() {
         McpToolDefinition t;
         t.name = "taskman_milestone_list";
         t.cli_command = "milestone:list";
+        t.read_only = true;
         t.description = "List milestones, optionally filtered by phase.";
         std::map<std::string, nlohmann::json> props;
         props["phase"] = nlohmann::json{{"type", "string"}, {"description", "Filter by phase ID"}};
+        props["format"] = nlohmann::json{{"type", "string"}, {"enum", nlohmann::json::array({"json", "columns"})}, {"description", "columns: compact table {columns, rows, dicts}; status/role/creator cells are indexes into dicts"}};
         t.inputSchema = make_schema(props);
         t.positional_keys = {};
         tools_.push_back(t);
@@ -166,6 +173,7 @@ void McpToolRegistry::initialize_tools() {
         McpToolDefinition t;
         t.name = "taskman_task_get";
         t.cli_command = "task:get";
+        t.read_only = true;
         t.description = "Get a task by ID in JSON or text format.";
         std::map<std::string, nlohmann::json> props;
         props["id"] = nlohmann::json{{"type", "string"}, {"description", "Task UUID"}};
@@ -181,19 +189,44 @@ void McpToolRegistry::initialize_tools() {
         McpToolDefinition t;
         t.name = "taskman_task_list";
         t.cli_command = "task:list";
-        t.description = "List tasks, optionally filtered by phase, status, role, or blocked state.";
+        t.read_only = true;
+        t.description = "List tasks, optionally filtered by phase, status, role, or blocked state. With limit/cursor, returns one page and nextCursor (null on the last page).";
         std::map<std::string, nlohmann::json> props;
         props["phase"] = nlohmann::json{{"type", "string"}};
         props["status"] = nlohmann::json{{"type", "string"}, {"enum", nlohmann::json::array({"to_do", "in_progress", "done"})}};
         props["role"] = nlohmann::json{{"type", "string"}, {"enum", get_roles_json_array()}};
         props["blocked-filter"] = nlohmann::json{{"type", "string"}, {"enum", nlohmann::json::array({"blocked", "unblocked"})}, {"description", "Filter by blocked state: blocked = only tasks blocked by a non-done dependency, unblocked = only non-blocked tasks"}};
-        props["format"] = nlohmann::json{{"type", "string"}, {"enum", nlohmann::json::array({"json", "text"})}};
+        props["fields"] = nlohmann::json{{"type", "string"}, {"description", "Comma-separated fields to return, e.g. id,title,status,role (among id, phase_id, milestone_id, title, description, status, sort_order, role, creator, created_at, updated_at). Unselected columns are not read."}};
+        props["summary"] = nlohmann::json{{"type", "boolean"}, {"description", "Summary preset: id, phase_id, milestone_id, title, status, role and description truncated to 120 characters (combined with fields: only truncates description)"}};
+        props["limit"] = nlohmann::json{{"type", "integer"}, {"minimum", 1}, {"maximum", 1000}, {"description", "Page size; the result becomes {tasks, nextCursor}"}};
+        props["cursor"] = nlohmann::json{{"type", "string"}, {"description", "nextCursor of the previous page (opaque)"}};
+        props["format"] = nlohmann::json{{"type", "string"}, {"enum", nlohmann::json::array({"json", "text", "columns"})}, {"description", "columns: compact table {columns, rows, dicts}; status/role/creator cells are indexes into dicts"}};
         t.inputSchema = make_schema(props);
         t.positional_keys = {};
         tools_.push_back(t);
         name_to_index_[t.name] = tools_.size() - 1;
     }
 
+    // taskman_task_wait → task:wait
+    {
+        McpToolDefinition t;
+        t.name = "taskman_task_wait";
+        t.cli_command = "task:wait";
+        t.blocking = true;
+        t.description = "Wait until at least one task is ready (to_do and not blocked by a non-done dependency) for the given role/phase, or until timeout. Returns {tasks, timed_out}. Use it instead of polling taskman_task_list: the database is only re-queried after a write.";
+        std::map<std::string, nlohmann::json> props;
+        props["phase"] = nlohmann::json{{"type", "string"}};
+        props["role"] = nlohmann::json{{"type", "string"}, {"enum", get_roles_json_array()}};
+        props["limit"] = nlohmann::json{{"type", "integer"}, {"minimum", 1}, {"maximum", 1000}, {"description", "Maximum number of ready tasks returned (default 1)"}};
+        props["timeout"] = nlohmann::json{{"type", "integer"}, {"minimum", 0}, {"maximum", 600}, {"description", "Maximum wait in seconds (default 30; 0 = check once)"}};
+        props["format"] = nlohmann::json{{"type", "string"}, {"enum", nlohmann::json::array({"json", "text"})}, {"default", "json"}};
+        t.inputSchema = make_schema(props);
+        t.inputSchema["additionalProperties"] = false;
+        t.positional_keys = {};
+        tools_.push_back(t);
+        name_to_index_[t.name] = tools_.size() - 1;
+    }
+
     // taskman_task_edit → task:edit
     {
         McpToolDefinition t;
@@ -245,6 +278,90 @@ void McpToolRegistry::initialize_tools() {
         name_to_index_[t.name] = tools_.size() - 1;
     }
 
+    // taskman_task_dep_batch → task:dep:batch
+    {
+        McpToolDefinition t;
+        t.name = "taskman_task_dep_batch";
+        t.cli_command = "task:dep:batch";
+        t.description = "Add and/or remove several task dependencies in one call. Existence and cycle checks run over the whole batch; edges are applied in one transaction (all or nothing). Returns {added, removed}.";
+        nlohmann::json edge = {
+            {"type", "object"},
+            {"properties", {
+                {"op", {{"type", "string"}, {"enum", nlohmann::json::array({"add", "remove"})}, {"description", "add (default) or remove"}}},
+                {"task-id", {{"type", "string"}, {"description", "Task that depends on another"}}},
+                {"dep-id", {{"type", "string"}, {"description", "Task that must be completed first"}}}
+            }},
+            {"required", nlohmann::json::array({"task-id", "dep-id"})}
+        };
+        std::map<std::string, nlohmann::json> props;
+        props["edges"] = nlohmann::json{{"type", "array"}, {"items", edge}, {"minItems", 1}, {"description", "Edges to add/remove, applied in order"}};
+        t.inputSchema = make_schema(props, {"edges"});
+        t.positional_keys = {};
+        tools_.push_back(t);
+        name_to_index_[t.name] = tools_.size() - 1;
+    }
+
+    // taskman_task_bulk_add → task:bulk-add
+    {
+        McpToolDefinition t;
+        t.name = "taskman_task_bulk_add";
+        t.cli_command = "task:bulk-add";
+        t.description = "Create several tasks (status to_do) and their dependencies in one call. The whole batch is validated first, then applied in one transaction (all or nothing). deps cite the key of another task of the batch or the ID of an existing task. Returns {ids, keys}: created IDs in input order and key → ID.";
+        nlohmann::json task = {
+            {"type", "object"},
+            {"properties", {
+                {"key", {{"type", "string"}, {"description", "Temporary key, unique within the batch, used by deps"}}},
+                {"title", {{"type", "string"}}},
+                {"phase", {{"type", "string"}, {"description", "Phase ID"}}},
+                {"description", {{"type", "string"}}},
+                {"role", {{"type", "string"}, {"enum", get_roles_json_array()}}},
+                {"creator", {{"type", "string"}, {"enum", get_roles_json_array()}, {"description", "Creator role (who created the task)"}}},
+                {"milestone", {{"type", "string"}}},
+                {"sort-order", {{"type", nlohmann::json::array({"string", "integer"})}}},
+                {"deps", {{"type", "array"}, {"items", {{"type", "string"}}}, {"description", "Tasks that must be completed first: batch keys or existing task IDs"}}}
+            }},
+            {"required", nlohmann::json::array({"title", "phase"})},
+            {"additionalProperties", false}
+        };
+        std::map<std::string, nlohmann::json> props;
+        props["tasks"] = nlohmann::json{{"type", "array"}, {"items", task}, {"minItems", 1}, {"maxItems", TaskService::MAX_BULK_ITEMS}, {"description", "Tasks to create, in order"}};
+        props["format"] = nlohmann::json{{"type", "string"}, {"enum", nlohmann::json::array({"json", "text"})}, {"default", "json"}};
+        t.inputSchema = make_schema(props, {"tasks"});
+        t.positional_keys = {};
+        tools_.push_back(t);
+        name_to_index_[t.name] = tools_.size() - 1;
+    }
+
+    // taskman_task_bulk_edit → task:bulk-edit
+    {
+        McpToolDefinition t;
+        t.name = "taskman_task_bulk_edit";
+        t.cli_command = "task:bulk-edit";
+        t.description = "Edit several tasks in one call. The whole batch is validated first, then applied in one transaction (all or nothing). Returns {updated, unblocked}: unblocked lists the tasks that became ready because an edited task moved to done.";
+        nlohmann::json task = {
+            {"type", "object"},
+            {"properties", {
+                {"id", {{"type", "string"}, {"description", "Task UUID to edit"}}},
+                {"title", {{"type", "string"}}},
+                {"description", {{"type", "string"}}},
+                {"status", {{"type", "string"}, {"enum", nlohmann::json::array({"to_do", "in_progress", "done"})}}},
+                {"role", {{"type", "string"}, {"enum", get_roles_json_array()}}},
+                {"creator", {{"type", "string"}, {"enum", get_roles_json_array()}, {"description", "Creator role (who created the task)"}}},
+                {"milestone", {{"type", "string"}}},
+                {"sort-order", {{"type", nlohmann::json::array({"string", "integer"})}}}
+            }},
+            {"required", nlohmann::json::array({"id"})},
+            {"additionalProperties", false}
+        };
+        std::map<std::string, nlohmann::json> props;
+        props["tasks"] = nlohmann::json{{"type", "array"}, {"items", task}, {"minItems", 1}, {"maxItems", TaskService::MAX_BULK_ITEMS}, {"description", "Changes to apply; each task appears at most once"}};
+        props["format"] = nlohmann::json{{"type", "string"}, {"enum", nlohmann::json::array({"json", "text"})}, {"default", "json"}};
+        t.inputSchema = make_schema(props, {"tasks"});
+        t.positional_keys = {};
+        tools_.push_back(t);
+        name_to_index_[t.name] = tools_.size() - 1;
+    }
+
     // taskman_task_note_add → task:note:add
     {
         McpToolDefinition t;
@@ -268,6 +385,7 @@ void McpToolRegistry::initialize_tools() {
         McpToolDefinition t;
         t.name = "taskman_task_note_list";
         t.cli_command = "task:note:list";
+        t.read_only = true;
         t.description = "List notes for a task.";
         std::map<std::string, nlohmann::json> props;
         props["task-id"] = nlohmann::json{{"type", "string"}, {"description", "Task ID"}};
@@ -283,6 +401,7 @@ void McpToolRegistry::initialize_tools() {
         McpToolDefinition t;
         t.name = "taskman_task_note_list_by_ids";
         t.cli_command = "task:note:list-by-ids";
+        t.read_only = true;
         t.description = "List notes by a comma-separated list of note IDs (e.g. from task:get note_ids).";
         std::map<std::string, nlohmann::json> props;
         props["ids"] = nlohmann::json{{"type", "string"}, {"description", "Comma-separated note IDs"}};
@@ -293,6 +412,24 @@ void McpToolRegistry::initialize_tools() {
         name_to_index_[t.name] = tools_.size() - 1;
     }
 
+    // taskman_context → context
+    {
+        McpToolDefinition t;
+        t.name = "taskman_context";
+        t.cli_command = "context";
+        t.read_only = true;
+        t.description = "Project context in one call, to start a session: phases with milestones and progress counts, ready tasks (to_do, unblocked), in-progress tasks with their latest note, and blocked tasks with their open dependencies. Each task section is capped by limit; totals tell when it was truncated.";
+        std::map<std::string, nlohmann::json> props;
+        props["role"] = nlohmann::json{{"type", "string"}, {"enum", get_roles_json_array()}, {"description", "Only tasks of this role (phases and progress stay global)"}};
+        props["limit"] = nlohmann::json{{"type", "integer"}, {"minimum", 1}, {"maximum", 100}, {"description", "Tasks per section (default 10)"}};
+        props["format"] = nlohmann::json{{"type", "string"}, {"enum", nlohmann::json::array({"json", "text"})}, {"default", "json"}};
+        t.inputSchema = make_schema(props);
+        t.inputSchema["additionalProperties"] = false;
+        t.positional_keys = {};
+        tools_.push_back(t);
+        name_to_index_[t.name] = tools_.size() - 1;
+    }
+
     // taskman_demo_generate → demo:generate
     {
         McpToolDefinition t;
@@ -347,6 +484,24 @@ void McpToolRegistry::initialize_tools() {
         tools_.push_back(t);
         name_to_index_[t.name] = tools_.size() - 1;
     }
+
+    // taskman_server_stats → métriques du serveur (pas de commande CLI, traité par McpDispatcher)
+    {
+        McpToolDefinition t;
+        t.name = "taskman_server_stats";
+        t.description = "Per-tool metrics of this MCP server since it started: calls, errors, latency (mean, p50, p95, p99, max in ms) and request/response bytes, most called tools first. Use it to find the tools worth batching or narrowing.";
+        t.inputSchema = make_schema({});
+        t.inputSchema["additionalProperties"] = false;
+        t.positional_keys = {};
+        tools_.push_back(t);
+        name_to_index_[t.name] = tools_.size() - 1;
+    }
+
+    // Lecture conditionnelle : commune à tous les outils en lecture seule
+    for (auto& t : tools_) {
+        if (!t.read_only) continue;
+        t.inputSchema["properties"][IF_NONE_MATCH_KEY] = nlohmann::json{{"type", "string"}, {"description", "version of a previous result: if nothing changed since, returns only {unchanged: true, version}; otherwise {unchanged: false, version, result}. Pass \"\" on the first call to get a version."}};
+    }
 }
 
 std::vector<nlohmann::json> McpToolRegistry::list_tools_json() const {
@@ -361,6 +516,12 @@ std::vector<nlohmann::json> McpToolRegistry::list_tools_json() const {
     return result;
 }
 
+std::string McpToolRegistry::tools_list_result_json() const {
+    nlohmann::json result;
+    result["tools"] = list_tools_json();
+    return result.dump();
+}
+
 const McpToolDefinition* McpToolRegistry::get_tool(const std::string& mcp_name) const {
     auto it = name_to_index_.find(mcp_name);
     if (it == name_to_index_.end()) {
@@ -369,6 +530,16 @@ const McpToolDefinition* McpToolRegistry::get_tool(const std::string& mcp_name)
     return &tools_[it->second];
 }
 
+bool McpToolRegistry::is_read_only(const std::string& mcp_name) const {
+    const McpToolDefinition* tool = get_tool(mcp_name);
+    return tool && tool->read_only;
+}
+
+bool McpToolRegistry::is_blocking(const std::string& mcp_name) const {
+    const McpToolDefinition* tool = get_tool(mcp_name);
+    return tool && tool->blocking;
+}
+
 std::string McpToolRegistry::get_cli_command(const std::string& mcp_name) const {
     const McpToolDefinition* tool = get_tool(mcp_name);
     return tool ? tool->cli_command : "";
@@ -23,6 +23,8 @@ struct McpToolDefinition {
     std::string description;             // Description de l'outil
     nlohmann::json inputSchema;          // Schéma JSON pour les arguments
     std::vector<std::string> positional_keys;  // Clés qui doivent être passées comme arguments positionnels
+    bool read_only = false;              // Lecture seule (peut partager un snapshot dans un lot JSON-RPC)
+    bool blocking = false;               // Attente bloquante (task_wait) : hors de l'ordre des lectures/écritures
 };
 
 /**
@@ -39,6 +41,12 @@ public:
      */
     std::vector<nlohmann::json> list_tools_json() const;
 
+    /**
+     * Retourne le result de tools/list sérialisé : {"tools":[…]}.
+     * Calculé une fois par le serveur au démarrage (la liste ne change pas pendant la session).
+     */
+    std::string tools_list_result_json() const;
+
     /**
      * Retourne la définition d'un outil par son nom MCP.
      * @param mcp_name Nom de l'outil MCP (ex: "taskman_init")
@@ -46,6 +54,16 @@ public:
      */
     const McpToolDefinition* get_tool(const std::string& mcp_name) const;
 
+    /**
+     * Indique si l'outil est en lecture seule (false si inconnu).
+     */
+    bool is_read_only(const std::string& mcp_name) const;
+
+    /**
+     * Indique si l'outil attend un changement de la base (false si inconnu).
+     */
+    bool is_blocking(const std::string& mcp_name) const;
+
     /**
      * Retourne le nom de la commande CLI correspondant à un outil MCP.
      * @param mcp_name Nom de l'outil MCP
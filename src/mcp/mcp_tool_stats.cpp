@@ -0,0 +1,142 @@
+/**
+ * Implémentation de McpToolStats.
+ */
+
+#include "mcp_tool_stats.hpp"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace taskman {
+
+namespace {
+
+/** Latence maximale comptée dans l'histogramme (les suivantes vont dans le dernier intervalle). */
+constexpr uint64_t MAX_LATENCY_US = (uint64_t(1) << 40) - 1;
+
+double round3(double v) {
+    return std::round(v * 1000.0) / 1000.0;
+}
+
+} // namespace
+
+McpToolStats::McpToolStats() : started_(std::chrono::steady_clock::now()) {}
+
+McpToolStats::~McpToolStats() {
+    stop_dump();
+}
+
+size_t McpToolStats::bucket_of(uint64_t us) {
+    us = std::clamp<uint64_t>(us, 1, MAX_LATENCY_US);
+    size_t e = 0;
+    while ((us >> (e + 1)) != 0) ++e;
+    // Deux bits sous le bit de poids fort : quart de la puissance de 2
+    size_t sub = static_cast<size_t>(((us << 2) >> e) & 3);
+    return std::min(e * 4 + sub, BUCKETS - 1);
+}
+
+double McpToolStats::bucket_upper_us(size_t bucket) {
+    size_t e = bucket / 4;
+    size_t sub = bucket % 4;
+    return std::ldexp(1.0 + static_cast<double>(sub + 1) / 4.0, static_cast<int>(e));
+}
+
+void McpToolStats::record(const std::string& tool, std::chrono::steady_clock::duration latency,
+                          size_t request_bytes, size_t response_bytes, bool is_error) {
+    uint64_t us = static_cast<uint64_t>(
+        std::max<long long>(0, std::chrono::duration_cast<std::chrono::microseconds>(latency).count()));
+    size_t bucket = bucket_of(us);
+    std::lock_guard<std::mutex> lock(mutex_);
+    ToolCounters& c = tools_[tool];
+    ++c.calls;
+    if (is_error) ++c.errors;
+    c.total_us += us;
+    c.max_us = std::max(c.max_us, us);
+    c.request_bytes += request_bytes;
+    c.response_bytes += response_bytes;
+    ++c.histogram[bucket];
+}
+
+double McpToolStats::percentile_ms(const ToolCounters& counters, double q) {
+    uint64_t rank = static_cast<uint64_t>(std::ceil(q * static_cast<double>(counters.calls)));
+    rank = std::max<uint64_t>(rank, 1);
+    uint64_t seen = 0;
+    for (size_t b = 0; b < BUCKETS; ++b) {
+        seen += counters.histogram[b];
+        if (seen >= rank) {
+            return std::min(bucket_upper_us(b), static_cast<double>(counters.max_us)) / 1000.0;
+        }
+    }
+    return static_cast<double>(counters.max_us) / 1000.0;
+}
+
+nlohmann::json McpToolStats::to_json() const {
+    std::vector<std::pair<std::string, ToolCounters>> tools;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tools.assign(tools_.begin(), tools_.end());
+    }
+    std::stable_sort(tools.begin(), tools.end(),
+                     [](const auto& a, const auto& b) { return a.second.calls > b.second.calls; });
+
+    uint64_t calls = 0, errors = 0;
+    nlohmann::json items = nlohmann::json::array();
+    for (const auto& [name, c] : tools) {
+        calls += c.calls;
+        errors += c.errors;
+        double mean_us = static_cast<double>(c.total_us) / static_cast<double>(c.calls);
+        items.push_back({
+            {"name", name},
+            {"calls", c.calls},
+            {"errors", c.errors},
+            {"mean_ms", round3(mean_us / 1000.0)},
+            {"p50_ms", round3(percentile_ms(c, 0.50))},
+            {"p95_ms", round3(percentile_ms(c, 0.95))},
+            {"p99_ms", round3(percentile_ms(c, 0.99))},
+            {"max_ms", round3(static_cast<double>(c.max_us) / 1000.0)},
+            {"request_bytes", c.request_bytes},
+            {"response_bytes", c.response_bytes},
+            {"mean_response_bytes", c.response_bytes / c.calls},
+        });
+    }
+    double uptime = std::chrono::duration<double>(std::chrono::steady_clock::now() - started_).count();
+    return {{"uptime_s", round3(uptime)}, {"calls", calls}, {"errors", errors}, {"tools", std::move(items)}};
+}
+
+bool McpToolStats::write_file(const std::string& path) const {
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out << to_json().dump() << "\n";
+        if (!out) return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    return !ec;
+}
+
+void McpToolStats::start_dump(const std::string& path, unsigned interval_s) {
+    if (dump_thread_.joinable()) return;
+    interval_s = std::max(interval_s, 1u);
+    dump_thread_ = std::thread([this, path, interval_s] {
+        std::unique_lock<std::mutex> lock(dump_mutex_);
+        while (!dump_stop_) {
+            dump_cv_.wait_for(lock, std::chrono::seconds(interval_s), [this] { return dump_stop_; });
+            write_file(path);
+        }
+    });
+}
+
+void McpToolStats::stop_dump() {
+    {
+        std::lock_guard<std::mutex> lock(dump_mutex_);
+        dump_stop_ = true;
+    }
+    dump_cv_.notify_all();
+    if (dump_thread_.joinable()) dump_thread_.join();
+}
+
+} // namespace taskman
@@ -0,0 +1,104 @@
+/**
+ * Métriques des appels d'outils MCP.
+ * Responsabilité unique : compter, par outil, les appels, les erreurs, les octets reçus et
+ * envoyés, et l'histogramme des latences ; les exposer en JSON (outil taskman_server_stats)
+ * et, en option, dans un fichier réécrit périodiquement.
+ *
+ * Une instance est partagée par tous les exécuteurs d'un McpDispatcher (voie d'écriture,
+ * workers de lecture, attentes) : les enregistrements sont protégés par un mutex.
+ * Histogramme : 4 intervalles par puissance de 2 de microsecondes (résolution ≤ 25 %),
+ * les percentiles sont la borne haute de leur intervalle (au plus le maximum observé).
+ */
+
+#ifndef TASKMAN_MCP_TOOL_STATS_HPP
+#define TASKMAN_MCP_TOOL_STATS_HPP
+
+#include <nlohmann/json.hpp>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace taskman {
+
+class McpToolStats {
+public:
+    /** Nom de l'outil MCP qui retourne les métriques. */
+    static constexpr const char* TOOL_NAME = "taskman_server_stats";
+    /** Intervalles de l'histogramme : 4 par puissance de 2, de 1 µs à 2^40 µs. */
+    static constexpr size_t BUCKETS = 4 * 40;
+
+    McpToolStats();
+
+    /** Arrête l'écriture périodique (après une dernière écriture du fichier). */
+    ~McpToolStats();
+
+    McpToolStats(const McpToolStats&) = delete;
+    McpToolStats& operator=(const McpToolStats&) = delete;
+
+    /**
+     * Enregistre un appel d'outil.
+     * @param tool Nom de l'outil MCP
+     * @param latency Durée de l'appel (exécution et sérialisation de la réponse)
+     * @param request_bytes Taille des arguments JSON sérialisés
+     * @param response_bytes Taille de la réponse JSON-RPC sérialisée
+     * @param is_error Erreur métier (isError: true)
+     */
+    void record(const std::string& tool, std::chrono::steady_clock::duration latency,
+                size_t request_bytes, size_t response_bytes, bool is_error);
+
+    /**
+     * Métriques courantes : {uptime_s, calls, errors, tools: [{name, calls, errors, mean_ms,
+     * p50_ms, p95_ms, p99_ms, max_ms, request_bytes, response_bytes, mean_response_bytes}]},
+     * outils triés par nombre d'appels décroissant.
+     */
+    nlohmann::json to_json() const;
+
+    /**
+     * Réécrit path (fichier temporaire puis renommage) toutes les interval_s secondes, et une
+     * dernière fois à l'arrêt. Un seul fichier par instance ; un second appel est ignoré.
+     */
+    void start_dump(const std::string& path, unsigned interval_s);
+
+    /** Écrit to_json() dans path (via path + ".tmp"). Retourne false en cas d'échec d'écriture. */
+    bool write_file(const std::string& path) const;
+
+    /** Intervalle de l'histogramme d'une latence en microsecondes. */
+    static size_t bucket_of(uint64_t us);
+
+    /** Borne haute (exclue) de l'intervalle, en microsecondes. */
+    static double bucket_upper_us(size_t bucket);
+
+private:
+    struct ToolCounters {
+        uint64_t calls = 0;
+        uint64_t errors = 0;
+        uint64_t total_us = 0;
+        uint64_t max_us = 0;
+        uint64_t request_bytes = 0;
+        uint64_t response_bytes = 0;
+        std::array<uint64_t, BUCKETS> histogram{};
+    };
+
+    /** Percentile (0 < q < 1) des latences d'un outil, en millisecondes. */
+    static double percentile_ms(const ToolCounters& counters, double q);
+
+    void stop_dump();
+
+    const std::chrono::steady_clock::time_point started_;
+    mutable std::mutex mutex_;
+    std::map<std::string, ToolCounters> tools_;
+
+    std::mutex dump_mutex_;
+    std::condition_variable dump_cv_;
+    bool dump_stop_ = false;
+    std::thread dump_thread_;
+};
+
+} // namespace taskman
+
+#endif /* TASKMAN_MCP_TOOL_STATS_HPP */
@@ -3,6 +3,7 @@
  */
 
 #include "demo.hpp"
+#include "demo_scale.hpp"
 #include "infrastructure/db/db.hpp"
 #include "core/milestone/milestone.hpp"
 #include "core/note/note.hpp"
@@ -36,26 +37,60 @@ namespace taskman {
 int cmd_demo_generate(int argc, char* argv[], Database& db) {
     cxxopts::Options opts("taskman demo:generate", "Generate a demo database");
     opts.add_options()
+        ("scale", "Generate a large synthetic project instead of the e-commerce example")
+        ("phases", "Number of phases (with --scale)", cxxopts::value<int>())
+        ("milestones", "Milestones per phase (with --scale)", cxxopts::value<int>())
+        ("tasks", "Number of tasks (with --scale)", cxxopts::value<int>())
+        ("deps", "Average dependencies per task (with --scale)", cxxopts::value<double>())
+        ("notes", "Average notes per task (with --scale)", cxxopts::value<double>())
+        ("description-size", "Task description length in characters, 0 for none (with --scale)", cxxopts::value<int>())
+        ("seed", "Random seed: same seed and options, same database (with --scale)", cxxopts::value<uint64_t>())
         ("help", "Show help");
 
     for (int i = 0; i < argc; ++i) {
         if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0) {
-            std::cout << "taskman demo:generate\n\n"
+            std::cout << "taskman demo:generate [--scale [options]]\n\n"
                          "Create a database filled with a real-life example (e-commerce site MVP project).\n"
                          "The database path is determined by TASKMAN_DB_NAME environment variable\n"
                          "or defaults to 'project_tasks.db'.\n\n"
-                         "If the database already exists, it will be removed and recreated.\n\n";
+                         "If the database already exists, it will be removed and recreated.\n\n"
+                         "With --scale, generate a large synthetic project for benchmarks instead\n"
+                         "(defaults: 10 phases, 4 milestones per phase, 100000 tasks, 1.5 deps and\n"
+                         "1 note per task, 300-character descriptions, seed 1):\n\n"
+                      << opts.help() << "\n";
             return 0;
         }
     }
 
+    cxxopts::ParseResult result;
     try {
-        opts.parse(argc, argv);
+        result = opts.parse(argc, argv);
     } catch (const cxxopts::exceptions::exception& e) {
         std::cerr << "taskman: " << e.what() << "\n";
         return 1;
     }
 
+    const bool scaled = result.count("scale") > 0;
+    DemoScale scale;
+    for (const char* name : {"phases", "milestones", "tasks", "deps", "notes", "description-size", "seed"}) {
+        if (result.count(name) && !scaled) {
+            std::cerr << "taskman: --" << name << " requires --scale\n";
+            return 1;
+        }
+    }
+    if (result.count("phases")) scale.phases = result["phases"].as<int>();
+    if (result.count("milestones")) scale.milestones = result["milestones"].as<int>();
+    if (result.count("tasks")) scale.tasks = result["tasks"].as<int>();
+    if (result.count("deps")) scale.deps = result["deps"].as<double>();
+    if (result.count("notes")) scale.notes = result["notes"].as<double>();
+    if (result.count("description-size")) scale.description_size = result["description-size"].as<int>();
+    if (result.count("seed")) scale.seed = result["seed"].as<uint64_t>();
+    if (scale.phases < 1 || scale.milestones < 0 || scale.tasks < 1 || scale.deps < 0 || scale.notes < 0
+        || scale.description_size < 0) {
+        std::cerr << "taskman: --phases and --tasks must be at least 1, other --scale options at least 0\n";
+        return 1;
+    }
+
     // Get database path
     const char* db_path_env = std::getenv("TASKMAN_DB_NAME");
     std::string db_path = (db_path_env && db_path_env[0] != '\0') ? db_path_env : "project_tasks.db";
@@ -85,7 +120,11 @@ int cmd_demo_generate(int argc, char* argv[], Database& db) {
         }
     }
 
-    std::cout << "Creating demo database with a real-life example (e-commerce site MVP project)...\n";
+    if (scaled) {
+        std::cout << "Creating scale demo database (" << scale.tasks << " tasks, seed " << scale.seed << ")...\n";
+    } else {
+        std::cout << "Creating demo database with a real-life example (e-commerce site MVP project)...\n";
+    }
 
     // Reopen database
     if (!db.open(db_path.c_str())) {
@@ -100,6 +139,12 @@ int cmd_demo_generate(int argc, char* argv[], Database& db) {
     }
     std::cout << "  init\n";
 
+    if (scaled) {
+        if (!generate_scale_demo(db, scale, std::cout)) return 1;
+        std::cout << "Done. Database: " << db_path << "\n";
+        return 0;
+    }
+
     // Phases
     if (!phase_add(db, "P1", "Design", "in_progress", 1)) return 1;
     if (!phase_add(db, "P2", "Development", "to_do", 2)) return 1;
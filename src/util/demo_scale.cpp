@@ -0,0 +1,268 @@
+/**
+ * Implémentation du générateur de projet synthétique (demo:generate --scale).
+ */
+
+#include "demo_scale.hpp"
+#include "core/milestone/milestone.hpp"
+#include "core/note/note_repository.hpp"
+#include "core/phase/phase.hpp"
+#include "core/task/task_repository.hpp"
+#include "infrastructure/db/bulk_load.hpp"
+#include "infrastructure/db/db.hpp"
+#include "infrastructure/db/transaction.hpp"
+#include "util/roles.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace taskman {
+
+namespace {
+
+/** Part du projet (ordre des tâches) terminée ; la tranche suivante est le front en cours. */
+constexpr double DONE_UNTIL = 0.35;
+constexpr double ACTIVE_UNTIL = 0.45;
+/** Une dépendance pointe vers l'une des DEP_WINDOW tâches précédentes. */
+constexpr uint64_t DEP_WINDOW = 2000;
+
+const char* const VERBS[] = {"Implement", "Design", "Review", "Test", "Document", "Refactor",
+                             "Fix", "Deploy", "Specify", "Benchmark", "Migrate", "Validate"};
+const char* const OBJECTS[] = {"checkout flow", "search index", "user profile", "billing API",
+                               "order export", "audit log", "cache layer", "login page",
+                               "report builder", "notification service", "data import", "admin dashboard",
+                               "payment webhook", "access control", "mobile layout", "backup job"};
+const char* const WORDS[] = {"the", "service", "must", "handle", "requests", "for", "each", "customer",
+                             "and", "report", "errors", "to", "operations", "with", "clear", "metrics",
+                             "update", "schema", "before", "release", "cover", "edge", "cases", "in",
+                             "tests", "keep", "latency", "under", "budget", "document", "API", "changes"};
+
+/** SplitMix64 : générateur 64 bits rapide, suite identique sur toutes les plateformes. */
+class SplitMix64 {
+public:
+    explicit SplitMix64(uint64_t seed) : state_(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state_ += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    /** Entier dans [0, n). */
+    uint64_t below(uint64_t n) { return next() % n; }
+
+    /** Réel dans [0, 1). */
+    double unit() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+
+    /** Effectif de moyenne mean (0 à 2 × mean), pour les dépendances et notes par tâche. */
+    int count(double mean) {
+        double x = unit() * 2.0 * mean;
+        double whole = std::floor(x);
+        return static_cast<int>(whole) + (unit() < x - whole ? 1 : 0);
+    }
+
+    template <size_t N>
+    const char* pick(const char* const (&values)[N]) {
+        return values[below(N)];
+    }
+
+private:
+    uint64_t state_;
+};
+
+/** UUID v4 tiré de rng (reproductible, contrairement à uuid_random_generator + random_device). */
+std::string uuid_v4(SplitMix64& rng) {
+    static const char hex[] = "0123456789abcdef";
+    uint64_t hi = (rng.next() & ~0xF000ull) | 0x4000ull;
+    uint64_t lo = (rng.next() & 0x3FFFFFFFFFFFFFFFull) | 0x8000000000000000ull;
+    std::string s(36, '-');
+    size_t k = 0;
+    for (int i = 0; i < 32; ++i) {
+        if (k == 8 || k == 13 || k == 18 || k == 23) ++k;
+        uint64_t word = i < 16 ? hi : lo;
+        s[k++] = hex[(word >> (60 - 4 * (i % 16))) & 0xF];
+    }
+    return s;
+}
+
+/** Phrase de mots tirés au hasard, exactement size caractères (majuscule initiale, point final). */
+std::string sentence(SplitMix64& rng, size_t size) {
+    std::string s;
+    if (size == 0) return s;
+    s.reserve(size + 16);
+    while (s.size() < size) {
+        if (!s.empty()) s += ' ';
+        s += rng.pick(WORDS);
+    }
+    s.resize(size - 1);
+    s += '.';
+    if (s[0] >= 'a' && s[0] <= 'z') s[0] = static_cast<char>(s[0] - 'a' + 'A');
+    return s;
+}
+
+/** Statut d'un élément couvrant [begin, end) de l'ordre du projet (fractions). */
+const char* status_of_range(double begin, double end) {
+    if (end <= DONE_UNTIL) return "done";
+    if (begin >= ACTIVE_UNTIL) return "to_do";
+    return "in_progress";
+}
+
+/** Statut d'une tâche à la position f (fraction) du projet. */
+const char* task_status(SplitMix64& rng, double f) {
+    double r = rng.unit();
+    if (f < DONE_UNTIL) return r < 0.95 ? "done" : "in_progress";
+    if (f < ACTIVE_UNTIL) return r < 0.3 ? "done" : (r < 0.7 ? "in_progress" : "to_do");
+    return r < 0.02 ? "in_progress" : "to_do";
+}
+
+/** Réglages de connexion du chargement en masse, rétablis à la destruction (RAII) : pas de
+ * fsync ni de journal sur disque (la base est recréée à chaque génération), grand cache de pages
+ * pour les index des clés UUID, insérées dans le désordre. */
+class BulkLoadPragmas {
+public:
+    explicit BulkLoadPragmas(QueryExecutor& executor) : executor_(executor) {
+        for (auto& p : pragmas_) {
+            auto rows = executor_.query((std::string("PRAGMA ") + p.name).c_str());
+            if (!rows.empty() && !rows[0].empty()) p.previous = rows[0].begin()->second;
+            executor_.exec((std::string("PRAGMA ") + p.name + " = " + p.bulk).c_str());
+        }
+    }
+    ~BulkLoadPragmas() {
+        for (const auto& p : pragmas_) {
+            if (p.previous) executor_.exec((std::string("PRAGMA ") + p.name + " = " + *p.previous).c_str());
+        }
+    }
+    BulkLoadPragmas(const BulkLoadPragmas&) = delete;
+    BulkLoadPragmas& operator=(const BulkLoadPragmas&) = delete;
+
+private:
+    struct Pragma {
+        const char* name;
+        const char* bulk;
+        std::optional<std::string> previous;
+    };
+    QueryExecutor& executor_;
+    Pragma pragmas_[3] = {{"synchronous", "OFF", {}}, {"journal_mode", "MEMORY", {}}, {"cache_size", "-262144", {}}};
+};
+
+/** Première tâche (index global) de la tranche part sur parts. */
+int64_t range_start(int64_t total, int64_t part, int64_t parts) {
+    return total * part / parts;
+}
+
+} // namespace
+
+bool generate_scale_demo(Database& db, const DemoScale& scale, std::ostream& out) {
+    SplitMix64 rng(scale.seed);
+    const int64_t total = scale.tasks;
+    const int64_t milestone_count = static_cast<int64_t>(scale.phases) * scale.milestones;
+
+    // Phases et jalons : quelques lignes, par les services (validation, data_version)
+    for (int p = 0; p < scale.phases; ++p) {
+        double begin = static_cast<double>(range_start(total, p, scale.phases)) / std::max<int64_t>(total, 1);
+        double end = static_cast<double>(range_start(total, p + 1, scale.phases)) / std::max<int64_t>(total, 1);
+        std::string phase_id = "P" + std::to_string(p + 1);
+        if (!phase_add(db, phase_id, "Phase " + std::to_string(p + 1), status_of_range(begin, end), p + 1)) return false;
+        for (int m = 0; m < scale.milestones; ++m) {
+            int64_t index = static_cast<int64_t>(p) * scale.milestones + m;
+            double m_end = static_cast<double>(range_start(total, index + 1, milestone_count)) / std::max<int64_t>(total, 1);
+            std::string name = std::string(rng.pick(OBJECTS)) + " ready";
+            if (!milestone_add(db, "M" + std::to_string(index + 1), phase_id, name, sentence(rng, 60),
+                               m_end <= DONE_UNTIL)) {
+                return false;
+            }
+        }
+    }
+    out << "  phases " << scale.phases << ", milestones " << milestone_count << "\n";
+
+    QueryExecutor& executor = db.get_executor();
+    BulkLoadPragmas pragmas(executor);
+    BulkLoad bulk_load(db);  // index et triggers data_version recréés même sur un retour anticipé
+    if (!bulk_load.active()) return false;
+    TaskRepository tasks(executor);
+    NoteRepository notes(executor);
+    std::vector<std::string> ids;  // IDs de toutes les tâches, cibles des dépendances
+    ids.reserve(static_cast<size_t>(total));
+    int64_t dep_total = 0, note_total = 0;
+    int next_report = 1;
+    const int64_t groups = milestone_count > 0 ? milestone_count : scale.phases;
+    int64_t group = 0;
+
+    for (int64_t start = 0; start < total; start += DEMO_SCALE_BATCH_TASKS) {
+        int64_t stop = std::min<int64_t>(total, start + DEMO_SCALE_BATCH_TASKS);
+        std::vector<TaskRecord> batch;
+        std::vector<TaskDependencyEdge> edges;
+        std::vector<NoteRecord> batch_notes;
+        batch.reserve(static_cast<size_t>(stop - start));
+
+        for (int64_t i = start; i < stop; ++i) {
+            // Tranche (jalon, ou phase sans jalons) de la tâche ; rang dans la tranche pour sort_order
+            while (i >= range_start(total, group + 1, groups)) ++group;
+            int64_t phase = milestone_count > 0 ? group / scale.milestones : group;
+            double f = static_cast<double>(i) / static_cast<double>(total);
+
+            TaskRecord t;
+            t.id = uuid_v4(rng);
+            t.phase_id = "P" + std::to_string(phase + 1);
+            if (milestone_count > 0) t.milestone_id = "M" + std::to_string(group + 1);
+            // Un tirage par instruction : l'ordre d'évaluation des opérandes de + n'est pas spécifié
+            const char* verb = rng.pick(VERBS);
+            const char* object = rng.pick(OBJECTS);
+            t.title = std::string(verb) + " " + object + " " + std::to_string(i + 1);
+            if (scale.description_size > 0) t.description = sentence(rng, static_cast<size_t>(scale.description_size));
+            t.status = task_status(rng, f);
+            t.sort_order = static_cast<int>(i - range_start(total, group, groups) + 1);
+            if (rng.below(10) != 0) t.role = rng.pick(ROLE_VALUES);
+            t.creator = rng.below(2) ? std::optional<std::string>("project-manager") : t.role;
+
+            // Dépendances vers des tâches antérieures (fenêtre DEP_WINDOW), sans doublon
+            int dep_count = i > 0 ? static_cast<int>(std::min<int64_t>(rng.count(scale.deps), i)) : 0;
+            size_t first_edge = edges.size();
+            for (int d = 0; d < dep_count; ++d) {
+                uint64_t window = std::min<uint64_t>(DEP_WINDOW, static_cast<uint64_t>(i));
+                const std::string& target = ids[static_cast<size_t>(i - 1 - static_cast<int64_t>(rng.below(window)))];
+                bool seen = std::any_of(edges.begin() + static_cast<std::ptrdiff_t>(first_edge), edges.end(),
+                                        [&target](const TaskDependencyEdge& e) { return e.second == target; });
+                if (!seen) edges.emplace_back(t.id, target);
+            }
+
+            int note_count = rng.count(scale.notes);
+            for (int n = 0; n < note_count; ++n) {
+                NoteRecord note;
+                note.id = uuid_v4(rng);
+                note.task_id = t.id;
+                note.content = sentence(rng, 40 + rng.below(120));
+                note.kind = (t.status == "done" && n + 1 == note_count) ? "completion"
+                                                                        : (rng.below(5) ? "progress" : "issue");
+                note.role = t.role;
+                batch_notes.push_back(std::move(note));
+            }
+
+            ids.push_back(t.id);
+            batch.push_back(std::move(t));
+        }
+
+        Transaction tx(executor);
+        if (!tx.active()) return false;
+        std::optional<TaskDependencyEdge> cycle;
+        if (!tasks.add_many(batch, {}, cycle)) return false;
+        if (!tasks.add_dependencies_unchecked(edges)) return false;
+        if (!notes.add_many(batch_notes)) return false;
+        if (!tx.commit()) return false;
+        dep_total += static_cast<int64_t>(edges.size());
+        note_total += static_cast<int64_t>(batch_notes.size());
+
+        if (next_report <= 10 && stop * 10 >= total * next_report) {
+            out << "  tasks " << stop << "/" << total << "\n";
+            while (next_report <= 10 && stop * 10 >= total * next_report) ++next_report;
+        }
+    }
+    if (!bulk_load.finish()) return false;
+    out << "  dependencies " << dep_total << ", notes " << note_total << "\n";
+    return true;
+}
+
+} // namespace taskman
@@ -0,0 +1,47 @@
+/**
+ * Générateur de projet synthétique (demo:generate --scale).
+ * Responsabilité unique : remplir une base vide avec un grand projet reproductible (phases,
+ * jalons, tâches, dépendances, notes) pour les benchmarks et le profilage.
+ *
+ * Tout est tiré d'un générateur pseudo-aléatoire à graine (SplitMix64, pas de std::*_distribution
+ * dont les résultats varient selon la bibliothèque standard) : même graine et mêmes paramètres,
+ * même base, UUID compris. Les lignes sont insérées par lots de DEMO_SCALE_BATCH_TASKS tâches, une
+ * transaction et un INSERT préparé par table et par lot.
+ */
+
+#ifndef TASKMAN_DEMO_SCALE_HPP
+#define TASKMAN_DEMO_SCALE_HPP
+
+#include <cstdint>
+#include <ostream>
+
+namespace taskman {
+
+class Database;
+
+/** Paramètres de demo:generate --scale. */
+struct DemoScale {
+    int phases = 10;
+    int milestones = 4;          // par phase
+    int tasks = 100000;
+    double deps = 1.5;           // dépendances par tâche (moyenne)
+    double notes = 1.0;          // notes par tâche (moyenne)
+    int description_size = 300;  // caractères ; 0 : pas de description
+    uint64_t seed = 1;
+};
+
+/** Tâches insérées par transaction. */
+inline constexpr int DEMO_SCALE_BATCH_TASKS = 10000;
+
+/**
+ * Remplit db (schéma initialisé, base vide) selon scale ; une ligne de progression sur out
+ * tous les 10 %. Les tâches sont réparties dans l'ordre des phases puis des jalons ; le début
+ * du projet est terminé, le front en cours, la suite à faire. Une dépendance pointe toujours
+ * vers une tâche créée avant (graphe acyclique, proche dans l'ordre du projet).
+ * Retourne false en cas d'erreur (stderr déjà écrit).
+ */
+bool generate_scale_demo(Database& db, const DemoScale& scale, std::ostream& out);
+
+} // namespace taskman
+
+#endif /* TASKMAN_DEMO_SCALE_HPP */
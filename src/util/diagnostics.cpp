@@ -0,0 +1,28 @@
+/**
+ * Implémentation du flux de diagnostics par thread.
+ */
+
+#include "diagnostics.hpp"
+#include <iostream>
+
+namespace taskman {
+
+namespace {
+
+thread_local std::ostream* current_diag = nullptr;
+
+} // namespace
+
+std::ostream& diag() {
+    return current_diag ? *current_diag : std::cerr;
+}
+
+DiagnosticCapture::DiagnosticCapture() : previous_(current_diag) {
+    current_diag = &buffer_;
+}
+
+DiagnosticCapture::~DiagnosticCapture() {
+    current_diag = previous_;
+}
+
+} // namespace taskman
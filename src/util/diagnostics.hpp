@@ -0,0 +1,41 @@
+/**
+ * Flux de diagnostics ("taskman: ...") des services, repositories et de la couche DB.
+ * Par défaut std::cerr ; DiagnosticCapture le redirige pour le thread courant seulement,
+ * sans toucher aux flux globaux (utilisé par les handlers MCP typés).
+ */
+
+#ifndef TASKMAN_DIAGNOSTICS_HPP
+#define TASKMAN_DIAGNOSTICS_HPP
+
+#include <ostream>
+#include <sstream>
+#include <string>
+
+namespace taskman {
+
+/** Flux de diagnostics du thread courant (std::cerr hors DiagnosticCapture). */
+std::ostream& diag();
+
+/**
+ * Capture RAII des diagnostics du thread courant dans un tampon.
+ * Les captures s'imbriquent : le destructeur restaure le flux précédent.
+ */
+class DiagnosticCapture {
+public:
+    DiagnosticCapture();
+    ~DiagnosticCapture();
+
+    DiagnosticCapture(const DiagnosticCapture&) = delete;
+    DiagnosticCapture& operator=(const DiagnosticCapture&) = delete;
+
+    /** Texte capturé depuis la construction. */
+    std::string str() const { return buffer_.str(); }
+
+private:
+    std::ostringstream buffer_;
+    std::ostream* previous_;
+};
+
+} // namespace taskman
+
+#endif /* TASKMAN_DIAGNOSTICS_HPP */
@@ -0,0 +1,127 @@
+/**
+ * Implémentation des valeurs JSON des champs d'entités (voir entity_fields.hpp).
+ */
+
+#include "entity_fields.hpp"
+
+namespace taskman {
+
+namespace {
+
+bool parse_int(const std::string& s, int& out) {
+    try {
+        size_t pos = 0;
+        out = std::stoi(s, &pos);
+        return pos == s.size();
+    } catch (...) {
+        return false;
+    }
+}
+
+std::vector<std::string> split_ids(const std::string& s) {
+    std::vector<std::string> ids;
+    std::string acc;
+    for (char c : s) {
+        if (c == ',') {
+            if (!acc.empty()) ids.push_back(acc);
+            acc.clear();
+        } else {
+            acc += c;
+        }
+    }
+    if (!acc.empty()) ids.push_back(acc);
+    return ids;
+}
+
+} // namespace
+
+nlohmann::json json_value(JsonType type, const std::optional<std::string>* value) {
+    bool missing = !value || !value->has_value();
+    switch (type) {
+    case JsonType::IdList: {
+        nlohmann::json arr = nlohmann::json::array();
+        if (!missing) {
+            for (auto& id : split_ids(**value)) arr.push_back(std::move(id));
+        }
+        return arr;
+    }
+    case JsonType::Integer: {
+        if (missing) return nullptr;
+        int n = 0;
+        if (parse_int(**value, n)) return n;
+        return **value;
+    }
+    case JsonType::StringOrNull:
+        if (missing || (*value)->empty()) return nullptr;
+        return **value;
+    case JsonType::String:
+        break;
+    }
+    if (missing) return nullptr;
+    return **value;
+}
+
+void append_json_value(std::string& out, JsonType type, const std::optional<std::string>* value) {
+    bool missing = !value || !value->has_value();
+    switch (type) {
+    case JsonType::IdList: {
+        out += '[';
+        if (!missing) {
+            bool first = true;
+            for (const auto& id : split_ids(**value)) {
+                if (!first) out += ',';
+                first = false;
+                append_json_string(out, id);
+            }
+        }
+        out += ']';
+        return;
+    }
+    case JsonType::Integer: {
+        if (missing) break;
+        int n = 0;
+        if (parse_int(**value, n)) out += std::to_string(n);
+        else append_json_string(out, **value);
+        return;
+    }
+    case JsonType::StringOrNull:
+        if (missing || (*value)->empty()) break;
+        append_json_string(out, **value);
+        return;
+    case JsonType::String:
+        if (missing) break;
+        append_json_string(out, **value);
+        return;
+    }
+    out += "null";
+}
+
+void append_json_string(std::string& out, std::string_view s) {
+    static const char hex[] = "0123456789abcdef";
+    out += '"';
+    size_t start = 0;
+    for (size_t i = 0; i < s.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(s[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+        out.append(s.data() + start, i - start);
+        start = i + 1;
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        case '\b': out += "\\b"; break;
+        case '\f': out += "\\f"; break;
+        default:
+            out += "\\u00";
+            out += hex[c >> 4];
+            out += hex[c & 0xF];
+            break;
+        }
+    }
+    out.append(s.data() + start, s.size() - start);
+    out += '"';
+}
+
+} // namespace taskman
@@ -0,0 +1,250 @@
+/**
+ * Descripteurs de champs des entités (phase, milestone, task, note).
+ * Responsabilité unique : décrire une fois, à la compilation, les champs de chaque entité
+ * (colonne, type SQL du schéma, type JSON) ; les templates en déduisent la liste de colonnes
+ * des SELECT, le décodage positionnel d'une Row et la sérialisation JSON sans DOM, ce qui
+ * garde les requêtes et les formats de sortie synchronisés.
+ *
+ * Les clés d'une Row (std::map) et celles d'un objet nlohmann::json sont triées par nom :
+ * les champs sont parcourus dans cet ordre (SortedFields), en un seul passage sur la map,
+ * et append_json écrit exactement le texte de nlohmann::json::dump().
+ */
+
+#ifndef TASKMAN_ENTITY_FIELDS_HPP
+#define TASKMAN_ENTITY_FIELDS_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace taskman {
+
+using Row = std::map<std::string, std::optional<std::string>>;
+
+/** Type JSON d'un champ. */
+enum class JsonType {
+    String,          // chaîne ; NULL → null
+    Integer,         // nombre si la valeur est un entier, sinon chaîne ; NULL → null
+    StringOrNull,    // chaîne ; NULL ou chaîne vide → null (kind, role des notes)
+    IdList           // IDs séparés par des virgules → tableau de chaînes (absent → [])
+};
+
+struct FieldDescriptor {
+    std::string_view column;  // nom de colonne, clé JSON et ligne texte
+    const char* sql_type;     // type déclaré dans le schéma ; nullptr : champ calculé, hors SELECT
+    JsonType json;
+};
+
+/** Champs de phases, dans l'ordre du SELECT. */
+inline constexpr FieldDescriptor PHASE_FIELDS[] = {
+    {"id", "TEXT", JsonType::String},
+    {"name", "TEXT", JsonType::String},
+    {"status", "TEXT", JsonType::String},
+    {"sort_order", "INTEGER", JsonType::Integer},
+    {"created_at", "TEXT", JsonType::String},
+    {"updated_at", "TEXT", JsonType::String},
+};
+
+/** Champs de milestones, dans l'ordre du SELECT. */
+inline constexpr FieldDescriptor MILESTONE_FIELDS[] = {
+    {"id", "TEXT", JsonType::String},
+    {"phase_id", "TEXT", JsonType::String},
+    {"name", "TEXT", JsonType::String},
+    {"criterion", "TEXT", JsonType::String},
+    {"reached", "INTEGER", JsonType::Integer},
+    {"created_at", "TEXT", JsonType::String},
+    {"updated_at", "TEXT", JsonType::String},
+};
+
+/** Champs de tasks, dans l'ordre du SELECT ; note_ids est rempli par TaskService (task_notes). */
+inline constexpr FieldDescriptor TASK_FIELDS[] = {
+    {"id", "TEXT", JsonType::String},
+    {"phase_id", "TEXT", JsonType::String},
+    {"milestone_id", "TEXT", JsonType::String},
+    {"title", "TEXT", JsonType::String},
+    {"description", "TEXT", JsonType::String},
+    {"status", "TEXT", JsonType::String},
+    {"sort_order", "INTEGER", JsonType::Integer},
+    {"role", "TEXT", JsonType::String},
+    {"creator", "TEXT", JsonType::String},
+    {"created_at", "TEXT", JsonType::String},
+    {"updated_at", "TEXT", JsonType::String},
+    {"note_ids", nullptr, JsonType::IdList},
+};
+
+/** Champs de task_notes, dans l'ordre du SELECT. */
+inline constexpr FieldDescriptor NOTE_FIELDS[] = {
+    {"id", "TEXT", JsonType::String},
+    {"task_id", "TEXT", JsonType::String},
+    {"content", "TEXT", JsonType::String},
+    {"kind", "TEXT", JsonType::StringOrNull},
+    {"role", "TEXT", JsonType::StringOrNull},
+    {"created_at", "TEXT", JsonType::String},
+};
+
+/** Index du champ column dans fields ; nom inconnu : erreur de compilation (évaluation constexpr). */
+template <size_t N>
+constexpr size_t field_index(const FieldDescriptor (&fields)[N], std::string_view column) {
+    for (size_t i = 0; i < N; ++i) {
+        if (fields[i].column == column) return i;
+    }
+    throw "unknown field";
+}
+
+/** Descripteur du champ column (recherche à l'exécution), nullptr si inconnu. */
+template <size_t N>
+const FieldDescriptor* find_field(const FieldDescriptor (&fields)[N], std::string_view column) {
+    for (const auto& field : fields) {
+        if (field.column == column) return &field;
+    }
+    return nullptr;
+}
+
+namespace detail {
+
+template <const auto& Fields>
+constexpr size_t select_list_length() {
+    size_t n = 0;
+    for (const auto& field : Fields) {
+        if (!field.sql_type) continue;
+        n += (n ? 2 : 0) + field.column.size();
+    }
+    return n;
+}
+
+template <const auto& Fields>
+struct SelectList {
+    static constexpr std::array<char, select_list_length<Fields>() + 1> make() {
+        std::array<char, select_list_length<Fields>() + 1> s{};
+        size_t k = 0;
+        for (const auto& field : Fields) {
+            if (!field.sql_type) continue;
+            if (k) {
+                s[k++] = ',';
+                s[k++] = ' ';
+            }
+            for (char c : field.column) s[k++] = c;
+        }
+        s[k] = '\0';
+        return s;
+    }
+    static constexpr auto value = make();
+};
+
+} // namespace detail
+
+/** Index des champs triés par nom (ordre des clés d'une Row et de nlohmann::json). */
+template <const auto& Fields>
+struct SortedFields {
+    static constexpr std::array<size_t, std::size(Fields)> make() {
+        std::array<size_t, std::size(Fields)> order{};
+        for (size_t i = 0; i < order.size(); ++i) {
+            size_t j = i;
+            while (j > 0 && Fields[i].column < Fields[order[j - 1]].column) {
+                order[j] = order[j - 1];
+                --j;
+            }
+            order[j] = i;
+        }
+        return order;
+    }
+    static constexpr auto value = make();
+};
+
+/** Liste de colonnes du SELECT ("id, name, …"), champs calculés exclus ; construite à la compilation. */
+template <const auto& Fields>
+constexpr const char* select_list() {
+    return detail::SelectList<Fields>::value.data();
+}
+
+/** Valeurs de row dans l'ordre de Fields (nullptr : champ absent), en un seul parcours de la map. */
+template <const auto& Fields>
+std::array<const std::optional<std::string>*, std::size(Fields)> decode_row(const Row& row) {
+    std::array<const std::optional<std::string>*, std::size(Fields)> values{};
+    auto it = row.begin();
+    for (size_t i : SortedFields<Fields>::value) {
+        std::string_view column = Fields[i].column;
+        while (it != row.end() && std::string_view(it->first) < column) ++it;
+        if (it == row.end()) break;
+        if (it->first == column) values[i] = &it->second;
+    }
+    return values;
+}
+
+/** Valeur JSON d'un champ (value nullptr : champ absent de la ligne). */
+nlohmann::json json_value(JsonType type, const std::optional<std::string>* value);
+
+/** Ajoute la valeur JSON d'un champ à out, sérialisée comme nlohmann::json::dump(). */
+void append_json_value(std::string& out, JsonType type, const std::optional<std::string>* value);
+
+/** Ajoute s à out en chaîne JSON (guillemets et échappements de nlohmann::json::dump()). */
+void append_json_string(std::string& out, std::string_view s);
+
+/** Objet JSON de row : tous les champs de Fields (absents ou NULL → null). */
+template <const auto& Fields>
+void fields_to_json(nlohmann::json& out, const Row& row) {
+    auto values = decode_row<Fields>(row);
+    for (size_t i = 0; i < values.size(); ++i) {
+        out[std::string(Fields[i].column)] = json_value(Fields[i].json, values[i]);
+    }
+}
+
+/** Ajoute à out l'objet JSON de row, même texte que fields_to_json(…).dump() (sans DOM). */
+template <const auto& Fields>
+void append_json(std::string& out, const Row& row) {
+    out += '{';
+    auto it = row.begin();
+    bool first = true;
+    for (size_t i : SortedFields<Fields>::value) {
+        std::string_view column = Fields[i].column;
+        while (it != row.end() && std::string_view(it->first) < column) ++it;
+        const std::optional<std::string>* value = (it != row.end() && it->first == column) ? &it->second : nullptr;
+        if (!first) out += ',';
+        first = false;
+        append_json_string(out, column);
+        out += ':';
+        append_json_value(out, Fields[i].json, value);
+    }
+    out += '}';
+}
+
+/** Ajoute à out l'objet JSON de row limité à columns (projection --fields : noms de Fields,
+ *  doublons ignorés) ; même texte que le DOM nlohmann équivalent. */
+template <const auto& Fields>
+void append_json(std::string& out, const Row& row, const std::vector<std::string>& columns) {
+    std::vector<std::string_view> sorted(columns.begin(), columns.end());
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    out += '{';
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        const FieldDescriptor* field = find_field(Fields, sorted[i]);
+        auto it = row.find(std::string(sorted[i]));
+        if (i) out += ',';
+        append_json_string(out, sorted[i]);
+        out += ':';
+        append_json_value(out, field ? field->json : JsonType::String, it != row.end() ? &it->second : nullptr);
+    }
+    out += '}';
+}
+
+/** Ajoute à out le tableau JSON des lignes (append_json de chacune). */
+template <const auto& Fields>
+void append_json_array(std::string& out, const std::vector<Row>& rows) {
+    out += '[';
+    for (size_t i = 0; i < rows.size(); ++i) {
+        if (i) out += ',';
+        append_json<Fields>(out, rows[i]);
+    }
+    out += ']';
+}
+
+} // namespace taskman
+
+#endif /* TASKMAN_ENTITY_FIELDS_HPP */
@@ -0,0 +1,80 @@
+/**
+ * EnumTable — énumération de chaînes (status, role) avec codes entiers.
+ * Responsabilité unique : associer à chaque nom un code stable (index + 1 ; 0 = inconnu) et
+ * retrouver le code d'une chaîne par hachage parfait, calculé à la compilation.
+ *
+ * Le constructeur constexpr cherche une graine de FNV-1a sans collision sur SLOTS alvéoles :
+ * l'analyse d'une chaîne coûte un hachage et une seule comparaison, au lieu d'un parcours
+ * strcmp de toute la liste. Les codes sont stockés en base (init --compact-enums) : ne jamais
+ * réordonner les noms, seulement en ajouter à la fin.
+ */
+
+#ifndef TASKMAN_ENUM_TABLE_HPP
+#define TASKMAN_ENUM_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace taskman {
+
+class EnumTable {
+public:
+    /** Nombre maximal de noms. */
+    static constexpr size_t MAX_NAMES = 32;
+    /** Alvéoles du hachage parfait (puissance de 2, au moins 2 × MAX_NAMES). */
+    static constexpr size_t SLOTS = 64;
+
+    template <size_t N>
+    constexpr EnumTable(const char* const (&names)[N]) : count_(N) {
+        static_assert(N > 0 && N <= MAX_NAMES, "EnumTable: too many names");
+        for (size_t i = 0; i < N; ++i) names_[i] = names[i];
+        for (uint32_t seed = 0; seed < 100000; ++seed) {
+            if (try_seed(seed)) return;
+        }
+        throw "EnumTable: no perfect hash seed";
+    }
+
+    /** Code de s (1..size()), 0 si s n'est pas un nom de la table. */
+    constexpr int code(std::string_view s) const {
+        int c = slots_[hash(s, seed_) & (SLOTS - 1)];
+        return (c && names_[c - 1] == s) ? c : 0;
+    }
+
+    /** Nom du code c, vide si c est hors de la table. */
+    constexpr std::string_view name(int c) const {
+        return (c >= 1 && static_cast<size_t>(c) <= count_) ? names_[c - 1] : std::string_view();
+    }
+
+    constexpr size_t size() const { return count_; }
+
+private:
+    static constexpr uint32_t hash(std::string_view s, uint32_t seed) {
+        uint32_t h = 2166136261u ^ (seed * 0x9E3779B9u);
+        for (char c : s) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 16777619u;
+        }
+        return h ^ (h >> 15);
+    }
+
+    constexpr bool try_seed(uint32_t seed) {
+        for (auto& slot : slots_) slot = 0;
+        for (size_t i = 0; i < count_; ++i) {
+            auto& slot = slots_[hash(names_[i], seed) & (SLOTS - 1)];
+            if (slot) return false;
+            slot = static_cast<uint8_t>(i + 1);
+        }
+        seed_ = seed;
+        return true;
+    }
+
+    std::string_view names_[MAX_NAMES] = {};
+    uint8_t slots_[SLOTS] = {};
+    size_t count_ = 0;
+    uint32_t seed_ = 0;
+};
+
+} // namespace taskman
+
+#endif /* TASKMAN_ENUM_TABLE_HPP */
@@ -1,21 +1,21 @@
 /**
  * Formats de sortie (phase 7) : JSON et text.
- * — JSON : structures pour phase, milestone, task (champs optionnels = null si absents).
+ * — JSON : structures pour phase, milestone, task, note (champs optionnels = null si absents).
  * — Text : format lisible pour task (titre, description, status, role, puis id, phase_id, …).
+ * Les champs et leurs types viennent des descripteurs de entity_fields.hpp.
  */
 
 #ifndef TASKMAN_FORMATS_HPP
 #define TASKMAN_FORMATS_HPP
 
-#include <map>
+#include "entity_fields.hpp"
 #include <nlohmann/json.hpp>
-#include <optional>
+#include <ostream>
 #include <string>
+#include <vector>
 
 namespace taskman {
 
-using Row = std::map<std::string, std::optional<std::string>>;
-
 /** Phase → JSON : id, name, status, sort_order, created_at, updated_at (sort_order en int si entier). */
 void phase_to_json(nlohmann::json& out, const Row& row);
 
@@ -25,8 +25,14 @@ void milestone_to_json(nlohmann::json& out, const Row& row);
 /** Task → JSON : id, phase_id, milestone_id, title, description, status, sort_order, role, creator, created_at, updated_at, note_ids (liste des UID des notes liées). */
 void task_to_json(nlohmann::json& out, const Row& row);
 
-/** Task → format text lisible (titre, description, status, role, creator, puis id, phase_id, …). */
-void print_task_text(const Row& row);
+/** Task → JSON limité aux champs donnés (projection --fields ; pas de note_ids). */
+void task_to_json(nlohmann::json& out, const Row& row, const std::vector<std::string>& fields);
+
+/** Note → JSON : id, task_id, content, kind, role, created_at (kind/role vides = null). */
+void note_to_json(nlohmann::json& out, const Row& row);
+
+/** Task → format text lisible (titre, description, status, role, creator, puis id, phase_id, …), écrit sur out. */
+void print_task_text(const Row& row, std::ostream& out);
 
 } // namespace taskman
 
@@ -0,0 +1,77 @@
+/**
+ * Implémentation de NdjsonWriter.
+ */
+
+#include "ndjson_writer.hpp"
+#include "entity_fields.hpp"
+#include <algorithm>
+#include <string_view>
+#include <utility>
+
+namespace taskman {
+
+NdjsonWriter::NdjsonWriter(std::ostream& out, std::vector<std::string> empty_as_null)
+    : out_(out), empty_as_null_(std::move(empty_as_null)) {
+    buffer_.reserve(BUFFER_SIZE + 4096);
+}
+
+void NdjsonWriter::columns(const RowCursor& cursor) {
+    int n = cursor.size();
+    for (int i = 0; i < n; ++i) {
+        const char* name = cursor.name(i);
+        std::string key(i ? "," : "{");
+        append_json_string(key, name ? name : "");
+        key += ':';
+        keys_.push_back(std::move(key));
+        null_if_empty_.push_back(name && std::find(empty_as_null_.begin(), empty_as_null_.end(), name)
+                                             != empty_as_null_.end());
+    }
+}
+
+void NdjsonWriter::row(const RowCursor& cursor) {
+    if (keys_.empty()) {
+        buffer_ += "{}\n";
+        flush_if_full();
+        return;
+    }
+    for (size_t i = 0; i < keys_.size(); ++i) {
+        int col = static_cast<int>(i);
+        buffer_ += keys_[i];
+        if (cursor.is_null(col)) {
+            buffer_ += "null";
+            continue;
+        }
+        std::string_view value = cursor.text(col);
+        if (value.empty() && null_if_empty_[i]) {
+            buffer_ += "null";
+        } else if (cursor.is_integer(col)) {
+            buffer_ += value;
+        } else {
+            append_json_string(buffer_, value);
+        }
+    }
+    buffer_ += "}\n";
+    flush_if_full();
+}
+
+void NdjsonWriter::next_cursor(const std::string& token) {
+    buffer_ += "{\"nextCursor\":";
+    append_json_string(buffer_, token);
+    buffer_ += "}\n";
+}
+
+void NdjsonWriter::finish() {
+    if (!buffer_.empty()) {
+        out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        buffer_.clear();
+    }
+    out_.flush();
+}
+
+void NdjsonWriter::flush_if_full() {
+    if (buffer_.size() < BUFFER_SIZE) return;
+    out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    buffer_.clear();
+}
+
+} // namespace taskman
@@ -0,0 +1,59 @@
+/**
+ * NdjsonWriter — sortie NDJSON des listes (--format ndjson).
+ * Responsabilité unique : écrire un objet JSON par ligne, au fil du curseur SQLite, sans
+ * construire de map ni de DOM nlohmann : la mémoire reste constante quel que soit le nombre
+ * de lignes et le consommateur (jq, …) traite la sortie au fur et à mesure.
+ *
+ * Un objet par ligne du SELECT, clés dans l'ordre des colonnes ; entiers SQLite en nombres,
+ * le reste en chaînes, NULL en null (comme TableWriter). Les lignes sont accumulées dans un
+ * tampon de BUFFER_SIZE octets, écrit d'un bloc sur le flux (pas d'écriture par caractère).
+ */
+
+#ifndef TASKMAN_NDJSON_WRITER_HPP
+#define TASKMAN_NDJSON_WRITER_HPP
+
+#include "infrastructure/db/query_executor.hpp"
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace taskman {
+
+class NdjsonWriter : public RowSink {
+public:
+    /** Taille du tampon d'écriture (écrit sur le flux dès qu'il est atteint). */
+    static constexpr size_t BUFFER_SIZE = 64 * 1024;
+
+    /**
+     * Écrit sur out ; la sortie n'est complète qu'après finish().
+     * empty_as_null : colonnes dont la chaîne vide s'écrit null (kind et role des notes).
+     */
+    explicit NdjsonWriter(std::ostream& out, std::vector<std::string> empty_as_null = {});
+
+    NdjsonWriter(const NdjsonWriter&) = delete;
+    NdjsonWriter& operator=(const NdjsonWriter&) = delete;
+
+    void columns(const RowCursor& cursor) override;
+    void row(const RowCursor& cursor) override;
+
+    /** Écrit la ligne finale {"nextCursor":jeton} d'une page incomplète (task:list --limit). */
+    void next_cursor(const std::string& token);
+
+    /** Écrit le reste du tampon sur le flux. */
+    void finish();
+
+private:
+    /** Écrit le tampon sur le flux s'il dépasse BUFFER_SIZE. */
+    void flush_if_full();
+
+    std::ostream& out_;
+    std::vector<std::string> empty_as_null_;
+    std::vector<std::string> keys_;      // préfixe de chaque colonne : {"nom": ou ,"nom":
+    std::vector<bool> null_if_empty_;
+    std::string buffer_;
+};
+
+} // namespace taskman
+
+#endif /* TASKMAN_NDJSON_WRITER_HPP */
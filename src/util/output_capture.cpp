@@ -0,0 +1,23 @@
+/**
+ * Implémentation de OutputCapture.
+ */
+
+#include "output_capture.hpp"
+#include <iostream>
+
+namespace taskman {
+
+OutputCapture::OutputCapture(Streams streams) : previous_out_(std::cout.rdbuf(out_.rdbuf())) {
+    if (streams == Streams::OutAndErr) {
+        previous_err_ = std::cerr.rdbuf(err_.rdbuf());
+    }
+}
+
+OutputCapture::~OutputCapture() {
+    std::cout.rdbuf(previous_out_);
+    if (previous_err_) {
+        std::cerr.rdbuf(previous_err_);
+    }
+}
+
+} // namespace taskman
@@ -0,0 +1,43 @@
+/**
+ * OutputCapture — capture de la sortie d'une commande CLI exécutée dans le processus.
+ * Responsabilité unique : rediriger std::cout, et std::cerr (donc diag()) si demandé, vers des
+ * tampons le temps d'une portée, puis rétablir les flux d'origine (RAII, même sur exception).
+ * Utilisé par batch, les lectures conditionnelles (--if-none-match) et l'exécution des outils MCP.
+ * Les captures s'imbriquent (chacune rétablit le flux qu'elle a remplacé) ; les flux standard
+ * étant globaux, une capture ne doit pas être concurrente d'une autre écriture sur std::cout.
+ */
+
+#ifndef TASKMAN_OUTPUT_CAPTURE_HPP
+#define TASKMAN_OUTPUT_CAPTURE_HPP
+
+#include <sstream>
+#include <streambuf>
+#include <string>
+
+namespace taskman {
+
+class OutputCapture {
+public:
+    /** Flux capturés : std::cout seul (std::cerr reste sur le terminal), ou les deux. */
+    enum class Streams { Out, OutAndErr };
+
+    explicit OutputCapture(Streams streams = Streams::OutAndErr);
+    ~OutputCapture();
+
+    OutputCapture(const OutputCapture&) = delete;
+    OutputCapture& operator=(const OutputCapture&) = delete;
+
+    /** Texte écrit sur std::cout depuis la construction. */
+    std::string out() const { return out_.str(); }
+    /** Texte écrit sur std::cerr depuis la construction (vide avec Streams::Out). */
+    std::string err() const { return err_.str(); }
+
+private:
+    std::ostringstream out_, err_;
+    std::streambuf* previous_out_;
+    std::streambuf* previous_err_ = nullptr;
+};
+
+} // namespace taskman
+
+#endif /* TASKMAN_OUTPUT_CAPTURE_HPP */
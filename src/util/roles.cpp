@@ -7,19 +7,8 @@
 
 namespace taskman {
 
-const char* const ROLE_VALUES[] = {
-    "project-manager", "project-designer", "software-architect",
-    "developer", "summary-writer", "documentation-writer",
-    "art-director", "ui-designer", "community-manager", "ux-designer",
-    "qa-engineer", "devops-engineer", "product-owner", "security-engineer"};
-
-const size_t ROLE_COUNT = sizeof(ROLE_VALUES) / sizeof(ROLE_VALUES[0]);
-
 bool is_valid_role(const std::string& s) {
-    for (const char* v : ROLE_VALUES) {
-        if (s == v) return true;
-    }
-    return false;
+    return ROLE_CODES.code(s) != 0;
 }
 
 nlohmann::json get_roles_json_array() {
@@ -6,15 +6,24 @@
 #ifndef TASKMAN_ROLES_HPP
 #define TASKMAN_ROLES_HPP
 
+#include "enum_table.hpp"
 #include <cstddef>
+#include <iterator>
 #include <string>
 #include <nlohmann/json.hpp>
 
 namespace taskman {
 
-/** Tableau des valeurs de rôles valides. */
-extern const char* const ROLE_VALUES[];
-extern const size_t ROLE_COUNT;
+/** Tableau des valeurs de rôles valides (code stocké = index + 1 : ajouter en fin de liste). */
+inline constexpr const char* ROLE_VALUES[] = {
+    "project-manager", "project-designer", "software-architect",
+    "developer", "summary-writer", "documentation-writer",
+    "art-director", "ui-designer", "community-manager", "ux-designer",
+    "qa-engineer", "devops-engineer", "product-owner", "security-engineer"};
+inline constexpr size_t ROLE_COUNT = std::size(ROLE_VALUES);
+
+/** Codes des rôles (role et creator des tâches, role des notes). */
+inline constexpr EnumTable ROLE_CODES(ROLE_VALUES);
 
 /** Vérifie si une chaîne est un rôle valide. */
 bool is_valid_role(const std::string& s);
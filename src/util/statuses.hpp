@@ -0,0 +1,21 @@
+/**
+ * Définition centralisée des statuts (phases et tâches).
+ * Source unique de vérité pour la liste des statuts.
+ */
+
+#ifndef TASKMAN_STATUSES_HPP
+#define TASKMAN_STATUSES_HPP
+
+#include "enum_table.hpp"
+
+namespace taskman {
+
+/** Statuts valides (code stocké = index + 1 : ajouter en fin de liste). */
+inline constexpr const char* STATUS_VALUES[] = {"to_do", "in_progress", "done"};
+
+/** Codes des statuts. */
+inline constexpr EnumTable STATUS_CODES(STATUS_VALUES);
+
+} // namespace taskman
+
+#endif /* TASKMAN_STATUSES_HPP */
@@ -0,0 +1,119 @@
+/**
+ * Implémentation de TableWriter.
+ */
+
+#include "table_writer.hpp"
+
+namespace taskman {
+
+namespace {
+    /** Colonnes à valeurs répétées (énumérations), encodées par dictionnaire. */
+    bool is_dict_column(std::string_view name) {
+        return name == "status" || name == "role" || name == "creator";
+    }
+}
+
+void TableWriter::write_string(std::ostream& out, std::string_view s) {
+    static const char hex[] = "0123456789abcdef";
+    out << '"';
+    size_t start = 0;
+    for (size_t i = 0; i < s.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(s[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+        out.write(s.data() + start, static_cast<std::streamsize>(i - start));
+        start = i + 1;
+        switch (c) {
+        case '"': out << "\\\""; break;
+        case '\\': out << "\\\\"; break;
+        case '\n': out << "\\n"; break;
+        case '\r': out << "\\r"; break;
+        case '\t': out << "\\t"; break;
+        case '\b': out << "\\b"; break;
+        case '\f': out << "\\f"; break;
+        default: out << "\\u00" << hex[c >> 4] << hex[c & 0xF]; break;
+        }
+    }
+    out.write(s.data() + start, static_cast<std::streamsize>(s.size() - start));
+    out << '"';
+}
+
+void TableWriter::columns(const RowCursor& cursor) {
+    int n = cursor.size();
+    out_ << "{\"columns\":[";
+    for (int i = 0; i < n; ++i) {
+        const char* name = cursor.name(i);
+        names_.emplace_back(name ? name : "");
+        if (i) out_ << ',';
+        write_string(out_, names_.back());
+        if (is_dict_column(names_.back())) {
+            dict_of_column_.push_back(static_cast<int>(dicts_.size()));
+            dicts_.emplace_back();
+        } else {
+            dict_of_column_.push_back(-1);
+        }
+    }
+    out_ << "],\"rows\":[";
+    header_written_ = true;
+}
+
+void TableWriter::row(const RowCursor& cursor) {
+    out_ << (any_row_ ? ",[" : "[");
+    any_row_ = true;
+    for (size_t i = 0; i < names_.size(); ++i) {
+        int col = static_cast<int>(i);
+        if (i) out_ << ',';
+        if (cursor.is_null(col)) {
+            out_ << "null";
+        } else if (dict_of_column_[i] >= 0) {
+            Dict& dict = dicts_[static_cast<size_t>(dict_of_column_[i])];
+            std::string value(cursor.text(col));
+            auto it = dict.index.find(value);
+            if (it == dict.index.end()) {
+                it = dict.index.emplace(value, dict.values.size()).first;
+                dict.values.push_back(std::move(value));
+            }
+            out_ << it->second;
+        } else if (cursor.is_integer(col)) {
+            out_ << cursor.text(col);
+        } else {
+            write_string(out_, cursor.text(col));
+        }
+    }
+    out_ << ']';
+}
+
+void TableWriter::finish() {
+    if (!header_written_) return;
+    write_dicts();
+    out_ << "}\n";
+}
+
+void TableWriter::finish(const std::optional<std::string>& next_cursor) {
+    if (!header_written_) return;
+    write_dicts();
+    out_ << ",\"nextCursor\":";
+    if (next_cursor) write_string(out_, *next_cursor);
+    else out_ << "null";
+    out_ << "}\n";
+}
+
+void TableWriter::write_dicts() {
+    out_ << "],\"dicts\":{";
+    bool first = true;
+    for (size_t i = 0; i < names_.size(); ++i) {
+        if (dict_of_column_[i] < 0) continue;
+        if (!first) out_ << ',';
+        first = false;
+        write_string(out_, names_[i]);
+        out_ << ":[";
+        const Dict& dict = dicts_[static_cast<size_t>(dict_of_column_[i])];
+        for (size_t v = 0; v < dict.values.size(); ++v) {
+            if (v) out_ << ',';
+            write_string(out_, dict.values[v]);
+        }
+        out_ << ']';
+    }
+    out_ << '}';
+}
+
+} // namespace taskman
@@ -0,0 +1,65 @@
+/**
+ * TableWriter — sortie colonnaire des listes (--format table, MCP format "columns").
+ * Responsabilité unique : écrire un résultat SELECT en JSON compact, directement depuis le
+ * curseur SQLite, sans construire de map ni de DOM nlohmann.
+ *
+ * Format : {"columns":[noms],"rows":[[valeurs],…],"dicts":{colonne:[valeurs distinctes]}}.
+ * Les colonnes status, role et creator sont encodées par dictionnaire : la cellule contient
+ * l'index de la valeur dans dicts[colonne] (null reste null). Les entiers SQLite sont écrits
+ * en nombres, le reste en chaînes. Une page (task:list --limit) ajoute "nextCursor" (jeton ou null).
+ */
+
+#ifndef TASKMAN_TABLE_WRITER_HPP
+#define TASKMAN_TABLE_WRITER_HPP
+
+#include "infrastructure/db/query_executor.hpp"
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace taskman {
+
+class TableWriter : public RowSink {
+public:
+    /** Écrit sur out ; l'objet n'est complet qu'après finish(). */
+    explicit TableWriter(std::ostream& out) : out_(out) {}
+
+    TableWriter(const TableWriter&) = delete;
+    TableWriter& operator=(const TableWriter&) = delete;
+
+    void columns(const RowCursor& cursor) override;
+    void row(const RowCursor& cursor) override;
+
+    /** Termine le tableau rows, écrit dicts puis "}\n". */
+    void finish();
+
+    /** Comme finish(), avec "nextCursor" (jeton de la page suivante, ou null) après dicts. */
+    void finish(const std::optional<std::string>& next_cursor);
+
+    /** Écrit s en chaîne JSON (guillemets et échappements compris). */
+    static void write_string(std::ostream& out, std::string_view s);
+
+private:
+    /** Termine rows et écrit ,"dicts":{…} (sans fermer l'objet). */
+    void write_dicts();
+
+    /** Dictionnaire d'une colonne encodée : valeurs dans l'ordre d'apparition. */
+    struct Dict {
+        std::vector<std::string> values;
+        std::unordered_map<std::string, size_t> index;
+    };
+
+    std::ostream& out_;
+    std::vector<std::string> names_;
+    std::vector<int> dict_of_column_;  // index dans dicts_, -1 si colonne non encodée
+    std::vector<Dict> dicts_;
+    bool header_written_ = false;
+    bool any_row_ = false;
+};
+
+} // namespace taskman
+
+#endif /* TASKMAN_TABLE_WRITER_HPP */
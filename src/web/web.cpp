@@ -1,6 +1,7 @@
 /**
  * Implémentation taskman web : serveur HTTP.
  * Utilise WebServer et les contrôleurs REST pour respecter le principe SRP.
+ * --mcp : sert aussi le protocole MCP (Streamable HTTP) sur /mcp, partagé par plusieurs agents.
  * Inclure httplib.h en premier (avant Windows.h sur Windows).
  */
 #include <httplib.h>
@@ -13,19 +14,33 @@
 #include "core/phase/phase_repository.hpp"
 #include "core/milestone/milestone_repository.hpp"
 #include "core/note/note_repository.hpp"
+#include "mcp/mcp_http_transport.hpp"
 #include <cxxopts.hpp>
+#include <cstdlib>
 #include <iostream>
+#include <memory>
 #include <string>
 
 namespace taskman {
 
+namespace {
+
+/** Obtient le chemin de la DB (identique à main.cpp), pour les connexions des sessions MCP. */
+std::string get_db_path() {
+    const char* env = std::getenv("TASKMAN_DB_NAME");
+    return (env && env[0] != '\0') ? env : "project_tasks.db";
+}
+
+} // namespace
+
 int cmd_web(int argc, char* argv[], Database& db) {
     cxxopts::Options opts("taskman web", "Start HTTP server for web UI");
     opts.add_options()
         ("host", "Bind address", cxxopts::value<std::string>()->default_value("127.0.0.1"))
         ("port", "Port", cxxopts::value<std::string>()->default_value("8080"))
         ("serve-assets-from", "Serve CSS/JS from directory (dev); default: use embedded",
-         cxxopts::value<std::string>()->default_value(""));
+         cxxopts::value<std::string>()->default_value(""))
+        ("mcp", "Also serve MCP (Streamable HTTP) on /mcp, shared by several agents");
 
     for (int i = 0; i < argc; ++i) {
         if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0) {
@@ -33,7 +48,8 @@ int cmd_web(int argc, char* argv[], Database& db) {
                       << "Examples:\n"
                       << "  taskman web\n"
                       << "  taskman web --host 127.0.0.1 --port 8080\n"
-                      << "  taskman web --serve-assets-from embed/web   # dev: edit CSS/JS and refresh\n\n";
+                      << "  taskman web --serve-assets-from embed/web   # dev: edit CSS/JS and refresh\n"
+                      << "  taskman web --mcp                           # MCP clients: http://127.0.0.1:8080/mcp\n\n";
             return 0;
         }
     }
@@ -57,6 +73,11 @@ int cmd_web(int argc, char* argv[], Database& db) {
 
     std::string assets_dir = result["serve-assets-from"].as<std::string>();
 
+    // Ouvrir la base avant les threads du serveur (main ne l'ouvre qu'à la première requête)
+    if (!db.ensure_open()) {
+        return 1;
+    }
+
     // Créer les repositories et services
     QueryExecutor& executor = db.get_executor();
     TaskRepository task_repo(executor);
@@ -70,8 +91,12 @@ int cmd_web(int argc, char* argv[], Database& db) {
     PhaseController phase_controller(phase_repo);
     MilestoneController milestone_controller(milestone_repo);
 
+    // Transport MCP : ses sessions partagent les connexions et la voie d'écriture du processus
+    std::unique_ptr<McpHttpTransport> mcp;
+    if (result.count("mcp")) mcp = std::make_unique<McpHttpTransport>(get_db_path());
+
     // Créer et démarrer le serveur web
-    WebServer server(task_controller, phase_controller, milestone_controller);
+    WebServer server(task_controller, phase_controller, milestone_controller, mcp.get());
     return server.start(host, port, assets_dir);
 }
 
@@ -9,12 +9,15 @@
 #include "core/phase/phase_repository.hpp"
 #include "core/milestone/milestone_repository.hpp"
 #include "core/note/note_repository.hpp"
+#include "util/diagnostics.hpp"
 #include "util/formats.hpp"
 #include "util/roles.hpp"
+#include "util/table_writer.hpp"
 #include <nlohmann/json.hpp>
 #include <climits>
 #include <string>
 #include <optional>
+#include <sstream>
 #include <vector>
 
 namespace taskman {
@@ -231,11 +234,47 @@ void TaskController::register_routes(httplib::Server& svr) {
             done_filter = std::nullopt;
         }
 
-        auto rows = task_repo_.list_paginated(phase, milestone, status, role, blocked_filter, done_filter, limit, offset);
+        // Projection (fields=id,title,… ; summary=1) : colonnes non demandées absentes du SELECT
+        std::optional<std::string> summary = get_optional_param(req, "summary");
+        TaskProjection projection;
+        {
+            DiagnosticCapture capture;
+            if (!TaskService::make_projection(get_optional_param(req, "fields"),
+                                              summary.has_value() && (*summary == "1" || *summary == "true"),
+                                              projection)) {
+                std::string message = capture.str();
+                while (!message.empty() && message.back() == '\n') message.pop_back();
+                nlohmann::json err;
+                err["error"] = message;
+                res.status = 400;
+                res.set_content(err.dump(), "application/json");
+                return;
+            }
+        }
+
+        // format=columns : tableau colonnaire écrit depuis le curseur SQLite (TableWriter)
+        std::optional<std::string> format = get_optional_param(req, "format");
+        if (format.has_value() && *format == "columns") {
+            std::ostringstream out;
+            TableWriter table(out);
+            if (!task_repo_.list_paginated_into(phase, milestone, status, role, blocked_filter, done_filter, limit,
+                                                offset, projection, table)) {
+                res.status = 500;
+                res.set_content(R"({"error":"query failed"})", "application/json");
+                return;
+            }
+            table.finish();
+            res.set_content(out.str(), "application/json");
+            return;
+        }
+
+        auto rows = task_repo_.list_paginated(phase, milestone, status, role, blocked_filter, done_filter, limit, offset,
+                                              projection);
         nlohmann::json arr = nlohmann::json::array();
         for (const auto& row : rows) {
             nlohmann::json obj;
-            task_to_json(obj, row);
+            if (projection.fields.empty()) task_to_json(obj, row);
+            else task_to_json(obj, row, projection.fields);
             arr.push_back(obj);
         }
         res.set_content(arr.dump(), "application/json");
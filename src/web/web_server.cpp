@@ -4,6 +4,7 @@
 
 #include "web_server.hpp"
 #include "web_controllers.hpp"
+#include "mcp/mcp_http_transport.hpp"
 #include "web_assets.generated.h"
 #include <fstream>
 #include <iostream>
@@ -53,10 +54,12 @@ namespace {
 
 WebServer::WebServer(TaskController& task_controller,
                      PhaseController& phase_controller,
-                     MilestoneController& milestone_controller)
+                     MilestoneController& milestone_controller,
+                     McpHttpTransport* mcp)
     : task_controller_(task_controller),
       phase_controller_(phase_controller),
-      milestone_controller_(milestone_controller) {}
+      milestone_controller_(milestone_controller),
+      mcp_(mcp) {}
 
 void WebServer::register_asset_routes(const std::string& assets_dir) {
     // GET /
@@ -160,13 +163,18 @@ void WebServer::register_controller_routes() {
     task_controller_.register_routes(svr_);
     phase_controller_.register_routes(svr_);
     milestone_controller_.register_routes(svr_);
+    if (mcp_) mcp_->register_routes(svr_);
 }
 
 int WebServer::start(const std::string& host, int port, const std::string& assets_dir) {
     register_asset_routes(assets_dir);
     register_controller_routes();
+    // --mcp : pool agrandi pour les flux SSE (partagé avec l'interface web) ; sinon pool par défaut de httplib
+    if (mcp_) svr_.new_task_queue = [] { return new httplib::ThreadPool(McpHttpTransport::HTTP_THREADS); };
 
     std::cout << "taskman web: http://" << host << ":" << port << "/\n";
+    if (mcp_) std::cout << "taskman mcp: http://" << host << ":" << port << McpHttpTransport::ENDPOINT << "\n";
+    std::cout.flush();
     if (!svr_.listen(host.c_str(), port)) {
         std::cerr << "taskman: cannot bind " << host << ":" << port << "\n";
         return 1;
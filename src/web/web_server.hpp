@@ -1,6 +1,7 @@
 /**
  * WebServer — infrastructure HTTP uniquement.
  * Responsabilité unique : gestion du serveur HTTP, routage de base, gestion des assets statiques.
+ * Le transport MCP Streamable HTTP (/mcp), s'il est fourni, est servi par le même serveur.
  * Respecte le principe SRP (Single Responsibility Principle).
  */
 
@@ -15,6 +16,7 @@ namespace taskman {
 class TaskController;
 class PhaseController;
 class MilestoneController;
+class McpHttpTransport;
 
 /**
  * Serveur web qui gère uniquement l'infrastructure HTTP.
@@ -22,10 +24,11 @@ class MilestoneController;
  */
 class WebServer {
 public:
-    /** Constructeur prenant les contrôleurs nécessaires. */
+    /** Constructeur prenant les contrôleurs nécessaires ; mcp : transport MCP optionnel (taskman web --mcp). */
     WebServer(TaskController& task_controller,
               PhaseController& phase_controller,
-              MilestoneController& milestone_controller);
+              MilestoneController& milestone_controller,
+              McpHttpTransport* mcp = nullptr);
 
     WebServer(const WebServer&) = delete;
     WebServer& operator=(const WebServer&) = delete;
@@ -45,6 +48,7 @@ private:
     TaskController& task_controller_;
     PhaseController& phase_controller_;
     MilestoneController& milestone_controller_;
+    McpHttpTransport* mcp_;
 };
 
 } // namespace taskman
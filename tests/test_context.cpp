@@ -0,0 +1,187 @@
+/**
+ * Tests unitaires — ContextService, ContextFormatter, cmd_context.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "infrastructure/db/db.hpp"
+#include "core/context/context.hpp"
+#include "core/context/context_formatter.hpp"
+#include "core/context/context_service.hpp"
+#include "core/milestone/milestone.hpp"
+#include "core/note/note.hpp"
+#include "core/phase/phase.hpp"
+#include "core/task/task.hpp"
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace taskman;
+
+struct CoutRedirect {
+    std::streambuf* prev;
+    std::stringstream buf;
+    CoutRedirect() : prev(std::cout.rdbuf()) { std::cout.rdbuf(buf.rdbuf()); }
+    ~CoutRedirect() { std::cout.rdbuf(prev); }
+    std::string str() const { return buf.str(); }
+};
+
+/** P1 (jalon M1 : t1 done, t2 in_progress) ; P2 (t3 to_do prête, t4 to_do bloquée par t2, t5 done). */
+static void setup_db(Database& db) {
+    REQUIRE(db.open(":memory:"));
+    REQUIRE(db.init_schema());
+    REQUIRE(phase_add(db, "P1", "Conception", "in_progress", 1));
+    REQUIRE(phase_add(db, "P2", "Développement", "to_do", 2));
+    REQUIRE(milestone_add(db, "M1", "P1", std::string("Specs validées")));
+    REQUIRE(task_add(db, "t1", "P1", std::string("M1"), "Rédiger les specs", std::nullopt, "done", 1,
+                     std::string("project-designer")));
+    REQUIRE(task_add(db, "t2", "P1", std::string("M1"), "Valider les specs", std::nullopt, "in_progress", 2,
+                     std::string("developer")));
+    REQUIRE(task_add(db, "t3", "P2", std::nullopt, "Initialiser le dépôt", std::nullopt, "to_do", 1,
+                     std::string("developer")));
+    REQUIRE(task_add(db, "t4", "P2", std::nullopt, "Écran de connexion", std::nullopt, "to_do", 2,
+                     std::string("developer")));
+    REQUIRE(task_add(db, "t5", "P2", std::nullopt, "Choix du framework", std::nullopt, "done", 3,
+                     std::string("software-architect")));
+    REQUIRE(task_dep_add(db, "t4", "t2"));
+    REQUIRE(note_add(db, "n1", "t2", "Relecture planifiée", std::string("progress"), std::string("developer")));
+    REQUIRE(note_add(db, "n2", "t2", "Un point ouvert sur les messages d'erreur", std::string("progress"),
+                     std::string("developer")));
+}
+
+static std::vector<std::string> ids_of(const nlohmann::json& section) {
+    std::vector<std::string> ids;
+    for (const auto& item : section["items"]) ids.push_back(item["id"].get<std::string>());
+    return ids;
+}
+
+static int run_context(Database& db, std::vector<std::string> args, std::string& out) {
+    std::vector<std::string> full = {"context"};
+    for (auto& a : args) full.push_back(a);
+    std::vector<char*> ptrs;
+    for (auto& s : full) ptrs.push_back(s.data());
+    CoutRedirect redir;
+    int r = cmd_context(static_cast<int>(ptrs.size()), ptrs.data(), db);
+    out = redir.str();
+    return r;
+}
+
+TEST_CASE("ContextService — sections prêtes, en cours, bloquées", "[context]") {
+    Database db;
+    setup_db(db);
+    ContextService service(db.get_executor());
+    ProjectContext context;
+    REQUIRE(service.load(std::nullopt, ContextService::DEFAULT_LIMIT, context));
+    auto ctx = ContextFormatter::to_json(context);
+
+    REQUIRE(ctx["role"].is_null());
+    REQUIRE(ids_of(ctx["ready"]) == std::vector<std::string>{"t3"});
+    REQUIRE(ctx["ready"]["total"] == 1);
+    REQUIRE(ids_of(ctx["in_progress"]) == std::vector<std::string>{"t2"});
+    REQUIRE(ids_of(ctx["blocked"]) == std::vector<std::string>{"t4"});
+
+    // Dernière note de la tâche en cours, sans task_id
+    const auto& note = ctx["in_progress"]["items"][0]["latest_note"];
+    REQUIRE(note["id"] == "n2");
+    REQUIRE(note["kind"] == "progress");
+    REQUIRE_FALSE(note.contains("task_id"));
+
+    // Dépendances non terminées de la tâche bloquée
+    const auto& blocked = ctx["blocked"]["items"][0];
+    REQUIRE(blocked["blocked_by_total"] == 1);
+    REQUIRE(blocked["blocked_by"][0]["id"] == "t2");
+    REQUIRE(blocked["blocked_by"][0]["status"] == "in_progress");
+}
+
+TEST_CASE("ContextService — arbre des phases et avancement", "[context]") {
+    Database db;
+    setup_db(db);
+    ContextService service(db.get_executor());
+    ProjectContext context;
+    REQUIRE(service.load(std::nullopt, ContextService::DEFAULT_LIMIT, context));
+    auto ctx = ContextFormatter::to_json(context);
+
+    REQUIRE(ctx["phases"]["total"] == 2);
+    const auto& p1 = ctx["phases"]["items"][0];
+    REQUIRE(p1["id"] == "P1");
+    REQUIRE(p1["progress"] == nlohmann::json({{"total", 2}, {"to_do", 0}, {"in_progress", 1}, {"done", 1}}));
+    REQUIRE(p1["milestones_total"] == 1);
+    REQUIRE(p1["milestones"][0]["id"] == "M1");
+    REQUIRE(p1["milestones"][0]["progress"]["done"] == 1);
+    const auto& p2 = ctx["phases"]["items"][1];
+    REQUIRE(p2["progress"] == nlohmann::json({{"total", 3}, {"to_do", 2}, {"in_progress", 0}, {"done", 1}}));
+    REQUIRE(p2["milestones"].empty());
+}
+
+TEST_CASE("ContextService — jalons plafonnés par phase", "[context]") {
+    Database db;
+    setup_db(db);
+    for (int i = 0; i < ContextService::MILESTONE_LIMIT + 2; ++i) {
+        REQUIRE(milestone_add(db, "M2-" + std::to_string(100 + i), "P2", std::nullopt));
+    }
+    ContextService service(db.get_executor());
+    ProjectContext context;
+    REQUIRE(service.load(std::nullopt, ContextService::DEFAULT_LIMIT, context));
+    auto ctx = ContextFormatter::to_json(context);
+
+    const auto& p1 = ctx["phases"]["items"][0];
+    REQUIRE(p1["milestones_total"] == 1);
+    REQUIRE(p1["milestones"].size() == 1);
+    const auto& p2 = ctx["phases"]["items"][1];
+    REQUIRE(p2["milestones_total"] == ContextService::MILESTONE_LIMIT + 2);
+    REQUIRE(p2["milestones"].size() == static_cast<size_t>(ContextService::MILESTONE_LIMIT));
+    REQUIRE(p2["milestones"][0]["id"] == "M2-100");
+}
+
+TEST_CASE("ContextService — filtre par rôle et troncature", "[context]") {
+    Database db;
+    setup_db(db);
+    ContextService service(db.get_executor());
+    ProjectContext context;
+
+    REQUIRE(service.load(std::string("software-architect"), ContextService::DEFAULT_LIMIT, context));
+    auto ctx = ContextFormatter::to_json(context);
+    REQUIRE(ctx["role"] == "software-architect");
+    REQUIRE(ctx["ready"]["items"].empty());
+    REQUIRE(ctx["in_progress"]["total"] == 0);
+    // L'avancement reste global
+    REQUIRE(ctx["phases"]["items"][1]["progress"]["total"] == 3);
+
+    REQUIRE(task_add(db, "t6", "P2", std::nullopt, "Configurer la CI", std::nullopt, "to_do", 4,
+                     std::string("developer")));
+    REQUIRE(service.load(std::string("developer"), 1, context));
+    ctx = ContextFormatter::to_json(context);
+    REQUIRE(ids_of(ctx["ready"]) == std::vector<std::string>{"t3"});
+    REQUIRE(ctx["ready"]["total"] == 2);
+}
+
+TEST_CASE("ContextService — rôle ou limite invalides", "[context]") {
+    Database db;
+    setup_db(db);
+    ContextService service(db.get_executor());
+    ProjectContext context;
+    REQUIRE_FALSE(service.load(std::string("invalid-role"), ContextService::DEFAULT_LIMIT, context));
+    REQUIRE_FALSE(service.load(std::nullopt, 0, context));
+    REQUIRE_FALSE(service.load(std::nullopt, ContextService::MAX_LIMIT + 1, context));
+}
+
+TEST_CASE("cmd_context — JSON et texte", "[context]") {
+    Database db;
+    setup_db(db);
+    std::string out;
+    REQUIRE(run_context(db, {"--role", "developer", "--limit", "5"}, out) == 0);
+    auto ctx = nlohmann::json::parse(out);
+    REQUIRE(ctx["role"] == "developer");
+    REQUIRE(ids_of(ctx["ready"]) == std::vector<std::string>{"t3"});
+
+    REQUIRE(run_context(db, {"--format", "text"}, out) == 0);
+    REQUIRE(out.find("role: all\n") == 0);
+    REQUIRE(out.find("ready (1):\n  - t3 Initialiser le dépôt (developer)\n") != std::string::npos);
+    REQUIRE(out.find("latest note (progress): Un point ouvert") != std::string::npos);
+    REQUIRE(out.find("blocked by t2 Valider les specs [in_progress]") != std::string::npos);
+
+    REQUIRE(run_context(db, {"--limit", "abc"}, out) == 1);
+    REQUIRE(run_context(db, {"--format", "yaml"}, out) == 1);
+}
@@ -4,6 +4,9 @@
 
 #include <catch2/catch_test_macros.hpp>
 #include "infrastructure/db/db.hpp"
+#include "infrastructure/db/bulk_load.hpp"
+#include "util/entity_fields.hpp"
+#include "infrastructure/db/data_version.hpp"
 
 using namespace taskman;
 
@@ -120,6 +123,46 @@ TEST_CASE("Database::query avec paramètres", "[db]") {
     REQUIRE(rows[0]["n"] == "2");
 }
 
+TEST_CASE("QueryExecutor — requêtes préparées réutilisées par connexion", "[db]") {
+    DatabaseConnection connection;
+    QueryExecutor executor(connection);
+    REQUIRE(connection.open(":memory:"));
+    REQUIRE(executor.exec("CREATE TABLE t(x TEXT)"));
+
+    const char* insert = "INSERT INTO t(x) VALUES (?)";
+    REQUIRE(executor.run(insert, {std::string("a")}));
+    REQUIRE(executor.run(insert, {std::nullopt}));  // bindings effacés au retour dans le cache
+    REQUIRE(connection.cached_statements() == 1);
+    REQUIRE(executor.query("SELECT COUNT(*) AS n FROM t WHERE x IS NULL")[0]["n"] == "1");
+
+    SECTION("même SELECT imbriqué dans un RowSink") {
+        struct Nested : RowSink {
+            QueryExecutor& executor;
+            size_t inner = 0;
+            explicit Nested(QueryExecutor& e) : executor(e) {}
+            void row(const RowCursor&) override { inner += executor.query("SELECT x FROM t").size(); }
+        } sink(executor);
+        REQUIRE(executor.query_into("SELECT x FROM t", {}, sink));
+        REQUIRE(sink.inner == 4u);
+    }
+
+    SECTION("changement de schéma") {
+        REQUIRE(executor.query("SELECT * FROM t")[0].size() == 1);
+        REQUIRE(executor.exec("ALTER TABLE t ADD COLUMN y INT"));
+        REQUIRE(executor.query("SELECT * FROM t")[0].size() == 2);
+    }
+
+    SECTION("taille bornée, cache vidé à la fermeture") {
+        for (size_t i = 0; i < STATEMENT_CACHE_SIZE + 10; ++i) {
+            REQUIRE(executor.query(("SELECT " + std::to_string(i) + " AS n").c_str())[0]["n"] == std::to_string(i));
+        }
+        REQUIRE(connection.cached_statements() == STATEMENT_CACHE_SIZE);
+        connection.close();
+        REQUIRE(!connection.is_open());
+        REQUIRE(connection.cached_statements() == 0);
+    }
+}
+
 TEST_CASE("init_schema crée les 4 tables", "[db]") {
     Database db;
     REQUIRE(db.open(":memory:"));
@@ -135,6 +178,108 @@ TEST_CASE("init_schema crée les 4 tables", "[db]") {
     REQUIRE(rows.size() == 4u);
 }
 
+TEST_CASE("Descripteurs de champs — colonnes et types du schéma", "[db]") {
+    Database db;
+    REQUIRE(db.open(":memory:"));
+    REQUIRE(db.init_schema());
+
+    auto check = [&db](const char* table, const auto& fields) {
+        auto rows = db.query((std::string("PRAGMA table_info(") + table + ")").c_str());
+        std::map<std::string, std::string> types;
+        for (auto& row : rows) types[row["name"].value_or("")] = row["type"].value_or("");
+        for (const auto& field : fields) {
+            if (!field.sql_type) continue;
+            INFO(table << "." << field.column);
+            REQUIRE(types.count(std::string(field.column)) == 1);
+            REQUIRE(types[std::string(field.column)] == field.sql_type);
+        }
+    };
+    check("phases", PHASE_FIELDS);
+    check("milestones", MILESTONE_FIELDS);
+    check("tasks", TASK_FIELDS);
+    check("task_notes", NOTE_FIELDS);
+
+    REQUIRE(std::string(select_list<PHASE_FIELDS>()) == "id, name, status, sort_order, created_at, updated_at");
+    REQUIRE(std::string(select_list<TASK_FIELDS>()) ==
+            "id, phase_id, milestone_id, title, description, status, sort_order, role, creator, created_at, updated_at");
+}
+
+TEST_CASE("init_schema crée l'index inverse task_deps(depends_on)", "[db]") {
+    Database db;
+    REQUIRE(db.open(":memory:"));
+    REQUIRE(db.init_schema());
+    auto rows = db.query("SELECT name FROM sqlite_master WHERE type='index' AND name = 'idx_task_deps_depends_on'");
+    REQUIRE(rows.size() == 1u);
+    // Idempotent : un second init ne doit pas échouer
+    REQUIRE(db.init_schema());
+}
+
+TEST_CASE("BulkLoad — index et triggers recréés sans finish()", "[db]") {
+    Database db;
+    REQUIRE(db.open(":memory:"));
+    REQUIRE(db.init_schema());
+    const char* objects = "SELECT COUNT(*) AS n FROM sqlite_master WHERE name IN ('trg_tasks_INSERT_version', "
+                          "'idx_tasks_list_order', 'idx_task_deps_depends_on', 'idx_task_notes_task_id')";
+    REQUIRE(db.query(objects)[0]["n"] == "4");
+    DataVersion version(db.get_executor());
+    auto before = version.token();
+    {
+        BulkLoad bulk_load(db);
+        REQUIRE(bulk_load.active());
+        REQUIRE(db.query(objects)[0]["n"] == "0");
+        // Retour anticipé (erreur d'insertion) : pas de finish()
+    }
+    REQUIRE(db.query(objects)[0]["n"] == "4");
+    REQUIRE(version.token() != before);
+    // Trigger INSERT de tasks recréé : une insertion de tâche change de nouveau le jeton
+    REQUIRE(db.exec("INSERT INTO phases (id, name) VALUES ('P1', 'Phase')"));
+    auto after = version.token();
+    REQUIRE(db.exec("INSERT INTO tasks (id, phase_id, title) VALUES ('t1', 'P1', 'Task')"));
+    REQUIRE(version.token() != after);
+
+    BulkLoad finished(db);
+    REQUIRE(finished.finish());
+    REQUIRE(!finished.active());
+    REQUIRE(finished.finish());  // déjà terminé
+}
+
+TEST_CASE("DataVersion — le jeton change à chaque écriture", "[db]") {
+    Database db;
+    REQUIRE(db.open(":memory:"));
+    REQUIRE(db.init_schema());
+    DataVersion data_version(db.get_executor());
+    auto initial = data_version.token();
+    REQUIRE(initial.has_value());
+    // Lecture et second init : jeton inchangé
+    db.query("SELECT * FROM tasks");
+    REQUIRE(db.init_schema());
+    REQUIRE(data_version.token() == initial);
+
+    std::vector<std::string> seen = {*initial};
+    auto changed = [&](const char* sql) {
+        REQUIRE(db.exec(sql));
+        auto token = data_version.token();
+        REQUIRE(token.has_value());
+        for (const auto& t : seen) REQUIRE(*token != t);
+        seen.push_back(*token);
+    };
+    changed("INSERT INTO phases (id, name) VALUES ('p1', 'Phase 1')");
+    changed("INSERT INTO milestones (id, phase_id) VALUES ('m1', 'p1')");
+    changed("INSERT INTO tasks (id, phase_id, title) VALUES ('t1', 'p1', 'Tâche')");
+    changed("INSERT INTO tasks (id, phase_id, title) VALUES ('t2', 'p1', 'Tâche 2')");
+    changed("UPDATE tasks SET status = 'done' WHERE id = 't1'");
+    changed("INSERT INTO task_deps (task_id, depends_on) VALUES ('t2', 't1')");
+    changed("DELETE FROM task_deps");
+    changed("INSERT INTO task_notes (id, task_id, content) VALUES ('n1', 't1', 'Fait')");
+}
+
+TEST_CASE("DataVersion — sans compteur (base antérieure)", "[db]") {
+    Database db;
+    REQUIRE(db.open(":memory:"));
+    DataVersion data_version(db.get_executor());
+    REQUIRE_FALSE(data_version.token().has_value());
+}
+
 TEST_CASE("init_schema échoue si DB non ouverte", "[db]") {
     Database db;
     REQUIRE(!db.init_schema());
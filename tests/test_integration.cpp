@@ -8,6 +8,8 @@
 #include <cstdio>
 #include <cstdlib>
 #include <filesystem>
+#include <fstream>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -174,6 +176,49 @@ TEST_CASE("integration — TASKMAN_JOURNAL_MEMORY=1 (init, phase:add, phase:list
     REQUIRE(out.find("p1") != std::string::npos);
 }
 
+TEST_CASE("integration — lecture conditionnelle --if-none-match", "[integration]") {
+    std::string exe = get_taskman_path();
+    if (exe.empty())
+        SKIP("taskman executable not found (build taskman first, or set TASKMAN_EXE)");
+
+    std::string db = (fs::temp_directory_path() / "taskman_int_6.db").string();
+    fs::remove(db);
+
+    int code;
+    std::string out;
+    std::tie(code, out) = run_taskman(exe, db, {"init"});
+    REQUIRE(code == 0);
+    std::tie(code, out) = run_taskman(exe, db, {"phase:add", "--id", "p1", "--name", "P1"});
+    REQUIRE(code == 0);
+
+    // Premier appel : jeton vide → résultat complet et version
+    std::tie(code, out) = run_taskman(exe, db, {"phase:list", "--if-none-match", "\"\""});
+    REQUIRE(code == 0);
+    auto j = nlohmann::json::parse(out);
+    REQUIRE(j["unchanged"] == false);
+    REQUIRE(j["result"][0]["id"] == "p1");
+    std::string version = j["version"].get<std::string>();
+
+    // Rien n'a changé : réponse réduite, quelle que soit la commande de lecture
+    std::tie(code, out) = run_taskman(exe, db, {"task:list", "--if-none-match", version});
+    REQUIRE(code == 0);
+    REQUIRE(nlohmann::json::parse(out) == nlohmann::json({{"unchanged", true}, {"version", version}}));
+
+    // Écriture : nouveau jeton et résultat (texte enveloppé comme chaîne)
+    std::tie(code, out) = run_taskman(exe, db, {"task:add", "--title", "T1", "--phase", "p1"});
+    REQUIRE(code == 0);
+    std::tie(code, out) = run_taskman(exe, db, {"task:list", "--format", "text", "--if-none-match=" + version});
+    REQUIRE(code == 0);
+    j = nlohmann::json::parse(out);
+    REQUIRE(j["unchanged"] == false);
+    REQUIRE(j["version"] != version);
+    REQUIRE(j["result"].get<std::string>().find("T1") != std::string::npos);
+
+    // Erreur de la commande : pas d'enveloppe
+    std::tie(code, out) = run_taskman(exe, db, {"task:get", "unknown", "--if-none-match", version});
+    REQUIRE(code == 1);
+}
+
 TEST_CASE("integration — commande inconnue → exit 1", "[integration]") {
     std::string exe = get_taskman_path();
     if (exe.empty())
@@ -189,3 +234,147 @@ TEST_CASE("integration — commande inconnue → exit 1", "[integration]") {
     REQUIRE(code == 1);
     REQUIRE(out.find("Unknown command") != std::string::npos);
 }
+
+TEST_CASE("integration — ouverture différée : arguments invalides sans créer la base", "[integration]") {
+    std::string exe = get_taskman_path();
+    if (exe.empty())
+        SKIP("taskman executable not found (build taskman first, or set TASKMAN_EXE)");
+
+    std::string db = (fs::temp_directory_path() / "taskman_int_deferred.db").string();
+    fs::remove(db);
+
+    int code;
+    std::string out;
+    std::tie(code, out) = run_taskman(exe, db, {"task:get"});
+    REQUIRE(code == 1);
+    std::tie(code, out) = run_taskman(exe, db, {"task:list", "--help"});
+    REQUIRE(code == 0);
+    REQUIRE_FALSE(fs::exists(db));
+
+    // Première requête : la base est ouverte (et créée)
+    std::tie(code, out) = run_taskman(exe, db, {"init"});
+    REQUIRE(code == 0);
+    REQUIRE(fs::exists(db));
+
+    // Base impossible à ouvrir : exit 1
+    std::string missing_dir = (fs::temp_directory_path() / "taskman_int_no_such_dir" / "x.db").string();
+    std::tie(code, out) = run_taskman(exe, missing_dir, {"phase:list"});
+    REQUIRE(code == 1);
+}
+
+TEST_CASE("integration — batch : plusieurs commandes dans un processus", "[integration]") {
+    std::string exe = get_taskman_path();
+    if (exe.empty())
+        SKIP("taskman executable not found (build taskman first, or set TASKMAN_EXE)");
+
+    std::string db = (fs::temp_directory_path() / "taskman_int_batch.db").string();
+    std::string input = (fs::temp_directory_path() / "taskman_int_batch.txt").string();
+    fs::remove(db);
+    auto write_input = [&input](const std::string& text) {
+        std::ofstream(input, std::ios::binary) << text;
+    };
+    auto result_lines = [](const std::string& out) {
+        std::vector<nlohmann::json> lines;
+        std::istringstream in(out);
+        std::string line;
+        while (std::getline(in, line)) {
+            if (!line.empty() && line[0] == '{') lines.push_back(nlohmann::json::parse(line));
+        }
+        return lines;
+    };
+
+    write_input("init\n"
+                "phase:add --id p1 --name 'Phase one'\n"
+                "# commentaire\n"
+                "\n"
+                "[\"phase:list\"]\n"
+                "taskman phase:list --help\n"
+                "no:such:command\n"
+                "phase:add --id \"p2\n");
+    int code;
+    std::string out;
+    std::tie(code, out) = run_taskman(exe, db, {"batch", "<", input});
+    REQUIRE(code == 1);
+    auto lines = result_lines(out);
+    REQUIRE(lines.size() == 6u);
+    REQUIRE(lines[0]["line"] == 1);
+    REQUIRE(lines[0]["exit_code"] == 0);
+    REQUIRE(lines[1]["command"] == "phase:add");
+    REQUIRE(lines[1]["result"]["name"] == "Phase one");
+    REQUIRE(lines[2]["line"] == 5);
+    REQUIRE(lines[2]["result"].is_array());
+    REQUIRE(lines[2]["result"].size() == 1u);
+    REQUIRE(lines[3]["result"].is_string());
+    REQUIRE(lines[4]["exit_code"] == 1);
+    REQUIRE(lines[4]["error"].get<std::string>().find("unknown command") != std::string::npos);
+    REQUIRE(lines[5]["error"].get<std::string>().find("unterminated quote") != std::string::npos);
+
+    // --transaction : tout ou rien, arrêt au premier échec
+    write_input("phase:add --id p3 --name Three\n"
+                "phase:add --id p4\n"
+                "phase:add --id p4 --name Four\n");
+    std::tie(code, out) = run_taskman(exe, db, {"batch", "--transaction", "<", input});
+    REQUIRE(code == 1);
+    REQUIRE(result_lines(out).size() == 2u);
+    REQUIRE(out.find("rolled back") != std::string::npos);
+    std::tie(code, out) = run_taskman(exe, db, {"phase:list"});
+    REQUIRE(code == 0);
+    REQUIRE(out.find("p3") == std::string::npos);
+
+    write_input("phase:add --id p3 --name Three\n"
+                "[\"phase:edit\", \"p3\", \"--status\", \"done\"]\n");
+    std::tie(code, out) = run_taskman(exe, db, {"batch", "--transaction", "<", input});
+    REQUIRE(code == 0);
+    std::tie(code, out) = run_taskman(exe, db, {"phase:list"});
+    REQUIRE(out.find("p3") != std::string::npos);
+    REQUIRE(out.find("done") != std::string::npos);
+    fs::remove(input);
+}
+
+TEST_CASE("integration — demo:generate --scale : projet synthétique reproductible", "[integration]") {
+    std::string exe = get_taskman_path();
+    if (exe.empty())
+        SKIP("taskman executable not found (build taskman first, or set TASKMAN_EXE)");
+
+    std::string db1 = (fs::temp_directory_path() / "taskman_int_scale_1.db").string();
+    std::string db2 = (fs::temp_directory_path() / "taskman_int_scale_2.db").string();
+    const std::vector<std::string> generate = {"demo:generate", "--scale", "--phases", "3", "--milestones", "2",
+                                               "--tasks", "250", "--deps", "2", "--notes", "1.5", "--seed", "9"};
+    const std::vector<std::string> list = {"task:list", "--format", "ndjson",
+                                           "--fields", "id,phase_id,milestone_id,title,status,sort_order,role"};
+    int code;
+    std::string out, out2;
+    std::tie(code, out) = run_taskman(exe, db1, generate);
+    REQUIRE(code == 0);
+    REQUIRE(out.find("tasks 250/250") != std::string::npos);
+    std::tie(code, out) = run_taskman(exe, db2, generate);
+    REQUIRE(code == 0);
+
+    // Même graine et mêmes options : mêmes tâches, UUID compris
+    std::tie(code, out) = run_taskman(exe, db1, list);
+    REQUIRE(code == 0);
+    std::tie(code, out2) = run_taskman(exe, db2, list);
+    REQUIRE(out == out2);
+    size_t lines = 0;
+    std::istringstream in(out);
+    std::string line;
+    while (std::getline(in, line)) {
+        auto task = nlohmann::json::parse(line);
+        REQUIRE(task["id"].get<std::string>().size() == 36u);
+        REQUIRE(task["milestone_id"].is_string());
+        ++lines;
+    }
+    REQUIRE(lines == 250u);
+    std::tie(code, out) = run_taskman(exe, db1, {"phase:list"});
+    REQUIRE(nlohmann::json::parse(out).size() == 3u);
+    std::tie(code, out) = run_taskman(exe, db1, {"task:list", "--blocked-filter", "blocked", "--fields", "id"});
+    REQUIRE(code == 0);
+    REQUIRE_FALSE(nlohmann::json::parse(out).empty());
+
+    // Options d'échelle sans --scale, ou hors bornes : refusées
+    std::tie(code, out) = run_taskman(exe, db1, {"demo:generate", "--tasks", "10"});
+    REQUIRE(code == 1);
+    REQUIRE(out.find("requires --scale") != std::string::npos);
+    std::tie(code, out) = run_taskman(exe, db1, {"demo:generate", "--scale", "--tasks", "0"});
+    REQUIRE(code == 1);
+}
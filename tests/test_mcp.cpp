@@ -1,16 +1,24 @@
 /**
  * Tests unitaires et d'intégration — serveur MCP (tools/list, tools/call, ping, erreurs JSON-RPC).
- * Tests d'intégration via subprocess (taskman mcp) avec pipes stdin/stdout.
+ * Tests d'intégration via subprocess (taskman mcp) avec pipes stdin/stdout ; transport HTTP
+ * via taskman web --mcp et un client httplib local.
  */
 
+#include <httplib.h>
 #include <catch2/catch_test_macros.hpp>
+#include "mcp/mcp_protocol_handler.hpp"
+#include "mcp/mcp_tool_stats.hpp"
 #include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <filesystem>
 #include <fstream>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 #ifdef _WIN32
@@ -21,6 +29,8 @@
 #endif
 
 namespace fs = std::filesystem;
+using taskman::McpProtocolHandler;
+using taskman::McpToolStats;
 
 static std::string get_taskman_path() {
     const char* env = std::getenv("TASKMAN_EXE");
@@ -121,6 +131,60 @@ static std::string run_mcp_request_bidirectional(const std::string& taskman_exe,
     return out;
 }
 
+/** Envoie plusieurs requêtes à un même processus taskman mcp ; retourne une réponse par ligne,
+ * triées par id (les lectures concurrentes peuvent se terminer dans le désordre).
+ * between (optionnel) : commande shell exécutée entre deux requêtes (POSIX uniquement). */
+static std::vector<nlohmann::json> run_mcp_session(const std::string& taskman_exe,
+                                                   const std::string& db_path,
+                                                   const std::vector<nlohmann::json>& requests,
+                                                   const std::string& between = "") {
+#ifdef _WIN32
+    _putenv_s("TASKMAN_DB_NAME", db_path.c_str());
+#else
+    setenv("TASKMAN_DB_NAME", db_path.c_str(), 1);
+#endif
+    std::vector<std::string> files;
+    std::string script;
+    for (size_t i = 0; i < requests.size(); ++i) {
+        std::string tmp = (fs::temp_directory_path() / ("mcp_session_" + std::to_string(i) + ".json")).string();
+        std::ofstream f(tmp);
+        f << requests[i].dump() << "\n";
+        files.push_back(tmp);
+        if (i && !between.empty()) script += between + "; ";
+        script += "cat \"" + tmp + "\"; ";
+    }
+    std::string cmd = "{ " + script + "} | \"" + taskman_exe + "\" mcp";
+    FILE* f = popen(cmd.c_str(), "r");
+    std::vector<nlohmann::json> out;
+    if (f) {
+        std::string line;
+        char buf[4096];
+        while (fgets(buf, sizeof(buf), f)) {
+            line += buf;
+            if (!line.empty() && line.back() == '\n') {
+                out.push_back(nlohmann::json::parse(line));
+                line.clear();
+            }
+        }
+        pclose(f);
+    }
+    for (const auto& p : files) fs::remove(p);
+    std::stable_sort(out.begin(), out.end(), [](const nlohmann::json& a, const nlohmann::json& b) {
+        return a.value("id", nlohmann::json()) < b.value("id", nlohmann::json());
+    });
+    return out;
+}
+
+static nlohmann::json tool_call(int id, const std::string& name, const nlohmann::json& arguments = nlohmann::json::object()) {
+    nlohmann::json req;
+    req["jsonrpc"] = "2.0";
+    req["id"] = id;
+    req["method"] = "tools/call";
+    req["params"]["name"] = name;
+    req["params"]["arguments"] = arguments;
+    return req;
+}
+
 TEST_CASE("MCP — initialize", "[mcp][integration]") {
     std::string exe = get_taskman_path();
     if (exe.empty())
@@ -219,7 +283,7 @@ TEST_CASE("MCP — tools/list", "[mcp][integration]") {
     REQUIRE(resp.contains("result"));
     REQUIRE(resp["result"].contains("tools"));
     REQUIRE(resp["result"]["tools"].is_array());
-    REQUIRE(resp["result"]["tools"].size() == 20u);
+    REQUIRE(resp["result"]["tools"].size() == 26u);
 
     // Vérifier quelques outils
     bool found_init = false, found_phase_add = false, found_task_list = false, found_demo_generate = false;
@@ -478,3 +542,969 @@ TEST_CASE("MCP — parse error (JSON invalide)", "[mcp][integration]") {
     REQUIRE(resp["error"]["code"] == -32700);
     REQUIRE(resp["error"]["message"] == "Parse error");
 }
+
+TEST_CASE("MCP — connexion persistante : demo:generate puis lecture", "[mcp][integration]") {
+    std::string exe = get_taskman_path();
+    if (exe.empty())
+        SKIP("taskman executable not found");
+#ifdef _WIN32
+    SKIP("session shell pipeline is POSIX only");
+#else
+    std::string db = (fs::temp_directory_path() / "taskman_mcp_persist.db").string();
+    fs::remove(db);
+
+    auto responses = run_mcp_session(exe, db, {
+        tool_call(1, "taskman_init"),
+        tool_call(2, "taskman_phase_list"),
+        tool_call(3, "taskman_demo_generate"),
+        tool_call(4, "taskman_phase_list"),
+    });
+    REQUIRE(responses.size() == 4u);
+    REQUIRE(responses[1]["result"]["isError"] == false);
+    REQUIRE(nlohmann::json::parse(responses[1]["result"]["content"][0]["text"].get<std::string>()).empty());
+    REQUIRE(responses[2]["result"]["isError"] == false);
+    REQUIRE(responses[3]["result"]["isError"] == false);
+    auto phases = nlohmann::json::parse(responses[3]["result"]["content"][0]["text"].get<std::string>());
+    REQUIRE(phases.size() == 4u);
+    fs::remove(db);
+#endif
+}
+
+TEST_CASE("MCP — connexion persistante : fichier remplacé pendant la session", "[mcp][integration]") {
+    std::string exe = get_taskman_path();
+    if (exe.empty())
+        SKIP("taskman executable not found");
+#ifdef _WIN32
+    SKIP("replacing an open SQLite file is POSIX only");
+#else
+    std::string db = (fs::temp_directory_path() / "taskman_mcp_replace.db").string();
+    std::string other = (fs::temp_directory_path() / "taskman_mcp_replace_other.db").string();
+    fs::remove(db);
+    fs::remove(other);
+    setenv("TASKMAN_DB_NAME", other.c_str(), 1);
+    std::string setup = "\"" + exe + "\" init && \"" + exe + "\" phase:add --id Q1 --name Other > /dev/null";
+    REQUIRE(std::system(setup.c_str()) == 0);
+
+    auto responses = run_mcp_session(exe, db, {
+        tool_call(1, "taskman_init"),
+        tool_call(2, "taskman_phase_list"),
+    }, "sleep 0.3; mv \"" + other + "\" \"" + db + "\"");
+    REQUIRE(responses.size() == 2u);
+    auto phases = nlohmann::json::parse(responses[1]["result"]["content"][0]["text"].get<std::string>());
+    REQUIRE(phases.size() == 1u);
+    REQUIRE(phases[0]["id"] == "Q1");
+    fs::remove(db);
+#endif
+}
+
+TEST_CASE("MCP — handlers typés : structuredContent", "[mcp][integration]") {
+    std::string exe = get_taskman_path();
+    if (exe.empty())
+        SKIP("taskman executable not found");
+#ifdef _WIN32
+    SKIP("session shell pipeline is POSIX only");
+#else
+    std::string db = (fs::temp_directory_path() / "taskman_mcp_typed.db").string();
+    fs::remove(db);
+
+    auto responses = run_mcp_session(exe, db, {
+        tool_call(1, "taskman_init"),
+        tool_call(2, "taskman_phase_add", {{"id", "P1"}, {"name", "Phase 1"}}),
+        tool_call(3, "taskman_task_add", {{"title", "A"}, {"phase", "P1"}, {"sort-order", 10}}),
+        tool_call(4, "taskman_task_list", {{"phase", "P1"}}),
+        tool_call(5, "taskman_task_get", {{"id", "missing"}}),
+        tool_call(6, "taskman_task_list", {{"format", "text"}}),
+        tool_call(7, "taskman_phase_list"),
+    });
+    REQUIRE(responses.size() == 7u);
+
+    // Objet : structuredContent = JSON du texte (identique à task:add)
+    const auto& added = responses[2]["result"];
+    REQUIRE(added["isError"] == false);
+    REQUIRE(added.contains("structuredContent"));
+    REQUIRE(added["structuredContent"] == nlohmann::json::parse(added["content"][0]["text"].get<std::string>()));
+    REQUIRE(added["structuredContent"]["title"] == "A");
+    REQUIRE(added["structuredContent"]["sort_order"] == 10);
+    std::string task_id = added["structuredContent"]["id"].get<std::string>();
+
+    // Liste : texte = tableau (comme la CLI), structuredContent = {"tasks": [...]}
+    const auto& listed = responses[3]["result"];
+    REQUIRE(listed["isError"] == false);
+    REQUIRE(listed["structuredContent"]["tasks"] == nlohmann::json::parse(listed["content"][0]["text"].get<std::string>()));
+    REQUIRE(listed["structuredContent"]["tasks"].size() == 1u);
+    REQUIRE(listed["structuredContent"]["tasks"][0]["id"] == task_id);
+
+    // Erreur métier : diagnostic du service dans le texte, pas de structuredContent
+    const auto& missing = responses[4]["result"];
+    REQUIRE(missing["isError"] == true);
+    REQUIRE_FALSE(missing.contains("structuredContent"));
+    REQUIRE(missing["content"][0]["text"].get<std::string>().find("task not found: missing") != std::string::npos);
+
+    // format text : chemin CLI, pas de structuredContent
+    const auto& text = responses[5]["result"];
+    REQUIRE(text["isError"] == false);
+    REQUIRE_FALSE(text.contains("structuredContent"));
+    REQUIRE(text["content"][0]["text"].get<std::string>().find("title: A") != std::string::npos);
+
+    REQUIRE(responses[6]["result"]["structuredContent"]["phases"].size() == 1u);
+    fs::remove(db);
+#endif
+}
+
+TEST_CASE("MCP — task_list : fields et summary", "[mcp][integration]") {
+    std::string exe = get_taskman_path();
+    if (exe.empty())
+        SKIP("taskman executable not found");
+
+    std::string db = (fs::temp_directory_path() / "taskman_mcp_fields.db").string();
+    fs::remove(db);
+    auto responses = run_mcp_session(exe, db, {
+        tool_call(1, "taskman_init"),
+        tool_call(2, "taskman_phase_add", {{"id", "P1"}, {"name", "Phase 1"}}),
+        tool_call(3, "taskman_task_add", {{"title", "T"}, {"phase", "P1"}, {"description", std::string(200, 'd')}}),
+        tool_call(4, "taskman_task_list", {{"fields", "id,title"}}),
+        tool_call(5, "taskman_task_list", {{"summary", true}}),
+        tool_call(6, "taskman_task_list", {{"fields", "id,title"}, {"format", "text"}}),
+        tool_call(7, "taskman_task_list", {{"fields", "nope"}}),
+    });
+    REQUIRE(responses.size() == 7u);
+    const auto& fields = responses[3]["result"]["structuredContent"]["tasks"];
+    REQUIRE(fields.size() == 1u);
+    REQUIRE(fields[0].size() == 2u);
+    REQUIRE(fields[0]["title"] == "T");
+    const auto& summary = responses[4]["result"]["structuredContent"]["tasks"];
+    REQUIRE(summary[0]["description"].get<std::string>().size() == 120u + std::string("…").size());
+    REQUIRE_FALSE(summary[0].contains("updated_at"));
+    // Chemin CLI (format text) : même projection
+    std::string text = responses[5]["result"]["content"][0]["text"].get<std::string>();
+    REQUIRE(text.rfind("id: ", 0) == 0);
+    REQUIRE(text.find("title: T\n") != std::string::npos);
+    REQUIRE(text.find("status:") == std::string::npos);
+    REQUIRE(responses[6]["result"]["isError"] == true);
+    REQUIRE(responses[6]["result"]["content"][0]["text"].get<std::string>().find("unknown field 'nope'") != std::string::npos);
+    fs::remove(db);
+}
+
+TEST_CASE("MCP — format columns (listes)", "[mcp][integration]") {
+    std::string exe = get_taskman_path();
+    if (exe.empty())
+        SKIP("taskman executable not found");
+
+    std::string db = (fs::temp_directory_path() / "taskman_mcp_columns.db").string();
+    fs::remove(db);
+    auto responses = run_mcp_session(exe, db, {
+        tool_call(1, "taskman_init"),
+        tool_call(2, "taskman_phase_add", {{"id", "P1"}, {"name", "Phase 1"}}),
+        tool_call(3, "taskman_task_add", {{"title", "T"}, {"phase", "P1"}, {"role", "developer"}}),
+        tool_call(4, "taskman_task_list", {{"format", "columns"}, {"fields", "id,title,role"}}),
+        tool_call(5, "taskman_phase_list", {{"format", "columns"}}),
+        tool_call(6, "taskman_milestone_list", {{"format", "columns"}}),
+    });
+    REQUIRE(responses.size() == 6u);
+    for (int i = 3; i < 6; ++i) {
+        REQUIRE(responses[i]["result"]["isError"] == false);
+        REQUIRE_FALSE(responses[i]["result"].contains("structuredContent"));
+    }
+    auto tasks = nlohmann::json::parse(responses[3]["result"]["content"][0]["text"].get<std::string>());
+    REQUIRE(tasks["columns"] == nlohmann::json({"id", "title", "role"}));
+    REQUIRE(tasks["rows"].size() == 1u);
+    REQUIRE(tasks["rows"][0][1] == "T");
+    REQUIRE(tasks["dicts"]["role"][tasks["rows"][0][2].get<int>()] == "developer");
+    auto phases = nlohmann::json::parse(responses[4]["result"]["content"][0]["text"].get<std::string>());
+    REQUIRE(phases["rows"][0][0] == "P1");
+    auto milestones = nlohmann::json::parse(responses[5]["result"]["content"][0]["text"].get<std::string>());
+    REQUIRE(milestones["rows"].empty());
+    fs::remove(db);
+}
+
+TEST_CASE("MCP — taskman_context", "[mcp][integration]") {
+    std::string exe = get_taskman_path();
+    if (exe.empty())
+        SKIP("taskman executable not found");
+
+    std::string db = (fs::temp_directory_path() / "taskman_mcp_context.db").string();
+    fs::remove(db);
+    auto responses = run_mcp_session(exe, db, {
+        tool_call(1, "taskman_init"),
+        tool_call(2, "taskman_phase_add", {{"id", "P1"}, {"name", "Phase 1"}}),
+        tool_call(3, "taskman_task_add", {{"title", "T"}, {"phase", "P1"}, {"role", "developer"}}),
+        tool_call(4, "taskman_context", {{"role", "developer"}, {"limit", 5}}),
+        tool_call(5, "taskman_context", {{"format", "text"}}),
+        tool_call(6, "taskman_context", {{"limit", 0}}),
+    });
+    REQUIRE(responses.size() == 6u);
+    const auto& ctx = responses[3]["result"]["structuredContent"];
+    REQUIRE(ctx["role"] == "developer");
+    REQUIRE(ctx["phases"]["items"][0]["id"] == "P1");
+    REQUIRE(ctx["phases"]["items"][0]["progress"]["to_do"] == 1);
+    REQUIRE(ctx["ready"]["total"] == 1);
+    REQUIRE(ctx["ready"]["items"][0]["title"] == "T");
+    REQUIRE(nlohmann::json::parse(responses[3]["result"]["content"][0]["text"].get<std::string>()) == ctx);
+    std::string text = responses[4]["result"]["content"][0]["text"].get<std::string>();
+    REQUIRE(text.find("ready (1):") != std::string::npos);
+    REQUIRE(responses[5]["result"]["isError"] == true);
+    fs::remove(db);
+}
+
+TEST_CASE("MCP — taskman_task_wait", "[mcp][integration]") {
+    std::string exe = get_taskman_path();
+    if (exe.empty())
+        SKIP("taskman executable not found");
+
+    std::string db = (fs::temp_directory_path() / "taskman_mcp_task_wait.db").string();
+    fs::remove(db);
+    // L'attente (id 3) ne doit pas retenir la création (id 4) qui la réveille
+    auto responses = run_mcp_session(exe, db, {
+        tool_call(1, "taskman_init"),
+        tool_call(2, "taskman_phase_add", {{"id", "P1"}, {"name", "Phase 1"}}),
+        tool_call(3, "taskman_task_wait", {{"role", "developer"}, {"timeout", 10}}),
+        tool_call(4, "taskman_task_add", {{"title", "T"}, {"phase", "P1"}, {"role", "developer"}}),
+        tool_call(5, "taskman_task_wait", {{"role", "qa-engineer"}, {"timeout", 0}, {"format", "text"}}),
+        tool_call(6, "taskman_task_wait", {{"timeout", 601}}),
+    }, "sleep 0.3");
+    REQUIRE(responses.size() == 6u);
+    const auto& waited = responses[2]["result"]["structuredContent"];
+    REQUIRE(waited["timed_out"] == false);
+    REQUIRE(waited["tasks"].size() == 1u);
+    REQUIRE(waited["tasks"][0]["title"] == "T");
+    REQUIRE(waited["tasks"][0]["id"] == responses[3]["result"]["structuredContent"]["id"]);
+    REQUIRE(responses[4]["result"]["content"][0]["text"] == "timed out: no ready task\n");
+    REQUIRE(responses[5]["result"]["isError"] == true);
+    fs::remove(db);
+}
+
+TEST_CASE("MCP — taskman_task_wait : limite des attentes sans bloquer la lecture", "[mcp][integration]") {
+    std::string exe = get_taskman_path();
+    if (exe.empty())
+        SKIP("taskman executable not found");
+
+    std::string db = (fs::temp_directory_path() / "taskman_mcp_task_wait_limit.db").string();
+    fs::remove(db);
+    // Une seule requête en cours et une seule attente : l'attente (id 3) ne prend pas la place de
+    // l'écriture (id 5) qui la réveille ; la seconde attente (id 4) est refusée aussitôt
+#ifdef _WIN32
+    _putenv_s("TASKMAN_MCP_MAX_IN_FLIGHT", "1");
+    _putenv_s("TASKMAN_MCP_MAX_WAITS", "1");
+#else
+    setenv("TASKMAN_MCP_MAX_IN_FLIGHT", "1", 1);
+    setenv("TASKMAN_MCP_MAX_WAITS", "1", 1);
+#endif
+    auto started = std::chrono::steady_clock::now();
+    auto responses = run_mcp_session(exe, db, {
+        tool_call(1, "taskman_init"),
+        tool_call(2, "taskman_phase_add", {{"id", "P1"}, {"name", "Phase 1"}}),
+        tool_call(3, "taskman_task_wait", {{"role", "developer"}, {"timeout", 20}}),
+        tool_call(4, "taskman_task_wait", {{"role", "qa-engineer"}, {"timeout", 20}}),
+        tool_call(5, "taskman_task_add", {{"title", "T"}, {"phase", "P1"}, {"role", "developer"}}),
+    }, "sleep 0.3");
+    auto elapsed = std::chrono::steady_clock::now() - started;
+#ifdef _WIN32
+    _putenv_s("TASKMAN_MCP_MAX_IN_FLIGHT", "");
+    _putenv_s("TASKMAN_MCP_MAX_WAITS", "");
+#else
+    unsetenv("TASKMAN_MCP_MAX_IN_FLIGHT");
+    unsetenv("TASKMAN_MCP_MAX_WAITS");
+#endif
+    REQUIRE(responses.size() == 5u);
+    REQUIRE(responses[2]["result"]["structuredContent"]["timed_out"] == false);
+    REQUIRE(responses[3]["result"]["isError"] == true);
+    REQUIRE(responses[3]["result"]["content"][0]["text"].get<std::string>().find("too many pending waits") != std::string::npos);
+    REQUIRE(elapsed < std::chrono::seconds(15));
+    fs::remove(db);
+}
+
+TEST_CASE("MCP — taskman_task_bulk_add / taskman_task_bulk_edit", "[mcp][integration]") {
+    std::string exe = get_taskman_path();
+    if (exe.empty())
+        SKIP("taskman executable not found");
+
+    std::string db = (fs::temp_directory_path() / "taskman_mcp_task_bulk.db").string();
+    fs::remove(db);
+    nlohmann::json tasks = nlohmann::json::array({
+        {{"key", "a"}, {"title", "A"}, {"phase", "P1"}},
+        {{"key", "b"}, {"title", "B"}, {"phase", "P1"}, {"role", "developer"}, {"deps", {"a"}}},
+    });
+    auto responses = run_mcp_session(exe, db, {
+        tool_call(1, "taskman_init"),
+        tool_call(2, "taskman_phase_add", {{"id", "P1"}, {"name", "Phase 1"}}),
+        tool_call(3, "taskman_task_bulk_add", {{"tasks", tasks}}),
+        tool_call(4, "taskman_task_bulk_add", {{"tasks", nlohmann::json::array({{{"title", "C"}, {"phase", "P1"}, {"deps", {"zz"}}}})}}),
+    });
+    REQUIRE(responses.size() == 4u);
+    const auto& added = responses[2]["result"]["structuredContent"];
+    REQUIRE(added["ids"].size() == 2u);
+    REQUIRE(added["keys"]["b"] == added["ids"][1]);
+    REQUIRE(responses[3]["result"]["isError"] == true);
+    REQUIRE(responses[3]["result"]["content"][0]["text"].get<std::string>().find("dependency not found") != std::string::npos);
+
+    std::string a = added["keys"]["a"], b = added["keys"]["b"];
+    responses = run_mcp_session(exe, db, {
+        tool_call(1, "taskman_task_bulk_edit", {{"tasks", nlohmann::json::array({{{"id", a}, {"status", "done"}}})}}),
+        tool_call(2, "taskman_task_bulk_edit", {{"tasks", nlohmann::json::array({{{"id", b}, {"title", "B2"}}})}, {"format", "text"}}),
+        tool_call(3, "taskman_task_list"),
+    });
+    REQUIRE(responses.size() == 3u);
+    // Le lot en échec n'a rien créé
+    REQUIRE(responses[2]["result"]["structuredContent"]["tasks"].size() == 2u);
+    REQUIRE(responses[0]["result"]["structuredContent"]
+            == nlohmann::json({{"updated", 1}, {"unblocked", {{{"id", b}, {"title", "B"}, {"role", "developer"}}}}}));
+    REQUIRE(responses[1]["result"]["content"][0]["text"] == "updated: 1\n");
+    fs::remove(db);
+}
+
+TEST_CASE("MCP — ressources : lecture groupée et abonnements", "[mcp][integration]") {
+    std::string exe = get_taskman_path();
+    if (exe.empty())
+        SKIP("taskman executable not found");
+
+    std::string db = (fs::temp_directory_path() / "taskman_mcp_resources.db").string();
+    fs::remove(db);
+    auto setup = run_mcp_session(exe, db, {
+        tool_call(1, "taskman_init"),
+        tool_call(2, "taskman_phase_add", {{"id", "P1"}, {"name", "Phase 1"}}),
+        tool_call(3, "taskman_task_add", {{"title", "A"}, {"phase", "P1"}}),
+        tool_call(4, "taskman_task_add", {{"title", "B"}, {"phase", "P1"}}),
+    });
+    REQUIRE(setup.size() == 4u);
+    std::string a = setup[2]["result"]["structuredContent"]["id"].get<std::string>();
+    std::string b = setup[3]["result"]["structuredContent"]["id"].get<std::string>();
+    std::string uri_a = "taskman://task/" + a;
+
+    auto request = [](int id, const std::string& method, const nlohmann::json& params) {
+        return nlohmann::json{{"jsonrpc", "2.0"}, {"id", id}, {"method", method}, {"params", params}};
+    };
+    auto responses = run_mcp_session(exe, db, {
+        nlohmann::json{{"jsonrpc", "2.0"}, {"id", 1}, {"method", "initialize"},
+                       {"params", {{"protocolVersion", "2025-11-25"}}}},
+        request(2, "resources/templates/list", nlohmann::json::object()),
+        request(3, "resources/read", {{"uris", {uri_a, "taskman://phase/P1", "taskman://note/none"}}}),
+        request(4, "resources/read", {{"uri", "taskman://task/none"}}),
+        request(5, "resources/subscribe", {{"uri", uri_a}}),
+        request(6, "resources/subscribe", {{"uri", "taskman://phase/P1"}}),
+        // Écriture sur une ressource non abonnée : aucune notification
+        tool_call(7, "taskman_task_edit", {{"id", b}, {"title", "B2"}}),
+        tool_call(8, "taskman_task_edit", {{"id", a}, {"title", "A2"}}),
+        request(9, "resources/subscribe", {{"uri", "task/x"}}),
+        request(10, "resources/list", nlohmann::json::object()),
+    }, "sleep 0.3");
+
+    std::vector<nlohmann::json> notifications;
+    std::vector<nlohmann::json> replies;
+    for (auto& r : responses) (r.contains("id") ? replies : notifications).push_back(r);
+    REQUIRE(replies.size() == 10u);
+    REQUIRE(replies[0]["result"]["capabilities"]["resources"]["subscribe"] == true);
+    REQUIRE(replies[1]["result"]["resourceTemplates"].size() == 4u);
+
+    const auto& read = replies[2]["result"];
+    REQUIRE(read["contents"].size() == 2u);
+    REQUIRE(read["contents"][0]["uri"] == uri_a);
+    REQUIRE(read["contents"][0]["mimeType"] == "application/json");
+    auto task = nlohmann::json::parse(read["contents"][0]["text"].get<std::string>());
+    REQUIRE(task["title"] == "A");
+    REQUIRE(task["note_ids"].is_array());
+    REQUIRE(nlohmann::json::parse(read["contents"][1]["text"].get<std::string>())["name"] == "Phase 1");
+    REQUIRE(read["missing"] == nlohmann::json::array({"taskman://note/none"}));
+    REQUIRE(replies[3]["error"]["code"] == -32002);
+
+    REQUIRE(replies[4]["result"] == nlohmann::json::object());
+    REQUIRE(replies[5]["result"] == nlohmann::json::object());
+    REQUIRE(replies[8]["error"]["code"] == -32602);
+    REQUIRE(replies[9]["result"]["resources"][0]["uri"] == "taskman://phase/P1");
+
+    REQUIRE(notifications.size() == 1u);
+    REQUIRE(notifications[0]["method"] == "notifications/resources/updated");
+    REQUIRE(notifications[0]["params"]["uri"] == uri_a);
+    fs::remove(db);
+}
+
+TEST_CASE("MCP — lecture conditionnelle if-none-match", "[mcp][integration]") {
+    std::string exe = get_taskman_path();
+    if (exe.empty())
+        SKIP("taskman executable not found");
+
+    std::string db = (fs::temp_directory_path() / "taskman_mcp_if_none_match.db").string();
+    fs::remove(db);
+    auto first = run_mcp_session(exe, db, {
+        tool_call(1, "taskman_init"),
+        tool_call(2, "taskman_phase_add", {{"id", "P1"}, {"name", "Phase 1"}}),
+        tool_call(3, "taskman_phase_list", {{"if-none-match", ""}}),
+    });
+    REQUIRE(first.size() == 3u);
+    const auto& changed = first[2]["result"];
+    REQUIRE(changed["isError"] == false);
+    REQUIRE(changed["structuredContent"]["unchanged"] == false);
+    REQUIRE(changed["structuredContent"]["result"]["phases"][0]["id"] == "P1");
+    auto text = nlohmann::json::parse(changed["content"][0]["text"].get<std::string>());
+    REQUIRE(text["result"][0]["id"] == "P1");
+    std::string version = changed["structuredContent"]["version"].get<std::string>();
+
+    auto second = run_mcp_session(exe, db, {
+        tool_call(1, "taskman_task_list", {{"if-none-match", version}}),
+        tool_call(2, "taskman_context", {{"if-none-match", version}, {"format", "text"}}),
+        tool_call(3, "taskman_task_add", {{"title", "T"}, {"phase", "P1"}}),
+        tool_call(4, "taskman_task_list", {{"if-none-match", version}, {"fields", "title"}}),
+    });
+    REQUIRE(second.size() == 4u);
+    nlohmann::json unchanged = {{"unchanged", true}, {"version", version}};
+    REQUIRE(second[0]["result"]["structuredContent"] == unchanged);
+    REQUIRE(nlohmann::json::parse(second[1]["result"]["content"][0]["text"].get<std::string>()) == unchanged);
+    const auto& after_write = second[3]["result"]["structuredContent"];
+    REQUIRE(after_write["unchanged"] == false);
+    REQUIRE(after_write["version"] != version);
+    REQUIRE(after_write["result"]["tasks"] == nlohmann::json::parse(R"([{"title":"T"}])"));
+    fs::remove(db);
+}
+
+TEST_CASE("MCP — handlers typés : task_edit done et notes", "[mcp][integration]") {
+    std::string exe = get_taskman_path();
+    if (exe.empty())
+        SKIP("taskman executable not found");
+#ifdef _WIN32
+    SKIP("session shell pipeline is POSIX only");
+#else
+    std::string db = (fs::temp_directory_path() / "taskman_mcp_typed_edit.db").string();
+    fs::remove(db);
+    setenv("TASKMAN_DB_NAME", db.c_str(), 1);
+    std::string setup = "\"" + exe + "\" init && \"" + exe + "\" phase:add --id P1 --name P > /dev/null";
+    REQUIRE(std::system(setup.c_str()) == 0);
+
+    auto first = run_mcp_session(exe, db, {
+        tool_call(1, "taskman_task_add", {{"title", "A"}, {"phase", "P1"}}),
+        tool_call(2, "taskman_task_add", {{"title", "B"}, {"phase", "P1"}}),
+    });
+    REQUIRE(first.size() == 2u);
+    std::string a = first[0]["result"]["structuredContent"]["id"].get<std::string>();
+    std::string b = first[1]["result"]["structuredContent"]["id"].get<std::string>();
+
+    auto responses = run_mcp_session(exe, db, {
+        tool_call(1, "taskman_task_dep_add", {{"task-id", b}, {"dep-id", a}}),
+        tool_call(2, "taskman_task_edit", {{"id", b}, {"title", "B2"}}),
+        tool_call(3, "taskman_task_edit", {{"id", a}, {"status", "done"}}),
+        tool_call(4, "taskman_task_note_add", {{"task-id", a}, {"content", "ok"}, {"kind", "completion"}}),
+        tool_call(5, "taskman_task_note_list", {{"task-id", a}}),
+        tool_call(6, "taskman_task_edit", {{"id", a}, {"sort-order", "x"}}),
+    });
+    REQUIRE(responses.size() == 6u);
+    REQUIRE(responses[0]["result"]["isError"] == false);
+    REQUIRE_FALSE(responses[0]["result"].contains("structuredContent"));
+    REQUIRE(responses[1]["result"]["isError"] == false);
+    REQUIRE_FALSE(responses[1]["result"].contains("structuredContent"));
+
+    const auto& done = responses[2]["result"]["structuredContent"];
+    REQUIRE(done["status"] == "done");
+    REQUIRE(done["unblocked"].size() == 1u);
+    REQUIRE(done["unblocked"][0]["id"] == b);
+
+    const auto& note = responses[3]["result"]["structuredContent"];
+    REQUIRE(note["task_id"] == a);
+    REQUIRE(note["kind"] == "completion");
+    REQUIRE(note["role"].is_null());
+    const auto& notes = responses[4]["result"]["structuredContent"]["notes"];
+    REQUIRE(notes.size() == 1u);
+    REQUIRE(notes[0]["id"] == note["id"]);
+
+    REQUIRE(responses[5]["result"]["isError"] == true);
+    REQUIRE(responses[5]["result"]["content"][0]["text"] == "taskman: --sort-order must be an integer\n");
+    fs::remove(db);
+#endif
+}
+
+TEST_CASE("MCP — session pipelinée : un message par ligne, CRLF, notification et erreurs", "[mcp][integration]") {
+    std::string exe = get_taskman_path();
+    if (exe.empty())
+        SKIP("taskman executable not found");
+
+    std::string db = (fs::temp_directory_path() / "taskman_mcp_pipeline.db").string();
+    fs::remove(db);
+
+    // Requêtes envoyées d'un bloc : ligne vide, CRLF, notification (sans réponse), JSON invalide
+    std::string session =
+        "{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"tools/list\"}\r\n"
+        "\n"
+        "{\"jsonrpc\":\"2.0\",\"method\":\"notifications/initialized\"}\n"
+        "{not json}\n"
+        "{\"jsonrpc\":\"2.0\",\"id\":\"b\",\"method\":\"ping\"}\n"
+        "{\"jsonrpc\":\"2.0\",\"id\":3,\"method\":\"tools/list\",\"params\":{}}\n"
+        "{\"jsonrpc\":\"2.0\",\"id\":4,\"method\":\"unknown/method\"}";
+    std::string out = run_mcp_request_bidirectional(exe, db, session);
+
+    std::vector<nlohmann::json> responses;
+    std::istringstream lines(out);
+    std::string line;
+    while (std::getline(lines, line))
+        responses.push_back(nlohmann::json::parse(line));
+    REQUIRE(responses.size() == 5u);
+    REQUIRE(responses[0]["id"] == 1);
+    REQUIRE(responses[0]["result"]["tools"].size() == 26u);
+    REQUIRE(responses[1]["id"].is_null());
+    REQUIRE(responses[1]["error"]["code"] == -32700);
+    REQUIRE(responses[2]["id"] == "b");
+    REQUIRE(responses[2]["result"].empty());
+    // tools/list précalculé : même contenu à chaque appel
+    REQUIRE(responses[3]["id"] == 3);
+    REQUIRE(responses[3]["result"] == responses[0]["result"]);
+    REQUIRE(responses[4]["id"] == 4);
+    REQUIRE(responses[4]["error"]["code"] == -32601);
+    fs::remove(db);
+}
+
+TEST_CASE("MCP — lot JSON-RPC (batch)", "[mcp][integration]") {
+    std::string exe = get_taskman_path();
+    if (exe.empty())
+        SKIP("taskman executable not found");
+
+    std::string db = (fs::temp_directory_path() / "taskman_mcp_batch.db").string();
+    fs::remove(db);
+#ifdef _WIN32
+    _putenv_s("TASKMAN_DB_NAME", db.c_str());
+#else
+    setenv("TASKMAN_DB_NAME", db.c_str(), 1);
+#endif
+    std::string setup = "\"" + exe + "\" init && \"" + exe + "\" phase:add --id P1 --name P";
+    REQUIRE(std::system(setup.c_str()) == 0);
+
+    auto parse_lines = [](const std::string& out) {
+        std::vector<nlohmann::json> lines;
+        std::istringstream in(out);
+        std::string line;
+        while (std::getline(in, line))
+            lines.push_back(nlohmann::json::parse(line));
+        return lines;
+    };
+
+    SECTION("lecture seule : réponses dans l'ordre, pas d'entrée pour les notifications") {
+        nlohmann::json batch = nlohmann::json::array({
+            tool_call(1, "taskman_phase_list"),
+            {{"jsonrpc", "2.0"}, {"method", "notifications/initialized"}},
+            tool_call(2, "taskman_milestone_list"),
+            {{"jsonrpc", "2.0"}, {"id", 3}, {"method", "ping"}},
+            tool_call(4, "taskman_task_list", {{"status", "to_do"}}),
+        });
+        auto lines = parse_lines(run_mcp_request_bidirectional(exe, db, batch.dump()));
+        REQUIRE(lines.size() == 1u);
+        const auto& resp = lines[0];
+        REQUIRE(resp.is_array());
+        REQUIRE(resp.size() == 4u);
+        REQUIRE(resp[0]["id"] == 1);
+        REQUIRE(resp[0]["result"]["structuredContent"]["phases"].size() == 1u);
+        REQUIRE(resp[1]["id"] == 2);
+        REQUIRE(resp[2]["id"] == 3);
+        REQUIRE(resp[3]["id"] == 4);
+        REQUIRE(resp[3]["result"]["isError"] == false);
+    }
+
+    SECTION("écriture puis lecture dans le même lot : exécution dans l'ordre") {
+        nlohmann::json batch = nlohmann::json::array({
+            tool_call(1, "taskman_task_add", {{"title", "T"}, {"phase", "P1"}}),
+            tool_call(2, "taskman_task_list"),
+        });
+        auto lines = parse_lines(run_mcp_request_bidirectional(exe, db, batch.dump()));
+        REQUIRE(lines.size() == 1u);
+        REQUIRE(lines[0].size() == 2u);
+        REQUIRE(lines[0][1]["result"]["structuredContent"]["tasks"].size() == 1u);
+        REQUIRE(lines[0][1]["result"]["structuredContent"]["tasks"][0]["id"]
+                == lines[0][0]["result"]["structuredContent"]["id"]);
+    }
+
+    SECTION("lot vide, éléments invalides, notifications seules") {
+        std::string session =
+            "[]\n"
+            "[1, {\"jsonrpc\":\"2.0\",\"id\":7,\"method\":\"ping\"}]\n"
+            "[{\"jsonrpc\":\"2.0\",\"method\":\"notifications/initialized\"}]\n"
+            "{\"jsonrpc\":\"2.0\",\"id\":8,\"method\":\"ping\"}";
+        auto lines = parse_lines(run_mcp_request_bidirectional(exe, db, session));
+        REQUIRE(lines.size() == 3u);
+        // Les lots passent par la voie d'écriture : le ping 8 (traité immédiatement) peut les précéder
+        std::vector<nlohmann::json> objects, arrays;
+        for (const auto& line : lines)
+            (line.is_array() ? arrays : objects).push_back(line);
+        REQUIRE(objects.size() == 2u);
+        REQUIRE(arrays.size() == 1u);
+        std::sort(objects.begin(), objects.end(), [](const nlohmann::json& a, const nlohmann::json& b) {
+            return a["id"].is_null() && !b["id"].is_null();
+        });
+        REQUIRE(objects[0]["error"]["code"] == -32600);
+        REQUIRE(objects[1]["id"] == 8);
+        REQUIRE(arrays[0].size() == 2u);
+        REQUIRE(arrays[0][0]["error"]["code"] == -32600);
+        REQUIRE(arrays[0][0]["id"].is_null());
+        REQUIRE(arrays[0][1]["id"] == 7);
+    }
+    fs::remove(db);
+}
+
+TEST_CASE("MCP — exécution concurrente : lectures parallèles, écritures ordonnées", "[mcp][integration]") {
+    std::string exe = get_taskman_path();
+    if (exe.empty())
+        SKIP("taskman executable not found");
+
+    std::string db = (fs::temp_directory_path() / "taskman_mcp_concurrent.db").string();
+    fs::remove(db);
+#ifdef _WIN32
+    _putenv_s("TASKMAN_DB_NAME", db.c_str());
+    _putenv_s("TASKMAN_MCP_WORKERS", "4");
+#else
+    setenv("TASKMAN_DB_NAME", db.c_str(), 1);
+    setenv("TASKMAN_MCP_WORKERS", "4", 1);
+#endif
+    std::string setup = "\"" + exe + "\" init && \"" + exe + "\" phase:add --id P1 --name P";
+    REQUIRE(std::system(setup.c_str()) == 0);
+
+    // Écriture, lectures en rafale (dont une qui doit voir l'écriture), ping, nouvelle écriture puis lecture
+    std::vector<nlohmann::json> requests;
+    requests.push_back(tool_call(1, "taskman_task_add", {{"title", "A"}, {"phase", "P1"}}));
+    for (int id = 2; id <= 21; ++id)
+        requests.push_back(tool_call(id, id % 2 ? "taskman_phase_list" : "taskman_task_list"));
+    requests.push_back({{"jsonrpc", "2.0"}, {"id", 22}, {"method", "ping"}});
+    requests.push_back(tool_call(23, "taskman_task_add", {{"title", "B"}, {"phase", "P1"}}));
+    requests.push_back(tool_call(24, "taskman_task_list"));
+
+    auto responses = run_mcp_session(exe, db, requests);
+    REQUIRE(responses.size() == requests.size());
+    for (size_t i = 0; i < responses.size(); ++i) {
+        REQUIRE(responses[i]["id"] == requests[i]["id"]);
+        REQUIRE_FALSE(responses[i].contains("error"));
+    }
+    // Une lecture voit toutes les écritures reçues avant elle, et aucune reçue après
+    for (int id = 2; id <= 21; id += 2)
+        REQUIRE(responses[id - 1]["result"]["structuredContent"]["tasks"].size() == 1u);
+    REQUIRE(responses[23]["result"]["structuredContent"]["tasks"].size() == 2u);
+#ifdef _WIN32
+    _putenv_s("TASKMAN_MCP_WORKERS", "");
+#else
+    unsetenv("TASKMAN_MCP_WORKERS");
+#endif
+    fs::remove(db);
+}
+
+TEST_CASE("MCP — taskman_task_list limit/cursor et nextCursor", "[mcp][integration]") {
+    std::string exe = get_taskman_path();
+    if (exe.empty())
+        SKIP("taskman executable not found");
+
+    std::string db = (fs::temp_directory_path() / "taskman_mcp_cursor.db").string();
+    fs::remove(db);
+    auto first = run_mcp_session(exe, db, {
+        tool_call(1, "taskman_init"),
+        tool_call(2, "taskman_phase_add", {{"id", "P1"}, {"name", "Phase 1"}}),
+        tool_call(3, "taskman_task_add", {{"title", "A"}, {"phase", "P1"}, {"sort-order", 1}}),
+        tool_call(4, "taskman_task_add", {{"title", "B"}, {"phase", "P1"}, {"sort-order", 2}}),
+        tool_call(5, "taskman_task_add", {{"title", "C"}, {"phase", "P1"}, {"sort-order", 3}}),
+        tool_call(6, "taskman_task_list", {{"limit", 2}, {"fields", "title"}}),
+        tool_call(7, "taskman_task_list", {{"limit", 0}}),
+        tool_call(8, "taskman_task_list", {{"cursor", "not-a-cursor"}}),
+    });
+    REQUIRE(first.size() == 8u);
+    const auto& page1 = first[5]["result"];
+    REQUIRE(page1["isError"] == false);
+    REQUIRE(page1["structuredContent"]["tasks"] == nlohmann::json::parse(R"([{"title":"A"},{"title":"B"}])"));
+    REQUIRE(page1["structuredContent"]["nextCursor"].is_string());
+    REQUIRE(nlohmann::json::parse(page1["content"][0]["text"].get<std::string>()) == page1["structuredContent"]);
+    REQUIRE(first[6]["result"]["isError"] == true);
+    REQUIRE(first[7]["result"]["isError"] == true);
+    REQUIRE(first[7]["result"]["content"][0]["text"].get<std::string>().find("invalid --cursor") != std::string::npos);
+
+    std::string cursor = page1["structuredContent"]["nextCursor"].get<std::string>();
+    auto second = run_mcp_session(exe, db, {
+        tool_call(1, "taskman_task_list", {{"limit", 2}, {"cursor", cursor}, {"fields", "title"}}),
+        tool_call(2, "taskman_task_list", {{"limit", 2}, {"cursor", cursor}, {"format", "columns"}, {"fields", "title"}}),
+        tool_call(3, "taskman_task_list", {{"limit", 2}, {"cursor", cursor}, {"format", "text"}, {"fields", "title"}}),
+    });
+    REQUIRE(second.size() == 3u);
+    REQUIRE(second[0]["result"]["structuredContent"]["tasks"] == nlohmann::json::parse(R"([{"title":"C"}])"));
+    REQUIRE(second[0]["result"]["structuredContent"]["nextCursor"].is_null());
+    auto table = nlohmann::json::parse(second[1]["result"]["content"][0]["text"].get<std::string>());
+    REQUIRE(table["rows"] == nlohmann::json::parse(R"([["C"]])"));
+    REQUIRE(table["nextCursor"].is_null());
+    REQUIRE(second[2]["result"]["content"][0]["text"] == "title: C\n");
+    fs::remove(db);
+}
+
+TEST_CASE("McpProtocolHandler — hook de fin de lot même si un handler lève", "[mcp]") {
+    McpProtocolHandler handler;
+    int begun = 0, ended = 0;
+    handler.set_batch_hooks([&begun](const nlohmann::json&) { ++begun; }, [&ended]() { ++ended; });
+    handler.register_method("boom", [](const nlohmann::json&, const nlohmann::json&) -> std::string {
+        throw std::runtime_error("boom");
+    });
+    std::string response;
+    REQUIRE(handler.dispatch_batch(nlohmann::json::parse(R"([{"jsonrpc":"2.0","id":1,"method":"ping"}])"), response));
+    REQUIRE(begun == 1);
+    REQUIRE(ended == 1);
+
+    auto batch = nlohmann::json::parse(R"([{"jsonrpc":"2.0","id":1,"method":"ping"},{"jsonrpc":"2.0","id":2,"method":"boom"}])");
+    REQUIRE_THROWS_AS(handler.dispatch_batch(batch, response), std::runtime_error);
+    REQUIRE(begun == 2);
+    REQUIRE(ended == 2);  // snapshot refermé malgré l'exception
+}
+
+TEST_CASE("McpToolStats — histogramme et percentiles", "[mcp]") {
+    // 4 intervalles par puissance de 2 : bornes 1.25, 1.5, 1.75, 2 µs pour [1, 2)
+    REQUIRE(McpToolStats::bucket_of(0) == 0u);
+    REQUIRE(McpToolStats::bucket_of(1) == 0u);
+    REQUIRE(McpToolStats::bucket_of(2) == 4u);
+    REQUIRE(McpToolStats::bucket_of(3) == 6u);
+    REQUIRE(McpToolStats::bucket_of(1000) < McpToolStats::bucket_of(1300));
+    REQUIRE(McpToolStats::bucket_upper_us(McpToolStats::bucket_of(1000)) > 1000.0);
+    REQUIRE(McpToolStats::bucket_of(~0ull) == McpToolStats::BUCKETS - 1);
+
+    McpToolStats stats;
+    using std::chrono::microseconds;
+    for (int i = 0; i < 98; ++i) stats.record("taskman_task_list", microseconds(1000), 10, 500, false);
+    stats.record("taskman_task_list", microseconds(50000), 10, 500, false);
+    stats.record("taskman_task_list", microseconds(80000), 10, 500, true);
+    stats.record("taskman_task_get", microseconds(200), 20, 100, true);
+
+    auto j = stats.to_json();
+    REQUIRE(j["calls"] == 101);
+    REQUIRE(j["errors"] == 2);
+    REQUIRE(j["tools"].size() == 2u);
+    const auto& list = j["tools"][0];
+    REQUIRE(list["name"] == "taskman_task_list");
+    REQUIRE(list["calls"] == 100);
+    REQUIRE(list["errors"] == 1);
+    REQUIRE(list["p50_ms"].get<double>() >= 1.0);
+    REQUIRE(list["p50_ms"].get<double>() <= 1.25);
+    REQUIRE(list["p99_ms"].get<double>() >= 50.0);
+    REQUIRE(list["p99_ms"].get<double>() <= 62.5);
+    REQUIRE(list["max_ms"] == 80.0);
+    REQUIRE(list["request_bytes"] == 1000);
+    REQUIRE(list["response_bytes"] == 50000);
+    REQUIRE(list["mean_response_bytes"] == 500);
+    // Un seul appel : tous les percentiles sont bornés par le maximum
+    REQUIRE(j["tools"][1]["p99_ms"] == 0.2);
+
+    std::string path = (fs::temp_directory_path() / "taskman_mcp_stats_unit.json").string();
+    REQUIRE(stats.write_file(path));
+    std::ifstream in(path);
+    REQUIRE(nlohmann::json::parse(in)["calls"] == 101);
+    in.close();
+    fs::remove(path);
+}
+
+TEST_CASE("MCP — taskman_server_stats et TASKMAN_MCP_STATS_FILE", "[mcp][integration]") {
+    std::string exe = get_taskman_path();
+    if (exe.empty())
+        SKIP("taskman executable not found");
+#ifdef _WIN32
+    SKIP("session shell pipeline is POSIX only");
+#else
+    std::string db = (fs::temp_directory_path() / "taskman_mcp_stats.db").string();
+    std::string stats_file = (fs::temp_directory_path() / "taskman_mcp_stats.json").string();
+    fs::remove(db);
+    fs::remove(stats_file);
+    setenv("TASKMAN_MCP_STATS_FILE", stats_file.c_str(), 1);
+    // Les lectures vont sur les workers : la pause laisse chaque appel finir avant le suivant
+    auto responses = run_mcp_session(exe, db, {
+        tool_call(1, "taskman_init"),
+        tool_call(2, "taskman_task_list"),
+        tool_call(3, "taskman_task_list"),
+        tool_call(4, "taskman_task_get", {{"id", "missing"}}),
+        tool_call(5, "taskman_unknown"),
+        tool_call(6, "taskman_server_stats"),
+    }, "sleep 0.2");
+    unsetenv("TASKMAN_MCP_STATS_FILE");
+    REQUIRE(responses.size() == 6u);
+    REQUIRE(responses[4]["error"]["code"] == -32602);
+
+    const auto& stats = responses[5]["result"]["structuredContent"];
+    REQUIRE(responses[5]["result"]["isError"] == false);
+    REQUIRE(stats["calls"] == 4);
+    REQUIRE(stats["errors"] == 1);
+    REQUIRE(stats["tools"][0]["name"] == "taskman_task_list");
+    REQUIRE(stats["tools"][0]["calls"] == 2);
+    REQUIRE(stats["tools"][0]["response_bytes"].get<int>() > 0);
+    for (const auto& tool : stats["tools"]) REQUIRE(tool["name"] != "taskman_unknown");
+
+    // Écriture finale à l'arrêt du serveur : l'appel à taskman_server_stats y figure
+    std::ifstream in(stats_file);
+    REQUIRE(in.good());
+    auto dumped = nlohmann::json::parse(in);
+    REQUIRE(dumped["calls"] == 5);
+    in.close();
+    fs::remove(stats_file);
+    fs::remove(db);
+#endif
+}
+
+TEST_CASE("MCP — TASKMAN_MCP_RECORD et bench:mcp --replay", "[mcp][integration]") {
+    std::string exe = get_taskman_path();
+    if (exe.empty())
+        SKIP("taskman executable not found");
+#ifdef _WIN32
+    SKIP("session shell pipeline is POSIX only");
+#else
+    std::string db = (fs::temp_directory_path() / "taskman_mcp_record.db").string();
+    std::string copy = (fs::temp_directory_path() / "taskman_mcp_record_copy.db").string();
+    std::string record = (fs::temp_directory_path() / "taskman_mcp_record.jsonl").string();
+    fs::remove(db);
+    fs::remove(record);
+    setenv("TASKMAN_MCP_RECORD", record.c_str(), 1);
+    auto responses = run_mcp_session(exe, db, {
+        tool_call(1, "taskman_init"),
+        tool_call(2, "taskman_phase_add", {{"id", "P1"}, {"name", "Phase 1"}}),
+        tool_call(3, "taskman_task_list"),
+        {{"jsonrpc", "2.0"}, {"method", "notifications/initialized"}},
+    });
+    unsetenv("TASKMAN_MCP_RECORD");
+    REQUIRE(responses.size() == 3u);
+
+    // Une ligne par message reçu (ordre d'arrivée), une par réponse, reliées par seq
+    std::vector<nlohmann::json> lines;
+    {
+        std::ifstream in(record);
+        std::string line;
+        while (std::getline(in, line)) lines.push_back(nlohmann::json::parse(line));
+    }
+    REQUIRE(lines.size() == 8u);
+    std::vector<nlohmann::json> received;
+    for (const auto& l : lines) {
+        if (l.contains("line")) received.push_back(l);
+        else REQUIRE(l["latency_ms"].get<double>() >= 0.0);
+    }
+    REQUIRE(received.size() == 4u);
+    REQUIRE(received[0]["seq"] == 1);
+    REQUIRE(nlohmann::json::parse(received[1]["line"].get<std::string>())["params"]["name"] == "taskman_phase_add");
+
+    // Rejeu sur une copie de la base d'origine (avant la session) : mêmes réponses, sans erreur
+    fs::remove(copy);
+    std::string cmd = "\"" + exe + "\" bench:mcp --replay \"" + record + "\" --db \"" + copy + "\" --repeat 3";
+    FILE* f = popen(cmd.c_str(), "r");
+    REQUIRE(f != nullptr);
+    std::string out;
+    char buf[4096];
+    while (fgets(buf, sizeof(buf), f)) out += buf;
+    REQUIRE(pclose(f) == 0);
+    auto report = nlohmann::json::parse(out);
+    REQUIRE(report["repeat"] == 3);
+    REQUIRE(report["messages"] == 12);
+    REQUIRE(report["responses"] == 9);
+    REQUIRE(report["errors"] == 0);
+    REQUIRE(report["tool_errors"] == 2);  // phase:add de P1 refusé aux deux répétitions suivantes
+    REQUIRE(report["p99_ms"].get<double>() >= report["p50_ms"].get<double>());
+    REQUIRE(report["recorded"]["responses"] == 4);
+
+    // Options invalides
+    REQUIRE(std::system(("\"" + exe + "\" bench:mcp --db x.db 2>/dev/null").c_str()) != 0);
+    REQUIRE(std::system(("\"" + exe + "\" bench:mcp --replay \"" + record + "\" --db x.db --repeat 0 2>/dev/null").c_str()) != 0);
+
+    fs::remove(record);
+    fs::remove(copy);
+    fs::remove(db);
+#endif
+}
+
+#ifndef _WIN32
+/** Client MCP Streamable HTTP minimal : POST d'un message sur /mcp, avec l'id de session. */
+struct McpHttpClient {
+    httplib::Client cli;
+    std::string session;
+    McpHttpClient(int port) : cli("127.0.0.1", port) { cli.set_read_timeout(10); }
+
+    httplib::Headers headers() const {
+        httplib::Headers h = {{"Accept", "application/json, text/event-stream"}};
+        if (!session.empty()) h.emplace("Mcp-Session-Id", session);
+        return h;
+    }
+    httplib::Result post(const nlohmann::json& message) {
+        return cli.Post("/mcp", headers(), message.dump(), "application/json");
+    }
+    /** initialize + notifications/initialized ; retourne false si le serveur ne répond pas. */
+    bool initialize() {
+        auto res = post({{"jsonrpc", "2.0"}, {"id", 0}, {"method", "initialize"},
+                         {"params", {{"protocolVersion", "2025-11-25"}, {"capabilities", nlohmann::json::object()},
+                                     {"clientInfo", {{"name", "test"}, {"version", "1"}}}}}});
+        if (!res || res->status != 200) return false;
+        session = res->get_header_value("Mcp-Session-Id");
+        res = post({{"jsonrpc", "2.0"}, {"method", "notifications/initialized"}});
+        return res && res->status == 202;
+    }
+    nlohmann::json call(int id, const std::string& name, const nlohmann::json& arguments = nlohmann::json::object()) {
+        auto res = post(tool_call(id, name, arguments));
+        return res && res->status == 200 ? nlohmann::json::parse(res->body) : nlohmann::json();
+    }
+};
+
+TEST_CASE("MCP — transport HTTP : sessions partagées et flux SSE", "[mcp][integration]") {
+    std::string exe = get_taskman_path();
+    if (exe.empty())
+        SKIP("taskman executable not found");
+
+    std::string db = (fs::temp_directory_path() / "taskman_mcp_http.db").string();
+    std::string pid_file = (fs::temp_directory_path() / "taskman_mcp_http.pid").string();
+    fs::remove(db);
+    int port = 18000 + static_cast<int>(std::chrono::steady_clock::now().time_since_epoch().count() % 1000);
+    std::string cmd = "TASKMAN_DB_NAME=\"" + db + "\" \"" + exe + "\" web --mcp --port " + std::to_string(port)
+                    + " > /dev/null 2>&1 & echo $! > \"" + pid_file + "\"";
+    REQUIRE(std::system(cmd.c_str()) == 0);
+    auto stop_server = [&pid_file] {
+        std::ifstream f(pid_file);
+        std::string pid;
+        f >> pid;
+        if (!pid.empty()) std::system(("kill " + pid).c_str());
+        fs::remove(pid_file);
+    };
+
+    McpHttpClient a(port);
+    bool started = false;
+    for (int i = 0; i < 50 && !started; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        started = a.initialize();
+    }
+    if (!started) {
+        stop_server();
+        SKIP("taskman web --mcp did not start (port in use?)");
+    }
+    REQUIRE_FALSE(a.session.empty());
+
+    REQUIRE(a.call(1, "taskman_init")["result"]["isError"] == false);
+    a.call(2, "taskman_phase_add", {{"id", "P1"}, {"name", "Phase 1"}});
+    auto added = a.call(3, "taskman_task_add", {{"title", "T"}, {"phase", "P1"}});
+    std::string task_id = added["result"]["structuredContent"]["id"];
+
+    // Une seconde session voit les écritures de la première (même processus)
+    McpHttpClient b(port);
+    REQUIRE(b.initialize());
+    REQUIRE(b.session != a.session);
+    auto listed = b.call(1, "taskman_task_list");
+    REQUIRE(listed["result"]["structuredContent"]["tasks"].size() == 1u);
+
+    // Sans session ou session inconnue
+    McpHttpClient anonymous(port);
+    auto res = anonymous.post(tool_call(1, "taskman_task_list"));
+    REQUIRE(res);
+    REQUIRE(res->status == 400);
+    anonymous.session = "unknown";
+    res = anonymous.post(tool_call(1, "taskman_task_list"));
+    REQUIRE(res->status == 404);
+
+    // Abonnement de la session a : la modification faite par b arrive sur le flux SSE de a
+    std::string uri = "taskman://task/" + task_id;
+    res = a.post({{"jsonrpc", "2.0"}, {"id", 4}, {"method", "resources/subscribe"}, {"params", {{"uri", uri}}}});
+    REQUIRE(res->status == 200);
+    std::string events;
+    std::thread stream([&] {
+        McpHttpClient sse(port);
+        sse.session = a.session;
+        httplib::Headers h = {{"Accept", "text/event-stream"}, {"Mcp-Session-Id", a.session}};
+        sse.cli.Get("/mcp", h, [&events](const char* data, size_t len) {
+            events.append(data, len);
+            return events.find("notifications/resources/updated") == std::string::npos;
+        });
+    });
+    b.call(2, "taskman_task_edit", {{"id", task_id}, {"title", "T2"}});
+    stream.join();
+    REQUIRE(events.find("event: message\ndata: ") != std::string::npos);
+    REQUIRE(events.find(uri) != std::string::npos);
+
+    // Fermeture de la session a
+    res = a.cli.Delete("/mcp", a.headers());
+    REQUIRE(res->status == 200);
+    res = a.post(tool_call(5, "taskman_task_list"));
+    REQUIRE(res->status == 404);
+    REQUIRE(b.call(3, "taskman_task_list")["result"]["isError"] == false);
+
+    stop_server();
+    fs::remove(db);
+}
+#endif
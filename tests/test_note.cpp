@@ -245,3 +245,28 @@ TEST_CASE("cmd_note_list_by_ids — --ids manquant retourne erreur", "[note]") {
     int r = run_note_list_by_ids_exit(db, {});
     REQUIRE(r == 1);
 }
+
+TEST_CASE("cmd_note_list / list-by-ids — --format ndjson", "[note]") {
+    Database db;
+    setup_db(db);
+    std::string id1 = nlohmann::json::parse(run_note_add_capture(db, {"task:note:add", "t1", "--content", "Première"}))["id"];
+    std::string id2 = nlohmann::json::parse(run_note_add_capture(db,
+        {"task:note:add", "t1", "--content", "Deuxième", "--kind", "progress", "--role", "developer"}))["id"];
+
+    auto list = nlohmann::json::parse(run_note_list(db, {"t1"}));
+    std::istringstream lines(run_note_list(db, {"t1", "--format", "ndjson"}));
+    std::string line;
+    size_t n = 0;
+    while (std::getline(lines, line)) {
+        REQUIRE(n < list.size());
+        auto note = nlohmann::json::parse(line);
+        REQUIRE(note["id"] == (n == 0 ? id1 : id2));  // ordre d'ajout
+        REQUIRE(note == list[n++]);  // kind/role vides → null, comme le JSON
+    }
+    REQUIRE(n == 2u);
+
+    std::string by_ids = run_note_list_by_ids(db, {"--ids", id2, "--format", "ndjson"});
+    REQUIRE(by_ids.find('\n') == by_ids.size() - 1);
+    REQUIRE(nlohmann::json::parse(by_ids)["id"] == id2);
+    REQUIRE(run_note_list_by_ids(db, {"--ids", "inexistant", "--format", "ndjson"}).empty());
+}
@@ -206,3 +206,37 @@ TEST_CASE("cmd_phase_list — ordre par sort_order", "[phase]") {
     REQUIRE(j[1]["id"] == "p2");
     REQUIRE(j[2]["id"] == "p3");
 }
+
+TEST_CASE("cmd_phase_list — --format table", "[phase]") {
+    Database db;
+    setup_db(db);
+    run_phase_add(db, {"phase:add", "--id", "p1", "--name", "Un \"quoted\"", "--sort-order", "1"});
+    run_phase_add(db, {"phase:add", "--id", "p2", "--name", "Deux", "--status", "done", "--sort-order", "2"});
+    run_phase_add(db, {"phase:add", "--id", "p3", "--name", "Trois", "--sort-order", "3"});
+    CoutRedirect redir;
+    char* argv[] = {const_cast<char*>("phase:list"), const_cast<char*>("--format"), const_cast<char*>("table"), nullptr};
+    REQUIRE(taskman::cmd_phase_list(3, argv, db) == 0);
+    auto j = nlohmann::json::parse(redir.str());
+    REQUIRE(j["columns"] == nlohmann::json({"id", "name", "status", "sort_order", "created_at", "updated_at"}));
+    REQUIRE(j["rows"].size() == 3u);
+    REQUIRE(j["rows"][0][0] == "p1");
+    REQUIRE(j["rows"][0][1] == "Un \"quoted\"");
+    REQUIRE(j["rows"][0][3] == 1);
+    // status encodé par dictionnaire (ordre d'apparition)
+    REQUIRE(j["dicts"]["status"] == nlohmann::json({"to_do", "done"}));
+    REQUIRE(j["rows"][0][2] == 0);
+    REQUIRE(j["rows"][1][2] == 1);
+    REQUIRE(j["rows"][2][2] == 0);
+}
+
+TEST_CASE("cmd_phase_list — --format table vide", "[phase]") {
+    Database db;
+    setup_db(db);
+    CoutRedirect redir;
+    char* argv[] = {const_cast<char*>("phase:list"), const_cast<char*>("--format"), const_cast<char*>("table"), nullptr};
+    REQUIRE(taskman::cmd_phase_list(3, argv, db) == 0);
+    auto j = nlohmann::json::parse(redir.str());
+    REQUIRE(j["columns"].size() == 6u);
+    REQUIRE(j["rows"].empty());
+    REQUIRE(j["dicts"]["status"].empty());
+}
@@ -1,5 +1,5 @@
 /**
- * Tests unitaires — commandes task:add, task:get, task:list, task:edit.
+ * Tests unitaires — commandes task:add, task:get, task:list, task:edit, task:wait.
  */
 
 #include <catch2/catch_test_macros.hpp>
@@ -8,11 +8,20 @@
 #include "core/note/note.hpp"
 #include "core/phase/phase.hpp"
 #include "core/task/task.hpp"
+#include "core/task/task_formatter.hpp"
+#include "core/task/task_repository.hpp"
+#include "core/task/task_service.hpp"
+#include "infrastructure/db/data_version.hpp"
+#include "util/roles.hpp"
+#include "util/statuses.hpp"
+#include <chrono>
+#include <filesystem>
 #include <iostream>
 #include <nlohmann/json.hpp>
 #include <optional>
 #include <sstream>
 #include <string>
+#include <thread>
 
 using namespace taskman;
 
@@ -97,6 +106,14 @@ static int run_task_dep_remove(Database& db, std::string task_id, std::string de
     return cmd_task_dep_remove(static_cast<int>(ptrs.size() - 1), ptrs.data(), db);
 }
 
+static int run_task_dep_batch(Database& db, std::string edges) {
+    std::vector<std::string> args = {"task:dep:batch", "--edges", std::move(edges)};
+    std::vector<char*> ptrs;
+    for (auto& s : args) ptrs.push_back(s.data());
+    ptrs.push_back(nullptr);
+    return cmd_task_dep_batch(static_cast<int>(ptrs.size() - 1), ptrs.data(), db);
+}
+
 static bool looks_like_uuid(const std::string& s) {
     // format xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx (36 chars, 4 hyphens)
     if (s.size() != 36) return false;
@@ -441,6 +458,92 @@ TEST_CASE("cmd_task_dep_remove — idempotent (dépendance absente)", "[task]")
     REQUIRE(r == 0);
 }
 
+TEST_CASE("task_dep_add — cycle refusé (utilitaire)", "[task]") {
+    Database db;
+    setup_db(db);
+    REQUIRE(task_add(db, "a", "p1", std::nullopt, "A", std::nullopt, "to_do", std::nullopt, std::nullopt));
+    REQUIRE(task_add(db, "b", "p1", std::nullopt, "B", std::nullopt, "to_do", std::nullopt, std::nullopt));
+    REQUIRE(task_add(db, "c", "p1", std::nullopt, "C", std::nullopt, "to_do", std::nullopt, std::nullopt));
+    REQUIRE(task_dep_add(db, "a", "b"));
+    REQUIRE(task_dep_add(db, "b", "c"));
+    std::stringstream sink;
+    std::streambuf* prev = std::cerr.rdbuf(sink.rdbuf());
+    bool ok = task_dep_add(db, "c", "a");
+    std::cerr.rdbuf(prev);
+    REQUIRE(!ok);
+    REQUIRE(sink.str().find("dependency cycle") != std::string::npos);
+    REQUIRE(db.query("SELECT 1 FROM task_deps WHERE task_id = 'c'").empty());
+}
+
+TEST_CASE("cmd_task_dep_batch — ajouts et suppressions en un lot", "[task]") {
+    Database db;
+    setup_db(db);
+    for (const char* id : {"a", "b", "c"}) {
+        REQUIRE(task_add(db, id, "p1", std::nullopt, id, std::nullopt, "to_do", std::nullopt, std::nullopt));
+    }
+    REQUIRE(task_dep_add(db, "a", "b"));
+    CoutRedirect redir;
+    int r = run_task_dep_batch(db, R"([{"task-id":"b","dep-id":"c"},{"task-id":"a","dep-id":"c"},)"
+                                   R"({"op":"remove","task-id":"a","dep-id":"b"}])");
+    REQUIRE(r == 0);
+    auto out = nlohmann::json::parse(redir.str());
+    REQUIRE(out["added"] == 2);
+    REQUIRE(out["removed"] == 1);
+    auto rows = db.query("SELECT task_id, depends_on FROM task_deps ORDER BY task_id, depends_on");
+    REQUIRE(rows.size() == 2u);
+    REQUIRE(rows[0]["task_id"] == "a");
+    REQUIRE(rows[0]["depends_on"] == "c");
+    REQUIRE(rows[1]["task_id"] == "b");
+    REQUIRE(rows[1]["depends_on"] == "c");
+}
+
+TEST_CASE("cmd_task_dep_batch — cycle dans le lot : rien n'est écrit", "[task]") {
+    Database db;
+    setup_db(db);
+    for (const char* id : {"a", "b", "c"}) {
+        REQUIRE(task_add(db, id, "p1", std::nullopt, id, std::nullopt, "to_do", std::nullopt, std::nullopt));
+    }
+    REQUIRE(task_dep_add(db, "a", "b"));
+    std::stringstream sink;
+    std::streambuf* prev = std::cerr.rdbuf(sink.rdbuf());
+    int r = run_task_dep_batch(db, R"([{"task-id":"b","dep-id":"c"},{"task-id":"c","dep-id":"a"}])");
+    std::cerr.rdbuf(prev);
+    REQUIRE(r == 1);
+    REQUIRE(sink.str().find("dependency cycle") != std::string::npos);
+    auto rows = db.query("SELECT task_id, depends_on FROM task_deps");
+    REQUIRE(rows.size() == 1u);
+    REQUIRE(rows[0]["task_id"] == "a");
+}
+
+TEST_CASE("cmd_task_dep_batch — tâche inexistante : rien n'est écrit", "[task]") {
+    Database db;
+    setup_db(db);
+    REQUIRE(task_add(db, "a", "p1", std::nullopt, "A", std::nullopt, "to_do", std::nullopt, std::nullopt));
+    REQUIRE(task_add(db, "b", "p1", std::nullopt, "B", std::nullopt, "to_do", std::nullopt, std::nullopt));
+    std::stringstream sink;
+    std::streambuf* prev = std::cerr.rdbuf(sink.rdbuf());
+    int r = run_task_dep_batch(db, R"([{"task-id":"a","dep-id":"b"},{"task-id":"a","dep-id":"zz"}])");
+    std::cerr.rdbuf(prev);
+    REQUIRE(r == 1);
+    REQUIRE(sink.str().find("task not found: zz") != std::string::npos);
+    REQUIRE(db.query("SELECT 1 FROM task_deps").empty());
+}
+
+TEST_CASE("cmd_task_dep_batch — doublon et JSON invalide rejetés", "[task]") {
+    Database db;
+    setup_db(db);
+    REQUIRE(task_add(db, "a", "p1", std::nullopt, "A", std::nullopt, "to_do", std::nullopt, std::nullopt));
+    REQUIRE(task_add(db, "b", "p1", std::nullopt, "B", std::nullopt, "to_do", std::nullopt, std::nullopt));
+    std::stringstream sink;
+    std::streambuf* prev = std::cerr.rdbuf(sink.rdbuf());
+    REQUIRE(run_task_dep_batch(db, R"([{"task-id":"a","dep-id":"b"},{"task-id":"a","dep-id":"b"}])") == 1);
+    REQUIRE(run_task_dep_batch(db, R"({"task-id":"a"})") == 1);
+    REQUIRE(run_task_dep_batch(db, "[]") == 1);
+    REQUIRE(run_task_dep_batch(db, R"([{"op":"move","task-id":"a","dep-id":"b"}])") == 1);
+    std::cerr.rdbuf(prev);
+    REQUIRE(db.query("SELECT 1 FROM task_deps").empty());
+}
+
 TEST_CASE("cmd_task_add — --format text", "[task]") {
     Database db;
     setup_db(db);
@@ -503,6 +606,57 @@ TEST_CASE("cmd_task_list — --blocked-filter blocked vs unblocked", "[task]") {
     REQUIRE(j_blocked[0]["id"] == "tb");
 }
 
+TEST_CASE("cmd_task_edit — --status done rapporte les tâches débloquées", "[task]") {
+    Database db;
+    setup_db(db);
+    for (const char* id : {"a", "b", "c", "d"}) {
+        REQUIRE(task_add(db, id, "p1", std::nullopt, id, std::nullopt, "to_do", std::nullopt, "developer"));
+    }
+    REQUIRE(task_dep_add(db, "b", "a")); // b n'attend que a → débloquée
+    REQUIRE(task_dep_add(db, "c", "a")); // c attend aussi d → reste bloquée
+    REQUIRE(task_dep_add(db, "c", "d"));
+    std::string out;
+    {
+        CoutRedirect redir;
+        REQUIRE(run_task_edit(db, {"task:edit", "a", "--status", "done"}) == 0);
+        out = redir.str();
+    }
+    auto j = nlohmann::json::parse(out);
+    REQUIRE(j["id"] == "a");
+    REQUIRE(j["status"] == "done");
+    REQUIRE(j["unblocked"].size() == 1u);
+    REQUIRE(j["unblocked"][0]["id"] == "b");
+    REQUIRE(j["unblocked"][0]["role"] == "developer");
+    REQUIRE(db.query("SELECT status FROM tasks WHERE id = 'a'")[0]["status"] == "done");
+
+    // d → done : c débloquée ; a déjà done ne compte plus comme bloqueur
+    {
+        CoutRedirect redir;
+        REQUIRE(run_task_edit(db, {"task:edit", "d", "--status", "done"}) == 0);
+        out = redir.str();
+    }
+    j = nlohmann::json::parse(out);
+    REQUIRE(j["unblocked"].size() == 1u);
+    REQUIRE(j["unblocked"][0]["id"] == "c");
+
+    // Déjà done : aucune transition, liste vide
+    {
+        CoutRedirect redir;
+        REQUIRE(run_task_edit(db, {"task:edit", "a", "--status", "done"}) == 0);
+        out = redir.str();
+    }
+    REQUIRE(nlohmann::json::parse(out)["unblocked"].empty());
+}
+
+TEST_CASE("cmd_task_edit — sans passage à done, pas de sortie", "[task]") {
+    Database db;
+    setup_db(db);
+    REQUIRE(task_add(db, "a", "p1", std::nullopt, "A", std::nullopt, "to_do", std::nullopt, std::nullopt));
+    CoutRedirect redir;
+    REQUIRE(run_task_edit(db, {"task:edit", "a", "--status", "in_progress"}) == 0);
+    REQUIRE(redir.str().empty());
+}
+
 TEST_CASE("cmd_task_list — --blocked-filter invalid", "[task]") {
     Database db;
     setup_db(db);
@@ -514,3 +668,565 @@ TEST_CASE("cmd_task_list — --blocked-filter invalid", "[task]") {
     int r = cmd_task_list(static_cast<int>(ptrs.size() - 1), ptrs.data(), db);
     REQUIRE(r == 1);
 }
+
+TEST_CASE("cmd_task_list — --fields : seules les colonnes demandées", "[task]") {
+    Database db;
+    setup_db(db);
+    REQUIRE(task_add(db, "ta", "p1", std::nullopt, "A", std::string("Longue description"), "to_do", std::nullopt, "developer"));
+    auto j = nlohmann::json::parse(run_task_list(db, {"--fields", "id, title,status,role,id"}));
+    REQUIRE(j.size() == 1u);
+    REQUIRE(j[0].size() == 4u);
+    REQUIRE(j[0]["id"] == "ta");
+    REQUIRE(j[0]["title"] == "A");
+    REQUIRE(j[0]["status"] == "to_do");
+    REQUIRE(j[0]["role"] == "developer");
+    REQUIRE_FALSE(j[0].contains("description"));
+    REQUIRE_FALSE(j[0].contains("note_ids"));
+
+    std::string text = run_task_list(db, {"--fields", "title,sort_order", "--format", "text"});
+    REQUIRE(text == "title: A\nsort_order: \n");
+}
+
+TEST_CASE("cmd_task_list — --summary : preset et description tronquée", "[task]") {
+    Database db;
+    setup_db(db);
+    std::string long_desc(300, 'x');
+    REQUIRE(task_add(db, "ta", "p1", std::nullopt, "A", long_desc, "to_do", std::nullopt, std::nullopt));
+    REQUIRE(task_add(db, "tb", "p1", std::nullopt, "B", std::string("court"), "to_do", std::nullopt, std::nullopt));
+    auto j = nlohmann::json::parse(run_task_list(db, {"--summary"}));
+    REQUIRE(j.size() == 2u);
+    REQUIRE(j[0].size() == 7u);
+    REQUIRE_FALSE(j[0].contains("created_at"));
+    REQUIRE(j[0]["description"] == std::string(120, 'x') + "…");
+    REQUIRE(j[1]["description"] == "court");
+
+    // summary + fields : les champs demandés, description tronquée
+    auto k = nlohmann::json::parse(run_task_list(db, {"--summary", "--fields", "id,description"}));
+    REQUIRE(k[0].size() == 2u);
+    REQUIRE(k[0]["description"] == std::string(120, 'x') + "…");
+}
+
+TEST_CASE("cmd_task_list — --fields inconnu ou vide refusé", "[task]") {
+    Database db;
+    setup_db(db);
+    for (const char* spec : {"id,password", " , "}) {
+        std::vector<std::string> args = {"task:list", "--fields", spec};
+        std::vector<char*> ptrs;
+        for (auto& s : args) ptrs.push_back(s.data());
+        ptrs.push_back(nullptr);
+        REQUIRE(cmd_task_list(static_cast<int>(ptrs.size() - 1), ptrs.data(), db) == 1);
+    }
+}
+
+TEST_CASE("cmd_task_list — --format table : colonnes, dictionnaires, échappements", "[task]") {
+    Database db;
+    setup_db(db);
+    REQUIRE(task_add(db, "ta", "p1", std::nullopt, "Ligne 1\nLigne \"2\"\t\\", std::nullopt, "to_do", 10, "developer"));
+    REQUIRE(task_add(db, "tb", "p1", std::nullopt, "B", std::nullopt, "done", 20, std::nullopt));
+    REQUIRE(task_add(db, "tc", "p1", std::nullopt, "C", std::nullopt, "to_do", 30, "developer"));
+    auto j = nlohmann::json::parse(run_task_list(db, {"--format", "table", "--fields", "id,title,status,role,sort_order"}));
+    REQUIRE(j["columns"] == nlohmann::json({"id", "title", "status", "role", "sort_order"}));
+    REQUIRE(j["rows"].size() == 3u);
+    REQUIRE(j["rows"][0] == nlohmann::json({"ta", "Ligne 1\nLigne \"2\"\t\\", 0, 0, 10}));
+    REQUIRE(j["rows"][1] == nlohmann::json({"tb", "B", 1, nullptr, 20}));
+    REQUIRE(j["rows"][2][2] == 0);
+    REQUIRE(j["dicts"]["status"] == nlohmann::json({"to_do", "done"}));
+    REQUIRE(j["dicts"]["role"] == nlohmann::json({"developer"}));
+
+    // Sans --fields : toutes les colonnes de task:list (sans note_ids)
+    auto all = nlohmann::json::parse(run_task_list(db, {"--format", "table"}));
+    REQUIRE(all["columns"].size() == 11u);
+    REQUIRE(all["dicts"].contains("creator"));
+}
+
+TEST_CASE("cmd_task_list — --format ndjson : un objet par ligne, comme le JSON", "[task]") {
+    Database db;
+    setup_db(db);
+    REQUIRE(task_add(db, "ta", "p1", std::nullopt, "Ligne 1\nLigne \"2\"\t\\", std::nullopt, "to_do", 10, "developer"));
+    REQUIRE(task_add(db, "tb", "p1", std::nullopt, "B", std::nullopt, "done", std::nullopt, std::nullopt));
+
+    auto list = nlohmann::json::parse(run_task_list(db));
+    std::istringstream lines(run_task_list(db, {"--format", "ndjson"}));
+    std::string line;
+    size_t n = 0;
+    while (std::getline(lines, line)) {
+        REQUIRE(n < list.size());
+        auto obj = nlohmann::json::parse(line);
+        auto expected = list[n++];
+        expected.erase("note_ids");  // colonnes de task:list uniquement (comme --format table)
+        REQUIRE(obj == expected);
+    }
+    REQUIRE(n == 2u);
+
+    std::string fields = run_task_list(db, {"--format", "ndjson", "--fields", "id,sort_order"});
+    REQUIRE(fields == "{\"id\":\"tb\",\"sort_order\":null}\n{\"id\":\"ta\",\"sort_order\":10}\n");
+
+    // Page : ligne finale {"nextCursor"} seulement s'il reste des tâches
+    std::string page = run_task_list(db, {"--format", "ndjson", "--fields", "id", "--limit", "1"});
+    REQUIRE(page.rfind("{\"id\":\"tb\"}\n{\"nextCursor\":\"", 0) == 0);
+    std::string cursor = nlohmann::json::parse(page.substr(page.find('\n') + 1))["nextCursor"];
+    REQUIRE(run_task_list(db, {"--format", "ndjson", "--fields", "id", "--limit", "1", "--cursor", cursor})
+            == "{\"id\":\"ta\"}\n");
+}
+
+TEST_CASE("TaskFormatter — sortie texte sur le flux fourni", "[task]") {
+    std::map<std::string, std::optional<std::string>> task = {
+        {"id", "t1"}, {"title", "T1"}, {"status", "to_do"}, {"note_ids", "n1,n2"}};
+    std::ostringstream out;
+    {
+        CoutRedirect redir;
+        TaskFormatter::format_text(task, out);
+        TaskFormatter::format_text_list({task, task}, out);
+        REQUIRE(redir.str().empty());
+    }
+    REQUIRE(out.str().rfind("title: T1\n", 0) == 0);
+    REQUIRE(out.str().find("note_ids: n1,n2\n---\ntitle: T1") != std::string::npos);
+}
+
+TEST_CASE("append_json — même texte que le DOM nlohmann", "[task]") {
+    std::map<std::string, std::optional<std::string>> task = {
+        {"id", "t1"}, {"title", "Quote \" slash \\ tab\t nl\n ctl\x01 é"}, {"status", std::nullopt},
+        {"sort_order", "12"}, {"role", ""}, {"note_ids", "n1,,n2"}, {"_key_id", "t1"}};
+    nlohmann::json dom;
+    task_to_json(dom, task);
+    std::string text;
+    append_json<TASK_FIELDS>(text, task);
+    REQUIRE(text == dom.dump());
+
+    task["sort_order"] = "x3";
+    std::vector<std::string> fields = {"title", "sort_order", "id", "title", "phase_id"};
+    task_to_json(dom, task, fields);
+    text.clear();
+    append_json<TASK_FIELDS>(text, task, fields);
+    REQUIRE(text == dom.dump());
+
+    std::map<std::string, std::optional<std::string>> note = {{"id", "n1"}, {"kind", ""}, {"role", "developer"}};
+    nlohmann::json note_dom;
+    note_to_json(note_dom, note);
+    text.clear();
+    append_json<NOTE_FIELDS>(text, note);
+    REQUIRE(text == note_dom.dump());
+    REQUIRE(note_dom["kind"].is_null());
+}
+
+TEST_CASE("cmd_task_list — --limit/--cursor parcourt toutes les tâches dans l'ordre", "[task]") {
+    Database db;
+    setup_db(db);
+    REQUIRE(milestone_add(db, "m1", "p1", std::nullopt, std::nullopt, false));
+    // milestone_id et sort_order NULL ou non, pour couvrir les transitions de la clé
+    REQUIRE(task_add(db, "t1", "p1", std::nullopt, "T1", std::nullopt, "to_do", std::nullopt, std::nullopt));
+    REQUIRE(task_add(db, "t2", "p1", std::nullopt, "T2", std::nullopt, "to_do", std::nullopt, std::nullopt));
+    REQUIRE(task_add(db, "t3", "p1", std::nullopt, "T3", std::nullopt, "done", 2, std::nullopt));
+    REQUIRE(task_add(db, "t4", "p1", std::string("m1"), "T4", std::nullopt, "to_do", std::nullopt, std::nullopt));
+    REQUIRE(task_add(db, "t5", "p1", std::string("m1"), "T5", std::nullopt, "to_do", 1, std::nullopt));
+    REQUIRE(task_add(db, "t6", "p1", std::string("m1"), "T6", std::nullopt, "to_do", 1, std::nullopt));
+
+    std::vector<std::string> expected;
+    for (const auto& t : nlohmann::json::parse(run_task_list(db, {"--fields", "id"})))
+        expected.push_back(t["id"].get<std::string>());
+    REQUIRE(expected.size() == 6u);
+
+    for (const char* limit : {"1", "2", "4", "6"}) {
+        std::vector<std::string> seen;
+        std::optional<std::string> cursor;
+        int pages = 0;
+        do {
+            std::vector<std::string> args = {"--fields", "title", "--limit", limit};
+            if (cursor) {
+                args.push_back("--cursor");
+                args.push_back(*cursor);
+            }
+            auto page = nlohmann::json::parse(run_task_list(db, args));
+            REQUIRE(page["tasks"].size() <= static_cast<size_t>(std::stoi(limit)));
+            for (const auto& t : page["tasks"]) seen.push_back("t" + t["title"].get<std::string>().substr(1));
+            cursor.reset();
+            if (!page["nextCursor"].is_null()) cursor = page["nextCursor"].get<std::string>();
+            REQUIRE(++pages <= 6);
+        } while (cursor);
+        REQUIRE(seen == expected);
+    }
+
+    // Filtres combinés avec la pagination
+    auto todo = nlohmann::json::parse(run_task_list(db, {"--status", "to_do", "--limit", "10", "--fields", "id"}));
+    REQUIRE(todo["tasks"].size() == 5u);
+    REQUIRE(todo["nextCursor"].is_null());
+}
+
+TEST_CASE("cmd_task_list — --limit avec --format table et text", "[task]") {
+    Database db;
+    setup_db(db);
+    REQUIRE(task_add(db, "ta", "p1", std::nullopt, "A", std::nullopt, "to_do", 1, "developer"));
+    REQUIRE(task_add(db, "tb", "p1", std::nullopt, "B", std::nullopt, "to_do", 2, "developer"));
+
+    auto table = nlohmann::json::parse(run_task_list(db, {"--format", "table", "--fields", "id,role", "--limit", "1"}));
+    REQUIRE(table["columns"] == nlohmann::json({"id", "role"}));
+    REQUIRE(table["rows"] == nlohmann::json::parse(R"([["ta",0]])"));
+    REQUIRE(table["nextCursor"].is_string());
+    auto rest = nlohmann::json::parse(run_task_list(
+        db, {"--format", "table", "--fields", "id", "--limit", "1", "--cursor", table["nextCursor"].get<std::string>()}));
+    REQUIRE(rest["rows"] == nlohmann::json::parse(R"([["tb"]])"));
+    REQUIRE(rest["nextCursor"].is_null());
+
+    std::string text = run_task_list(db, {"--format", "text", "--fields", "title", "--limit", "1"});
+    REQUIRE(text.rfind("title: A\n---\nnextCursor: ", 0) == 0);
+}
+
+TEST_CASE("cmd_task_list — --limit ou --cursor invalide refusé", "[task]") {
+    Database db;
+    setup_db(db);
+    for (std::vector<std::string> args : {std::vector<std::string>{"--limit", "0"},
+                                          std::vector<std::string>{"--limit", "1001"},
+                                          std::vector<std::string>{"--limit", "abc"},
+                                          std::vector<std::string>{"--cursor", "!!"},
+                                          std::vector<std::string>{"--cursor", "WyJhIl0"}}) {
+        std::vector<std::string> full = {"task:list"};
+        full.insert(full.end(), args.begin(), args.end());
+        std::vector<char*> ptrs;
+        for (auto& s : full) ptrs.push_back(s.data());
+        ptrs.push_back(nullptr);
+        CoutRedirect redir;
+        REQUIRE(cmd_task_list(static_cast<int>(ptrs.size() - 1), ptrs.data(), db) == 1);
+        REQUIRE(redir.str().empty());
+    }
+}
+
+TEST_CASE("TaskService::wait_ready — tâche déjà prête ou délai nul", "[task]") {
+    Database db;
+    setup_db(db);
+    TaskRepository repository(db.get_executor());
+    TaskService service(repository);
+    DataVersion data_version(db.get_executor());
+    std::vector<std::map<std::string, std::optional<std::string>>> tasks;
+    bool timed_out = true;
+
+    // Rien de prêt : délai nul → une seule vérification
+    REQUIRE(service.wait_ready(data_version, std::nullopt, std::nullopt, 1, 0, tasks, timed_out));
+    REQUIRE(timed_out);
+    REQUIRE(tasks.empty());
+
+    REQUIRE(task_add(db, "t1", "p1", std::nullopt, "Bloquante", std::nullopt, "in_progress", 1, std::string("developer")));
+    REQUIRE(task_add(db, "t2", "p1", std::nullopt, "Bloquée", std::nullopt, "to_do", 2, std::string("developer")));
+    REQUIRE(task_add(db, "t3", "p1", std::nullopt, "Autre rôle", std::nullopt, "to_do", 3, std::string("qa-engineer")));
+    REQUIRE(task_dep_add(db, "t2", "t1"));
+    REQUIRE(service.wait_ready(data_version, std::nullopt, std::string("developer"), 1, 0, tasks, timed_out));
+    REQUIRE(timed_out);
+
+    REQUIRE(service.wait_ready(data_version, std::nullopt, std::nullopt, 5, 0, tasks, timed_out));
+    REQUIRE_FALSE(timed_out);
+    REQUIRE(tasks.size() == 1u);
+    REQUIRE(tasks[0]["id"] == "t3");
+
+    // Arguments invalides
+    REQUIRE_FALSE(service.wait_ready(data_version, std::nullopt, std::string("invalid-role"), 1, 0, tasks, timed_out));
+    REQUIRE_FALSE(service.wait_ready(data_version, std::nullopt, std::nullopt, 0, 0, tasks, timed_out));
+    REQUIRE_FALSE(service.wait_ready(data_version, std::nullopt, std::nullopt, 1, -1, tasks, timed_out));
+}
+
+TEST_CASE("TaskService::wait_ready — réveil sur écriture d'une autre connexion", "[task]") {
+    std::string path = (std::filesystem::temp_directory_path() / "taskman_task_wait.db").string();
+    std::filesystem::remove(path);
+    Database db;
+    REQUIRE(db.open(path.c_str()));
+    REQUIRE(db.init_schema());
+    REQUIRE(phase_add(db, "p1", "Conception", "to_do", 1));
+    REQUIRE(task_add(db, "t1", "p1", std::nullopt, "Bloquante", std::nullopt, "in_progress", 1, std::string("developer")));
+    REQUIRE(task_add(db, "t2", "p1", std::nullopt, "Suivante", std::nullopt, "to_do", 2, std::string("developer")));
+    REQUIRE(task_dep_add(db, "t2", "t1"));
+
+    // Un autre processus (ici une autre connexion) termine t1 : t2 devient prête
+    bool written = false;
+    std::thread writer([&path, &written] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        Database other;
+        written = other.open(path.c_str()) && other.exec("UPDATE tasks SET status = 'done' WHERE id = 't1'");
+    });
+
+    TaskRepository repository(db.get_executor());
+    TaskService service(repository);
+    DataVersion data_version(db.get_executor());
+    std::vector<std::map<std::string, std::optional<std::string>>> tasks;
+    bool timed_out = true;
+    auto start = std::chrono::steady_clock::now();
+    bool ok = service.wait_ready(data_version, std::string("p1"), std::string("developer"), 1, 10000, tasks, timed_out);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    writer.join();
+
+    REQUIRE(written);
+    REQUIRE(ok);
+    REQUIRE_FALSE(timed_out);
+    REQUIRE(tasks.size() == 1u);
+    REQUIRE(tasks[0]["id"] == "t2");
+    REQUIRE(elapsed < std::chrono::seconds(5));
+    db.close();
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("cmd_task_wait — JSON, texte et options invalides", "[task]") {
+    Database db;
+    setup_db(db);
+    REQUIRE(task_add(db, "t1", "p1", std::nullopt, "Prête", std::nullopt, "to_do", 1, std::string("developer")));
+    auto run = [&db](std::vector<std::string> args, std::string& out) {
+        std::vector<std::string> full = {"task:wait"};
+        for (auto& a : args) full.push_back(a);
+        std::vector<char*> ptrs;
+        for (auto& s : full) ptrs.push_back(s.data());
+        ptrs.push_back(nullptr);
+        CoutRedirect redir;
+        int r = cmd_task_wait(static_cast<int>(ptrs.size() - 1), ptrs.data(), db);
+        out = redir.str();
+        return r;
+    };
+    std::string out;
+    REQUIRE(run({"--role", "developer", "--timeout", "0"}, out) == 0);
+    auto j = nlohmann::json::parse(out);
+    REQUIRE(j["timed_out"] == false);
+    REQUIRE(j["tasks"][0]["id"] == "t1");
+    REQUIRE(j["tasks"][0].contains("description"));
+    REQUIRE_FALSE(j["tasks"][0].contains("created_at"));
+
+    REQUIRE(run({"--role", "qa-engineer", "--timeout", "0", "--format", "text"}, out) == 0);
+    REQUIRE(out == "timed out: no ready task\n");
+
+    REQUIRE(run({"--timeout", "601"}, out) == 1);
+    REQUIRE(run({"--timeout", "abc"}, out) == 1);
+    REQUIRE(run({"--format", "table"}, out) == 1);
+}
+
+TEST_CASE("TaskService::get_tasks — plusieurs tâches avec note_ids", "[task]") {
+    Database db;
+    setup_db(db);
+    REQUIRE(task_add(db, "t1", "p1", std::nullopt, "T1", std::nullopt, "to_do"));
+    REQUIRE(task_add(db, "t2", "p1", std::nullopt, "T2", std::nullopt, "to_do"));
+    REQUIRE(note_add(db, "n1", "t2", "Première", std::nullopt, std::nullopt));
+    REQUIRE(note_add(db, "n2", "t2", "Seconde", std::nullopt, std::nullopt));
+    TaskRepository repository(db.get_executor());
+    TaskService service(repository);
+
+    auto tasks = service.get_tasks({"t2", "missing", "t1"});
+    REQUIRE(tasks.size() == 2u);
+    REQUIRE(tasks[0]["id"] == "t2");
+    REQUIRE(tasks[0]["note_ids"] == "n1,n2");
+    REQUIRE(tasks[1]["id"] == "t1");
+    REQUIRE(tasks[1]["note_ids"] == "");
+    // Même contenu que task:get
+    REQUIRE(tasks[0] == service.get_task("t2"));
+    REQUIRE(service.get_tasks({}).empty());
+}
+
+TEST_CASE("TaskService::bulk_add — clés, dépendances et ordre des IDs", "[task]") {
+    Database db;
+    setup_db(db);
+    REQUIRE(task_add(db, "ext", "p1", std::nullopt, "Existante", std::nullopt, "to_do"));
+    TaskRepository repository(db.get_executor());
+    TaskService service(repository);
+
+    std::vector<TaskBulkAddItem> items(3);
+    items[0].key = "a";
+    items[0].task.title = "A";
+    items[0].task.phase_id = "p1";
+    items[0].task.role = "developer";
+    items[1].task.title = "B";
+    items[1].task.phase_id = "p1";
+    items[1].task.sort_order = 2;
+    items[1].deps = {"a", "ext"};
+    items[2].key = "c";
+    items[2].task.title = "C";
+    items[2].task.phase_id = "p1";
+    items[2].task.status = "done";  // ignoré : un lot crée des tâches to_do
+    std::vector<std::string> ids;
+    REQUIRE(service.bulk_add(items, ids));
+    REQUIRE(ids.size() == 3u);
+    REQUIRE(looks_like_uuid(ids[0]));
+
+    auto tasks = service.get_tasks(ids);
+    REQUIRE(tasks[0]["title"] == "A");
+    REQUIRE(tasks[0]["role"] == "developer");
+    REQUIRE(tasks[1]["title"] == "B");
+    REQUIRE(tasks[1]["sort_order"] == "2");
+    REQUIRE(tasks[2]["status"] == "to_do");
+    auto deps = repository.get_dependencies(ids[1]);
+    REQUIRE(deps.size() == 2u);
+
+    auto j = TaskFormatter::bulk_add_to_json(items, ids);
+    REQUIRE(j["ids"] == nlohmann::json(ids));
+    REQUIRE(j["keys"] == nlohmann::json({{"a", ids[0]}, {"c", ids[2]}}));
+}
+
+TEST_CASE("TaskService::bulk_add — lot invalide : rien n'est écrit", "[task]") {
+    Database db;
+    setup_db(db);
+    TaskRepository repository(db.get_executor());
+    TaskService service(repository);
+    auto item = [](std::optional<std::string> key, std::string title, std::vector<std::string> deps = {}) {
+        TaskBulkAddItem it;
+        it.key = std::move(key);
+        it.task.title = std::move(title);
+        it.task.phase_id = "p1";
+        it.deps = std::move(deps);
+        return it;
+    };
+    std::vector<std::string> ids;
+    REQUIRE_FALSE(service.bulk_add({}, ids));
+    REQUIRE_FALSE(service.bulk_add({item("a", "A"), item("a", "B")}, ids));          // clé en double
+    REQUIRE_FALSE(service.bulk_add({item("a", "A", {"missing"})}, ids));             // dépendance inconnue
+    REQUIRE_FALSE(service.bulk_add({item("a", "A", {"a"})}, ids));                   // auto-dépendance
+    REQUIRE_FALSE(service.bulk_add({item("a", "A", {"b"}), item("b", "B", {"a"})}, ids));  // cycle
+    REQUIRE_FALSE(service.bulk_add({item("a", "A"), item(std::nullopt, "")}, ids));  // titre manquant
+    auto bad_role = item("a", "A");
+    bad_role.task.role = "invalid-role";
+    REQUIRE_FALSE(service.bulk_add({bad_role}, ids));
+    REQUIRE(service.list_tasks().empty());
+}
+
+TEST_CASE("TaskService::bulk_edit — une transaction et tâches débloquées", "[task]") {
+    Database db;
+    setup_db(db);
+    REQUIRE(task_add(db, "t1", "p1", std::nullopt, "T1", std::nullopt, "to_do"));
+    REQUIRE(task_add(db, "t2", "p1", std::nullopt, "T2", std::nullopt, "to_do"));
+    REQUIRE(task_add(db, "t3", "p1", std::nullopt, "T3", std::nullopt, "to_do", std::nullopt, std::string("developer")));
+    REQUIRE(task_dep_add(db, "t3", "t1"));
+    REQUIRE(task_dep_add(db, "t3", "t2"));
+    TaskRepository repository(db.get_executor());
+    TaskService service(repository);
+
+    TaskChanges c1;
+    c1.id = "t1";
+    c1.status = "done";
+    TaskChanges c2;
+    c2.id = "t2";
+    c2.status = "done";
+    c2.title = "T2 bis";
+    std::vector<std::map<std::string, std::optional<std::string>>> unblocked;
+    REQUIRE(service.bulk_edit({c1, c2}, unblocked));
+    REQUIRE(unblocked.size() == 1u);
+    REQUIRE(unblocked[0]["id"] == "t3");
+    REQUIRE(service.get_task("t2")["title"] == "T2 bis");
+    REQUIRE(service.get_task("t2")["description"] == std::nullopt);
+
+    auto j = TaskFormatter::bulk_edit_to_json(2, unblocked);
+    REQUIRE(j == nlohmann::json::parse(R"({"updated":2,"unblocked":[{"id":"t3","title":"T3","role":"developer"}]})"));
+
+    // Déjà done : pas de nouveau déblocage
+    REQUIRE(service.bulk_edit({c1}, unblocked));
+    REQUIRE(unblocked.empty());
+
+    // Tout ou rien : une tâche inconnue annule le lot
+    TaskChanges c3;
+    c3.id = "t3";
+    c3.title = "Modifiée";
+    TaskChanges missing;
+    missing.id = "missing";
+    missing.title = "X";
+    REQUIRE_FALSE(service.bulk_edit({c3, missing}, unblocked));
+    REQUIRE_FALSE(service.bulk_edit({c3, c3}, unblocked));
+    TaskChanges empty;
+    empty.id = "t3";
+    REQUIRE_FALSE(service.bulk_edit({empty}, unblocked));
+    REQUIRE(service.get_task("t3")["title"] == "T3");
+}
+
+TEST_CASE("cmd_task_bulk_add / cmd_task_bulk_edit — JSON, texte et erreurs", "[task]") {
+    Database db;
+    setup_db(db);
+    auto run = [&db](bool edit, std::vector<std::string> args, std::string& out) {
+        std::vector<std::string> full = {edit ? "task:bulk-edit" : "task:bulk-add"};
+        for (auto& a : args) full.push_back(a);
+        std::vector<char*> ptrs;
+        for (auto& s : full) ptrs.push_back(s.data());
+        ptrs.push_back(nullptr);
+        CoutRedirect redir;
+        int r = edit ? cmd_task_bulk_edit(static_cast<int>(ptrs.size() - 1), ptrs.data(), db)
+                     : cmd_task_bulk_add(static_cast<int>(ptrs.size() - 1), ptrs.data(), db);
+        out = redir.str();
+        return r;
+    };
+    std::string out;
+    REQUIRE(run(false, {"--tasks", R"([{"key":"a","title":"A","phase":"p1"},
+                                       {"key":"b","title":"B","phase":"p1","sort-order":"3","deps":["a"]}])"}, out) == 0);
+    auto j = nlohmann::json::parse(out);
+    std::string a = j["keys"]["a"], b = j["keys"]["b"];
+    REQUIRE(j["ids"] == nlohmann::json({a, b}));
+
+    // Une dépendance hors lot cite l'ID d'une tâche existante
+    REQUIRE(run(false, {"--format", "text", "--tasks", "[{\"title\":\"C\",\"phase\":\"p1\",\"deps\":[\"" + b + "\"]}]"}, out) == 0);
+    REQUIRE(out.size() == 37u);  // un UUID par ligne, sans clé
+
+    REQUIRE(run(true, {"--format", "text", "--tasks", "[{\"id\":\"" + a + "\",\"status\":\"done\",\"sort-order\":5}]"}, out) == 0);
+    REQUIRE(out == "updated: 1\nunblocked: " + b + " B\n");
+
+    REQUIRE(run(false, {"--tasks", R"([{"titl":"A","phase":"p1"}])"}, out) == 1);
+    REQUIRE(run(false, {"--tasks", R"([{"title":"A","phase":"p1","deps":"a"}])"}, out) == 1);
+    REQUIRE(run(false, {"--tasks", R"({"title":"A"})"}, out) == 1);
+    REQUIRE(run(false, {}, out) == 1);
+    REQUIRE(run(true, {"--tasks", R"([{"id":"x","sort-order":"abc"}])"}, out) == 1);
+    REQUIRE(run(true, {"--tasks", "[]", "--format", "table"}, out) == 1);
+}
+
+TEST_CASE("EnumTable — codes stables et hachage parfait", "[task]") {
+    REQUIRE(STATUS_CODES.size() == 3u);
+    REQUIRE(STATUS_CODES.code("to_do") == 1);
+    REQUIRE(STATUS_CODES.code("done") == 3);
+    REQUIRE(STATUS_CODES.code("Done") == 0);
+    REQUIRE(STATUS_CODES.code("") == 0);
+    REQUIRE(STATUS_CODES.name(2) == "in_progress");
+    REQUIRE(STATUS_CODES.name(4).empty());
+    for (size_t i = 0; i < ROLE_COUNT; ++i) {
+        REQUIRE(ROLE_CODES.code(ROLE_VALUES[i]) == static_cast<int>(i + 1));
+        REQUIRE(ROLE_CODES.name(static_cast<int>(i + 1)) == ROLE_VALUES[i]);
+    }
+    static_assert(STATUS_CODES.code("in_progress") == 2);
+}
+
+TEST_CASE("compact_enums — codes entiers en base, sorties inchangées", "[task]") {
+    Database db;
+    setup_db(db);
+    REQUIRE(task_add(db, "ta", "p1", std::nullopt, "A", std::nullopt, "in_progress", std::nullopt, "developer"));
+    REQUIRE(task_add(db, "tb", "p1", std::nullopt, "B", std::nullopt, "to_do", std::nullopt, "ui-designer"));
+    REQUIRE(task_add(db, "tc", "p1", std::nullopt, "C", std::nullopt, "done", std::nullopt, std::nullopt));
+    REQUIRE(task_dep_add(db, "tb", "ta"));
+    REQUIRE(note_add(db, "n1", "ta", "Note", std::optional<std::string>("progress"),
+                     std::optional<std::string>("developer")));
+    const std::vector<std::vector<std::string>> listings = {
+        {}, {"--status", "done"}, {"--role", "developer"}, {"--blocked-filter", "blocked"},
+        {"--blocked-filter", "unblocked"}, {"--format", "text"}, {"--format", "ndjson"}};
+    std::vector<std::string> before;
+    for (const auto& args : listings) before.push_back(run_task_list(db, args));
+    std::string get_before = run_task_get_capture(db, {"task:get", "ta"});
+
+    REQUIRE(db.compact_enums());
+    REQUIRE(db.compact_enums());  // déjà migrée : sans effet
+    REQUIRE(db.init_schema());
+    REQUIRE(db.query("SELECT typeof(status) AS t FROM tasks WHERE id = 'ta'")[0]["t"] == "integer");
+    REQUIRE(db.query("SELECT typeof(role) AS t FROM task_notes")[0]["t"] == "integer");
+    REQUIRE(db.query("SELECT typeof(status) AS t FROM phases")[0]["t"] == "integer");
+    REQUIRE(db.query("SELECT name FROM status_codes WHERE code = 3")[0]["name"] == "done");
+    for (size_t i = 0; i < listings.size(); ++i) REQUIRE(run_task_list(db, listings[i]) == before[i]);
+    REQUIRE(run_task_get_capture(db, {"task:get", "ta"}) == get_before);
+
+    // Écritures après migration : codées, relues en texte
+    run_task_add_capture(db, {"task:add", "--title", "D", "--phase", "p1", "--role", "software-architect",
+                              "--creator", "project-manager"});
+    {
+        CoutRedirect redir;
+        REQUIRE(run_task_edit(db, {"task:edit", "ta", "--status", "done"}) == 0);
+        auto j = nlohmann::json::parse(redir.str());
+        REQUIRE(j["unblocked"].size() == 1u);
+        REQUIRE(j["unblocked"][0]["role"] == "ui-designer");
+    }
+    REQUIRE(db.query("SELECT COUNT(*) AS n FROM tasks WHERE typeof(role) = 'text' OR typeof(status) = 'text'")[0]["n"] == "0");
+    auto j = nlohmann::json::parse(run_task_list(db, {"--role", "software-architect"}));
+    REQUIRE(j.size() == 1u);
+    REQUIRE(j[0]["status"] == "to_do");
+    REQUIRE(j[0]["creator"] == "project-manager");
+    REQUIRE(nlohmann::json::parse(run_task_list(db, {"--status", "done"})).size() == 2u);
+}
+
+TEST_CASE("compact_enums — valeur hors liste : migration refusée", "[task]") {
+    Database db;
+    setup_db(db);
+    REQUIRE(task_add(db, "ta", "p1", std::nullopt, "A", std::nullopt, "to_do", std::nullopt, std::nullopt));
+    REQUIRE(db.exec("UPDATE tasks SET role = 'wizard'"));
+    REQUIRE_FALSE(db.compact_enums());
+    REQUIRE(db.query("SELECT typeof(status) AS t FROM tasks")[0]["t"] == "text");
+    REQUIRE(db.query("SELECT name FROM sqlite_master WHERE name = 'status_codes'").empty());
+}